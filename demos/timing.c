@@ -519,6 +519,83 @@ static void time_hash(void)
    tally_results(2);
 }
 
+#define LOOKUPS 100000
+
+static int lookup_cipher, lookup_hash;
+
+static int lookup(unsigned long n)
+{
+   int r = 0;
+   const char *cname = cipher_descriptor[lookup_cipher].name;
+   const char *hname = hash_descriptor[lookup_hash].name;
+   const unsigned long *oid = hash_descriptor[lookup_hash].OID;
+   unsigned long oidlen = hash_descriptor[lookup_hash].OIDlen;
+
+   while (n--) {
+      r += find_cipher(cname);
+      r += find_hash(hname);
+      r += find_hash_oid(oid, oidlen);
+      r += cipher_is_valid(r & 7);
+   }
+   return r;
+}
+
+#ifdef LTC_PTHREAD
+static void *lookup_thread(void *arg)
+{
+   (void)arg;
+   lookup(LOOKUPS);
+   return NULL;
+}
+#endif
+
+static void time_lookup(void)
+{
+   ulong64 t1, c1;
+   unsigned long x;
+#ifdef LTC_PTHREAD
+   pthread_t th[64];
+   unsigned long n, y;
+#endif
+
+   fprintf(stderr, "\n\nDescriptor lookups:\n");
+   /* the last registered ones */
+   for (lookup_cipher = 0; lookup_cipher < TAB_SIZE - 1 && cipher_descriptor[lookup_cipher + 1].name != NULL; lookup_cipher++);
+   for (lookup_hash = 0; lookup_hash < TAB_SIZE - 1 && hash_descriptor[lookup_hash + 1].name != NULL; lookup_hash++);
+   if (cipher_descriptor[lookup_cipher].name == NULL || hash_descriptor[lookup_hash].name == NULL) {
+      fprintf(stderr, "no ciphers or hashes registered\n");
+      return;
+   }
+   fprintf(stderr, "find_cipher(\"%s\") + find_hash(\"%s\") + find_hash_oid() + cipher_is_valid()\n",
+                   cipher_descriptor[lookup_cipher].name, hash_descriptor[lookup_hash].name);
+
+   c1 = (ulong64)-1;
+   for (x = 0; x < 10; x++) {
+      t_start();
+      lookup(1000);
+      t1 = t_read();
+      c1 = (t1 > c1) ? c1 : t1;
+   }
+   fprintf(stderr, "%10"PRI64"u cycles per iteration\n", (c1 - skew) / 1000);
+
+#ifdef LTC_PTHREAD
+   for (n = 1; n <= 64; n *= 2) {
+      t_start();
+      for (y = 0; y < n; y++) {
+         if (pthread_create(&th[y], NULL, lookup_thread, NULL) != 0) {
+            fprintf(stderr, "pthread_create failed\n");
+            exit(EXIT_FAILURE);
+         }
+      }
+      for (y = 0; y < n; y++) {
+         pthread_join(th[y], NULL);
+      }
+      t1 = t_read();
+      fprintf(stderr, "%2lu threads: %10"PRI64"u cycles per iteration (wall clock)\n", n, t1 / ((ulong64)n * LOOKUPS));
+   }
+#endif
+}
+
 /*#warning you need an mp_rand!!!*/
 
 static void time_mult(void)
@@ -1155,7 +1232,8 @@ static void time_macs(void)
 
 static void time_encmacs_(unsigned long MAC_SIZE)
 {
-#if defined(LTC_EAX_MODE) || defined(LTC_OCB_MODE) || defined(LTC_OCB3_MODE) || defined(LTC_CCM_MODE) || defined(LTC_GCM_MODE)
+#if defined(LTC_EAX_MODE) || defined(LTC_OCB_MODE) || defined(LTC_OCB3_MODE) || defined(LTC_CCM_MODE) || defined(LTC_GCM_MODE) || \
+    defined(LTC_CHACHA20POLY1305_MODE)
    unsigned char *buf, IV[16], key[16], tag[16];
    ulong64 t1, t2;
    unsigned long x, z;
@@ -1311,6 +1389,53 @@ __attribute__ ((aligned (16)))
    fprintf(stderr, "GCM (precomp)\t\t%9"PRI64"u\n", t2/(ulong64)(MAC_SIZE*1024));
    }
 
+#endif
+
+#ifdef LTC_CHACHA20POLY1305_MODE
+   {
+   unsigned char key32[32];
+   chacha20poly1305_state st;
+
+   /* the cycles/byte of ChaCha20-Poly1305 are below 1, so they're printed with two decimals */
+   XMEMCPY(key32, key, 16);
+   XMEMCPY(key32 + 16, key, 16);
+   t2 = -1;
+   for (x = 0; x < 1000; x++) {
+        t_start();
+        t1 = t_read();
+        z = 16;
+        if ((err = chacha20poly1305_memory(key32, 32, IV, 12, NULL, 0, buf, MAC_SIZE*1024, buf, tag, &z, CHACHA20POLY1305_ENCRYPT)) != CRYPT_OK) {
+           fprintf(stderr, "\nChaCha20Poly1305 error... %s\n", error_to_string(err));
+           exit(EXIT_FAILURE);
+        }
+        t1 = t_read() - t1;
+        if (t1 < t2) t2 = t1;
+   }
+   fprintf(stderr, "ChaCha20Poly1305\t%12.2f\n", (double)t2/(double)(MAC_SIZE*1024));
+
+   /* the same with the encryption and Poly1305 in two separate passes, to compare with the single pass above */
+   t2 = -1;
+   for (x = 0; x < 1000; x++) {
+        t_start();
+        t1 = t_read();
+        z = 16;
+        if ((err = chacha20poly1305_init(&st, key32, 32)) != CRYPT_OK ||
+            (err = chacha20poly1305_setiv(&st, IV, 12)) != CRYPT_OK ||
+            (err = chacha_crypt(&st.chacha, buf, MAC_SIZE*1024, buf)) != CRYPT_OK ||
+            (err = poly1305_process(&st.poly, buf, MAC_SIZE*1024)) != CRYPT_OK) {
+           fprintf(stderr, "\nChaCha20Poly1305 error... %s\n", error_to_string(err));
+           exit(EXIT_FAILURE);
+        }
+        st.ctlen = MAC_SIZE*1024;
+        if ((err = chacha20poly1305_done(&st, tag, &z)) != CRYPT_OK) {
+           fprintf(stderr, "\nChaCha20Poly1305 error... %s\n", error_to_string(err));
+           exit(EXIT_FAILURE);
+        }
+        t1 = t_read() - t1;
+        if (t1 < t2) t2 = t1;
+   }
+   fprintf(stderr, "ChaCha20Poly1305 (2 passes)\t%12.2f\n", (double)t2/(double)(MAC_SIZE*1024));
+   }
 #endif
    XFREE(buf);
 #else
@@ -1327,6 +1452,260 @@ static void time_encmacs(void)
    time_encmacs_(32);
 }
 
+static void time_aead_batch_(unsigned long PKT_SIZE)
+{
+#if defined(LTC_GCM_MODE) || defined(LTC_OCB3_MODE)
+#define BATCH_PACKETS 64
+#define BATCH_KEYS    4
+   unsigned char *buf, IV[BATCH_PACKETS][12], key[16], tag[BATCH_PACKETS][16];
+   aead_packet pkt[BATCH_PACKETS];
+   ulong64 t1, t2, t3;
+   unsigned long x, y, z;
+   int err, cipher_idx;
+
+   fprintf(stderr, "\nAEAD batch Timings (%d packets of %lu bytes, %d keys, cycles/packet, one by one vs. batch):\n",
+           BATCH_PACKETS, PKT_SIZE, BATCH_KEYS);
+
+   buf = XMALLOC(BATCH_PACKETS*PKT_SIZE);
+   if (buf == NULL) {
+      fprintf(stderr, "\n\nout of heap yo\n\n");
+      exit(EXIT_FAILURE);
+   }
+
+   cipher_idx = find_cipher("aes");
+
+   yarrow_read(buf, BATCH_PACKETS*PKT_SIZE, &yarrow_prng);
+   yarrow_read(key, 16, &yarrow_prng);
+   yarrow_read(IV[0], sizeof(IV), &yarrow_prng);
+
+   XMEMSET(pkt, 0, sizeof(pkt));
+   for (x = 0; x < BATCH_PACKETS; x++) {
+      pkt[x].nonce    = IV[x];
+      pkt[x].noncelen = 12;
+      pkt[x].in       = buf + x*PKT_SIZE;
+      pkt[x].inlen    = PKT_SIZE;
+      pkt[x].out      = buf + x*PKT_SIZE;
+      pkt[x].tag      = tag[x];
+      pkt[x].taglen   = 16;
+   }
+
+#ifdef LTC_GCM_MODE
+   {
+   gcm_key *gk = XMALLOC(BATCH_KEYS * sizeof(*gk));
+   if (gk == NULL) {
+      fprintf(stderr, "\n\nout of heap yo\n\n");
+      exit(EXIT_FAILURE);
+   }
+   for (y = 0; y < BATCH_KEYS; y++) {
+      key[0] = (unsigned char)y;
+      if ((err = gcm_key_init(&gk[y], cipher_idx, key, 16)) != CRYPT_OK) { fprintf(stderr, "gcm_key_init: %s\n", error_to_string(err)); exit(EXIT_FAILURE); }
+   }
+   for (x = 0; x < BATCH_PACKETS; x++) {
+      pkt[x].mode = LTC_AEAD_GCM;
+      pkt[x].key.gcm = &gk[x % BATCH_KEYS];
+   }
+   t2 = t3 = -1;
+   for (y = 0; y < 1000; y++) {
+      t_start();
+      t1 = t_read();
+      for (x = 0; x < BATCH_PACKETS; x++) {
+         z = 16;
+         if ((err = gcm_key_memory(pkt[x].key.gcm, IV[x], 12, NULL, 0, pkt[x].out, PKT_SIZE, pkt[x].out, tag[x], &z, GCM_ENCRYPT)) != CRYPT_OK) {
+            fprintf(stderr, "\nGCM error... %s\n", error_to_string(err));
+            exit(EXIT_FAILURE);
+         }
+      }
+      t1 = t_read() - t1;
+      if (t1 < t2) t2 = t1;
+      t_start();
+      t1 = t_read();
+      if ((err = aead_encrypt_batch(LTC_AEAD_GCM, pkt, BATCH_PACKETS)) != CRYPT_OK) {
+         fprintf(stderr, "\nGCM batch error... %s\n", error_to_string(err));
+         exit(EXIT_FAILURE);
+      }
+      t1 = t_read() - t1;
+      if (t1 < t3) t3 = t1;
+   }
+   fprintf(stderr, "GCM \t\t\t%9"PRI64"u %9"PRI64"u\n", t2/BATCH_PACKETS, t3/BATCH_PACKETS);
+   for (y = 0; y < BATCH_KEYS; y++) {
+      gcm_key_done(&gk[y]);
+   }
+   XFREE(gk);
+   }
+#endif
+
+#ifdef LTC_OCB3_MODE
+   {
+   ocb3_key *ok = XMALLOC(BATCH_KEYS * sizeof(*ok));
+   if (ok == NULL) {
+      fprintf(stderr, "\n\nout of heap yo\n\n");
+      exit(EXIT_FAILURE);
+   }
+   for (y = 0; y < BATCH_KEYS; y++) {
+      key[0] = (unsigned char)y;
+      if ((err = ocb3_key_init(&ok[y], cipher_idx, key, 16)) != CRYPT_OK) { fprintf(stderr, "ocb3_key_init: %s\n", error_to_string(err)); exit(EXIT_FAILURE); }
+   }
+   for (x = 0; x < BATCH_PACKETS; x++) {
+      pkt[x].mode = LTC_AEAD_OCB3;
+      pkt[x].key.ocb3 = &ok[x % BATCH_KEYS];
+   }
+   t2 = t3 = -1;
+   for (y = 0; y < 1000; y++) {
+      t_start();
+      t1 = t_read();
+      for (x = 0; x < BATCH_PACKETS; x++) {
+         z = 16;
+         if ((err = ocb3_key_encrypt_authenticate_memory(pkt[x].key.ocb3, IV[x], 12, NULL, 0, pkt[x].out, PKT_SIZE, pkt[x].out, tag[x], &z)) != CRYPT_OK) {
+            fprintf(stderr, "\nOCB3 error... %s\n", error_to_string(err));
+            exit(EXIT_FAILURE);
+         }
+      }
+      t1 = t_read() - t1;
+      if (t1 < t2) t2 = t1;
+      t_start();
+      t1 = t_read();
+      if ((err = aead_encrypt_batch(LTC_AEAD_OCB3, pkt, BATCH_PACKETS)) != CRYPT_OK) {
+         fprintf(stderr, "\nOCB3 batch error... %s\n", error_to_string(err));
+         exit(EXIT_FAILURE);
+      }
+      t1 = t_read() - t1;
+      if (t1 < t3) t3 = t1;
+   }
+   fprintf(stderr, "OCB3 \t\t\t%9"PRI64"u %9"PRI64"u\n", t2/BATCH_PACKETS, t3/BATCH_PACKETS);
+   XFREE(ok);
+   }
+#endif
+
+   XFREE(buf);
+#undef BATCH_PACKETS
+#undef BATCH_KEYS
+#else
+   LTC_UNUSED_PARAM(PKT_SIZE);
+   fprintf(stderr, "NO AEAD batch\n");
+#endif
+}
+
+static void time_aead_batch(void)
+{
+   time_aead_batch_(64);
+   time_aead_batch_(256);
+   time_aead_batch_(1500);
+}
+
+static void time_hash_many_(unsigned long MSG_SIZE)
+{
+#if defined(LTC_SHA256) && defined(LTC_HASH_HELPERS)
+#define MANY_MSGS 64
+   unsigned char *buf, out[MANY_MSGS][32];
+   hash_job jobs[MANY_MSGS];
+   ulong64 t1, t2, t3;
+   unsigned long x, y, z;
+   int err, hash_idx;
+
+   buf = XMALLOC(MANY_MSGS*MSG_SIZE);
+   if (buf == NULL) {
+      fprintf(stderr, "\n\nout of heap yo\n\n");
+      exit(EXIT_FAILURE);
+   }
+
+   hash_idx = find_hash("sha256");
+
+   yarrow_read(buf, MANY_MSGS*MSG_SIZE, &yarrow_prng);
+   for (x = 0; x < MANY_MSGS; x++) {
+      jobs[x].in    = buf + x*MSG_SIZE;
+      jobs[x].inlen = MSG_SIZE;
+      jobs[x].out   = out[x];
+   }
+
+   t2 = t3 = -1;
+   for (y = 0; y < 1000; y++) {
+      t_start();
+      t1 = t_read();
+      for (x = 0; x < MANY_MSGS; x++) {
+         z = 32;
+         if ((err = hash_memory(hash_idx, jobs[x].in, MSG_SIZE, out[x], &z)) != CRYPT_OK) {
+            fprintf(stderr, "\nhash_memory error... %s\n", error_to_string(err));
+            exit(EXIT_FAILURE);
+         }
+      }
+      t1 = t_read() - t1;
+      if (t1 < t2) t2 = t1;
+      t_start();
+      t1 = t_read();
+      if ((err = hash_memory_many(hash_idx, jobs, MANY_MSGS)) != CRYPT_OK) {
+         fprintf(stderr, "\nhash_memory_many error... %s\n", error_to_string(err));
+         exit(EXIT_FAILURE);
+      }
+      t1 = t_read() - t1;
+      if (t1 < t3) t3 = t1;
+   }
+   fprintf(stderr, "SHA-256 %4lu bytes \t%9"PRI64"u %9"PRI64"u %9.2f %9.2f\n", MSG_SIZE,
+           t2/MANY_MSGS, t3/MANY_MSGS, (double)t2/(MANY_MSGS*MSG_SIZE), (double)t3/(MANY_MSGS*MSG_SIZE));
+
+   XFREE(buf);
+#undef MANY_MSGS
+#else
+   LTC_UNUSED_PARAM(MSG_SIZE);
+   fprintf(stderr, "NO SHA-256\n");
+#endif
+}
+
+static void time_hash_many(void)
+{
+   fprintf(stderr, "\nhash_memory_many() Timings (64 messages, cycles/message and cycles/byte, one by one vs. many):\n");
+   time_hash_many_(64);
+   time_hash_many_(256);
+   time_hash_many_(1024);
+   time_hash_many_(4096);
+}
+
+static void time_argon2(void)
+{
+#ifdef LTC_ARGON2
+#define ARGON2_SECONDS 3
+   static const struct {
+      unsigned long t_cost, m_cost, parallelism;
+   } params[] = {
+      { 3,   4096, 1 },
+      { 3,  65536, 1 },
+      { 3,  65536, 4 },
+      { 1, 262144, 4 },
+   };
+   unsigned char out[32], salt[16];
+   unsigned long x, n;
+   time_t t1;
+   int err;
+
+#ifdef LTC_PTHREAD
+   fprintf(stderr, "\nArgon2id Timings (hashes/second, one thread per lane):\n");
+#else
+   fprintf(stderr, "\nArgon2id Timings (hashes/second, single threaded):\n");
+#endif
+   yarrow_read(salt, sizeof(salt), &yarrow_prng);
+   for (x = 0; x < sizeof(params)/sizeof(params[0]); x++) {
+      /* count the hashes of at least ARGON2_SECONDS, from the start of a second */
+      t1 = time(NULL);
+      while (time(NULL) == t1);
+      t1 = time(NULL);
+      n = 0;
+      do {
+         if ((err = argon2_hash(ARGON2_ID, params[x].t_cost, params[x].m_cost, params[x].parallelism,
+                                (const unsigned char*)"password", 8, salt, sizeof(salt),
+                                NULL, 0, NULL, 0, out, sizeof(out))) != CRYPT_OK) {
+            fprintf(stderr, "\nargon2_hash error... %s\n", error_to_string(err));
+            exit(EXIT_FAILURE);
+         }
+         n++;
+      } while (difftime(time(NULL), t1) < ARGON2_SECONDS);
+      fprintf(stderr, "t=%lu m=%6lu KiB p=%lu \t%9.2f\n", params[x].t_cost, params[x].m_cost, params[x].parallelism,
+              n / difftime(time(NULL), t1));
+   }
+#undef ARGON2_SECONDS
+#else
+   fprintf(stderr, "NO ARGON2\n");
+#endif
+}
+
 #define LTC_TEST_FN(f)  { f, #f }
 int main(int argc, char **argv)
 {
@@ -1343,8 +1722,12 @@ const struct
    LTC_TEST_FN(time_cipher_ctr),
    LTC_TEST_FN(time_cipher_lrw),
    LTC_TEST_FN(time_hash),
+   LTC_TEST_FN(time_hash_many),
+   LTC_TEST_FN(time_argon2),
+   LTC_TEST_FN(time_lookup),
    LTC_TEST_FN(time_macs),
    LTC_TEST_FN(time_encmacs),
+   LTC_TEST_FN(time_aead_batch),
    LTC_TEST_FN(time_prng),
    LTC_TEST_FN(time_mult),
    LTC_TEST_FN(time_sqr),
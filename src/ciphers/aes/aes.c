@@ -32,6 +32,33 @@
 
 #ifdef LTC_RIJNDAEL
 
+#if defined(LTC_AES_NI) || defined(LTC_AES_BITSLICE)
+/* the multi-block functions dispatch to the fastest implementation at runtime */
+#define ACCEL_ECB_ENC rijndael_accel_ecb_encrypt
+#define ACCEL_ECB_DEC rijndael_accel_ecb_decrypt
+#define ACCEL_CBC_ENC rijndael_accel_cbc_encrypt
+#define ACCEL_CBC_DEC rijndael_accel_cbc_decrypt
+#define ACCEL_CTR     rijndael_accel_ctr_encrypt
+#else
+#define ACCEL_ECB_ENC NULL
+#define ACCEL_ECB_DEC NULL
+#define ACCEL_CBC_ENC NULL
+#define ACCEL_CBC_DEC NULL
+#define ACCEL_CTR     NULL
+#endif
+#if (defined(LTC_AES_NI) || defined(LTC_AES_BITSLICE)) && defined(LTC_XTS_MODE)
+#define ACCEL_XTS_ENC rijndael_accel_xts_encrypt
+#define ACCEL_XTS_DEC rijndael_accel_xts_decrypt
+#else
+#define ACCEL_XTS_ENC NULL
+#define ACCEL_XTS_DEC NULL
+#endif
+#if defined(LTC_GCM_AESNI)
+#define ACCEL_GCM     rijndael_accel_gcm_memory
+#else
+#define ACCEL_GCM     NULL
+#endif
+
 #ifndef ENCRYPT_ONLY
 
 #define SETUP    rijndael_setup
@@ -47,7 +74,8 @@ const struct ltc_cipher_descriptor rijndael_desc =
     6,
     16, 32, 16, 10,
     SETUP, ECB_ENC, ECB_DEC, ECB_TEST, ECB_DONE, ECB_KS,
-    NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL
+    ACCEL_ECB_ENC, ACCEL_ECB_DEC, ACCEL_CBC_ENC, ACCEL_CBC_DEC, ACCEL_CTR,
+    NULL, NULL, NULL, ACCEL_GCM, NULL, NULL, NULL, ACCEL_XTS_ENC, ACCEL_XTS_DEC
 };
 
 const struct ltc_cipher_descriptor aes_desc =
@@ -56,7 +84,8 @@ const struct ltc_cipher_descriptor aes_desc =
     6,
     16, 32, 16, 10,
     SETUP, ECB_ENC, ECB_DEC, ECB_TEST, ECB_DONE, ECB_KS,
-    NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL
+    ACCEL_ECB_ENC, ACCEL_ECB_DEC, ACCEL_CBC_ENC, ACCEL_CBC_DEC, ACCEL_CTR,
+    NULL, NULL, NULL, ACCEL_GCM, NULL, NULL, NULL, ACCEL_XTS_ENC, ACCEL_XTS_DEC
 };
 
 #else
@@ -72,7 +101,8 @@ const struct ltc_cipher_descriptor rijndael_enc_desc =
     6,
     16, 32, 16, 10,
     SETUP, ECB_ENC, NULL, NULL, ECB_DONE, ECB_KS,
-    NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL
+    ACCEL_ECB_ENC, NULL, ACCEL_CBC_ENC, NULL, ACCEL_CTR,
+    NULL, NULL, NULL, ACCEL_GCM, NULL, NULL, NULL, NULL, NULL
 };
 
 const struct ltc_cipher_descriptor aes_enc_desc =
@@ -81,7 +111,8 @@ const struct ltc_cipher_descriptor aes_enc_desc =
     6,
     16, 32, 16, 10,
     SETUP, ECB_ENC, NULL, NULL, ECB_DONE, ECB_KS,
-    NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL
+    ACCEL_ECB_ENC, NULL, ACCEL_CBC_ENC, NULL, ACCEL_CTR,
+    NULL, NULL, NULL, ACCEL_GCM, NULL, NULL, NULL, NULL, NULL
 };
 
 #endif
@@ -127,6 +158,16 @@ int SETUP(const unsigned char *key, int keylen, int num_rounds, symmetric_key *s
     LTC_ARGCHK(key  != NULL);
     LTC_ARGCHK(skey != NULL);
 
+#ifdef LTC_AES_NI
+    if (aesni_is_supported()) {
+#ifdef LTC_AES_BITSLICE
+       /* AES-NI does the multi-block functions as well, they use the tables if it gets masked */
+       skey->rijndael.has_bsK = 0;
+#endif
+       return aesni_setup(key, keylen, num_rounds, skey);
+    }
+#endif
+
     if (keylen != 16 && keylen != 24 && keylen != 32) {
        return CRYPT_INVALID_KEYSIZE;
     }
@@ -270,6 +311,11 @@ int SETUP(const unsigned char *key, int keylen, int num_rounds, symmetric_key *s
     *rk   = *rrk;
 #endif /* ENCRYPT_ONLY */
 
+#ifdef LTC_AES_BITSLICE
+    /* the round keys of the multi-block functions */
+    rijndael_bs_setup(skey);
+#endif
+
     return CRYPT_OK;
 }
 
@@ -294,6 +340,12 @@ int ECB_ENC(const unsigned char *pt, unsigned char *ct, const symmetric_key *ske
     LTC_ARGCHK(ct != NULL);
     LTC_ARGCHK(skey != NULL);
 
+#ifdef LTC_AES_NI
+    if (aesni_is_supported()) {
+       return aesni_ecb_encrypt(pt, ct, 1, skey);
+    }
+#endif
+
     Nr = skey->rijndael.Nr;
     rk = skey->rijndael.eK;
 
@@ -474,6 +526,12 @@ int ECB_DEC(const unsigned char *ct, unsigned char *pt, const symmetric_key *ske
     LTC_ARGCHK(ct != NULL);
     LTC_ARGCHK(skey != NULL);
 
+#ifdef LTC_AES_NI
+    if (aesni_is_supported()) {
+       return aesni_ecb_decrypt(ct, pt, 1, skey);
+    }
+#endif
+
     Nr = skey->rijndael.Nr;
     rk = skey->rijndael.dK;
 
@@ -632,6 +690,90 @@ int ECB_DEC(const unsigned char *ct, unsigned char *pt, const symmetric_key *ske
 }
 #endif
 
+#if defined(LTC_TEST) && (defined(LTC_AES_NI) || defined(LTC_AES_BITSLICE))
+/* compare the multi-block functions with the single block ones */
+static int _rijndael_accel_test(symmetric_key *key, int i)
+{
+  unsigned char pt[21*16], ct[21*16], ref[21*16], iv[16], ctr[16];
+  unsigned long x;
+  int y, z, mode, err;
+
+  for (x = 0; x < sizeof(pt); x++) {
+     pt[x] = (unsigned char)(x * 7 + i);
+  }
+
+  /* ECB */
+  for (x = 0; x < sizeof(pt); x += 16) {
+     rijndael_ecb_encrypt(pt + x, ref + x, key);
+  }
+  if ((err = rijndael_accel_ecb_encrypt(pt, ct, 21, key)) != CRYPT_OK) {
+     return err;
+  }
+  if (compare_testvector(ct, sizeof(ct), ref, sizeof(ref), "AES ECB accel encrypt", i)) {
+     return CRYPT_FAIL_TESTVECTOR;
+  }
+  if ((err = rijndael_accel_ecb_decrypt(ct, ct, 21, key)) != CRYPT_OK) {
+     return err;
+  }
+  if (compare_testvector(ct, sizeof(ct), pt, sizeof(pt), "AES ECB accel decrypt", i)) {
+     return CRYPT_FAIL_TESTVECTOR;
+  }
+
+  /* CBC */
+  zeromem(ctr, sizeof(ctr));
+  for (x = 0; x < sizeof(pt); x += 16) {
+     for (y = 0; y < 16; y++) ctr[y] ^= pt[x + y];
+     rijndael_ecb_encrypt(ctr, ctr, key);
+     XMEMCPY(ref + x, ctr, 16);
+  }
+  zeromem(iv, sizeof(iv));
+  if ((err = rijndael_accel_cbc_encrypt(pt, ct, 21, iv, key)) != CRYPT_OK) {
+     return err;
+  }
+  if (compare_testvector(ct, sizeof(ct), ref, sizeof(ref), "AES CBC accel encrypt", i) ||
+      compare_testvector(iv, 16, ctr, 16, "AES CBC accel encrypt IV", i)) {
+     return CRYPT_FAIL_TESTVECTOR;
+  }
+  zeromem(iv, sizeof(iv));
+  if ((err = rijndael_accel_cbc_decrypt(ct, ct, 21, iv, key)) != CRYPT_OK) {
+     return err;
+  }
+  if (compare_testvector(ct, sizeof(ct), pt, sizeof(pt), "AES CBC accel decrypt", i) ||
+      compare_testvector(iv, 16, ctr, 16, "AES CBC accel decrypt IV", i)) {
+     return CRYPT_FAIL_TESTVECTOR;
+  }
+
+  /* CTR, the counter is started so that it carries into the upper 64 bits */
+  for (z = 0; z < 2; z++) {
+     mode = z ? CTR_COUNTER_LITTLE_ENDIAN : CTR_COUNTER_BIG_ENDIAN;
+     zeromem(ctr, sizeof(ctr));
+     if (mode == CTR_COUNTER_LITTLE_ENDIAN) {
+        XMEMSET(ctr, 0xff, 7);
+        ctr[7] = 0xf0;
+     } else {
+        XMEMSET(ctr + 8, 0xff, 7);
+        ctr[15] = 0xf0;
+     }
+     XMEMCPY(iv, ctr, 16);
+     for (x = 0; x < sizeof(pt); x += 16) {
+        for (y = 0; y < 16; y++) {
+           if (++ctr[mode == CTR_COUNTER_LITTLE_ENDIAN ? y : 15 - y] != 0) break;
+        }
+        rijndael_ecb_encrypt(ctr, ref + x, key);
+        for (y = 0; y < 16; y++) ref[x + y] ^= pt[x + y];
+     }
+     if ((err = rijndael_accel_ctr_encrypt(pt, ct, 21, iv, mode, key)) != CRYPT_OK) {
+        return err;
+     }
+     if (compare_testvector(ct, sizeof(ct), ref, sizeof(ref), "AES CTR accel", i) ||
+         compare_testvector(iv, 16, ctr, 16, "AES CTR accel counter", i)) {
+        return CRYPT_FAIL_TESTVECTOR;
+     }
+  }
+  return CRYPT_OK;
+}
+#endif
+
 /**
   Performs a self-test of the AES block cipher
   @return CRYPT_OK if functional, CRYPT_NOP if self-test has been disabled
@@ -678,6 +820,9 @@ int ECB_TEST(void)
   symmetric_key key;
   unsigned char tmp[2][16];
   int i, y;
+#if defined(LTC_AES_NI) && defined(LTC_AES_BITSLICE)
+  unsigned long mask;
+#endif
 
   for (i = 0; i < (int)(sizeof(tests)/sizeof(tests[0])); i++) {
     zeromem(&key, sizeof(key));
@@ -697,6 +842,21 @@ int ECB_TEST(void)
     for (y = 0; y < 1000; y++) rijndael_ecb_encrypt(tmp[0], tmp[0], &key);
     for (y = 0; y < 1000; y++) rijndael_ecb_decrypt(tmp[0], tmp[0], &key);
     for (y = 0; y < 16; y++) if (tmp[0][y] != 0) return CRYPT_FAIL_TESTVECTOR;
+
+#if defined(LTC_AES_NI) || defined(LTC_AES_BITSLICE)
+    if ((err = _rijndael_accel_test(&key, i)) != CRYPT_OK) {
+       return err;
+    }
+#endif
+#if defined(LTC_AES_NI) && defined(LTC_AES_BITSLICE)
+    /* a key set up with AES-NI has no bitsliced round keys, without AES-NI it's used with the tables */
+    mask = ltc_cpu_mask(~LTC_CPU_AESNI);
+    err = _rijndael_accel_test(&key, i);
+    ltc_cpu_mask(mask);
+    if (err != CRYPT_OK) {
+       return err;
+    }
+#endif
   }
   return CRYPT_OK;
  #endif
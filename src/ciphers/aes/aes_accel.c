@@ -0,0 +1,376 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ */
+
+/**
+  @file aes_accel.c
+  Multi-block functions of the AES (Rijndael) descriptors
+
+  They're hooked into the accel_xxx members of the descriptors and dispatch
+  to the fastest implementation the CPU supports. If there is none, ECB
+  encryption and CTR mode use the constant-time bitsliced implementation if
+  it's enabled; everything else processes the blocks one at a time with the
+  table based implementation. The GCM hook returns CRYPT_NOP, which makes
+  gcm_memory() fall back to its generic code.
+*/
+
+#include "tomcrypt_private.h"
+
+#if defined(LTC_RIJNDAEL) && (defined(LTC_AES_NI) || defined(LTC_AES_BITSLICE))
+
+/**
+  Encrypt blocks in ECB mode
+  @param pt     The plaintext
+  @param ct     [out] The ciphertext
+  @param blocks The number of 16 byte blocks to encrypt
+  @param skey   The key as scheduled
+  @return CRYPT_OK if successful
+*/
+int rijndael_accel_ecb_encrypt(const unsigned char *pt, unsigned char *ct, unsigned long blocks, symmetric_key *skey)
+{
+   int err;
+
+   LTC_ARGCHK(pt   != NULL);
+   LTC_ARGCHK(ct   != NULL);
+   LTC_ARGCHK(skey != NULL);
+
+#ifdef LTC_AES_NI
+   if (aesni_is_supported()) {
+      return aesni_ecb_encrypt(pt, ct, blocks, skey);
+   }
+#endif
+#ifdef LTC_AES_BITSLICE
+   if (skey->rijndael.has_bsK) {
+      return rijndael_bs_ecb_encrypt(pt, ct, blocks, skey);
+   }
+#endif
+   for (; blocks > 0; blocks--) {
+      if ((err = rijndael_ecb_encrypt(pt, ct, skey)) != CRYPT_OK) {
+         return err;
+      }
+      pt += 16;
+      ct += 16;
+   }
+   return CRYPT_OK;
+}
+
+/**
+  Decrypt blocks in ECB mode
+  @param ct     The ciphertext
+  @param pt     [out] The plaintext
+  @param blocks The number of 16 byte blocks to decrypt
+  @param skey   The key as scheduled
+  @return CRYPT_OK if successful
+*/
+int rijndael_accel_ecb_decrypt(const unsigned char *ct, unsigned char *pt, unsigned long blocks, symmetric_key *skey)
+{
+   int err;
+
+   LTC_ARGCHK(pt   != NULL);
+   LTC_ARGCHK(ct   != NULL);
+   LTC_ARGCHK(skey != NULL);
+
+#ifdef LTC_AES_NI
+   if (aesni_is_supported()) {
+      return aesni_ecb_decrypt(ct, pt, blocks, skey);
+   }
+#endif
+
+   for (; blocks > 0; blocks--) {
+      if ((err = rijndael_ecb_decrypt(ct, pt, skey)) != CRYPT_OK) {
+         return err;
+      }
+      ct += 16;
+      pt += 16;
+   }
+   return CRYPT_OK;
+}
+
+/**
+  Encrypt blocks in CBC mode
+  @param pt     The plaintext
+  @param ct     [out] The ciphertext
+  @param blocks The number of 16 byte blocks to encrypt
+  @param IV     [in/out] The chaining value
+  @param skey   The key as scheduled
+  @return CRYPT_OK if successful
+*/
+int rijndael_accel_cbc_encrypt(const unsigned char *pt, unsigned char *ct, unsigned long blocks, unsigned char *IV, symmetric_key *skey)
+{
+   unsigned char buf[16];
+   int x, err;
+
+   LTC_ARGCHK(pt   != NULL);
+   LTC_ARGCHK(ct   != NULL);
+   LTC_ARGCHK(IV   != NULL);
+   LTC_ARGCHK(skey != NULL);
+
+#ifdef LTC_AES_NI
+   if (aesni_is_supported()) {
+      return aesni_cbc_encrypt(pt, ct, blocks, IV, skey);
+   }
+#endif
+
+   for (; blocks > 0; blocks--) {
+      for (x = 0; x < 16; x++) {
+         buf[x] = pt[x] ^ IV[x];
+      }
+      if ((err = rijndael_ecb_encrypt(buf, ct, skey)) != CRYPT_OK) {
+         return err;
+      }
+      XMEMCPY(IV, ct, 16);
+      pt += 16;
+      ct += 16;
+   }
+#ifdef LTC_CLEAN_STACK
+   zeromem(buf, sizeof(buf));
+#endif
+   return CRYPT_OK;
+}
+
+/**
+  Decrypt blocks in CBC mode
+  @param ct     The ciphertext
+  @param pt     [out] The plaintext, may be the same buffer as ct
+  @param blocks The number of 16 byte blocks to decrypt
+  @param IV     [in/out] The chaining value
+  @param skey   The key as scheduled
+  @return CRYPT_OK if successful
+*/
+int rijndael_accel_cbc_decrypt(const unsigned char *ct, unsigned char *pt, unsigned long blocks, unsigned char *IV, symmetric_key *skey)
+{
+   unsigned char buf[16], tmp[16];
+   int x, err;
+
+   LTC_ARGCHK(pt   != NULL);
+   LTC_ARGCHK(ct   != NULL);
+   LTC_ARGCHK(IV   != NULL);
+   LTC_ARGCHK(skey != NULL);
+
+#ifdef LTC_AES_NI
+   if (aesni_is_supported()) {
+      return aesni_cbc_decrypt(ct, pt, blocks, IV, skey);
+   }
+#endif
+
+   for (; blocks > 0; blocks--) {
+      if ((err = rijndael_ecb_decrypt(ct, buf, skey)) != CRYPT_OK) {
+         return err;
+      }
+      XMEMCPY(tmp, ct, 16);
+      for (x = 0; x < 16; x++) {
+         pt[x] = buf[x] ^ IV[x];
+      }
+      XMEMCPY(IV, tmp, 16);
+      ct += 16;
+      pt += 16;
+   }
+#ifdef LTC_CLEAN_STACK
+   zeromem(buf, sizeof(buf));
+#endif
+   return CRYPT_OK;
+}
+
+/**
+  Encrypt blocks in CTR mode
+
+  The counter is incremented before each block, over the full block width.
+  @param pt     The plaintext
+  @param ct     [out] The ciphertext
+  @param blocks The number of 16 byte blocks to encrypt
+  @param IV     [in/out] The counter, the last counter used on output
+  @param mode   CTR_COUNTER_LITTLE_ENDIAN or CTR_COUNTER_BIG_ENDIAN
+  @param skey   The key as scheduled
+  @return CRYPT_OK if successful
+*/
+int rijndael_accel_ctr_encrypt(const unsigned char *pt, unsigned char *ct, unsigned long blocks, unsigned char *IV, int mode, symmetric_key *skey)
+{
+   unsigned char buf[16];
+   int x, err;
+
+   LTC_ARGCHK(pt   != NULL);
+   LTC_ARGCHK(ct   != NULL);
+   LTC_ARGCHK(IV   != NULL);
+   LTC_ARGCHK(skey != NULL);
+
+#ifdef LTC_AES_NI
+   if (aesni_is_supported()) {
+      return aesni_ctr_encrypt(pt, ct, blocks, IV, mode, skey);
+   }
+#endif
+#ifdef LTC_AES_BITSLICE
+   if (skey->rijndael.has_bsK) {
+      return rijndael_bs_ctr_encrypt(pt, ct, blocks, IV, mode, skey);
+   }
+#endif
+   for (; blocks > 0; blocks--) {
+      if (mode == CTR_COUNTER_LITTLE_ENDIAN) {
+         for (x = 0; x < 16; x++) {
+            IV[x] = (IV[x] + (unsigned char)1) & (unsigned char)255;
+            if (IV[x] != (unsigned char)0) {
+               break;
+            }
+         }
+      } else {
+         for (x = 15; x >= 0; x--) {
+            IV[x] = (IV[x] + (unsigned char)1) & (unsigned char)255;
+            if (IV[x] != (unsigned char)0) {
+               break;
+            }
+         }
+      }
+      if ((err = rijndael_ecb_encrypt(IV, buf, skey)) != CRYPT_OK) {
+         return err;
+      }
+      for (x = 0; x < 16; x++) {
+         ct[x] = pt[x] ^ buf[x];
+      }
+      pt += 16;
+      ct += 16;
+   }
+#ifdef LTC_CLEAN_STACK
+   zeromem(buf, sizeof(buf));
+#endif
+   return CRYPT_OK;
+}
+
+#ifdef LTC_XTS_MODE
+
+/**
+  Encrypt blocks in XTS mode
+  @param pt     The plaintext
+  @param ct     [out] The ciphertext
+  @param blocks The number of 16 byte blocks to encrypt
+  @param tweak  [in/out] The tweak on input, the encrypted tweak of the next block on output
+  @param skey1  The key used to encrypt the data
+  @param skey2  The key used to encrypt the tweak
+  @return CRYPT_OK if successful
+*/
+int rijndael_accel_xts_encrypt(const unsigned char *pt, unsigned char *ct, unsigned long blocks, unsigned char *tweak,
+                               const symmetric_key *skey1, const symmetric_key *skey2)
+{
+   unsigned char T[16], buf[16];
+   int x, err;
+
+   LTC_ARGCHK(pt    != NULL);
+   LTC_ARGCHK(ct    != NULL);
+   LTC_ARGCHK(tweak != NULL);
+   LTC_ARGCHK(skey1 != NULL);
+   LTC_ARGCHK(skey2 != NULL);
+
+#ifdef LTC_AES_NI
+   if (aesni_is_supported()) {
+      return aesni_xts_encrypt(pt, ct, blocks, tweak, skey1, skey2);
+   }
+#endif
+
+   if ((err = rijndael_ecb_encrypt(tweak, T, skey2)) != CRYPT_OK) {
+      return err;
+   }
+   for (; blocks > 0; blocks--) {
+      for (x = 0; x < 16; x++) {
+         buf[x] = pt[x] ^ T[x];
+      }
+      if ((err = rijndael_ecb_encrypt(buf, ct, skey1)) != CRYPT_OK) {
+         return err;
+      }
+      for (x = 0; x < 16; x++) {
+         ct[x] ^= T[x];
+      }
+      xts_mult_x(T);
+      pt += 16;
+      ct += 16;
+   }
+   XMEMCPY(tweak, T, 16);
+#ifdef LTC_CLEAN_STACK
+   zeromem(buf, sizeof(buf));
+#endif
+   return CRYPT_OK;
+}
+
+/**
+  Decrypt blocks in XTS mode
+  @param ct     The ciphertext
+  @param pt     [out] The plaintext
+  @param blocks The number of 16 byte blocks to decrypt
+  @param tweak  [in/out] The tweak on input, the encrypted tweak of the next block on output
+  @param skey1  The key used to decrypt the data
+  @param skey2  The key used to encrypt the tweak
+  @return CRYPT_OK if successful
+*/
+int rijndael_accel_xts_decrypt(const unsigned char *ct, unsigned char *pt, unsigned long blocks, unsigned char *tweak,
+                               const symmetric_key *skey1, const symmetric_key *skey2)
+{
+   unsigned char T[16], buf[16];
+   int x, err;
+
+   LTC_ARGCHK(pt    != NULL);
+   LTC_ARGCHK(ct    != NULL);
+   LTC_ARGCHK(tweak != NULL);
+   LTC_ARGCHK(skey1 != NULL);
+   LTC_ARGCHK(skey2 != NULL);
+
+#ifdef LTC_AES_NI
+   if (aesni_is_supported()) {
+      return aesni_xts_decrypt(ct, pt, blocks, tweak, skey1, skey2);
+   }
+#endif
+
+   if ((err = rijndael_ecb_encrypt(tweak, T, skey2)) != CRYPT_OK) {
+      return err;
+   }
+   for (; blocks > 0; blocks--) {
+      for (x = 0; x < 16; x++) {
+         buf[x] = ct[x] ^ T[x];
+      }
+      if ((err = rijndael_ecb_decrypt(buf, pt, skey1)) != CRYPT_OK) {
+         return err;
+      }
+      for (x = 0; x < 16; x++) {
+         pt[x] ^= T[x];
+      }
+      xts_mult_x(T);
+      ct += 16;
+      pt += 16;
+   }
+   XMEMCPY(tweak, T, 16);
+#ifdef LTC_CLEAN_STACK
+   zeromem(buf, sizeof(buf));
+#endif
+   return CRYPT_OK;
+}
+
+#endif /* LTC_XTS_MODE */
+
+#ifdef LTC_GCM_AESNI
+
+/**
+  Process an entire AES-GCM packet in one call, see gcm_memory()
+  @return CRYPT_OK if successful, CRYPT_NOP if gcm_memory() has to use the generic code
+*/
+int rijndael_accel_gcm_memory(const unsigned char *key,    unsigned long keylen,
+                              const unsigned char *IV,     unsigned long IVlen,
+                              const unsigned char *adata,  unsigned long adatalen,
+                                    unsigned char *pt,     unsigned long ptlen,
+                                    unsigned char *ct,
+                                    unsigned char *tag,    unsigned long *taglen,
+                                              int direction)
+{
+   if (gcm_aesni_is_supported()) {
+      return gcm_aesni_memory(key, keylen, IV, IVlen, adata, adatalen, pt, ptlen, ct, tag, taglen, direction);
+   }
+   return CRYPT_NOP;
+}
+
+#endif /* LTC_GCM_AESNI */
+
+#endif
+
+/* ref:         $Format:%D$ */
+/* git commit:  $Format:%H$ */
+/* commit time: $Format:%ai$ */
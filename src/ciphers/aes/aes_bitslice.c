@@ -0,0 +1,603 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ */
+
+/**
+  @file aes_bitslice.c
+  Constant-time bitsliced AES (Rijndael) encryption
+
+  Four blocks are processed at once in eight 64-bit words, each word holding
+  one bit position of all 64 state bytes. The S-Box is computed with the
+  circuit of Boyar and Peralta, so there are no table lookups and no secret
+  dependent memory accesses at all.
+
+  On x86-64 the words are the two 64-bit lanes of SSE2 registers, which
+  doubles the number of blocks processed at once to eight.
+
+  The round keys are bitsliced once by rijndael_bs_setup() and kept in the
+  key.  A single block costs a pass over BS_BLOCKS blocks, so this is only
+  used for the multi-block functions, single blocks use the tables.
+*/
+
+#include "tomcrypt_private.h"
+
+#ifdef LTC_AES_BITSLICE
+
+#if defined(LTC_AMD64_SIMD)
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <emmintrin.h>
+#endif
+
+/* SSE2 is part of the x86-64 base instruction set, no need for a CPUID check */
+typedef __m128i bs_word;
+#define BS_LANES          2
+#define BS_XOR(a, b)      _mm_xor_si128(a, b)
+#define BS_AND(a, b)      _mm_and_si128(a, b)
+#define BS_OR(a, b)       _mm_or_si128(a, b)
+#define BS_XNOR(a, b)     _mm_xor_si128(_mm_xor_si128(a, b), _mm_set1_epi32(-1))
+#define BS_SHL(a, n)      _mm_slli_epi64(a, n)
+#define BS_SHR(a, n)      _mm_srli_epi64(a, n)
+#define BS_SET1(x)        _mm_set1_epi64x((long long)(x))
+#define BS_SET2(x1, x0)   _mm_set_epi64x((long long)(x1), (long long)(x0))
+#define BS_LANES_OUT(p, a) _mm_storeu_si128((__m128i *)(void *)(p), a)
+/* rotate each 64-bit lane right by 16 resp. 32 bits */
+#define BS_ROR16(a)       _mm_shufflehi_epi16(_mm_shufflelo_epi16(a, 0x39), 0x39)
+#define BS_ROR32(a)       _mm_shuffle_epi32(a, 0xB1)
+
+#else
+
+typedef ulong64 bs_word;
+#define BS_LANES          1
+#define BS_XOR(a, b)      ((a) ^ (b))
+#define BS_AND(a, b)      ((a) & (b))
+#define BS_OR(a, b)       ((a) | (b))
+#define BS_XNOR(a, b)     (~((a) ^ (b)))
+#define BS_SHL(a, n)      ((a) << (n))
+#define BS_SHR(a, n)      ((a) >> (n))
+#define BS_SET1(x)        (x)
+#define BS_LANES_OUT(p, a) (p)[0] = (a)
+#define BS_ROR16(a)       (((a) >> 16) | ((a) << 48))
+#define BS_ROR32(a)       (((a) >> 32) | ((a) << 32))
+
+#endif
+
+#define BS_CONST(x)       BS_SET1(CONST64(x))
+#define BS_BLOCKS         (4 * BS_LANES)
+
+/* the S-Box on the eight bit planes */
+static LTC_INLINE void bs_sbox(bs_word *q)
+{
+   bs_word x0, x1, x2, x3, x4, x5, x6, x7;
+   bs_word y1, y2, y3, y4, y5, y6, y7, y8, y9;
+   bs_word y10, y11, y12, y13, y14, y15, y16, y17, y18, y19;
+   bs_word y20, y21;
+   bs_word z0, z1, z2, z3, z4, z5, z6, z7, z8, z9;
+   bs_word z10, z11, z12, z13, z14, z15, z16, z17;
+   bs_word t0, t1, t2, t3, t4, t5, t6, t7, t8, t9;
+   bs_word t10, t11, t12, t13, t14, t15, t16, t17, t18, t19;
+   bs_word t20, t21, t22, t23, t24, t25, t26, t27, t28, t29;
+   bs_word t30, t31, t32, t33, t34, t35, t36, t37, t38, t39;
+   bs_word t40, t41, t42, t43, t44, t45, t46, t47, t48, t49;
+   bs_word t50, t51, t52, t53, t54, t55, t56, t57, t58, t59;
+   bs_word t60, t61, t62, t63, t64, t65, t66, t67;
+   bs_word s0, s1, s2, s3, s4, s5, s6, s7;
+
+   x0 = q[7];
+   x1 = q[6];
+   x2 = q[5];
+   x3 = q[4];
+   x4 = q[3];
+   x5 = q[2];
+   x6 = q[1];
+   x7 = q[0];
+
+   /* top linear transformation */
+   y14 = BS_XOR(x3, x5);
+   y13 = BS_XOR(x0, x6);
+   y9 = BS_XOR(x0, x3);
+   y8 = BS_XOR(x0, x5);
+   t0 = BS_XOR(x1, x2);
+   y1 = BS_XOR(t0, x7);
+   y4 = BS_XOR(y1, x3);
+   y12 = BS_XOR(y13, y14);
+   y2 = BS_XOR(y1, x0);
+   y5 = BS_XOR(y1, x6);
+   y3 = BS_XOR(y5, y8);
+   t1 = BS_XOR(x4, y12);
+   y15 = BS_XOR(t1, x5);
+   y20 = BS_XOR(t1, x1);
+   y6 = BS_XOR(y15, x7);
+   y10 = BS_XOR(y15, t0);
+   y11 = BS_XOR(y20, y9);
+   y7 = BS_XOR(x7, y11);
+   y17 = BS_XOR(y10, y11);
+   y19 = BS_XOR(y10, y8);
+   y16 = BS_XOR(t0, y11);
+   y21 = BS_XOR(y13, y16);
+   y18 = BS_XOR(x0, y16);
+
+   /* non-linear section */
+   t2 = BS_AND(y12, y15);
+   t3 = BS_AND(y3, y6);
+   t4 = BS_XOR(t3, t2);
+   t5 = BS_AND(y4, x7);
+   t6 = BS_XOR(t5, t2);
+   t7 = BS_AND(y13, y16);
+   t8 = BS_AND(y5, y1);
+   t9 = BS_XOR(t8, t7);
+   t10 = BS_AND(y2, y7);
+   t11 = BS_XOR(t10, t7);
+   t12 = BS_AND(y9, y11);
+   t13 = BS_AND(y14, y17);
+   t14 = BS_XOR(t13, t12);
+   t15 = BS_AND(y8, y10);
+   t16 = BS_XOR(t15, t12);
+   t17 = BS_XOR(t4, t14);
+   t18 = BS_XOR(t6, t16);
+   t19 = BS_XOR(t9, t14);
+   t20 = BS_XOR(t11, t16);
+   t21 = BS_XOR(t17, y20);
+   t22 = BS_XOR(t18, y19);
+   t23 = BS_XOR(t19, y21);
+   t24 = BS_XOR(t20, y18);
+
+   t25 = BS_XOR(t21, t22);
+   t26 = BS_AND(t21, t23);
+   t27 = BS_XOR(t24, t26);
+   t28 = BS_AND(t25, t27);
+   t29 = BS_XOR(t28, t22);
+   t30 = BS_XOR(t23, t24);
+   t31 = BS_XOR(t22, t26);
+   t32 = BS_AND(t31, t30);
+   t33 = BS_XOR(t32, t24);
+   t34 = BS_XOR(t23, t33);
+   t35 = BS_XOR(t27, t33);
+   t36 = BS_AND(t24, t35);
+   t37 = BS_XOR(t36, t34);
+   t38 = BS_XOR(t27, t36);
+   t39 = BS_AND(t29, t38);
+   t40 = BS_XOR(t25, t39);
+
+   t41 = BS_XOR(t40, t37);
+   t42 = BS_XOR(t29, t33);
+   t43 = BS_XOR(t29, t40);
+   t44 = BS_XOR(t33, t37);
+   t45 = BS_XOR(t42, t41);
+   z0 = BS_AND(t44, y15);
+   z1 = BS_AND(t37, y6);
+   z2 = BS_AND(t33, x7);
+   z3 = BS_AND(t43, y16);
+   z4 = BS_AND(t40, y1);
+   z5 = BS_AND(t29, y7);
+   z6 = BS_AND(t42, y11);
+   z7 = BS_AND(t45, y17);
+   z8 = BS_AND(t41, y10);
+   z9 = BS_AND(t44, y12);
+   z10 = BS_AND(t37, y3);
+   z11 = BS_AND(t33, y4);
+   z12 = BS_AND(t43, y13);
+   z13 = BS_AND(t40, y5);
+   z14 = BS_AND(t29, y2);
+   z15 = BS_AND(t42, y9);
+   z16 = BS_AND(t45, y14);
+   z17 = BS_AND(t41, y8);
+
+   /* bottom linear transformation */
+   t46 = BS_XOR(z15, z16);
+   t47 = BS_XOR(z10, z11);
+   t48 = BS_XOR(z5, z13);
+   t49 = BS_XOR(z9, z10);
+   t50 = BS_XOR(z2, z12);
+   t51 = BS_XOR(z2, z5);
+   t52 = BS_XOR(z7, z8);
+   t53 = BS_XOR(z0, z3);
+   t54 = BS_XOR(z6, z7);
+   t55 = BS_XOR(z16, z17);
+   t56 = BS_XOR(z12, t48);
+   t57 = BS_XOR(t50, t53);
+   t58 = BS_XOR(z4, t46);
+   t59 = BS_XOR(z3, t54);
+   t60 = BS_XOR(t46, t57);
+   t61 = BS_XOR(z14, t57);
+   t62 = BS_XOR(t52, t58);
+   t63 = BS_XOR(t49, t58);
+   t64 = BS_XOR(z4, t59);
+   t65 = BS_XOR(t61, t62);
+   t66 = BS_XOR(z1, t63);
+   s0 = BS_XOR(t59, t63);
+   s6 = BS_XNOR(t56, t62);
+   s7 = BS_XNOR(t48, t60);
+   t67 = BS_XOR(t64, t65);
+   s3 = BS_XOR(t53, t66);
+   s4 = BS_XOR(t51, t66);
+   s5 = BS_XOR(t47, t65);
+   s1 = BS_XNOR(t64, s3);
+   s2 = BS_XNOR(t55, t67);
+
+   q[7] = s0;
+   q[6] = s1;
+   q[5] = s2;
+   q[4] = s3;
+   q[3] = s4;
+   q[2] = s5;
+   q[1] = s6;
+   q[0] = s7;
+}
+
+/* transpose the bits of q[0..7] in 8x8 blocks, an involution */
+#define BS_SWAPN(cl, ch, s, x, y)                                              \
+   do {                                                                        \
+      bs_word a_ = (x), b_ = (y);                                              \
+      (x) = BS_OR(BS_AND(a_, BS_CONST(cl)), BS_SHL(BS_AND(b_, BS_CONST(cl)), s)); \
+      (y) = BS_OR(BS_SHR(BS_AND(a_, BS_CONST(ch)), s), BS_AND(b_, BS_CONST(ch))); \
+   } while (0)
+
+static LTC_INLINE void bs_ortho(bs_word *q)
+{
+   BS_SWAPN(0x5555555555555555, 0xAAAAAAAAAAAAAAAA, 1, q[0], q[1]);
+   BS_SWAPN(0x5555555555555555, 0xAAAAAAAAAAAAAAAA, 1, q[2], q[3]);
+   BS_SWAPN(0x5555555555555555, 0xAAAAAAAAAAAAAAAA, 1, q[4], q[5]);
+   BS_SWAPN(0x5555555555555555, 0xAAAAAAAAAAAAAAAA, 1, q[6], q[7]);
+
+   BS_SWAPN(0x3333333333333333, 0xCCCCCCCCCCCCCCCC, 2, q[0], q[2]);
+   BS_SWAPN(0x3333333333333333, 0xCCCCCCCCCCCCCCCC, 2, q[1], q[3]);
+   BS_SWAPN(0x3333333333333333, 0xCCCCCCCCCCCCCCCC, 2, q[4], q[6]);
+   BS_SWAPN(0x3333333333333333, 0xCCCCCCCCCCCCCCCC, 2, q[5], q[7]);
+
+   BS_SWAPN(0x0F0F0F0F0F0F0F0F, 0xF0F0F0F0F0F0F0F0, 4, q[0], q[4]);
+   BS_SWAPN(0x0F0F0F0F0F0F0F0F, 0xF0F0F0F0F0F0F0F0, 4, q[1], q[5]);
+   BS_SWAPN(0x0F0F0F0F0F0F0F0F, 0xF0F0F0F0F0F0F0F0, 4, q[2], q[6]);
+   BS_SWAPN(0x0F0F0F0F0F0F0F0F, 0xF0F0F0F0F0F0F0F0, 4, q[3], q[7]);
+}
+
+/* spread the four little-endian words of a block over two words, interleaving their bytes */
+static void bs_interleave_in(ulong64 *q0, ulong64 *q1, const ulong32 *w)
+{
+   ulong64 x0, x1, x2, x3;
+
+   x0 = w[0];
+   x1 = w[1];
+   x2 = w[2];
+   x3 = w[3];
+   x0 |= (x0 << 16);
+   x1 |= (x1 << 16);
+   x2 |= (x2 << 16);
+   x3 |= (x3 << 16);
+   x0 &= CONST64(0x0000FFFF0000FFFF);
+   x1 &= CONST64(0x0000FFFF0000FFFF);
+   x2 &= CONST64(0x0000FFFF0000FFFF);
+   x3 &= CONST64(0x0000FFFF0000FFFF);
+   x0 |= (x0 << 8);
+   x1 |= (x1 << 8);
+   x2 |= (x2 << 8);
+   x3 |= (x3 << 8);
+   x0 &= CONST64(0x00FF00FF00FF00FF);
+   x1 &= CONST64(0x00FF00FF00FF00FF);
+   x2 &= CONST64(0x00FF00FF00FF00FF);
+   x3 &= CONST64(0x00FF00FF00FF00FF);
+   *q0 = x0 | (x2 << 8);
+   *q1 = x1 | (x3 << 8);
+}
+
+/* the inverse of bs_interleave_in() */
+static void bs_interleave_out(ulong32 *w, ulong64 q0, ulong64 q1)
+{
+   ulong64 x0, x1, x2, x3;
+
+   x0 = q0 & CONST64(0x00FF00FF00FF00FF);
+   x1 = q1 & CONST64(0x00FF00FF00FF00FF);
+   x2 = (q0 >> 8) & CONST64(0x00FF00FF00FF00FF);
+   x3 = (q1 >> 8) & CONST64(0x00FF00FF00FF00FF);
+   x0 |= (x0 >> 8);
+   x1 |= (x1 >> 8);
+   x2 |= (x2 >> 8);
+   x3 |= (x3 >> 8);
+   x0 &= CONST64(0x0000FFFF0000FFFF);
+   x1 &= CONST64(0x0000FFFF0000FFFF);
+   x2 &= CONST64(0x0000FFFF0000FFFF);
+   x3 &= CONST64(0x0000FFFF0000FFFF);
+   w[0] = (ulong32)(x0 | (x0 >> 16)) & 0xFFFFFFFFUL;
+   w[1] = (ulong32)(x1 | (x1 >> 16)) & 0xFFFFFFFFUL;
+   w[2] = (ulong32)(x2 | (x2 >> 16)) & 0xFFFFFFFFUL;
+   w[3] = (ulong32)(x3 | (x3 >> 16)) & 0xFFFFFFFFUL;
+}
+
+static LTC_INLINE void bs_add_round_key(bs_word *q, const ulong64 *rk)
+{
+   int i;
+   for (i = 0; i < 8; i++) {
+      q[i] = BS_XOR(q[i], BS_SET1(rk[i]));
+   }
+}
+
+static LTC_INLINE void bs_shift_rows(bs_word *q)
+{
+   int i;
+   bs_word x;
+
+   for (i = 0; i < 8; i++) {
+      x = q[i];
+      q[i] = BS_OR(BS_OR(BS_OR(BS_AND(x, BS_CONST(0x000000000000FFFF)),
+                               BS_SHR(BS_AND(x, BS_CONST(0x00000000FFF00000)), 4)),
+                         BS_OR(BS_SHL(BS_AND(x, BS_CONST(0x00000000000F0000)), 12),
+                               BS_SHR(BS_AND(x, BS_CONST(0x0000FF0000000000)), 8))),
+                   BS_OR(BS_OR(BS_SHL(BS_AND(x, BS_CONST(0x000000FF00000000)), 8),
+                               BS_SHR(BS_AND(x, BS_CONST(0xF000000000000000)), 12)),
+                         BS_SHL(BS_AND(x, BS_CONST(0x0FFF000000000000)), 4)));
+   }
+}
+
+static LTC_INLINE void bs_mix_columns(bs_word *q)
+{
+   bs_word q0, q1, q2, q3, q4, q5, q6, q7;
+   bs_word r0, r1, r2, r3, r4, r5, r6, r7;
+
+   q0 = q[0];
+   q1 = q[1];
+   q2 = q[2];
+   q3 = q[3];
+   q4 = q[4];
+   q5 = q[5];
+   q6 = q[6];
+   q7 = q[7];
+   r0 = BS_ROR16(q0);
+   r1 = BS_ROR16(q1);
+   r2 = BS_ROR16(q2);
+   r3 = BS_ROR16(q3);
+   r4 = BS_ROR16(q4);
+   r5 = BS_ROR16(q5);
+   r6 = BS_ROR16(q6);
+   r7 = BS_ROR16(q7);
+
+   q[0] = BS_XOR(BS_XOR(q7, r7), BS_XOR(r0, BS_ROR32(BS_XOR(q0, r0))));
+   q[1] = BS_XOR(BS_XOR(BS_XOR(q0, r0), BS_XOR(q7, r7)), BS_XOR(r1, BS_ROR32(BS_XOR(q1, r1))));
+   q[2] = BS_XOR(BS_XOR(q1, r1), BS_XOR(r2, BS_ROR32(BS_XOR(q2, r2))));
+   q[3] = BS_XOR(BS_XOR(BS_XOR(q2, r2), BS_XOR(q7, r7)), BS_XOR(r3, BS_ROR32(BS_XOR(q3, r3))));
+   q[4] = BS_XOR(BS_XOR(BS_XOR(q3, r3), BS_XOR(q7, r7)), BS_XOR(r4, BS_ROR32(BS_XOR(q4, r4))));
+   q[5] = BS_XOR(BS_XOR(q4, r4), BS_XOR(r5, BS_ROR32(BS_XOR(q5, r5))));
+   q[6] = BS_XOR(BS_XOR(q5, r5), BS_XOR(r6, BS_ROR32(BS_XOR(q6, r6))));
+   q[7] = BS_XOR(BS_XOR(q6, r6), BS_XOR(r7, BS_ROR32(BS_XOR(q7, r7))));
+}
+
+/* bitslice BS_BLOCKS blocks */
+static void bs_load(bs_word *q, const unsigned char *blk)
+{
+   ulong64 t[BS_LANES][8];
+   ulong32 w[16];
+   int i, l;
+
+   for (l = 0; l < BS_LANES; l++) {
+      for (i = 0; i < 16; i++) {
+         LOAD32L(w[i], blk + 64 * l + 4 * i);
+      }
+      for (i = 0; i < 4; i++) {
+         bs_interleave_in(&t[l][i], &t[l][i + 4], w + 4 * i);
+      }
+   }
+   for (i = 0; i < 8; i++) {
+#if BS_LANES == 2
+      q[i] = BS_SET2(t[1][i], t[0][i]);
+#else
+      q[i] = t[0][i];
+#endif
+   }
+   bs_ortho(q);
+#ifdef LTC_CLEAN_STACK
+   zeromem(t, sizeof(t));
+   zeromem(w, sizeof(w));
+#endif
+}
+
+/* the inverse of bs_load(), q is destroyed */
+static void bs_store(unsigned char *blk, bs_word *q)
+{
+   ulong64 t[BS_LANES][8];
+   ulong32 w[16];
+   int i, l;
+
+   bs_ortho(q);
+   for (i = 0; i < 8; i++) {
+#if BS_LANES == 2
+      _mm_storeu_si128((__m128i *)(void *)w, q[i]);
+      LOAD64L(t[0][i], (unsigned char *)w);
+      LOAD64L(t[1][i], (unsigned char *)w + 8);
+#else
+      t[0][i] = q[i];
+#endif
+   }
+   for (l = 0; l < BS_LANES; l++) {
+      for (i = 0; i < 4; i++) {
+         bs_interleave_out(w + 4 * i, t[l][i], t[l][i + 4]);
+      }
+      for (i = 0; i < 16; i++) {
+         STORE32L(w[i], blk + 64 * l + 4 * i);
+      }
+   }
+#ifdef LTC_CLEAN_STACK
+   zeromem(t, sizeof(t));
+   zeromem(w, sizeof(w));
+#endif
+}
+
+/* encrypt BS_BLOCKS blocks in place */
+static void bs_encrypt(unsigned char *blk, const ulong64 *rk, int Nr)
+{
+   bs_word q[8];
+   int i;
+
+   bs_load(q, blk);
+   bs_add_round_key(q, rk);
+   for (i = 1; i < Nr; i++) {
+      bs_sbox(q);
+      bs_shift_rows(q);
+      bs_mix_columns(q);
+      bs_add_round_key(q, rk + 8 * i);
+   }
+   bs_sbox(q);
+   bs_shift_rows(q);
+   bs_add_round_key(q, rk + 8 * Nr);
+   bs_store(blk, q);
+#ifdef LTC_CLEAN_STACK
+   zeromem(q, sizeof(q));
+#endif
+}
+
+/**
+  Bitslice the round keys of a scheduled key into skey->rijndael.bsK
+  @param skey   [in/out] The key as scheduled, eK and Nr already set
+*/
+void rijndael_bs_setup(symmetric_key *skey)
+{
+   bs_word sk[8];
+   ulong64 t[BS_LANES][8], p[BS_LANES];
+   ulong32 w[4];
+   int i, j, l, r, Nr;
+
+   Nr = skey->rijndael.Nr;
+   /* a round key per lane */
+   for (i = 0; i <= Nr; i += BS_LANES) {
+      for (l = 0; l < BS_LANES; l++) {
+         r = i + l <= Nr ? i + l : Nr;
+         for (j = 0; j < 4; j++) {
+            /* the key schedule holds big-endian words */
+            w[j] = skey->rijndael.eK[4 * r + j];
+            w[j] = BSWAP(w[j]);
+         }
+         bs_interleave_in(&t[l][0], &t[l][4], w);
+      }
+      for (j = 0; j < 8; j++) {
+#if BS_LANES == 2
+         sk[j] = BS_SET2(t[1][j & 4], t[0][j & 4]);
+#else
+         sk[j] = t[0][j & 4];
+#endif
+      }
+      bs_ortho(sk);
+      for (j = 0; j < 8; j++) {
+         BS_LANES_OUT(p, sk[j]);
+         for (l = 0; l < BS_LANES && i + l <= Nr; l++) {
+            skey->rijndael.bsK[8 * (i + l) + j] = p[l];
+         }
+      }
+   }
+#ifdef LTC_CLEAN_STACK
+   zeromem(sk, sizeof(sk));
+   zeromem(t, sizeof(t));
+   zeromem(p, sizeof(p));
+   zeromem(w, sizeof(w));
+#endif
+   skey->rijndael.has_bsK = 1;
+}
+
+/**
+  Encrypt blocks in ECB mode with the bitsliced implementation
+  @param pt     The plaintext
+  @param ct     [out] The ciphertext
+  @param blocks The number of 16 byte blocks to encrypt
+  @param skey   The key as scheduled
+  @return CRYPT_OK if successful
+*/
+int rijndael_bs_ecb_encrypt(const unsigned char *pt, unsigned char *ct, unsigned long blocks, const symmetric_key *skey)
+{
+   unsigned char buf[16 * BS_BLOCKS];
+   unsigned long n;
+
+   LTC_ARGCHK(pt   != NULL);
+   LTC_ARGCHK(ct   != NULL);
+   LTC_ARGCHK(skey != NULL);
+
+   if (skey->rijndael.Nr != 10 && skey->rijndael.Nr != 12 && skey->rijndael.Nr != 14) {
+      return CRYPT_INVALID_ROUNDS;
+   }
+
+   while (blocks > 0) {
+      n = blocks < BS_BLOCKS ? blocks : BS_BLOCKS;
+      XMEMCPY(buf, pt, 16 * n);
+      bs_encrypt(buf, skey->rijndael.bsK, skey->rijndael.Nr);
+      XMEMCPY(ct, buf, 16 * n);
+      pt += 16 * n;
+      ct += 16 * n;
+      blocks -= n;
+   }
+
+#ifdef LTC_CLEAN_STACK
+   zeromem(buf, sizeof(buf));
+#endif
+   return CRYPT_OK;
+}
+
+/**
+  Encrypt blocks in CTR mode with the bitsliced implementation
+
+  The counter is incremented before each block, over the full block width.
+  @param pt     The plaintext
+  @param ct     [out] The ciphertext
+  @param blocks The number of 16 byte blocks to encrypt
+  @param IV     [in/out] The counter, the last counter used on output
+  @param mode   CTR_COUNTER_LITTLE_ENDIAN or CTR_COUNTER_BIG_ENDIAN
+  @param skey   The key as scheduled
+  @return CRYPT_OK if successful
+*/
+int rijndael_bs_ctr_encrypt(const unsigned char *pt, unsigned char *ct, unsigned long blocks, unsigned char *IV, int mode, const symmetric_key *skey)
+{
+   unsigned char buf[16 * BS_BLOCKS];
+   unsigned long n, i;
+   int x;
+
+   LTC_ARGCHK(pt   != NULL);
+   LTC_ARGCHK(ct   != NULL);
+   LTC_ARGCHK(IV   != NULL);
+   LTC_ARGCHK(skey != NULL);
+
+   if (skey->rijndael.Nr != 10 && skey->rijndael.Nr != 12 && skey->rijndael.Nr != 14) {
+      return CRYPT_INVALID_ROUNDS;
+   }
+
+   while (blocks > 0) {
+      n = blocks < BS_BLOCKS ? blocks : BS_BLOCKS;
+      for (i = 0; i < n; i++) {
+         if (mode == CTR_COUNTER_LITTLE_ENDIAN) {
+            for (x = 0; x < 16; x++) {
+               IV[x] = (IV[x] + (unsigned char)1) & (unsigned char)255;
+               if (IV[x] != (unsigned char)0) {
+                  break;
+               }
+            }
+         } else {
+            for (x = 15; x >= 0; x--) {
+               IV[x] = (IV[x] + (unsigned char)1) & (unsigned char)255;
+               if (IV[x] != (unsigned char)0) {
+                  break;
+               }
+            }
+         }
+         XMEMCPY(buf + 16 * i, IV, 16);
+      }
+      bs_encrypt(buf, skey->rijndael.bsK, skey->rijndael.Nr);
+      for (i = 0; i < 16 * n; i++) {
+         ct[i] = pt[i] ^ buf[i];
+      }
+      pt += 16 * n;
+      ct += 16 * n;
+      blocks -= n;
+   }
+
+#ifdef LTC_CLEAN_STACK
+   zeromem(buf, sizeof(buf));
+#endif
+   return CRYPT_OK;
+}
+
+#endif /* LTC_AES_BITSLICE */
+
+/* ref:         $Format:%D$ */
+/* git commit:  $Format:%H$ */
+/* commit time: $Format:%ai$ */
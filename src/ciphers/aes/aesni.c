@@ -0,0 +1,716 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ */
+
+/**
+  @file aesni.c
+  AES (Rijndael) using the AES-NI instructions of x86-64 CPUs
+
+  The key schedule is stored in the same format as the one of the table based
+  implementation in aes.c (big-endian words, "equivalent inverse cipher" for
+  the decryption key), so a key scheduled by either code path can be used by
+  both of them. The round keys are byte swapped when they're loaded into the
+  XMM registers.
+
+  The multi-block functions process eight blocks in parallel wherever the mode
+  allows it, which hides the latency of the AESENC/AESDEC instructions.
+*/
+
+#include "tomcrypt_private.h"
+
+#ifdef LTC_AES_NI
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <wmmintrin.h>
+#include <tmmintrin.h>
+#endif
+
+#define AESNI_TARGET LTC_ATTRIBUTE_TARGET("aes,ssse3")
+
+#define AESNI_LOAD(p)      _mm_loadu_si128((const __m128i *)(const void *)(p))
+#define AESNI_STORE(p, v)  _mm_storeu_si128((__m128i *)(void *)(p), (v))
+
+static const ulong32 rcon[] = {
+    0x01000000UL, 0x02000000UL, 0x04000000UL, 0x08000000UL,
+    0x10000000UL, 0x20000000UL, 0x40000000UL, 0x80000000UL,
+    0x1B000000UL, 0x36000000UL
+};
+
+/**
+  Check whether the CPU supports the AES-NI code path
+  @return 1 if supported, 0 otherwise
+*/
+int aesni_is_supported(void)
+{
+   return ltc_cpu_has(LTC_CPU_AESNI | LTC_CPU_SSSE3);
+}
+
+/* SubWord() of the key schedule, AESKEYGENASSIST applies the S-Box to dword 1 and 3 */
+AESNI_TARGET
+static ulong32 aesni_subword(ulong32 w)
+{
+   int r;
+   r = _mm_cvtsi128_si32(_mm_aeskeygenassist_si128(_mm_set1_epi32((int)w), 0));
+   return (ulong32)r;
+}
+
+/* convert between the big-endian words of the key schedule and the AES state byte order */
+AESNI_TARGET
+static LTC_INLINE __m128i aesni_bswap32(__m128i x)
+{
+   return _mm_shuffle_epi8(x, _mm_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12));
+}
+
+AESNI_TARGET
+static int aesni_load_keys(const ulong32 *rk, int Nr, __m128i *K)
+{
+   int i;
+
+   if (Nr != 10 && Nr != 12 && Nr != 14) {
+      return CRYPT_INVALID_ROUNDS;
+   }
+   for (i = 0; i <= Nr; i++) {
+      K[i] = aesni_bswap32(AESNI_LOAD(rk + 4 * i));
+   }
+   return CRYPT_OK;
+}
+
+AESNI_TARGET
+static LTC_INLINE __m128i aesni_enc1(__m128i b, const __m128i *K, int Nr)
+{
+   int r;
+   b = _mm_xor_si128(b, K[0]);
+   for (r = 1; r < Nr; r++) {
+      b = _mm_aesenc_si128(b, K[r]);
+   }
+   return _mm_aesenclast_si128(b, K[Nr]);
+}
+
+AESNI_TARGET
+static LTC_INLINE __m128i aesni_dec1(__m128i b, const __m128i *K, int Nr)
+{
+   int r;
+   b = _mm_xor_si128(b, K[0]);
+   for (r = 1; r < Nr; r++) {
+      b = _mm_aesdec_si128(b, K[r]);
+   }
+   return _mm_aesdeclast_si128(b, K[Nr]);
+}
+
+AESNI_TARGET
+static LTC_INLINE void aesni_enc8(__m128i *b, const __m128i *K, int Nr)
+{
+   int r, i;
+   for (i = 0; i < 8; i++) {
+      b[i] = _mm_xor_si128(b[i], K[0]);
+   }
+   for (r = 1; r < Nr; r++) {
+      for (i = 0; i < 8; i++) {
+         b[i] = _mm_aesenc_si128(b[i], K[r]);
+      }
+   }
+   for (i = 0; i < 8; i++) {
+      b[i] = _mm_aesenclast_si128(b[i], K[Nr]);
+   }
+}
+
+AESNI_TARGET
+static LTC_INLINE void aesni_dec8(__m128i *b, const __m128i *K, int Nr)
+{
+   int r, i;
+   for (i = 0; i < 8; i++) {
+      b[i] = _mm_xor_si128(b[i], K[0]);
+   }
+   for (r = 1; r < Nr; r++) {
+      for (i = 0; i < 8; i++) {
+         b[i] = _mm_aesdec_si128(b[i], K[r]);
+      }
+   }
+   for (i = 0; i < 8; i++) {
+      b[i] = _mm_aesdeclast_si128(b[i], K[Nr]);
+   }
+}
+
+/* multiply the XTS tweak by x in GF(2^128), same as xts_mult_x() */
+AESNI_TARGET
+static LTC_INLINE __m128i aesni_xts_mult_x(__m128i t)
+{
+   __m128i m;
+   m = _mm_srai_epi32(t, 31);
+   m = _mm_shuffle_epi32(m, 0x93);
+   m = _mm_and_si128(m, _mm_set_epi32(1, 1, 1, 0x87));
+   return _mm_xor_si128(_mm_slli_epi32(t, 1), m);
+}
+
+/**
+  Initialize the AES (Rijndael) block cipher using AES-NI
+  @param key The symmetric key you wish to pass
+  @param keylen The key length in bytes
+  @param num_rounds The number of rounds desired (0 for default)
+  @param skey The key in as scheduled by this function.
+  @return CRYPT_OK if successful
+*/
+AESNI_TARGET
+int aesni_setup(const unsigned char *key, int keylen, int num_rounds, symmetric_key *skey)
+{
+   int i, Nk, Nr;
+   ulong32 temp, *rk, *rrk;
+
+   LTC_ARGCHK(key  != NULL);
+   LTC_ARGCHK(skey != NULL);
+
+   if (keylen != 16 && keylen != 24 && keylen != 32) {
+      return CRYPT_INVALID_KEYSIZE;
+   }
+
+   if (num_rounds != 0 && num_rounds != (10 + ((keylen/8)-2)*2)) {
+      return CRYPT_INVALID_ROUNDS;
+   }
+
+   Nk = keylen / 4;
+   Nr = Nk + 6;
+   skey->rijndael.Nr = Nr;
+
+   /* setup the forward key */
+   rk = skey->rijndael.eK;
+   for (i = 0; i < Nk; i++) {
+      LOAD32H(rk[i], key + 4 * i);
+   }
+   for (i = Nk; i < 4 * (Nr + 1); i++) {
+      temp = rk[i - 1];
+      if ((i % Nk) == 0) {
+         temp = aesni_subword(ROLc(temp, 8)) ^ rcon[i / Nk - 1];
+      } else if (Nk == 8 && (i % Nk) == 4) {
+         temp = aesni_subword(temp);
+      }
+      rk[i] = rk[i - Nk] ^ temp;
+   }
+
+   /* setup the inverse key, InvMixColumns of the inner round keys in reverse order */
+   rk  = skey->rijndael.dK;
+   rrk = skey->rijndael.eK + 4 * Nr;
+   AESNI_STORE(rk, AESNI_LOAD(rrk));
+   for (i = 1; i < Nr; i++) {
+      rk  += 4;
+      rrk -= 4;
+      AESNI_STORE(rk, aesni_bswap32(_mm_aesimc_si128(aesni_bswap32(AESNI_LOAD(rrk)))));
+   }
+   rk  += 4;
+   rrk -= 4;
+   AESNI_STORE(rk, AESNI_LOAD(rrk));
+
+   return CRYPT_OK;
+}
+
+/**
+  Encrypt blocks with AES-NI in ECB mode
+  @param pt     The plaintext
+  @param ct     [out] The ciphertext
+  @param blocks The number of 16 byte blocks to encrypt
+  @param skey   The key as scheduled
+  @return CRYPT_OK if successful
+*/
+AESNI_TARGET
+int aesni_ecb_encrypt(const unsigned char *pt, unsigned char *ct, unsigned long blocks, const symmetric_key *skey)
+{
+   __m128i K[15], b[8];
+   int Nr, i, err;
+
+   LTC_ARGCHK(pt   != NULL);
+   LTC_ARGCHK(ct   != NULL);
+   LTC_ARGCHK(skey != NULL);
+
+   Nr = skey->rijndael.Nr;
+   if ((err = aesni_load_keys(skey->rijndael.eK, Nr, K)) != CRYPT_OK) {
+      return err;
+   }
+
+   for (; blocks >= 8; blocks -= 8) {
+      for (i = 0; i < 8; i++) {
+         b[i] = AESNI_LOAD(pt + 16 * i);
+      }
+      aesni_enc8(b, K, Nr);
+      for (i = 0; i < 8; i++) {
+         AESNI_STORE(ct + 16 * i, b[i]);
+      }
+      pt += 128;
+      ct += 128;
+   }
+   for (; blocks > 0; blocks--) {
+      AESNI_STORE(ct, aesni_enc1(AESNI_LOAD(pt), K, Nr));
+      pt += 16;
+      ct += 16;
+   }
+
+#ifdef LTC_CLEAN_STACK
+   zeromem(K, sizeof(K));
+#endif
+   return CRYPT_OK;
+}
+
+/**
+  Decrypt blocks with AES-NI in ECB mode
+  @param ct     The ciphertext
+  @param pt     [out] The plaintext
+  @param blocks The number of 16 byte blocks to decrypt
+  @param skey   The key as scheduled
+  @return CRYPT_OK if successful
+*/
+AESNI_TARGET
+int aesni_ecb_decrypt(const unsigned char *ct, unsigned char *pt, unsigned long blocks, const symmetric_key *skey)
+{
+   __m128i K[15], b[8];
+   int Nr, i, err;
+
+   LTC_ARGCHK(pt   != NULL);
+   LTC_ARGCHK(ct   != NULL);
+   LTC_ARGCHK(skey != NULL);
+
+   Nr = skey->rijndael.Nr;
+   if ((err = aesni_load_keys(skey->rijndael.dK, Nr, K)) != CRYPT_OK) {
+      return err;
+   }
+
+   for (; blocks >= 8; blocks -= 8) {
+      for (i = 0; i < 8; i++) {
+         b[i] = AESNI_LOAD(ct + 16 * i);
+      }
+      aesni_dec8(b, K, Nr);
+      for (i = 0; i < 8; i++) {
+         AESNI_STORE(pt + 16 * i, b[i]);
+      }
+      ct += 128;
+      pt += 128;
+   }
+   for (; blocks > 0; blocks--) {
+      AESNI_STORE(pt, aesni_dec1(AESNI_LOAD(ct), K, Nr));
+      ct += 16;
+      pt += 16;
+   }
+
+#ifdef LTC_CLEAN_STACK
+   zeromem(K, sizeof(K));
+#endif
+   return CRYPT_OK;
+}
+
+/**
+  Encrypt blocks with AES-NI in CBC mode
+  @param pt     The plaintext
+  @param ct     [out] The ciphertext
+  @param blocks The number of 16 byte blocks to encrypt
+  @param IV     [in/out] The chaining value
+  @param skey   The key as scheduled
+  @return CRYPT_OK if successful
+*/
+AESNI_TARGET
+int aesni_cbc_encrypt(const unsigned char *pt, unsigned char *ct, unsigned long blocks, unsigned char *IV, const symmetric_key *skey)
+{
+   __m128i K[15], iv;
+   int Nr, err;
+
+   LTC_ARGCHK(pt   != NULL);
+   LTC_ARGCHK(ct   != NULL);
+   LTC_ARGCHK(IV   != NULL);
+   LTC_ARGCHK(skey != NULL);
+
+   Nr = skey->rijndael.Nr;
+   if ((err = aesni_load_keys(skey->rijndael.eK, Nr, K)) != CRYPT_OK) {
+      return err;
+   }
+
+   /* CBC encryption is inherently serial */
+   iv = AESNI_LOAD(IV);
+   for (; blocks > 0; blocks--) {
+      iv = aesni_enc1(_mm_xor_si128(AESNI_LOAD(pt), iv), K, Nr);
+      AESNI_STORE(ct, iv);
+      pt += 16;
+      ct += 16;
+   }
+   AESNI_STORE(IV, iv);
+
+#ifdef LTC_CLEAN_STACK
+   zeromem(K, sizeof(K));
+#endif
+   return CRYPT_OK;
+}
+
+/**
+  Decrypt blocks with AES-NI in CBC mode
+  @param ct     The ciphertext
+  @param pt     [out] The plaintext, may be the same buffer as ct
+  @param blocks The number of 16 byte blocks to decrypt
+  @param IV     [in/out] The chaining value
+  @param skey   The key as scheduled
+  @return CRYPT_OK if successful
+*/
+AESNI_TARGET
+int aesni_cbc_decrypt(const unsigned char *ct, unsigned char *pt, unsigned long blocks, unsigned char *IV, const symmetric_key *skey)
+{
+   __m128i K[15], b[8], c[8], iv;
+   int Nr, i, err;
+
+   LTC_ARGCHK(pt   != NULL);
+   LTC_ARGCHK(ct   != NULL);
+   LTC_ARGCHK(IV   != NULL);
+   LTC_ARGCHK(skey != NULL);
+
+   Nr = skey->rijndael.Nr;
+   if ((err = aesni_load_keys(skey->rijndael.dK, Nr, K)) != CRYPT_OK) {
+      return err;
+   }
+
+   iv = AESNI_LOAD(IV);
+   for (; blocks >= 8; blocks -= 8) {
+      for (i = 0; i < 8; i++) {
+         c[i] = b[i] = AESNI_LOAD(ct + 16 * i);
+      }
+      aesni_dec8(b, K, Nr);
+      AESNI_STORE(pt, _mm_xor_si128(b[0], iv));
+      for (i = 1; i < 8; i++) {
+         AESNI_STORE(pt + 16 * i, _mm_xor_si128(b[i], c[i - 1]));
+      }
+      iv = c[7];
+      ct += 128;
+      pt += 128;
+   }
+   for (; blocks > 0; blocks--) {
+      c[0] = AESNI_LOAD(ct);
+      AESNI_STORE(pt, _mm_xor_si128(aesni_dec1(c[0], K, Nr), iv));
+      iv = c[0];
+      ct += 16;
+      pt += 16;
+   }
+   AESNI_STORE(IV, iv);
+
+#ifdef LTC_CLEAN_STACK
+   zeromem(K, sizeof(K));
+#endif
+   return CRYPT_OK;
+}
+
+/**
+  Encrypt blocks with AES-NI in CTR mode
+
+  The counter is incremented before each block, over the full block width.
+  @param pt     The plaintext
+  @param ct     [out] The ciphertext
+  @param blocks The number of 16 byte blocks to encrypt
+  @param IV     [in/out] The counter, the last counter used on output
+  @param mode   CTR_COUNTER_LITTLE_ENDIAN or CTR_COUNTER_BIG_ENDIAN
+  @param skey   The key as scheduled
+  @return CRYPT_OK if successful
+*/
+AESNI_TARGET
+int aesni_ctr_encrypt(const unsigned char *pt, unsigned char *ct, unsigned long blocks, unsigned char *IV, int mode, const symmetric_key *skey)
+{
+   __m128i K[15], b[8], bswap128;
+   ulong64 lo, hi;
+   unsigned long n;
+   int Nr, i, err;
+
+   LTC_ARGCHK(pt   != NULL);
+   LTC_ARGCHK(ct   != NULL);
+   LTC_ARGCHK(IV   != NULL);
+   LTC_ARGCHK(skey != NULL);
+
+   Nr = skey->rijndael.Nr;
+   if ((err = aesni_load_keys(skey->rijndael.eK, Nr, K)) != CRYPT_OK) {
+      return err;
+   }
+
+   /* keep the counter as two 64-bit halves and build the blocks from them */
+   if (mode == CTR_COUNTER_LITTLE_ENDIAN) {
+      LOAD64L(lo, IV);
+      LOAD64L(hi, IV + 8);
+   } else {
+      LOAD64H(hi, IV);
+      LOAD64H(lo, IV + 8);
+   }
+   bswap128 = _mm_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+
+   while (blocks > 0) {
+      n = blocks < 8 ? blocks : 8;
+      for (i = 0; i < (int)n; i++) {
+         if (++lo == 0) {
+            ++hi;
+         }
+         b[i] = _mm_set_epi64x((long long)hi, (long long)lo);
+         if (mode != CTR_COUNTER_LITTLE_ENDIAN) {
+            b[i] = _mm_shuffle_epi8(b[i], bswap128);
+         }
+      }
+      if (n == 8) {
+         aesni_enc8(b, K, Nr);
+      } else {
+         for (i = 0; i < (int)n; i++) {
+            b[i] = aesni_enc1(b[i], K, Nr);
+         }
+      }
+      for (i = 0; i < (int)n; i++) {
+         AESNI_STORE(ct + 16 * i, _mm_xor_si128(b[i], AESNI_LOAD(pt + 16 * i)));
+      }
+      pt += 16 * n;
+      ct += 16 * n;
+      blocks -= n;
+   }
+
+   if (mode == CTR_COUNTER_LITTLE_ENDIAN) {
+      STORE64L(lo, IV);
+      STORE64L(hi, IV + 8);
+   } else {
+      STORE64H(hi, IV);
+      STORE64H(lo, IV + 8);
+   }
+
+#ifdef LTC_CLEAN_STACK
+   zeromem(K, sizeof(K));
+   zeromem(b, sizeof(b));
+#endif
+   return CRYPT_OK;
+}
+
+/**
+  Encrypt blocks with AES-NI in XTS mode
+  @param pt     The plaintext
+  @param ct     [out] The ciphertext
+  @param blocks The number of 16 byte blocks to encrypt
+  @param tweak  [in/out] The tweak on input, the encrypted tweak of the next block on output
+  @param skey1  The key used to encrypt the data
+  @param skey2  The key used to encrypt the tweak
+  @return CRYPT_OK if successful
+*/
+AESNI_TARGET
+int aesni_xts_encrypt(const unsigned char *pt, unsigned char *ct, unsigned long blocks, unsigned char *tweak,
+                      const symmetric_key *skey1, const symmetric_key *skey2)
+{
+   __m128i K[15], b[8], t[8], T;
+   int Nr, i, err;
+
+   LTC_ARGCHK(pt    != NULL);
+   LTC_ARGCHK(ct    != NULL);
+   LTC_ARGCHK(tweak != NULL);
+   LTC_ARGCHK(skey1 != NULL);
+   LTC_ARGCHK(skey2 != NULL);
+
+   Nr = skey2->rijndael.Nr;
+   if ((err = aesni_load_keys(skey2->rijndael.eK, Nr, K)) != CRYPT_OK) {
+      return err;
+   }
+   T = aesni_enc1(AESNI_LOAD(tweak), K, Nr);
+
+   Nr = skey1->rijndael.Nr;
+   if ((err = aesni_load_keys(skey1->rijndael.eK, Nr, K)) != CRYPT_OK) {
+      return err;
+   }
+
+   for (; blocks >= 8; blocks -= 8) {
+      for (i = 0; i < 8; i++) {
+         t[i] = T;
+         T = aesni_xts_mult_x(T);
+         b[i] = _mm_xor_si128(AESNI_LOAD(pt + 16 * i), t[i]);
+      }
+      aesni_enc8(b, K, Nr);
+      for (i = 0; i < 8; i++) {
+         AESNI_STORE(ct + 16 * i, _mm_xor_si128(b[i], t[i]));
+      }
+      pt += 128;
+      ct += 128;
+   }
+   for (; blocks > 0; blocks--) {
+      b[0] = aesni_enc1(_mm_xor_si128(AESNI_LOAD(pt), T), K, Nr);
+      AESNI_STORE(ct, _mm_xor_si128(b[0], T));
+      T = aesni_xts_mult_x(T);
+      pt += 16;
+      ct += 16;
+   }
+   AESNI_STORE(tweak, T);
+
+#ifdef LTC_CLEAN_STACK
+   zeromem(K, sizeof(K));
+#endif
+   return CRYPT_OK;
+}
+
+/**
+  Decrypt blocks with AES-NI in XTS mode
+  @param ct     The ciphertext
+  @param pt     [out] The plaintext
+  @param blocks The number of 16 byte blocks to decrypt
+  @param tweak  [in/out] The tweak on input, the encrypted tweak of the next block on output
+  @param skey1  The key used to decrypt the data
+  @param skey2  The key used to encrypt the tweak
+  @return CRYPT_OK if successful
+*/
+AESNI_TARGET
+int aesni_xts_decrypt(const unsigned char *ct, unsigned char *pt, unsigned long blocks, unsigned char *tweak,
+                      const symmetric_key *skey1, const symmetric_key *skey2)
+{
+   __m128i K[15], b[8], t[8], T;
+   int Nr, i, err;
+
+   LTC_ARGCHK(pt    != NULL);
+   LTC_ARGCHK(ct    != NULL);
+   LTC_ARGCHK(tweak != NULL);
+   LTC_ARGCHK(skey1 != NULL);
+   LTC_ARGCHK(skey2 != NULL);
+
+   Nr = skey2->rijndael.Nr;
+   if ((err = aesni_load_keys(skey2->rijndael.eK, Nr, K)) != CRYPT_OK) {
+      return err;
+   }
+   T = aesni_enc1(AESNI_LOAD(tweak), K, Nr);
+
+   Nr = skey1->rijndael.Nr;
+   if ((err = aesni_load_keys(skey1->rijndael.dK, Nr, K)) != CRYPT_OK) {
+      return err;
+   }
+
+   for (; blocks >= 8; blocks -= 8) {
+      for (i = 0; i < 8; i++) {
+         t[i] = T;
+         T = aesni_xts_mult_x(T);
+         b[i] = _mm_xor_si128(AESNI_LOAD(ct + 16 * i), t[i]);
+      }
+      aesni_dec8(b, K, Nr);
+      for (i = 0; i < 8; i++) {
+         AESNI_STORE(pt + 16 * i, _mm_xor_si128(b[i], t[i]));
+      }
+      ct += 128;
+      pt += 128;
+   }
+   for (; blocks > 0; blocks--) {
+      b[0] = aesni_dec1(_mm_xor_si128(AESNI_LOAD(ct), T), K, Nr);
+      AESNI_STORE(pt, _mm_xor_si128(b[0], T));
+      T = aesni_xts_mult_x(T);
+      ct += 16;
+      pt += 16;
+   }
+   AESNI_STORE(tweak, T);
+
+#ifdef LTC_CLEAN_STACK
+   zeromem(K, sizeof(K));
+#endif
+   return CRYPT_OK;
+}
+
+/* the blocks are encrypted/decrypted under their own keys, blocks which use the same key
+   as their neighbours are the common case and don't need to reload the round keys */
+AESNI_TARGET
+static LTC_INLINE int aesni_ecb_multi(const unsigned char *in, unsigned char *out, unsigned long blocks,
+                                      const symmetric_key * const *skey, int decrypt)
+{
+   __m128i K[15], b[8], k;
+   const symmetric_key *cur = NULL;
+   const ulong32 *rk[8];
+   int Nr[8], maxNr, r, i, n, err;
+
+   for (; blocks > 0; blocks -= n) {
+      n = (blocks < 8) ? (int)blocks : 8;
+      for (i = 1; i < n && skey[i] == skey[0]; i++);
+      if (i == n) {
+         /* all of them use the same key */
+         if (skey[0] != cur) {
+            cur = skey[0];
+            if ((err = aesni_load_keys(decrypt ? cur->rijndael.dK : cur->rijndael.eK, cur->rijndael.Nr, K)) != CRYPT_OK) {
+               return err;
+            }
+         }
+         for (i = 0; i < n; i++) {
+            b[i] = AESNI_LOAD(in + 16 * i);
+         }
+         if (n == 8 && decrypt) {
+            aesni_dec8(b, K, cur->rijndael.Nr);
+         } else if (n == 8) {
+            aesni_enc8(b, K, cur->rijndael.Nr);
+         } else {
+            for (i = 0; i < n; i++) {
+               b[i] = decrypt ? aesni_dec1(b[i], K, cur->rijndael.Nr) : aesni_enc1(b[i], K, cur->rijndael.Nr);
+            }
+         }
+      } else {
+         /* interleave the rounds of the different keys */
+         maxNr = 0;
+         for (i = 0; i < n; i++) {
+            Nr[i] = skey[i]->rijndael.Nr;
+            if (Nr[i] != 10 && Nr[i] != 12 && Nr[i] != 14) {
+               return CRYPT_INVALID_ROUNDS;
+            }
+            maxNr = MAX(maxNr, Nr[i]);
+            rk[i] = decrypt ? skey[i]->rijndael.dK : skey[i]->rijndael.eK;
+            b[i] = _mm_xor_si128(AESNI_LOAD(in + 16 * i), aesni_bswap32(AESNI_LOAD(rk[i])));
+         }
+         for (r = 1; r <= maxNr; r++) {
+            for (i = 0; i < n; i++) {
+               if (r > Nr[i]) continue;
+               k = aesni_bswap32(AESNI_LOAD(rk[i] + 4 * r));
+               if (decrypt) {
+                  b[i] = (r < Nr[i]) ? _mm_aesdec_si128(b[i], k) : _mm_aesdeclast_si128(b[i], k);
+               } else {
+                  b[i] = (r < Nr[i]) ? _mm_aesenc_si128(b[i], k) : _mm_aesenclast_si128(b[i], k);
+               }
+            }
+         }
+      }
+      for (i = 0; i < n; i++) {
+         AESNI_STORE(out + 16 * i, b[i]);
+      }
+      in   += 16 * n;
+      out  += 16 * n;
+      skey += n;
+   }
+
+#ifdef LTC_CLEAN_STACK
+   zeromem(K, sizeof(K));
+#endif
+   return CRYPT_OK;
+}
+
+/**
+  Encrypt blocks under several keys with AES-NI in ECB mode, e.g. the blocks of different packets
+  @param pt     The plaintext
+  @param ct     [out] The ciphertext
+  @param blocks The number of 16 byte blocks to encrypt
+  @param skey   The keys as scheduled, one per block
+  @return CRYPT_OK if successful
+*/
+AESNI_TARGET
+int aesni_ecb_encrypt_multi(const unsigned char *pt, unsigned char *ct, unsigned long blocks, const symmetric_key * const *skey)
+{
+   LTC_ARGCHK(pt   != NULL);
+   LTC_ARGCHK(ct   != NULL);
+   LTC_ARGCHK(skey != NULL);
+
+   return aesni_ecb_multi(pt, ct, blocks, skey, 0);
+}
+
+/**
+  Decrypt blocks under several keys with AES-NI in ECB mode
+  @param ct     The ciphertext
+  @param pt     [out] The plaintext
+  @param blocks The number of 16 byte blocks to decrypt
+  @param skey   The keys as scheduled, one per block
+  @return CRYPT_OK if successful
+*/
+AESNI_TARGET
+int aesni_ecb_decrypt_multi(const unsigned char *ct, unsigned char *pt, unsigned long blocks, const symmetric_key * const *skey)
+{
+   LTC_ARGCHK(pt   != NULL);
+   LTC_ARGCHK(ct   != NULL);
+   LTC_ARGCHK(skey != NULL);
+
+   return aesni_ecb_multi(ct, pt, blocks, skey, 1);
+}
+
+#endif /* LTC_AES_NI */
+
+/* ref:         $Format:%D$ */
+/* git commit:  $Format:%H$ */
+/* commit time: $Format:%ai$ */
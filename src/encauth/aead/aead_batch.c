@@ -0,0 +1,147 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ */
+#include "tomcrypt_private.h"
+
+/**
+   @file aead_batch.c
+   Process a batch of independent AEAD packets
+*/
+
+#if defined(LTC_GCM_MODE) || defined(LTC_OCB3_MODE) || defined(LTC_CHACHA20POLY1305_MODE)
+
+#ifdef LTC_AES_NI
+static int _is_aes(int cipher, int direction)
+{
+   if (cipher_descriptor[cipher].setup == rijndael_setup) {
+      return 1;
+   }
+   return direction == LTC_ENCRYPT && cipher_descriptor[cipher].setup == rijndael_enc_setup;
+}
+#endif
+
+/**
+   Encrypt or decrypt blocks of 16 octets, each of them under its own key (internal function)
+
+   The blocks of all packets of a batch are collected, so the block cipher
+   can process several of them at once even if the packets are short.
+   @param in        The input blocks
+   @param out       [out] The output blocks
+   @param blocks    The number of blocks
+   @param skey      The scheduled key of each block
+   @param cipher    The cipher of each block
+   @param direction LTC_ENCRYPT or LTC_DECRYPT
+   @return CRYPT_OK if successful
+*/
+int aead_int_ecb_multi(const unsigned char *in, unsigned char *out, unsigned long blocks,
+                       const symmetric_key * const *skey, const int *cipher, int direction)
+{
+   unsigned long x, y;
+   int err;
+
+#ifdef LTC_AES_NI
+   if (aesni_is_supported()) {
+      for (x = 0; x < blocks && _is_aes(cipher[x], direction); x++);
+      if (x == blocks) {
+         if (direction == LTC_ENCRYPT) {
+            return aesni_ecb_encrypt_multi(in, out, blocks, skey);
+         }
+         return aesni_ecb_decrypt_multi(in, out, blocks, skey);
+      }
+   }
+#endif
+
+   for (x = 0; x < blocks; x = y) {
+      /* the run of blocks under the same key */
+      for (y = x + 1; y < blocks && skey[y] == skey[x] && cipher[y] == cipher[x]; y++);
+      /* the accel_ecb hooks take a non-const key for compatibility, they don't modify it */
+      if (direction == LTC_ENCRYPT && cipher_descriptor[cipher[x]].accel_ecb_encrypt != NULL) {
+         if ((err = cipher_descriptor[cipher[x]].accel_ecb_encrypt(in + 16 * x, out + 16 * x, y - x,
+                                                                 (symmetric_key *)skey[x])) != CRYPT_OK) {
+            return err;
+         }
+         continue;
+      }
+      if (direction == LTC_DECRYPT && cipher_descriptor[cipher[x]].accel_ecb_decrypt != NULL) {
+         if ((err = cipher_descriptor[cipher[x]].accel_ecb_decrypt(in + 16 * x, out + 16 * x, y - x,
+                                                                 (symmetric_key *)skey[x])) != CRYPT_OK) {
+            return err;
+         }
+         continue;
+      }
+      for (; x < y; x++) {
+         if (direction == LTC_ENCRYPT) {
+            err = cipher_descriptor[cipher[x]].ecb_encrypt(in + 16 * x, out + 16 * x, skey[x]);
+         } else {
+            err = cipher_descriptor[cipher[x]].ecb_decrypt(in + 16 * x, out + 16 * x, skey[x]);
+         }
+         if (err != CRYPT_OK) {
+            return err;
+         }
+      }
+   }
+   return CRYPT_OK;
+}
+
+static int _aead_batch(int mode, aead_packet *pkt, unsigned long n, int direction)
+{
+   LTC_ARGCHK(pkt != NULL || n == 0);
+
+   switch (mode) {
+#ifdef LTC_GCM_MODE
+      case LTC_AEAD_GCM:
+         return gcm_memory_batch(pkt, n, direction);
+#endif
+#ifdef LTC_OCB3_MODE
+      case LTC_AEAD_OCB3:
+         return ocb3_memory_batch(pkt, n, direction);
+#endif
+#ifdef LTC_CHACHA20POLY1305_MODE
+      case LTC_AEAD_CHACHA20POLY1305:
+         return chacha20poly1305_memory_batch(pkt, n, direction);
+#endif
+      default:
+         return CRYPT_INVALID_ARG;
+   }
+}
+
+/**
+   Encrypt and authenticate a batch of packets.
+
+   The packets can use different keys and nonces.  The result of each packet
+   is stored in its err member.
+   @param mode   LTC_AEAD_GCM, LTC_AEAD_OCB3 or LTC_AEAD_CHACHA20POLY1305
+   @param pkt    The packets
+   @param n      The number of packets
+   @return CRYPT_OK if all packets were successful, otherwise the error of the first packet which failed
+*/
+int aead_encrypt_batch(int mode, aead_packet *pkt, unsigned long n)
+{
+   return _aead_batch(mode, pkt, n, LTC_ENCRYPT);
+}
+
+/**
+   Decrypt and verify a batch of packets.
+
+   The result of each packet is stored in its err member, it's CRYPT_ERROR if
+   the tag didn't match.  The plaintext of such a packet is zeroed.
+   @param mode   LTC_AEAD_GCM, LTC_AEAD_OCB3 or LTC_AEAD_CHACHA20POLY1305
+   @param pkt    The packets
+   @param n      The number of packets
+   @return CRYPT_OK if all packets were successful, otherwise the error of the first packet which failed
+*/
+int aead_decrypt_batch(int mode, aead_packet *pkt, unsigned long n)
+{
+   return _aead_batch(mode, pkt, n, LTC_DECRYPT);
+}
+
+#endif
+
+/* ref:         $Format:%D$ */
+/* git commit:  $Format:%H$ */
+/* commit time: $Format:%ai$ */
@@ -23,6 +23,9 @@ int chacha20poly1305_decrypt(chacha20poly1305_state *st, const unsigned char *in
 {
    unsigned char padzero[16] = { 0 };
    unsigned long padlen;
+#ifdef LTC_CHACHA20POLY1305_SIMD
+   unsigned long n;
+#endif
    int err;
 
    LTC_ARGCHK(st != NULL);
@@ -35,6 +38,18 @@ int chacha20poly1305_decrypt(chacha20poly1305_state *st, const unsigned char *in
       st->aadflg = 0; /* no more AAD */
    }
    if (st->aadflg) st->aadflg = 0; /* no more AAD */
+#ifdef LTC_CHACHA20POLY1305_SIMD
+   if (inlen >= 512) {
+      /* whole chunks in a single pass, Poly1305 reads the ciphertext before it's decrypted */
+      LTC_ARGCHK(in  != NULL);
+      LTC_ARGCHK(out != NULL);
+      n = chacha20poly1305_simd_crypt(&st->chacha, &st->poly, in, out, inlen, CHACHA20POLY1305_DECRYPT);
+      st->ctlen += (ulong64)n;
+      inlen -= n;
+      in    += n;
+      out   += n;
+   }
+#endif
    if ((err = poly1305_process(&st->poly, in, inlen)) != CRYPT_OK)         return err;
    if ((err = chacha_crypt(&st->chacha, in, inlen, out)) != CRYPT_OK)      return err;
    st->ctlen += (ulong64)inlen;
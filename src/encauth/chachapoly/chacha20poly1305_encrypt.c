@@ -23,11 +23,13 @@ int chacha20poly1305_encrypt(chacha20poly1305_state *st, const unsigned char *in
 {
    unsigned char padzero[16] = { 0 };
    unsigned long padlen;
+#ifdef LTC_CHACHA20POLY1305_SIMD
+   unsigned long n;
+#endif
    int err;
 
    LTC_ARGCHK(st != NULL);
 
-   if ((err = chacha_crypt(&st->chacha, in, inlen, out)) != CRYPT_OK)         return err;
    if (st->aadflg) {
       padlen = 16 - (unsigned long)(st->aadlen % 16);
       if (padlen < 16) {
@@ -35,6 +37,19 @@ int chacha20poly1305_encrypt(chacha20poly1305_state *st, const unsigned char *in
       }
       st->aadflg = 0; /* no more AAD */
    }
+#ifdef LTC_CHACHA20POLY1305_SIMD
+   if (inlen >= 512) {
+      /* whole chunks in a single pass, Poly1305 reads the ciphertext while it's in the L1 cache */
+      LTC_ARGCHK(in  != NULL);
+      LTC_ARGCHK(out != NULL);
+      n = chacha20poly1305_simd_crypt(&st->chacha, &st->poly, in, out, inlen, CHACHA20POLY1305_ENCRYPT);
+      st->ctlen += (ulong64)n;
+      inlen -= n;
+      in    += n;
+      out   += n;
+   }
+#endif
+   if ((err = chacha_crypt(&st->chacha, in, inlen, out)) != CRYPT_OK)         return err;
    if ((err = poly1305_process(&st->poly, out, inlen)) != CRYPT_OK)           return err;
    st->ctlen += (ulong64)inlen;
    return CRYPT_OK;
@@ -0,0 +1,326 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ */
+
+#include "tomcrypt_private.h"
+
+#ifdef LTC_CHACHA20POLY1305_MODE
+
+static int _chacha20poly1305_batch_check(const aead_packet *p, int direction)
+{
+   if (p->mode != LTC_AEAD_CHACHA20POLY1305 || p->key.chacha20poly1305 == NULL || p->nonce == NULL ||
+       (p->noncelen != 12 && p->noncelen != 8) ||
+       p->taglen == 0 || p->taglen > 16 || p->tag == NULL || (p->adatalen > 0 && p->adata == NULL) ||
+       (p->inlen > 0 && (p->in == NULL || p->out == NULL))) {
+      return CRYPT_INVALID_ARG;
+   }
+   if (direction != CHACHA20POLY1305_ENCRYPT && direction != CHACHA20POLY1305_DECRYPT) {
+      return CRYPT_INVALID_ARG;
+   }
+   return CRYPT_OK;
+}
+
+static int _chacha20poly1305_batch_one(const aead_packet *p, int direction)
+{
+   const chacha20poly1305_state *key = p->key.chacha20poly1305;
+   chacha20poly1305_state st;
+   unsigned char T[16];
+   unsigned long Tlen = sizeof(T);
+   int err;
+
+   /* only the ChaCha20 key is taken over, the rest depends on the nonce */
+   XMEMCPY(&st.chacha, &key->chacha, sizeof(st.chacha));
+   if ((err = chacha20poly1305_setiv(&st, p->nonce, p->noncelen)) != CRYPT_OK)         { goto LBL_ERR; }
+   if (p->adatalen > 0) {
+      if ((err = chacha20poly1305_add_aad(&st, p->adata, p->adatalen)) != CRYPT_OK)    { goto LBL_ERR; }
+   }
+   if (direction == CHACHA20POLY1305_ENCRYPT) {
+      if ((err = chacha20poly1305_encrypt(&st, p->in, p->inlen, p->out)) != CRYPT_OK)  { goto LBL_ERR; }
+   } else {
+      if ((err = chacha20poly1305_decrypt(&st, p->in, p->inlen, p->out)) != CRYPT_OK)  { goto LBL_ERR; }
+   }
+   if ((err = chacha20poly1305_done(&st, T, &Tlen)) != CRYPT_OK)                       { goto LBL_ERR; }
+
+   if (direction == CHACHA20POLY1305_ENCRYPT) {
+      XMEMCPY(p->tag, T, p->taglen);
+   } else if (XMEM_NEQ(T, p->tag, p->taglen) != 0) {
+      if (p->inlen > 0) {
+         zeromem(p->out, p->inlen);
+      }
+      err = CRYPT_ERROR;
+   }
+
+LBL_ERR:
+#ifdef LTC_CLEAN_STACK
+   zeromem(&st, sizeof(st));
+   zeromem(T, sizeof(T));
+#endif
+   return err;
+}
+
+#ifdef LTC_CHACHA_SIMD
+
+/* the ChaCha20 blocks of one pass over short packets */
+#define BATCH_BLOCKS  32
+/* longer packets are processed one by one, the 8-block kernels of chacha_crypt() are faster for them */
+#define BATCH_MAXLEN  448
+/* the number of ChaCha20 blocks of a packet, one for the Poly1305 key */
+#define BATCH_NBLOCKS(p) (1 + ((p)->inlen + 63) / 64)
+
+/* the ChaCha20 state of block ctr of a packet */
+static void _chacha20poly1305_batch_state(ulong32 *input, const aead_packet *p, ulong32 ctr)
+{
+   const chacha20poly1305_state *key = p->key.chacha20poly1305;
+
+   XMEMCPY(input, key->chacha.input, 12 * sizeof(ulong32));
+   input[12] = ctr;
+   if (p->noncelen == 12) {
+      LOAD32L(input[13], p->nonce + 0);
+      LOAD32L(input[14], p->nonce + 4);
+      LOAD32L(input[15], p->nonce + 8);
+   } else {
+      input[13] = 0;
+      LOAD32L(input[14], p->nonce + 0);
+      LOAD32L(input[15], p->nonce + 4);
+   }
+}
+
+/* the number of Poly1305 blocks of a packet: the padded AAD, the padded ciphertext and the lengths */
+static unsigned long _chacha20poly1305_batch_polylen(const aead_packet *p)
+{
+   return (p->adatalen + 15) / 16 + (p->inlen + 15) / 16 + 1;
+}
+
+/* the Poly1305 block b of a packet, ct is the ciphertext */
+static void _chacha20poly1305_batch_polyblock(const aead_packet *p, const unsigned char *ct, unsigned long b, unsigned char *blk)
+{
+   const unsigned char *src;
+   unsigned long na, len;
+
+   na = (p->adatalen + 15) / 16;
+   if (b < na) {
+      src = p->adata + 16 * b;
+      len = p->adatalen - 16 * b;
+   } else if (b - na < (p->inlen + 15) / 16) {
+      src = ct + 16 * (b - na);
+      len = p->inlen - 16 * (b - na);
+   } else {
+      STORE64L((ulong64)p->adatalen, blk);
+      STORE64L((ulong64)p->inlen, blk + 8);
+      return;
+   }
+   if (len >= 16) {
+      XMEMCPY(blk, src, 16);
+   } else {
+      XMEMCPY(blk, src, len);
+      XMEMSET(blk + len, 0, 16 - len);
+   }
+}
+
+/* the Poly1305 blocks from b on, up to 8 at a time */
+static void _chacha20poly1305_batch_polyrest(poly1305_state *st, const aead_packet *p, const unsigned char *ct,
+                                             unsigned long b, unsigned char *buf)
+{
+   unsigned long nb, x;
+
+   nb = _chacha20poly1305_batch_polylen(p);
+   while (b < nb) {
+      for (x = 0; x < 8 && b < nb; x++, b++) {
+         _chacha20poly1305_batch_polyblock(p, ct, b, buf + 16 * x);
+      }
+      poly1305_process(st, buf, 16 * x);
+   }
+}
+
+/* the ciphertext which is authenticated */
+#define BATCH_CT(p, direction) ((direction) == CHACHA20POLY1305_ENCRYPT ? (p)->out : (p)->in)
+
+/**
+   The tags of up to BATCH_BLOCKS packets
+
+   Groups of four packets are run through the lanes of the AVX2 kernel for
+   their common number of blocks, the rest through poly1305_process().  A
+   last group of less than four packets is padded with copies of its first.
+*/
+static void _chacha20poly1305_batch_tags(aead_packet **p, unsigned long n, int direction,
+                                         const unsigned char *ks, const unsigned long *first,
+                                         unsigned char (*tag)[16], unsigned char *buf)
+{
+   poly1305_state st[4];
+   unsigned long i, l, m, b, Tlen;
+#ifdef LTC_POLY1305_SIMD
+   const aead_packet *q[4];
+   unsigned long x, steps;
+#endif
+
+   for (i = 0; i < n; i += m) {
+      m = (n - i < 4) ? n - i : 4;
+      for (l = 0; l < m; l++) {
+         poly1305_init(&st[l], ks + 64 * first[i + l], 32);
+      }
+      b = 0;
+#ifdef LTC_POLY1305_SIMD
+      if (ltc_cpu_has(LTC_CPU_AVX2)) {
+         steps = _chacha20poly1305_batch_polylen(p[i]);
+         for (l = 0; l < 4; l++) {
+            q[l] = p[i + (l < m ? l : 0)];
+            if (l >= m) {
+               XMEMCPY(&st[l], &st[0], sizeof(st[l]));
+            }
+            x = _chacha20poly1305_batch_polylen(q[l]);
+            if (x < steps) {
+               steps = x;
+            }
+         }
+         while (b < steps) {
+            for (x = 0; x < 8 && b < steps; x++, b++) {
+               for (l = 0; l < 4; l++) {
+                  _chacha20poly1305_batch_polyblock(q[l], BATCH_CT(q[l], direction), b, buf + 64 * x + 16 * l);
+               }
+            }
+            poly1305_avx2_multi(st, buf, x);
+         }
+      }
+#endif
+      for (l = 0; l < m; l++) {
+         _chacha20poly1305_batch_polyrest(&st[l], p[i + l], BATCH_CT(p[i + l], direction), b, buf);
+         Tlen = 16;
+         poly1305_done(&st[l], tag[i + l], &Tlen);
+      }
+   }
+#ifdef LTC_CLEAN_STACK
+   zeromem(st, sizeof(st));
+#endif
+}
+
+/**
+   Process short packets together, their ChaCha20 blocks are computed in one pass
+   @param p         The packets, validated and at most BATCH_BLOCKS ChaCha20 blocks in total
+   @param n         The number of packets
+   @param direction CHACHA20POLY1305_ENCRYPT or CHACHA20POLY1305_DECRYPT
+*/
+static void _chacha20poly1305_batch_short(aead_packet **p, unsigned long n, int direction)
+{
+   ulong32 input[16 * BATCH_BLOCKS];
+   unsigned char ks[64 * BATCH_BLOCKS], tag[BATCH_BLOCKS][16], buf[64 * 8];
+   unsigned long first[BATCH_BLOCKS], i, x, nblocks;
+   const unsigned char *k;
+
+   nblocks = 0;
+   for (i = 0; i < n; i++) {
+      first[i] = nblocks;
+      for (x = 0; x < BATCH_NBLOCKS(p[i]); x++) {
+         _chacha20poly1305_batch_state(input + 16 * nblocks++, p[i], (ulong32)x);
+      }
+   }
+   /* the kernel computes multiples of four blocks, pad with copies of the first one */
+   while (nblocks == 0 || nblocks % 4 != 0) {
+      _chacha20poly1305_batch_state(input + 16 * nblocks++, p[0], 0);
+   }
+   chacha_simd_keystream_multi(input, 20, ks, nblocks);
+
+   if (direction == CHACHA20POLY1305_ENCRYPT) {
+      for (i = 0; i < n; i++) {
+         k = ks + 64 * (first[i] + 1);
+         for (x = 0; x < p[i]->inlen; x++) {
+            p[i]->out[x] = p[i]->in[x] ^ k[x];
+         }
+      }
+   }
+
+   _chacha20poly1305_batch_tags(p, n, direction, ks, first, tag, buf);
+
+   for (i = 0; i < n; i++) {
+      if (direction == CHACHA20POLY1305_ENCRYPT) {
+         XMEMCPY(p[i]->tag, tag[i], p[i]->taglen);
+         p[i]->err = CRYPT_OK;
+      } else if (XMEM_NEQ(tag[i], p[i]->tag, p[i]->taglen) != 0) {
+         if (p[i]->inlen > 0) {
+            zeromem(p[i]->out, p[i]->inlen);
+         }
+         p[i]->err = CRYPT_ERROR;
+      } else {
+         k = ks + 64 * (first[i] + 1);
+         for (x = 0; x < p[i]->inlen; x++) {
+            p[i]->out[x] = p[i]->in[x] ^ k[x];
+         }
+         p[i]->err = CRYPT_OK;
+      }
+   }
+
+#ifdef LTC_CLEAN_STACK
+   zeromem(input, sizeof(input));
+   zeromem(ks, sizeof(ks));
+   zeromem(tag, sizeof(tag));
+   zeromem(buf, sizeof(buf));
+#endif
+}
+
+#endif /* LTC_CHACHA_SIMD */
+
+/**
+   Encrypt or decrypt a batch of independent ChaCha20Poly1305 packets
+
+   With SIMD the packets of up to 448 octets are collected, the ChaCha20
+   blocks of several of them are computed side by side in one pass and
+   their tags four at a time.
+   @param pkt       The packets, their mode is LTC_AEAD_CHACHA20POLY1305
+   @param n         The number of packets
+   @param direction CHACHA20POLY1305_ENCRYPT or CHACHA20POLY1305_DECRYPT
+   @return CRYPT_OK if all packets were successful, otherwise the error of the first packet which failed
+*/
+int chacha20poly1305_memory_batch(aead_packet *pkt, unsigned long n, int direction)
+{
+   unsigned long i;
+   int ret = CRYPT_OK;
+#ifdef LTC_CHACHA_SIMD
+   aead_packet *group[BATCH_BLOCKS];
+   unsigned long ngroup = 0, nblocks = 0;
+   int simd = ltc_cpu_has(LTC_CPU_SSE2);
+#endif
+
+   LTC_ARGCHK(pkt != NULL || n == 0);
+
+   for (i = 0; i < n; i++) {
+      pkt[i].err = _chacha20poly1305_batch_check(&pkt[i], direction);
+      if (pkt[i].err != CRYPT_OK) {
+         continue;
+      }
+#ifdef LTC_CHACHA_SIMD
+      if (simd && pkt[i].inlen <= BATCH_MAXLEN) {
+         if (nblocks + BATCH_NBLOCKS(&pkt[i]) > BATCH_BLOCKS) {
+            _chacha20poly1305_batch_short(group, ngroup, direction);
+            ngroup = nblocks = 0;
+         }
+         group[ngroup++] = &pkt[i];
+         nblocks += BATCH_NBLOCKS(&pkt[i]);
+         continue;
+      }
+#endif
+      pkt[i].err = _chacha20poly1305_batch_one(&pkt[i], direction);
+   }
+#ifdef LTC_CHACHA_SIMD
+   if (ngroup > 0) {
+      _chacha20poly1305_batch_short(group, ngroup, direction);
+   }
+#endif
+
+   for (i = 0; i < n; i++) {
+      if (pkt[i].err != CRYPT_OK) {
+         ret = pkt[i].err;
+         break;
+      }
+   }
+   return ret;
+}
+
+#endif
+
+/* ref:         $Format:%D$ */
+/* git commit:  $Format:%H$ */
+/* commit time: $Format:%ai$ */
@@ -123,6 +123,210 @@ int chacha20poly1305_test(void)
    if (compare_testvector(pt, mlen, m, mlen, "DEC-PT4", 1) != 0) return CRYPT_FAIL_TESTVECTOR;
    if (compare_testvector(dmac, len, emac, len, "DEC-TAG4", 2) != 0) return CRYPT_FAIL_TESTVECTOR;
 
+   /* batch: the RFC 7539 vector, the same with a 64-bit IV and one with a wrong tag */
+   {
+      aead_packet pkt[3];
+      unsigned char btag[3][16], bct[3][sizeof(enc)];
+      int i;
+
+      if ((err = chacha20poly1305_init(&st1, k, sizeof(k))) != CRYPT_OK) return err;
+      for (i = 0; i < 3; i++) {
+         XMEMSET(&pkt[i], 0, sizeof(pkt[i]));
+         pkt[i].mode     = LTC_AEAD_CHACHA20POLY1305;
+         pkt[i].key.chacha20poly1305 = &st1;
+         pkt[i].nonce    = i == 1 ? i8 : i12;
+         pkt[i].noncelen = i == 1 ? sizeof(i8) : sizeof(i12);
+         pkt[i].adata    = aad;
+         pkt[i].adatalen = sizeof(aad);
+         pkt[i].in       = (unsigned char*)m;
+         pkt[i].inlen    = mlen;
+         pkt[i].out      = bct[i];
+         pkt[i].tag      = btag[i];
+         pkt[i].taglen   = sizeof(btag[i]);
+      }
+      if ((err = aead_encrypt_batch(LTC_AEAD_CHACHA20POLY1305, pkt, 3)) != CRYPT_OK) return err;
+      if (compare_testvector(bct[0], mlen, enc, sizeof(enc), "BATCH-CT", 1) != 0) return CRYPT_FAIL_TESTVECTOR;
+      if (compare_testvector(btag[0], 16, tag, sizeof(tag), "BATCH-TAG", 1) != 0) return CRYPT_FAIL_TESTVECTOR;
+      len = sizeof(emac);
+      if ((err = chacha20poly1305_memory(k, sizeof(k), i8, sizeof(i8), aad, sizeof(aad), (unsigned char*)m,
+                                         mlen, ct, emac, &len, CHACHA20POLY1305_ENCRYPT)) != CRYPT_OK) return err;
+      if (compare_testvector(bct[1], mlen, ct, mlen, "BATCH-CT", 2) != 0) return CRYPT_FAIL_TESTVECTOR;
+      if (compare_testvector(btag[1], 16, emac, len, "BATCH-TAG", 2) != 0) return CRYPT_FAIL_TESTVECTOR;
+
+      btag[2][15] ^= 0x80;
+      for (i = 0; i < 3; i++) {
+         pkt[i].in = bct[i];
+      }
+      if (aead_decrypt_batch(LTC_AEAD_CHACHA20POLY1305, pkt, 3) != CRYPT_ERROR) return CRYPT_FAIL_TESTVECTOR;
+      if (pkt[0].err != CRYPT_OK || pkt[1].err != CRYPT_OK || pkt[2].err != CRYPT_ERROR) return CRYPT_FAIL_TESTVECTOR;
+      if (compare_testvector(bct[1], mlen, m, mlen, "BATCH-PT", 2) != 0) return CRYPT_FAIL_TESTVECTOR;
+      XMEMSET(pt, 0, mlen);
+      if (compare_testvector(bct[2], mlen, pt, mlen, "BATCH-PT", 3) != 0) return CRYPT_FAIL_TESTVECTOR;
+
+      /* a packet of another mode is rejected */
+      pkt[0].mode = LTC_AEAD_GCM;
+      if (aead_decrypt_batch(LTC_AEAD_CHACHA20POLY1305, pkt, 1) != CRYPT_INVALID_ARG) return CRYPT_FAIL_TESTVECTOR;
+   }
+
+   /* batch: packets of varied lengths which are processed together, against chacha20poly1305_memory() */
+   {
+      const unsigned long lens[] = { 0, 1, 15, 16, 63, 64, 65, 130, 200, 300, 448, 449 };
+      const unsigned long nlens = sizeof(lens) / sizeof(lens[0]);
+#ifdef LTC_AMD64_SIMD
+      const ulong32 masks[] = { ~(ulong32)0, ~(ulong32)LTC_CPU_AVX2, 0 };
+      ulong32 mask;
+#else
+      const ulong32 masks[] = { 0 };
+#endif
+      aead_packet pkt[sizeof(lens) / sizeof(lens[0])];
+      unsigned char btag[sizeof(lens) / sizeof(lens[0])][16], bout[sizeof(lens) / sizeof(lens[0])][520];
+      unsigned long x, y, msk;
+
+      for (x = 0; x < sizeof(ct); x++) {
+         pt[x] = (unsigned char)(x * 13 + 5);
+      }
+      if ((err = chacha20poly1305_init(&st1, k, sizeof(k))) != CRYPT_OK) return err;
+      for (msk = 0; msk < sizeof(masks) / sizeof(masks[0]); msk++) {
+         for (x = 0; x < nlens; x++) {
+            XMEMSET(&pkt[x], 0, sizeof(pkt[x]));
+            pkt[x].mode     = LTC_AEAD_CHACHA20POLY1305;
+            pkt[x].key.chacha20poly1305 = &st1;
+            pkt[x].nonce    = (x & 1) ? i8 : i12;
+            pkt[x].noncelen = (x & 1) ? sizeof(i8) : sizeof(i12);
+            pkt[x].adata    = pt + 600;
+            pkt[x].adatalen = (x * 7) % 40;
+            pkt[x].in       = pt + x;
+            pkt[x].inlen    = lens[x];
+            pkt[x].out      = bout[x];
+            pkt[x].tag      = btag[x];
+            pkt[x].taglen   = sizeof(btag[x]);
+         }
+#ifdef LTC_AMD64_SIMD
+         mask = ltc_cpu_mask(masks[msk]);
+         err = aead_encrypt_batch(LTC_AEAD_CHACHA20POLY1305, pkt, nlens);
+         ltc_cpu_mask(mask);
+#else
+         err = aead_encrypt_batch(LTC_AEAD_CHACHA20POLY1305, pkt, nlens);
+#endif
+         if (err != CRYPT_OK) return err;
+         for (x = 0; x < nlens; x++) {
+            len = sizeof(emac);
+            if ((err = chacha20poly1305_memory(k, sizeof(k), pkt[x].nonce, pkt[x].noncelen, pkt[x].adata, pkt[x].adatalen,
+                                               pt + x, lens[x], ct, emac, &len, CHACHA20POLY1305_ENCRYPT)) != CRYPT_OK) return err;
+            if (compare_testvector(bout[x], lens[x], ct, lens[x], "BATCH-VAR-CT", (int)(msk * 100 + x)) != 0) return CRYPT_FAIL_TESTVECTOR;
+            if (compare_testvector(btag[x], 16, emac, len, "BATCH-VAR-TAG", (int)(msk * 100 + x)) != 0) return CRYPT_FAIL_TESTVECTOR;
+            pkt[x].in = bout[x];
+         }
+
+         /* decrypt in place, one of the tags is wrong */
+         btag[5][0] ^= 1;
+#ifdef LTC_AMD64_SIMD
+         mask = ltc_cpu_mask(masks[msk]);
+         err = aead_decrypt_batch(LTC_AEAD_CHACHA20POLY1305, pkt, nlens);
+         ltc_cpu_mask(mask);
+#else
+         err = aead_decrypt_batch(LTC_AEAD_CHACHA20POLY1305, pkt, nlens);
+#endif
+         if (err != CRYPT_ERROR) return CRYPT_FAIL_TESTVECTOR;
+         for (x = 0; x < nlens; x++) {
+            if (x == 5) {
+               if (pkt[x].err != CRYPT_ERROR) return CRYPT_FAIL_TESTVECTOR;
+               for (y = 0; y < lens[x]; y++) {
+                  if (bout[x][y] != 0) return CRYPT_FAIL_TESTVECTOR;
+               }
+               continue;
+            }
+            if (pkt[x].err != CRYPT_OK) return pkt[x].err;
+            if (compare_testvector(bout[x], lens[x], pt + x, lens[x], "BATCH-VAR-PT", (int)(msk * 100 + x)) != 0) return CRYPT_FAIL_TESTVECTOR;
+         }
+      }
+   }
+
+   /* several calls, split at odd and at chunk aligned offsets, against ChaCha and Poly1305 run separately over the whole buffer */
+   {
+      const unsigned long biglen = 33768;
+      const unsigned long splits[] = { 1088, 100, 16461 };
+      const unsigned long nsplits = sizeof(splits) / sizeof(splits[0]);
+#ifdef LTC_CHACHA20POLY1305_SIMD
+      /* the single pass isn't used with AVX-512 */
+      const ulong32 masks[] = { ~(ulong32)0, ~(ulong32)LTC_CPU_AVX512 };
+      ulong32 mask;
+#else
+      const ulong32 masks[] = { 0 };
+#endif
+      unsigned char *big, *bigct, *bigpt;
+      unsigned long x, off, n, msk;
+
+      big   = XMALLOC(biglen);
+      bigct = XMALLOC(biglen);
+      bigpt = XMALLOC(biglen);
+      if (big == NULL || bigct == NULL || bigpt == NULL) {
+         err = CRYPT_MEM;
+         goto LBL_BIG;
+      }
+      for (x = 0; x < biglen; x++) {
+         bigpt[x] = (unsigned char)(x * 31 + (x >> 9));
+      }
+
+      if ((err = chacha20poly1305_init(&st1, k, sizeof(k))) != CRYPT_OK)               goto LBL_BIG;
+      if ((err = chacha20poly1305_setiv(&st1, i12, sizeof(i12))) != CRYPT_OK)          goto LBL_BIG;
+      if ((err = chacha20poly1305_add_aad(&st1, aad, sizeof(aad))) != CRYPT_OK)        goto LBL_BIG;
+      if ((err = chacha20poly1305_encrypt(&st1, bigpt, 0, bigct)) != CRYPT_OK)         goto LBL_BIG;
+      if ((err = chacha_crypt(&st1.chacha, bigpt, biglen, bigct)) != CRYPT_OK)         goto LBL_BIG;
+      if ((err = poly1305_process(&st1.poly, bigct, biglen)) != CRYPT_OK)              goto LBL_BIG;
+      st1.ctlen = biglen;
+      len = sizeof(emac);
+      if ((err = chacha20poly1305_done(&st1, emac, &len)) != CRYPT_OK)                 goto LBL_BIG;
+
+      for (msk = 0; msk < sizeof(masks) / sizeof(masks[0]); msk++) {
+#ifdef LTC_CHACHA20POLY1305_SIMD
+         mask = ltc_cpu_mask(masks[msk]);
+#endif
+         XMEMCPY(big, bigpt, biglen);
+
+         /* encrypt in place */
+         if ((err = chacha20poly1305_init(&st1, k, sizeof(k))) != CRYPT_OK)               goto LBL_MASK;
+         if ((err = chacha20poly1305_setiv(&st1, i12, sizeof(i12))) != CRYPT_OK)          goto LBL_MASK;
+         if ((err = chacha20poly1305_add_aad(&st1, aad, sizeof(aad))) != CRYPT_OK)        goto LBL_MASK;
+         for (x = 0, off = 0; off < biglen; x++, off += n) {
+            n = (x < nsplits) ? splits[x] : biglen - off;
+            if ((err = chacha20poly1305_encrypt(&st1, big + off, n, big + off)) != CRYPT_OK) goto LBL_MASK;
+         }
+         len = sizeof(dmac);
+         if ((err = chacha20poly1305_done(&st1, dmac, &len)) != CRYPT_OK)                 goto LBL_MASK;
+         if (compare_testvector(big, biglen, bigct, biglen, "SPLIT-CT", (int)(msk * 100 + 1)) != 0 ||
+             compare_testvector(dmac, len, emac, sizeof(emac), "SPLIT-TAG", (int)(msk * 100 + 1)) != 0) {
+            err = CRYPT_FAIL_TESTVECTOR;
+            goto LBL_MASK;
+         }
+
+         /* and decrypt in place */
+         if ((err = chacha20poly1305_init(&st2, k, sizeof(k))) != CRYPT_OK)               goto LBL_MASK;
+         if ((err = chacha20poly1305_setiv(&st2, i12, sizeof(i12))) != CRYPT_OK)          goto LBL_MASK;
+         if ((err = chacha20poly1305_add_aad(&st2, aad, sizeof(aad))) != CRYPT_OK)        goto LBL_MASK;
+         for (x = 0, off = 0; off < biglen; x++, off += n) {
+            n = (x < nsplits) ? splits[nsplits - 1 - x] : biglen - off;
+            if ((err = chacha20poly1305_decrypt(&st2, big + off, n, big + off)) != CRYPT_OK) goto LBL_MASK;
+         }
+         len = sizeof(dmac);
+         if ((err = chacha20poly1305_done(&st2, dmac, &len)) != CRYPT_OK)                 goto LBL_MASK;
+         if (compare_testvector(big, biglen, bigpt, biglen, "SPLIT-PT", (int)(msk * 100 + 2)) != 0 ||
+             compare_testvector(dmac, len, emac, sizeof(emac), "SPLIT-TAG", (int)(msk * 100 + 2)) != 0) {
+            err = CRYPT_FAIL_TESTVECTOR;
+         }
+LBL_MASK:
+#ifdef LTC_CHACHA20POLY1305_SIMD
+         ltc_cpu_mask(mask);
+#endif
+         if (err != CRYPT_OK) break;
+      }
+LBL_BIG:
+      if (big != NULL)   XFREE(big);
+      if (bigct != NULL) XFREE(bigct);
+      if (bigpt != NULL) XFREE(bigpt);
+      if (err != CRYPT_OK) return err;
+   }
+
    /* wycheproof failing test - https://github.com/libtom/libtomcrypt/pull/451 */
    {
       unsigned char key[] = { 0x00,0x11,0x22,0x33,0x44,0x55,0x66,0x77,0x88,0x99,0xaa,0xbb,0xcc,0xdd,0xee,0xff,
@@ -16,10 +16,8 @@
 #ifdef LTC_EAX_MODE
 
 /**
-   Decrypt a block of memory and verify the provided MAC tag with EAX
-   @param cipher     The index of the cipher desired
-   @param key        The secret key
-   @param keylen     The length of the key (octets)
+   Decrypt a block of memory and verify the provided MAC tag with EAX and an expanded key
+   @param key        The expanded key
    @param nonce      The nonce data (use once) for the session
    @param noncelen   The length of the nonce data.
    @param header     The session header data
@@ -32,8 +30,7 @@
    @param stat       [out] The result of the decryption (1==valid tag, 0==invalid)
    @return CRYPT_OK if successful regardless of the resulting tag comparison
 */
-int eax_decrypt_verify_memory(int cipher,
-    const unsigned char *key,    unsigned long keylen,
+int eax_key_decrypt_verify_memory(const eax_key *key,
     const unsigned char *nonce,  unsigned long noncelen,
     const unsigned char *header, unsigned long headerlen,
     const unsigned char *ct,     unsigned long ctlen,
@@ -71,7 +68,7 @@ int eax_decrypt_verify_memory(int cipher,
       return CRYPT_MEM;
    }
 
-   if ((err = eax_init(eax, cipher, key, keylen, nonce, noncelen, header, headerlen)) != CRYPT_OK) {
+   if ((err = eax_msg_init(eax, key, nonce, noncelen, header, headerlen)) != CRYPT_OK) {
       goto LBL_ERR;
    }
 
@@ -102,6 +99,62 @@ LBL_ERR:
    return err;
 }
 
+/**
+   Decrypt a block of memory and verify the provided MAC tag with EAX
+   @param cipher     The index of the cipher desired
+   @param key        The secret key
+   @param keylen     The length of the key (octets)
+   @param nonce      The nonce data (use once) for the session
+   @param noncelen   The length of the nonce data.
+   @param header     The session header data
+   @param headerlen  The length of the header (octets)
+   @param ct         The ciphertext
+   @param ctlen      The length of the ciphertext (octets)
+   @param pt         [out] The plaintext
+   @param tag        The authentication tag provided by the encoder
+   @param taglen     [in/out] The length of the tag (octets)
+   @param stat       [out] The result of the decryption (1==valid tag, 0==invalid)
+   @return CRYPT_OK if successful regardless of the resulting tag comparison
+*/
+int eax_decrypt_verify_memory(int cipher,
+    const unsigned char *key,    unsigned long keylen,
+    const unsigned char *nonce,  unsigned long noncelen,
+    const unsigned char *header, unsigned long headerlen,
+    const unsigned char *ct,     unsigned long ctlen,
+          unsigned char *pt,
+    const unsigned char *tag,    unsigned long taglen,
+          int           *stat)
+{
+   int            err;
+   eax_key       *ek;
+
+   LTC_ARGCHK(stat != NULL);
+   LTC_ARGCHK(key  != NULL);
+
+   /* default to zero */
+   *stat = 0;
+
+   ek = XMALLOC(sizeof(*ek));
+   if (ek == NULL) {
+      return CRYPT_MEM;
+   }
+
+   if ((err = eax_key_init(ek, cipher, key, keylen)) != CRYPT_OK) {
+      goto LBL_ERR;
+   }
+
+   err = eax_key_decrypt_verify_memory(ek, nonce, noncelen, header, headerlen, ct, ctlen, pt, tag, taglen, stat);
+
+LBL_ERR:
+#ifdef LTC_CLEAN_STACK
+   zeromem(ek, sizeof(*ek));
+#endif
+
+   XFREE(ek);
+
+   return err;
+}
+
 #endif
 
 /* ref:         $Format:%D$ */
@@ -16,10 +16,8 @@
 #ifdef LTC_EAX_MODE
 
 /**
-   EAX encrypt and produce an authentication tag
-   @param cipher     The index of the cipher desired
-   @param key        The secret key to use
-   @param keylen     The length of the secret key (octets)
+   EAX encrypt and produce an authentication tag with an expanded key
+   @param key        The expanded key
    @param nonce      The session nonce [use once]
    @param noncelen   The length of the nonce
    @param header     The header for the session
@@ -31,8 +29,7 @@
    @param taglen     [in/out] The max size and resulting size of the authentication tag
    @return CRYPT_OK if successful
 */
-int eax_encrypt_authenticate_memory(int cipher,
-    const unsigned char *key,    unsigned long keylen,
+int eax_key_encrypt_authenticate_memory(const eax_key *key,
     const unsigned char *nonce,  unsigned long noncelen,
     const unsigned char *header, unsigned long headerlen,
     const unsigned char *pt,     unsigned long ptlen,
@@ -49,8 +46,11 @@ int eax_encrypt_authenticate_memory(int cipher,
    LTC_ARGCHK(taglen != NULL);
 
    eax = XMALLOC(sizeof(*eax));
+   if (eax == NULL) {
+      return CRYPT_MEM;
+   }
 
-   if ((err = eax_init(eax, cipher, key, keylen, nonce, noncelen, header, headerlen)) != CRYPT_OK) {
+   if ((err = eax_msg_init(eax, key, nonce, noncelen, header, headerlen)) != CRYPT_OK) {
       goto LBL_ERR;
    }
 
@@ -73,6 +73,56 @@ LBL_ERR:
    return err;
 }
 
+/**
+   EAX encrypt and produce an authentication tag
+   @param cipher     The index of the cipher desired
+   @param key        The secret key to use
+   @param keylen     The length of the secret key (octets)
+   @param nonce      The session nonce [use once]
+   @param noncelen   The length of the nonce
+   @param header     The header for the session
+   @param headerlen  The length of the header (octets)
+   @param pt         The plaintext
+   @param ptlen      The length of the plaintext (octets)
+   @param ct         [out] The ciphertext
+   @param tag        [out] The destination tag
+   @param taglen     [in/out] The max size and resulting size of the authentication tag
+   @return CRYPT_OK if successful
+*/
+int eax_encrypt_authenticate_memory(int cipher,
+    const unsigned char *key,    unsigned long keylen,
+    const unsigned char *nonce,  unsigned long noncelen,
+    const unsigned char *header, unsigned long headerlen,
+    const unsigned char *pt,     unsigned long ptlen,
+          unsigned char *ct,
+          unsigned char *tag,    unsigned long *taglen)
+{
+   int err;
+   eax_key *ek;
+
+   LTC_ARGCHK(key    != NULL);
+
+   ek = XMALLOC(sizeof(*ek));
+   if (ek == NULL) {
+      return CRYPT_MEM;
+   }
+
+   if ((err = eax_key_init(ek, cipher, key, keylen)) != CRYPT_OK) {
+      goto LBL_ERR;
+   }
+
+   err = eax_key_encrypt_authenticate_memory(ek, nonce, noncelen, header, headerlen, pt, ptlen, ct, tag, taglen);
+
+LBL_ERR:
+#ifdef LTC_CLEAN_STACK
+   zeromem(ek, sizeof(*ek));
+#endif
+
+   XFREE(ek);
+
+   return err;
+}
+
 #endif
 
 /* ref:         $Format:%D$ */
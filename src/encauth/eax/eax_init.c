@@ -16,28 +16,52 @@
 #ifdef LTC_EAX_MODE
 
 /**
-   Initialized an EAX state
-   @param eax       [out] The EAX state to initialize
+   Expand an EAX key, the result can be used for several messages
+   @param eax       [out] The destination of the expanded key
    @param cipher    The index of the desired cipher
    @param key       The secret key
    @param keylen    The length of the secret key (octets)
+   @return CRYPT_OK if successful
+*/
+int eax_key_init(eax_key *eax, int cipher, const unsigned char *key, unsigned long keylen)
+{
+   unsigned char IV[MAXBLOCKSIZE];
+   int           err;
+
+   LTC_ARGCHK(eax != NULL);
+   LTC_ARGCHK(key != NULL);
+
+   if ((err = cipher_is_valid(cipher)) != CRYPT_OK) {
+      return err;
+   }
+
+   if ((err = omac_init(&eax->omac, cipher, key, keylen)) != CRYPT_OK) {
+      return err;
+   }
+
+   /* the IV is replaced by N in eax_msg_init() */
+   zeromem(IV, sizeof(IV));
+   return ctr_start(cipher, IV, key, keylen, 0, CTR_COUNTER_BIG_ENDIAN, &eax->ctr);
+}
+
+/**
+   Start a new message with an expanded key
+   @param eax       [out] The EAX state to initialize
+   @param key       The expanded key
    @param nonce     The use-once nonce for the session
    @param noncelen  The length of the nonce (octets)
    @param header    The header for the EAX state
    @param headerlen The header length (octets)
    @return CRYPT_OK if successful
 */
-int eax_init(eax_state *eax, int cipher,
-             const unsigned char *key,    unsigned long keylen,
-             const unsigned char *nonce,  unsigned long noncelen,
-             const unsigned char *header, unsigned long headerlen)
+int eax_msg_init(eax_state *eax, const eax_key *key,
+                 const unsigned char *nonce, unsigned long noncelen,
+                 const unsigned char *header, unsigned long headerlen)
 {
-   unsigned char *buf;
+   unsigned char buf[MAXBLOCKSIZE];
    int           err, blklen;
-   omac_state    *omac;
    unsigned long len;
 
-
    LTC_ARGCHK(eax   != NULL);
    LTC_ARGCHK(key   != NULL);
    LTC_ARGCHK(nonce != NULL);
@@ -45,53 +69,33 @@ int eax_init(eax_state *eax, int cipher,
       LTC_ARGCHK(header != NULL);
    }
 
-   if ((err = cipher_is_valid(cipher)) != CRYPT_OK) {
+   if ((err = cipher_is_valid(key->omac.cipher_idx)) != CRYPT_OK) {
       return err;
    }
-   blklen = cipher_descriptor[cipher].block_length;
-
-   /* allocate ram */
-   buf  = XMALLOC(MAXBLOCKSIZE);
-   omac = XMALLOC(sizeof(*omac));
-
-   if (buf == NULL || omac == NULL) {
-      if (buf != NULL) {
-         XFREE(buf);
-      }
-      if (omac != NULL) {
-         XFREE(omac);
-      }
-      return CRYPT_MEM;
-   }
+   blklen = cipher_descriptor[key->omac.cipher_idx].block_length;
 
-   /* N = LTC_OMAC_0K(nonce) */
-   zeromem(buf, MAXBLOCKSIZE);
-   if ((err = omac_init(omac, cipher, key, keylen)) != CRYPT_OK) {
-      goto LBL_ERR;
-   }
+   /* N = LTC_OMAC_0K(nonce), the ctomac is used as scratch space */
+   XMEMCPY(&eax->ctomac, &key->omac, sizeof(eax->ctomac));
+   zeromem(buf, sizeof(buf));
 
    /* omac the [0]_n */
-   if ((err = omac_process(omac, buf, blklen)) != CRYPT_OK) {
+   if ((err = omac_process(&eax->ctomac, buf, blklen)) != CRYPT_OK) {
       goto LBL_ERR;
    }
    /* omac the nonce */
-   if ((err = omac_process(omac, nonce, noncelen)) != CRYPT_OK) {
+   if ((err = omac_process(&eax->ctomac, nonce, noncelen)) != CRYPT_OK) {
       goto LBL_ERR;
    }
    /* store result */
    len = sizeof(eax->N);
-   if ((err = omac_done(omac, eax->N, &len)) != CRYPT_OK) {
+   if ((err = omac_done(&eax->ctomac, eax->N, &len)) != CRYPT_OK) {
       goto LBL_ERR;
    }
 
    /* H = LTC_OMAC_1K(header) */
-   zeromem(buf, MAXBLOCKSIZE);
+   XMEMCPY(&eax->headeromac, &key->omac, sizeof(eax->headeromac));
    buf[blklen - 1] = 1;
 
-   if ((err = omac_init(&eax->headeromac, cipher, key, keylen)) != CRYPT_OK) {
-      goto LBL_ERR;
-   }
-
    /* omac the [1]_n */
    if ((err = omac_process(&eax->headeromac, buf, blklen)) != CRYPT_OK) {
       goto LBL_ERR;
@@ -106,17 +110,15 @@ int eax_init(eax_state *eax, int cipher,
    /* note we don't finish the headeromac, this allows us to add more header later */
 
    /* setup the CTR mode */
-   if ((err = ctr_start(cipher, eax->N, key, keylen, 0, CTR_COUNTER_BIG_ENDIAN, &eax->ctr)) != CRYPT_OK) {
+   XMEMCPY(&eax->ctr, &key->ctr, sizeof(eax->ctr));
+   if ((err = ctr_setiv(eax->N, (unsigned long)blklen, &eax->ctr)) != CRYPT_OK) {
       goto LBL_ERR;
    }
 
    /* setup the LTC_OMAC for the ciphertext */
-   if ((err = omac_init(&eax->ctomac, cipher, key, keylen)) != CRYPT_OK) {
-      goto LBL_ERR;
-   }
+   XMEMCPY(&eax->ctomac, &key->omac, sizeof(eax->ctomac));
 
    /* omac [2]_n */
-   zeromem(buf, MAXBLOCKSIZE);
    buf[blklen-1] = 2;
    if ((err = omac_process(&eax->ctomac, buf, blklen)) != CRYPT_OK) {
       goto LBL_ERR;
@@ -125,12 +127,57 @@ int eax_init(eax_state *eax, int cipher,
    err = CRYPT_OK;
 LBL_ERR:
 #ifdef LTC_CLEAN_STACK
-   zeromem(buf,  MAXBLOCKSIZE);
-   zeromem(omac, sizeof(*omac));
+   zeromem(buf, sizeof(buf));
+#endif
+
+   return err;
+}
+
+/**
+   Initialized an EAX state
+   @param eax       [out] The EAX state to initialize
+   @param cipher    The index of the desired cipher
+   @param key       The secret key
+   @param keylen    The length of the secret key (octets)
+   @param nonce     The use-once nonce for the session
+   @param noncelen  The length of the nonce (octets)
+   @param header    The header for the EAX state
+   @param headerlen The header length (octets)
+   @return CRYPT_OK if successful
+*/
+int eax_init(eax_state *eax, int cipher,
+             const unsigned char *key,    unsigned long keylen,
+             const unsigned char *nonce,  unsigned long noncelen,
+             const unsigned char *header, unsigned long headerlen)
+{
+   int           err;
+   eax_key       *ek;
+
+   LTC_ARGCHK(eax   != NULL);
+   LTC_ARGCHK(key   != NULL);
+   LTC_ARGCHK(nonce != NULL);
+   if (headerlen > 0) {
+      LTC_ARGCHK(header != NULL);
+   }
+
+   /* allocate ram */
+   ek = XMALLOC(sizeof(*ek));
+   if (ek == NULL) {
+      return CRYPT_MEM;
+   }
+
+   if ((err = eax_key_init(ek, cipher, key, keylen)) != CRYPT_OK) {
+      goto LBL_ERR;
+   }
+
+   err = eax_msg_init(eax, ek, nonce, noncelen, header, headerlen);
+
+LBL_ERR:
+#ifdef LTC_CLEAN_STACK
+   zeromem(ek, sizeof(*ek));
 #endif
 
-   XFREE(omac);
-   XFREE(buf);
+   XFREE(ek);
 
    return err;
 }
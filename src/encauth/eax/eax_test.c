@@ -214,6 +214,7 @@ int eax_test(void)
    int err, x, idx, res;
    unsigned long len;
    unsigned char outct[MAXBLOCKSIZE], outtag[MAXBLOCKSIZE];
+   eax_key ek;
 
     /* AES can be under rijndael or aes... try to find it */
     if ((idx = find_cipher("aes")) == -1) {
@@ -247,6 +248,29 @@ int eax_test(void)
            return CRYPT_FAIL_TESTVECTOR;
         }
 
+        /* the same with an expanded key */
+        if ((err = eax_key_init(&ek, idx, tests[x].key, tests[x].keylen)) != CRYPT_OK) {
+           return err;
+        }
+        len = sizeof(outtag);
+        if ((err = eax_key_encrypt_authenticate_memory(&ek,
+            tests[x].nonce, tests[x].noncelen, tests[x].header, tests[x].headerlen,
+            tests[x].plaintext, tests[x].msglen, outct, outtag, &len)) != CRYPT_OK) {
+           return err;
+        }
+        if (compare_testvector(outtag, len, tests[x].tag, len, "EAX Tag (key)", x) ||
+              compare_testvector(outct, tests[x].msglen, tests[x].ciphertext, tests[x].msglen, "EAX CT (key)", x)) {
+           return CRYPT_FAIL_TESTVECTOR;
+        }
+        if ((err = eax_key_decrypt_verify_memory(&ek,
+             tests[x].nonce, tests[x].noncelen, tests[x].header, tests[x].headerlen,
+             outct, tests[x].msglen, outct, outtag, len, &res)) != CRYPT_OK) {
+            return err;
+        }
+        if ((res != 1) || compare_testvector(outct, tests[x].msglen, tests[x].plaintext, tests[x].msglen, "EAX (key)", x)) {
+           return CRYPT_FAIL_TESTVECTOR;
+        }
+
     }
     return CRYPT_OK;
 #endif /* LTC_TEST */
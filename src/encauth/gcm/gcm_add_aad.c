@@ -17,13 +17,13 @@
 
 /**
   Add AAD to the GCM state
-  @param gcm       The GCM state
+  @param gcm       The GCM message state
   @param adata     The additional authentication data to add to the GCM state
   @param adatalen  The length of the AAD data.
   @return CRYPT_OK on success
  */
-int gcm_add_aad(gcm_state *gcm,
-               const unsigned char *adata,  unsigned long adatalen)
+int gcm_msg_add_aad(gcm_msg *gcm,
+                    const unsigned char *adata,  unsigned long adatalen)
 {
    unsigned long x;
    int           err;
@@ -31,7 +31,8 @@ int gcm_add_aad(gcm_state *gcm,
    unsigned long y;
 #endif
 
-   LTC_ARGCHK(gcm    != NULL);
+   LTC_ARGCHK(gcm      != NULL);
+   LTC_ARGCHK(gcm->key != NULL);
    if (adatalen > 0) {
       LTC_ARGCHK(adata  != NULL);
    }
@@ -40,7 +41,7 @@ int gcm_add_aad(gcm_state *gcm,
       return CRYPT_INVALID_ARG;
    }
 
-   if ((err = cipher_is_valid(gcm->cipher)) != CRYPT_OK) {
+   if ((err = cipher_is_valid(gcm->key->cipher)) != CRYPT_OK) {
       return err;
    }
 
@@ -55,7 +56,7 @@ int gcm_add_aad(gcm_state *gcm,
          }
          if (gcm->buflen) {
             gcm->totlen += gcm->buflen * CONST64(8);
-            gcm_mult_h(gcm, gcm->X);
+            gcm_key_mult_h(gcm->key, gcm->X);
          }
 
          /* mix in the length */
@@ -64,7 +65,7 @@ int gcm_add_aad(gcm_state *gcm,
          for (x = 0; x < 16; x++) {
              gcm->X[x] ^= gcm->buf[x];
          }
-         gcm_mult_h(gcm, gcm->X);
+         gcm_key_mult_h(gcm->key, gcm->X);
 
          /* copy counter out */
          XMEMCPY(gcm->Y, gcm->X, 16);
@@ -88,18 +89,25 @@ int gcm_add_aad(gcm_state *gcm,
    }
 
    x = 0;
+#ifdef LTC_GCM_PCLMUL
+   if (gcm->buflen == 0 && (gcm->key->simd & LTC_GCM_SIMD_HPOW) && gcm_pclmul_is_supported()) {
+      x = adatalen & ~15uL;
+      gcm_pclmul_ghash(gcm->X, gcm->key->Hpow[0], adata, x);
+      gcm->totlen += (ulong64)x * CONST64(8);
+   }
+#endif
 #ifdef LTC_FAST
    if (gcm->buflen == 0) {
-      for (x = 0; x < (adatalen & ~15); x += 16) {
+      for (; x < (adatalen & ~15); x += 16) {
           for (y = 0; y < 16; y += sizeof(LTC_FAST_TYPE)) {
               *(LTC_FAST_TYPE_PTR_CAST(&gcm->X[y])) ^= *(LTC_FAST_TYPE_PTR_CAST(&adata[x + y]));
           }
-          gcm_mult_h(gcm, gcm->X);
+          gcm_key_mult_h(gcm->key, gcm->X);
           gcm->totlen += 128;
       }
-      adata += x;
    }
 #endif
+   adata += x;
 
 
    /* start adding AAD data to the state */
@@ -108,7 +116,7 @@ int gcm_add_aad(gcm_state *gcm,
 
       if (gcm->buflen == 16) {
          /* GF mult it */
-         gcm_mult_h(gcm, gcm->X);
+         gcm_key_mult_h(gcm->key, gcm->X);
          gcm->buflen = 0;
          gcm->totlen += 128;
       }
@@ -116,6 +124,22 @@ int gcm_add_aad(gcm_state *gcm,
 
    return CRYPT_OK;
 }
+
+/**
+  Add AAD to the GCM state
+  @param gcm       The GCM state
+  @param adata     The additional authentication data to add to the GCM state
+  @param adatalen  The length of the AAD data.
+  @return CRYPT_OK on success
+ */
+int gcm_add_aad(gcm_state *gcm,
+               const unsigned char *adata,  unsigned long adatalen)
+{
+   LTC_ARGCHK(gcm != NULL);
+   gcm->msg.key = &gcm->key;
+   return gcm_msg_add_aad(&gcm->msg, adata, adatalen);
+}
+
 #endif
 
 
@@ -17,18 +17,19 @@
 
 /**
   Add IV data to the GCM state
-  @param gcm    The GCM state
+  @param gcm    The GCM message state
   @param IV     The initial value data to add
   @param IVlen  The length of the IV
   @return CRYPT_OK on success
  */
-int gcm_add_iv(gcm_state *gcm,
-               const unsigned char *IV,     unsigned long IVlen)
+int gcm_msg_add_iv(gcm_msg *gcm,
+                   const unsigned char *IV,     unsigned long IVlen)
 {
    unsigned long x, y;
    int           err;
 
    LTC_ARGCHK(gcm != NULL);
+   LTC_ARGCHK(gcm->key != NULL);
    if (IVlen > 0) {
       LTC_ARGCHK(IV  != NULL);
    }
@@ -42,7 +43,7 @@ int gcm_add_iv(gcm_state *gcm,
       return CRYPT_INVALID_ARG;
    }
 
-   if ((err = cipher_is_valid(gcm->cipher)) != CRYPT_OK) {
+   if ((err = cipher_is_valid(gcm->key->cipher)) != CRYPT_OK) {
       return err;
    }
 
@@ -59,7 +60,7 @@ int gcm_add_iv(gcm_state *gcm,
           for (y = 0; y < 16; y += sizeof(LTC_FAST_TYPE)) {
               *(LTC_FAST_TYPE_PTR_CAST(&gcm->X[y])) ^= *(LTC_FAST_TYPE_PTR_CAST(&IV[x + y]));
           }
-          gcm_mult_h(gcm, gcm->X);
+          gcm_key_mult_h(gcm->key, gcm->X);
           gcm->totlen += 128;
       }
       IV += x;
@@ -75,7 +76,7 @@ int gcm_add_iv(gcm_state *gcm,
          for (y = 0; y < 16; y++) {
              gcm->X[y] ^= gcm->buf[y];
          }
-         gcm_mult_h(gcm, gcm->X);
+         gcm_key_mult_h(gcm->key, gcm->X);
          gcm->buflen = 0;
          gcm->totlen += 128;
       }
@@ -84,6 +85,21 @@ int gcm_add_iv(gcm_state *gcm,
    return CRYPT_OK;
 }
 
+/**
+  Add IV data to the GCM state
+  @param gcm    The GCM state
+  @param IV     The initial value data to add
+  @param IVlen  The length of the IV
+  @return CRYPT_OK on success
+ */
+int gcm_add_iv(gcm_state *gcm,
+               const unsigned char *IV,     unsigned long IVlen)
+{
+   LTC_ARGCHK(gcm != NULL);
+   gcm->msg.key = &gcm->key;
+   return gcm_msg_add_iv(&gcm->msg, IV, IVlen);
+}
+
 #endif
 
 
@@ -0,0 +1,295 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ */
+
+/**
+   @file gcm_aesni.c
+   AES-GCM with the AES-NI and PCLMULQDQ instructions of x86-64 CPUs
+
+   Encryption and authentication are done in a single pass over the data:
+   while the AES rounds of eight counter blocks are computed, the carry-less
+   multiplications of the previous eight ciphertext blocks are interleaved
+   with them, so the AES and the multiplier units are busy at the same time.
+   The VAES code of gcm_vaes.c is used instead on CPUs supporting it.
+*/
+#include "tomcrypt_private.h"
+
+#ifdef LTC_GCM_AESNI
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <wmmintrin.h>
+#include <tmmintrin.h>
+#endif
+#include "gcm_clmul.h"
+
+#define AESNI_TARGET LTC_ATTRIBUTE_TARGET("aes,pclmul,ssse3")
+
+#define AESNI_LOAD(p)      _mm_loadu_si128((const __m128i *)(const void *)(p))
+#define AESNI_STORE(p, v)  _mm_storeu_si128((__m128i *)(void *)(p), (v))
+
+/**
+  Check whether the CPU supports the AES-NI code path
+  @return 1 if supported, 0 otherwise
+*/
+int gcm_aesni_is_supported(void)
+{
+   return ltc_cpu_has(LTC_CPU_AESNI | LTC_CPU_PCLMUL | LTC_CPU_SSSE3);
+}
+
+AESNI_TARGET
+static int _ctr_ghash(const symmetric_key *skey, unsigned char *Y, unsigned char *X, const unsigned char *Hpow,
+                      const unsigned char *in, unsigned char *out, unsigned long len, int direction)
+{
+   __m128i K[15], c[8], g[8], bswap32, one, x, y, lo, mid, hi;
+   unsigned char buf[2][128];
+   unsigned long n, k;
+   int i, Nr, pending;
+
+   Nr = skey->rijndael.Nr;
+   if (Nr != 10 && Nr != 12 && Nr != 14) {
+      return CRYPT_INVALID_ROUNDS;
+   }
+   /* the key schedule is stored as big-endian words */
+   bswap32 = _mm_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+   for (i = 0; i <= Nr; i++) {
+      K[i] = _mm_shuffle_epi8(AESNI_LOAD(skey->rijndael.eK + 4 * i), bswap32);
+   }
+
+   x = _reflect(AESNI_LOAD(X));
+   /* reflected, the 32-bit counter is the lowest dword and wraps around on its own */
+   y = _reflect(AESNI_LOAD(Y));
+   one = _mm_setr_epi32(1, 0, 0, 0);
+   lo = mid = hi = _mm_setzero_si128();
+   pending = 0;
+
+   while (len > 0) {
+      n = (len < 128) ? len : 128;
+
+      for (k = 0; k < 8; k++) {
+         c[k] = _mm_xor_si128(_reflect(y), K[0]);
+         y = _mm_add_epi32(y, one);
+      }
+      /* the GHASH of the previous eight blocks in the first eight rounds */
+      for (i = 1; i < Nr; i++) {
+         for (k = 0; k < 8; k++) {
+            c[k] = _mm_aesenc_si128(c[k], K[i]);
+         }
+         if (pending && i <= 8) {
+            _mul_add(g[i - 1], AESNI_LOAD(Hpow + 16 * (7 + i)), &lo, &mid, &hi);
+         }
+      }
+      for (k = 0; k < 8; k++) {
+         c[k] = _mm_aesenclast_si128(c[k], K[Nr]);
+      }
+      if (pending) {
+         x = _fold(lo, mid, hi);
+         lo = mid = hi = _mm_setzero_si128();
+         pending = 0;
+      }
+
+      if (n == 128) {
+         for (k = 0; k < 8; k++) {
+            g[k] = AESNI_LOAD(in + 16 * k);
+            c[k] = _mm_xor_si128(c[k], g[k]);
+            AESNI_STORE(out + 16 * k, c[k]);
+            g[k] = _reflect(direction == GCM_ENCRYPT ? c[k] : g[k]);
+         }
+         g[0] = _mm_xor_si128(g[0], x);
+         pending = 1;
+      } else {
+         /* the last blocks, GHASH them right away with H^n ... H^1 */
+         zeromem(buf, sizeof(buf));
+         XMEMCPY(buf[0], in, n);
+         for (k = 0; k < 8; k++) {
+            AESNI_STORE(buf[1] + 16 * k, _mm_xor_si128(c[k], AESNI_LOAD(buf[0] + 16 * k)));
+         }
+         XMEMCPY(out, buf[1], n);
+         y = _mm_sub_epi32(y, _mm_cvtsi32_si128((int)(8 - (n + 15) / 16)));
+         if (direction == GCM_ENCRYPT) {
+            zeromem(buf[1] + n, sizeof(buf[1]) - n);
+         }
+         for (k = 0; k * 16 < n; k++) {
+            g[k] = _reflect(AESNI_LOAD(buf[direction == GCM_ENCRYPT ? 1 : 0] + 16 * k));
+            if (k == 0) {
+               g[k] = _mm_xor_si128(g[k], x);
+            }
+            _mul_add(g[k], AESNI_LOAD(Hpow + 16 * (16 - (n + 15) / 16 + k)), &lo, &mid, &hi);
+         }
+         x = _fold(lo, mid, hi);
+      }
+
+      in  += n;
+      out += n;
+      len -= n;
+   }
+
+   if (pending) {
+      for (k = 0; k < 8; k++) {
+         _mul_add(g[k], AESNI_LOAD(Hpow + 16 * (8 + k)), &lo, &mid, &hi);
+      }
+      x = _fold(lo, mid, hi);
+   }
+
+   AESNI_STORE(X, _reflect(x));
+   AESNI_STORE(Y, _reflect(y));
+#ifdef LTC_CLEAN_STACK
+   zeromem(K, sizeof(K));
+   zeromem(c, sizeof(c));
+   zeromem(buf, sizeof(buf));
+#endif
+   return CRYPT_OK;
+}
+
+/**
+  Encrypt or decrypt in CTR mode (32-bit counter) and GHASH the ciphertext
+  @param skey       The AES key as scheduled
+  @param Y          [in/out] The counter of the first block, the counter of the next block on output
+  @param X          [in/out] The GHASH accumulator
+  @param Hpow       The powers of H
+  @param in         The input
+  @param out        [out] The output, may be the same buffer as in
+  @param len        The length of the data, a partial last block is padded with zeros for GHASH
+  @param direction  GCM_ENCRYPT or GCM_DECRYPT
+  @return CRYPT_OK if successful
+*/
+int gcm_aesni_ctr_ghash(const symmetric_key *skey, unsigned char *Y, unsigned char *X, const unsigned char *Hpow,
+                        const unsigned char *in, unsigned char *out, unsigned long len, int direction)
+{
+#ifdef LTC_GCM_VAES
+   if (gcm_vaes_is_supported()) {
+      return gcm_vaes_ctr_ghash(skey, Y, X, Hpow, in, out, len, direction);
+   }
+#endif
+   return _ctr_ghash(skey, Y, X, Hpow, in, out, len, direction);
+}
+
+/**
+  Process an entire AES-GCM packet in one call, see gcm_memory()
+  @return CRYPT_OK on success
+*/
+int gcm_aesni_memory(const unsigned char *key,    unsigned long keylen,
+                     const unsigned char *IV,     unsigned long IVlen,
+                     const unsigned char *adata,  unsigned long adatalen,
+                           unsigned char *pt,     unsigned long ptlen,
+                           unsigned char *ct,
+                           unsigned char *tag,    unsigned long *taglen,
+                                     int direction)
+{
+   symmetric_key skey;
+   unsigned char Hpow[16][16], X[16], Y[16], Y_0[16], T[16];
+   unsigned long x;
+   int y, err;
+
+   LTC_ARGCHK(key    != NULL);
+   LTC_ARGCHK(IV     != NULL);
+   LTC_ARGCHK(tag    != NULL);
+   LTC_ARGCHK(taglen != NULL);
+   if (adatalen > 0) {
+      LTC_ARGCHK(adata != NULL);
+   }
+   if (ptlen > 0) {
+      LTC_ARGCHK(pt != NULL);
+      LTC_ARGCHK(ct != NULL);
+   }
+
+   if (direction != GCM_ENCRYPT && direction != GCM_DECRYPT) {
+      return CRYPT_INVALID_ARG;
+   }
+   /* IV length must be > 0 */
+   if (IVlen == 0) {
+      return CRYPT_ERROR;
+   }
+   /* 0xFFFFFFFE0 = ((2^39)-256)/8 */
+   if ((ulong64)ptlen >= CONST64(0xFFFFFFFE0)) {
+      return CRYPT_INVALID_ARG;
+   }
+
+   if ((err = aesni_setup(key, (int)keylen, 0, &skey)) != CRYPT_OK) {
+      return err;
+   }
+
+   /* H = E(0) */
+   zeromem(T, 16);
+   if ((err = aesni_ecb_encrypt(T, T, 1, &skey)) != CRYPT_OK) {
+      goto LBL_ERR;
+   }
+   gcm_pclmul_init(Hpow[0], T);
+
+   /* Y_0 */
+   if (IVlen == 12) {
+      XMEMCPY(Y, IV, 12);
+      Y[12] = 0;
+      Y[13] = 0;
+      Y[14] = 0;
+      Y[15] = 1;
+   } else {
+      zeromem(Y, 16);
+      gcm_pclmul_ghash(Y, Hpow[0], IV, IVlen);
+      zeromem(T, 8);
+      STORE64H((ulong64)IVlen * CONST64(8), T + 8);
+      gcm_pclmul_ghash(Y, Hpow[0], T, 16);
+   }
+   XMEMCPY(Y_0, Y, 16);
+
+   zeromem(X, 16);
+   gcm_pclmul_ghash(X, Hpow[0], adata, adatalen);
+
+   /* increment counter */
+   for (y = 15; y >= 12; y--) {
+       if (++Y[y] & 255) { break; }
+   }
+   if (direction == GCM_ENCRYPT) {
+      err = gcm_aesni_ctr_ghash(&skey, Y, X, Hpow[0], pt, ct, ptlen, direction);
+   } else {
+      err = gcm_aesni_ctr_ghash(&skey, Y, X, Hpow[0], ct, pt, ptlen, direction);
+   }
+   if (err != CRYPT_OK) {
+      goto LBL_ERR;
+   }
+
+   /* length block */
+   STORE64H((ulong64)adatalen * CONST64(8), T);
+   STORE64H((ulong64)ptlen * CONST64(8), T + 8);
+   gcm_pclmul_ghash(X, Hpow[0], T, 16);
+
+   /* tag = E(Y_0) xor X */
+   if ((err = aesni_ecb_encrypt(Y_0, T, 1, &skey)) != CRYPT_OK) {
+      goto LBL_ERR;
+   }
+   for (x = 0; x < 16; x++) {
+      T[x] ^= X[x];
+   }
+
+   if (direction == GCM_ENCRYPT) {
+      for (x = 0; x < 16 && x < *taglen; x++) {
+         tag[x] = T[x];
+      }
+      *taglen = x;
+   } else if (*taglen != 16 || XMEM_NEQ(T, tag, 16) != 0) {
+      err = CRYPT_ERROR;
+   }
+
+LBL_ERR:
+#ifdef LTC_CLEAN_STACK
+   zeromem(&skey, sizeof(skey));
+   zeromem(Hpow, sizeof(Hpow));
+   zeromem(X, sizeof(X));
+   zeromem(Y, sizeof(Y));
+   zeromem(Y_0, sizeof(Y_0));
+   zeromem(T, sizeof(T));
+#endif
+   return err;
+}
+
+#endif
+
+/* ref:         $Format:%D$ */
+/* git commit:  $Format:%H$ */
+/* commit time: $Format:%ai$ */
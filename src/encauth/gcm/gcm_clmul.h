@@ -0,0 +1,88 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ */
+
+/**
+   @file gcm_clmul.h
+   GHASH helpers shared by gcm_pclmul.c, gcm_aesni.c and gcm_vaes.c
+
+   Include after <wmmintrin.h> and <tmmintrin.h> (or <immintrin.h>).  The
+   helpers only need PCLMULQDQ and SSSE3, so they are inlined into the
+   functions of the including file whose targets are a superset of that.
+*/
+
+#ifndef GCM_CLMUL_H_
+#define GCM_CLMUL_H_
+
+#define GCM_CLMUL_TARGET LTC_ATTRIBUTE_TARGET("pclmul,ssse3")
+
+GCM_CLMUL_TARGET
+static LTC_INLINE __m128i _reflect(__m128i x)
+{
+   return _mm_shuffle_epi8(x, _mm_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0));
+}
+
+/* shift the 256 bit product [hi:lo] left by one bit and reduce it modulo the GCM polynomial */
+GCM_CLMUL_TARGET
+static LTC_INLINE __m128i _reduce(__m128i lo, __m128i hi)
+{
+   __m128i t1, t2, t3;
+
+   t1 = _mm_srli_epi32(lo, 31);
+   t2 = _mm_srli_epi32(hi, 31);
+   lo = _mm_slli_epi32(lo, 1);
+   hi = _mm_slli_epi32(hi, 1);
+   t3 = _mm_srli_si128(t1, 12);
+   t2 = _mm_slli_si128(t2, 4);
+   t1 = _mm_slli_si128(t1, 4);
+   lo = _mm_or_si128(lo, t1);
+   hi = _mm_or_si128(hi, t2);
+   hi = _mm_or_si128(hi, t3);
+
+   t1 = _mm_slli_epi32(lo, 31);
+   t2 = _mm_slli_epi32(lo, 30);
+   t3 = _mm_slli_epi32(lo, 25);
+   t1 = _mm_xor_si128(t1, t2);
+   t1 = _mm_xor_si128(t1, t3);
+   t2 = _mm_srli_si128(t1, 4);
+   t1 = _mm_slli_si128(t1, 12);
+   lo = _mm_xor_si128(lo, t1);
+
+   t1 = _mm_srli_epi32(lo, 1);
+   t3 = _mm_srli_epi32(lo, 2);
+   t1 = _mm_xor_si128(t1, t3);
+   t3 = _mm_srli_epi32(lo, 7);
+   t1 = _mm_xor_si128(t1, t3);
+   t1 = _mm_xor_si128(t1, t2);
+   lo = _mm_xor_si128(lo, t1);
+   return _mm_xor_si128(hi, lo);
+}
+
+/* add the unreduced product a * b to [hi:mid:lo] */
+GCM_CLMUL_TARGET
+static LTC_INLINE void _mul_add(__m128i a, __m128i b, __m128i *lo, __m128i *mid, __m128i *hi)
+{
+   *lo  = _mm_xor_si128(*lo, _mm_clmulepi64_si128(a, b, 0x00));
+   *hi  = _mm_xor_si128(*hi, _mm_clmulepi64_si128(a, b, 0x11));
+   *mid = _mm_xor_si128(*mid, _mm_clmulepi64_si128(a, b, 0x01));
+   *mid = _mm_xor_si128(*mid, _mm_clmulepi64_si128(a, b, 0x10));
+}
+
+GCM_CLMUL_TARGET
+static LTC_INLINE __m128i _fold(__m128i lo, __m128i mid, __m128i hi)
+{
+   lo = _mm_xor_si128(lo, _mm_slli_si128(mid, 8));
+   hi = _mm_xor_si128(hi, _mm_srli_si128(mid, 8));
+   return _reduce(lo, hi);
+}
+
+#endif
+
+/* ref:         $Format:%D$ */
+/* git commit:  $Format:%H$ */
+/* commit time: $Format:%ai$ */
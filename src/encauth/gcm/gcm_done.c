@@ -16,19 +16,20 @@
 #ifdef LTC_GCM_MODE
 
 /**
-  Terminate a GCM stream
-  @param gcm     The GCM state
+  Terminate a GCM message
+  @param gcm     The GCM message state
   @param tag     [out] The destination for the MAC tag
   @param taglen  [in/out]  The length of the MAC tag
   @return CRYPT_OK on success
  */
-int gcm_done(gcm_state *gcm,
-                     unsigned char *tag,    unsigned long *taglen)
+int gcm_msg_done(gcm_msg *gcm,
+                       unsigned char *tag,    unsigned long *taglen)
 {
    unsigned long x;
    int err;
 
-   LTC_ARGCHK(gcm     != NULL);
+   LTC_ARGCHK(gcm      != NULL);
+   LTC_ARGCHK(gcm->key != NULL);
    LTC_ARGCHK(tag     != NULL);
    LTC_ARGCHK(taglen  != NULL);
 
@@ -36,18 +37,18 @@ int gcm_done(gcm_state *gcm,
       return CRYPT_INVALID_ARG;
    }
 
-   if ((err = cipher_is_valid(gcm->cipher)) != CRYPT_OK) {
+   if ((err = cipher_is_valid(gcm->key->cipher)) != CRYPT_OK) {
       return err;
    }
 
    if (gcm->mode == LTC_GCM_MODE_IV) {
       /* let's process the IV */
-      if ((err = gcm_add_aad(gcm, NULL, 0)) != CRYPT_OK) return err;
+      if ((err = gcm_msg_add_aad(gcm, NULL, 0)) != CRYPT_OK) return err;
    }
 
    if (gcm->mode == LTC_GCM_MODE_AAD) {
       /* let's process the AAD */
-      if ((err = gcm_process(gcm, NULL, 0, NULL, 0)) != CRYPT_OK) return err;
+      if ((err = gcm_msg_process(gcm, NULL, 0, NULL, 0)) != CRYPT_OK) return err;
    }
 
    if (gcm->mode != LTC_GCM_MODE_TEXT) {
@@ -57,7 +58,7 @@ int gcm_done(gcm_state *gcm,
    /* handle remaining ciphertext */
    if (gcm->buflen) {
       gcm->pttotlen += gcm->buflen * CONST64(8);
-      gcm_mult_h(gcm, gcm->X);
+      gcm_key_mult_h(gcm->key, gcm->X);
    }
 
    /* length */
@@ -66,10 +67,10 @@ int gcm_done(gcm_state *gcm,
    for (x = 0; x < 16; x++) {
        gcm->X[x] ^= gcm->buf[x];
    }
-   gcm_mult_h(gcm, gcm->X);
+   gcm_key_mult_h(gcm->key, gcm->X);
 
    /* encrypt original counter */
-   if ((err = cipher_descriptor[gcm->cipher].ecb_encrypt(gcm->Y_0, gcm->buf, &gcm->K)) != CRYPT_OK) {
+   if ((err = cipher_descriptor[gcm->key->cipher].ecb_encrypt(gcm->Y_0, gcm->buf, &gcm->key->K)) != CRYPT_OK) {
       return err;
    }
    for (x = 0; x < 16 && x < *taglen; x++) {
@@ -77,11 +78,42 @@ int gcm_done(gcm_state *gcm,
    }
    *taglen = x;
 
-   cipher_descriptor[gcm->cipher].done(&gcm->K);
+   return CRYPT_OK;
+}
+
+/**
+  Terminate a GCM stream
+  @param gcm     The GCM state
+  @param tag     [out] The destination for the MAC tag
+  @param taglen  [in/out]  The length of the MAC tag
+  @return CRYPT_OK on success
+ */
+int gcm_done(gcm_state *gcm,
+                     unsigned char *tag,    unsigned long *taglen)
+{
+   int err;
+
+   LTC_ARGCHK(gcm != NULL);
+
+   gcm->msg.key = &gcm->key;
+   if ((err = gcm_msg_done(&gcm->msg, tag, taglen)) != CRYPT_OK) {
+      return err;
+   }
+   gcm_key_done(&gcm->key);
 
    return CRYPT_OK;
 }
 
+/**
+  Free an expanded GCM key
+  @param gcm     The GCM key
+ */
+void gcm_key_done(gcm_key *gcm)
+{
+   LTC_ARGCHKVD(gcm != NULL);
+   cipher_descriptor[gcm->cipher].done(&gcm->K);
+}
+
 #endif
 
 
@@ -56,7 +56,105 @@ const unsigned char gcm_shift_table[256*2] = {
 
 #if defined(LTC_GCM_MODE) || defined(LRW_MODE)
 
-#ifndef LTC_FAST
+#if defined(LTC_GCM_CTMUL)
+
+/* carry-less multiplication of the lower 64 bits, with integer multiplications
+ * and 3 zero bits between the data bits so that the carries don't propagate
+ * (from BearSSL's ghash_ctmul64) */
+static LTC_INLINE ulong64 _bmul64(ulong64 x, ulong64 y)
+{
+   ulong64 x0, x1, x2, x3, y0, y1, y2, y3, z0, z1, z2, z3;
+
+   x0 = x & CONST64(0x1111111111111111);
+   x1 = x & CONST64(0x2222222222222222);
+   x2 = x & CONST64(0x4444444444444444);
+   x3 = x & CONST64(0x8888888888888888);
+   y0 = y & CONST64(0x1111111111111111);
+   y1 = y & CONST64(0x2222222222222222);
+   y2 = y & CONST64(0x4444444444444444);
+   y3 = y & CONST64(0x8888888888888888);
+   z0 = (x0 * y0) ^ (x1 * y3) ^ (x2 * y2) ^ (x3 * y1);
+   z1 = (x0 * y1) ^ (x1 * y0) ^ (x2 * y3) ^ (x3 * y2);
+   z2 = (x0 * y2) ^ (x1 * y1) ^ (x2 * y0) ^ (x3 * y3);
+   z3 = (x0 * y3) ^ (x1 * y2) ^ (x2 * y1) ^ (x3 * y0);
+   z0 &= CONST64(0x1111111111111111);
+   z1 &= CONST64(0x2222222222222222);
+   z2 &= CONST64(0x4444444444444444);
+   z3 &= CONST64(0x8888888888888888);
+   return z0 | z1 | z2 | z3;
+}
+
+/* reverse the bits */
+static LTC_INLINE ulong64 _rev64(ulong64 x)
+{
+   x = ((x & CONST64(0x5555555555555555)) <<  1) | ((x >>  1) & CONST64(0x5555555555555555));
+   x = ((x & CONST64(0x3333333333333333)) <<  2) | ((x >>  2) & CONST64(0x3333333333333333));
+   x = ((x & CONST64(0x0F0F0F0F0F0F0F0F)) <<  4) | ((x >>  4) & CONST64(0x0F0F0F0F0F0F0F0F));
+   x = ((x & CONST64(0x00FF00FF00FF00FF)) <<  8) | ((x >>  8) & CONST64(0x00FF00FF00FF00FF));
+   x = ((x & CONST64(0x0000FFFF0000FFFF)) << 16) | ((x >> 16) & CONST64(0x0000FFFF0000FFFF));
+   return (x << 32) | (x >> 32);
+}
+
+/**
+  GCM GF multiplier (internal use only)  constant time, no tables
+  @param a   First value
+  @param b   Second value
+  @param c   Destination for a * b
+ */
+void gcm_gf_mult(const unsigned char *a, const unsigned char *b, unsigned char *c)
+{
+   ulong64 a0, a1, a2, a0r, a1r, a2r, b0, b1, b2, b0r, b1r, b2r;
+   ulong64 z0, z1, z2, z0h, z1h, z2h, v0, v1, v2, v3;
+
+   /* the bits are reversed, the carry-less products of the reversed
+    * values give the upper halves (Karatsuba in both cases) */
+   LOAD64H(a1, a);
+   LOAD64H(a0, a + 8);
+   LOAD64H(b1, b);
+   LOAD64H(b0, b + 8);
+   a0r = _rev64(a0);
+   a1r = _rev64(a1);
+   a2  = a0 ^ a1;
+   a2r = a0r ^ a1r;
+   b0r = _rev64(b0);
+   b1r = _rev64(b1);
+   b2  = b0 ^ b1;
+   b2r = b0r ^ b1r;
+
+   z0  = _bmul64(a0, b0);
+   z1  = _bmul64(a1, b1);
+   z2  = _bmul64(a2, b2);
+   z0h = _bmul64(a0r, b0r);
+   z1h = _bmul64(a1r, b1r);
+   z2h = _bmul64(a2r, b2r);
+   z2  ^= z0 ^ z1;
+   z2h ^= z0h ^ z1h;
+   z0h = _rev64(z0h) >> 1;
+   z1h = _rev64(z1h) >> 1;
+   z2h = _rev64(z2h) >> 1;
+
+   /* the 256 bit product [v3:v2:v1:v0] */
+   v0 = z0;
+   v1 = z0h ^ z2;
+   v2 = z1 ^ z2h;
+   v3 = z1h;
+
+   v3 = (v3 << 1) | (v2 >> 63);
+   v2 = (v2 << 1) | (v1 >> 63);
+   v1 = (v1 << 1) | (v0 >> 63);
+   v0 = (v0 << 1);
+
+   /* reduce */
+   v2 ^= v0 ^ (v0 >> 1) ^ (v0 >> 2) ^ (v0 >> 7);
+   v1 ^= (v0 << 63) ^ (v0 << 62) ^ (v0 << 57);
+   v3 ^= v1 ^ (v1 >> 1) ^ (v1 >> 2) ^ (v1 >> 7);
+   v2 ^= (v1 << 63) ^ (v1 << 62) ^ (v1 << 57);
+
+   STORE64H(v3, c);
+   STORE64H(v2, c + 8);
+}
+
+#elif !defined(LTC_FAST)
 /* right shift */
 static void _gcm_rightshift(unsigned char *a)
 {
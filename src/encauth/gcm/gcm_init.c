@@ -16,21 +16,25 @@
 #ifdef LTC_GCM_MODE
 
 /**
-  Initialize a GCM state
-  @param gcm     The GCM state to initialize
+  Expand a GCM key, the result can be used by several gcm_msg states at once
+  @param gcm     The GCM key to initialize
   @param cipher  The index of the cipher to use
   @param key     The secret key
   @param keylen  The length of the secret key
   @return CRYPT_OK on success
  */
-int gcm_init(gcm_state *gcm, int cipher,
-             const unsigned char *key,  int keylen)
+int gcm_key_init(gcm_key *gcm, int cipher,
+                 const unsigned char *key, int keylen)
 {
    int           err;
    unsigned char B[16];
 #ifdef LTC_GCM_TABLES
    int           x, y, z, t;
 #endif
+#ifdef LTC_GCM_TABLES_4BIT
+   int           x, y;
+   ulong64       vh, vl, m;
+#endif
 
    LTC_ARGCHK(gcm != NULL);
    LTC_ARGCHK(key != NULL);
@@ -60,15 +64,45 @@ int gcm_init(gcm_state *gcm, int cipher,
       return err;
    }
 
-   /* setup state */
-   zeromem(gcm->buf, sizeof(gcm->buf));
-   zeromem(gcm->X,   sizeof(gcm->X));
    gcm->cipher   = cipher;
-   gcm->mode     = LTC_GCM_MODE_IV;
-   gcm->ivmode   = 0;
-   gcm->buflen   = 0;
-   gcm->totlen   = 0;
-   gcm->pttotlen = 0;
+
+#ifdef LTC_GCM_PCLMUL
+   gcm->simd = 0;
+#ifdef LTC_RIJNDAEL
+   if (cipher_descriptor[cipher].setup == rijndael_setup || cipher_descriptor[cipher].setup == rijndael_enc_setup) {
+      gcm->simd |= LTC_GCM_SIMD_AES;
+   }
+#endif
+   if (gcm_pclmul_is_supported()) {
+      gcm_pclmul_init(gcm->Hpow[0], gcm->H);
+      gcm->simd |= LTC_GCM_SIMD_HPOW;
+      /* the tables aren't needed */
+      return CRYPT_OK;
+   }
+#endif
+
+#ifdef LTC_GCM_TABLES_4BIT
+   /* i * H for the 4-bit values i, bit 3 of i is the coefficient of x^0 */
+   LOAD64H(vh, gcm->H);
+   LOAD64H(vl, gcm->H + 8);
+   gcm->HH[0] = gcm->HL[0] = 0;
+   gcm->HH[8] = vh;
+   gcm->HL[8] = vl;
+   for (x = 4; x > 0; x >>= 1) {
+      /* multiply by x */
+      m  = CONST64(0) - (vl & 1);
+      vl = (vh << 63) | (vl >> 1);
+      vh = (vh >> 1) ^ (m & CONST64(0xE100000000000000));
+      gcm->HH[x] = vh;
+      gcm->HL[x] = vl;
+   }
+   for (x = 2; x <= 8; x *= 2) {
+      for (y = 1; y < x; y++) {
+         gcm->HH[x + y] = gcm->HH[x] ^ gcm->HH[y];
+         gcm->HL[x + y] = gcm->HL[x] ^ gcm->HL[y];
+      }
+   }
+#endif
 
 #ifdef LTC_GCM_TABLES
    /* setup tables */
@@ -98,6 +132,27 @@ int gcm_init(gcm_state *gcm, int cipher,
    return CRYPT_OK;
 }
 
+/**
+  Initialize a GCM state
+  @param gcm     The GCM state to initialize
+  @param cipher  The index of the cipher to use
+  @param key     The secret key
+  @param keylen  The length of the secret key
+  @return CRYPT_OK on success
+ */
+int gcm_init(gcm_state *gcm, int cipher,
+             const unsigned char *key,  int keylen)
+{
+   int err;
+
+   LTC_ARGCHK(gcm != NULL);
+
+   if ((err = gcm_key_init(&gcm->key, cipher, key, keylen)) != CRYPT_OK) {
+      return err;
+   }
+   return gcm_msg_init(&gcm->msg, &gcm->key);
+}
+
 #endif
 
 /* ref:         $Format:%D$ */
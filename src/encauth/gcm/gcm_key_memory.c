@@ -0,0 +1,90 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ */
+
+/**
+   @file gcm_key_memory.c
+   GCM implementation, process a packet with an expanded key
+*/
+#include "tomcrypt_private.h"
+
+#ifdef LTC_GCM_MODE
+
+/**
+  Process an entire GCM packet in one call with an expanded key.
+  The key isn't modified, so several threads can use the same key at once.
+  @param key               The expanded key (see gcm_key_init())
+  @param IV                The initialization vector
+  @param IVlen             The length of the initialization vector
+  @param adata             The additional authentication data (header)
+  @param adatalen          The length of the adata
+  @param pt                The plaintext
+  @param ptlen             The length of the plaintext (ciphertext length is the same)
+  @param ct                The ciphertext
+  @param tag               [out] The MAC tag
+  @param taglen            [in/out] The MAC tag length
+  @param direction         Encrypt or Decrypt mode (GCM_ENCRYPT or GCM_DECRYPT)
+  @return CRYPT_OK on success
+ */
+int gcm_key_memory(const gcm_key       *key,
+                   const unsigned char *IV,     unsigned long IVlen,
+                   const unsigned char *adata,  unsigned long adatalen,
+                         unsigned char *pt,     unsigned long ptlen,
+                         unsigned char *ct,
+                         unsigned char *tag,    unsigned long *taglen,
+                                   int direction)
+{
+   gcm_msg       msg;
+   unsigned char buf[16];
+   unsigned long buflen = sizeof(buf);
+   int           err;
+
+   LTC_ARGCHK(key    != NULL);
+   LTC_ARGCHK(tag    != NULL);
+   LTC_ARGCHK(taglen != NULL);
+
+   if (direction != GCM_ENCRYPT && direction != GCM_DECRYPT) {
+      return CRYPT_INVALID_ARG;
+   }
+
+   if ((err = gcm_msg_init(&msg, key)) != CRYPT_OK) {
+      goto LBL_ERR;
+   }
+   if ((err = gcm_msg_add_iv(&msg, IV, IVlen)) != CRYPT_OK) {
+      goto LBL_ERR;
+   }
+   if ((err = gcm_msg_add_aad(&msg, adata, adatalen)) != CRYPT_OK) {
+      goto LBL_ERR;
+   }
+   if ((err = gcm_msg_process(&msg, pt, ptlen, ct, direction)) != CRYPT_OK) {
+      goto LBL_ERR;
+   }
+   if (direction == GCM_ENCRYPT) {
+      err = gcm_msg_done(&msg, tag, taglen);
+   } else {
+      if ((err = gcm_msg_done(&msg, buf, &buflen)) != CRYPT_OK) {
+         goto LBL_ERR;
+      }
+      if (buflen != *taglen || XMEM_NEQ(buf, tag, buflen) != 0) {
+         err = CRYPT_ERROR;
+      }
+   }
+
+LBL_ERR:
+#ifdef LTC_CLEAN_STACK
+   zeromem(&msg, sizeof(msg));
+   zeromem(buf, sizeof(buf));
+#endif
+   return err;
+}
+
+#endif
+
+/* ref:         $Format:%D$ */
+/* git commit:  $Format:%H$ */
+/* commit time: $Format:%ai$ */
@@ -50,7 +50,7 @@ int gcm_memory(      int           cipher,
     }
 
     if (cipher_descriptor[cipher].accel_gcm_memory != NULL) {
-       return cipher_descriptor[cipher].accel_gcm_memory
+       err = cipher_descriptor[cipher].accel_gcm_memory
                                           (key,   keylen,
                                            IV,    IVlen,
                                            adata, adatalen,
@@ -58,10 +58,12 @@ int gcm_memory(      int           cipher,
                                            ct,
                                            tag,   taglen,
                                            direction);
+       /* CRYPT_NOP: the accelerator can't be used, e.g. since the CPU lacks the instructions */
+       if (err != CRYPT_NOP) {
+          return err;
+       }
     }
 
-
-
 #ifndef LTC_GCM_TABLES_SSE2
     orig = gcm = XMALLOC(sizeof(*gcm));
 #else
@@ -0,0 +1,303 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ */
+
+/**
+   @file gcm_memory_batch.c
+   GCM implementation, process a batch of packets
+
+   The counter blocks of several packets are encrypted together, so the
+   block cipher can work on many blocks at once even if each packet is only
+   a few blocks long.  The GHASH of each packet is computed afterwards.
+*/
+#include "tomcrypt_private.h"
+
+#ifdef LTC_GCM_MODE
+
+/* the number of counter blocks encrypted at once */
+#define GCM_BATCH_BLOCKS 256
+
+typedef struct {
+   unsigned char        ctr[GCM_BATCH_BLOCKS][16];
+   unsigned char        ks[GCM_BATCH_BLOCKS][16];
+   const symmetric_key *skey[GCM_BATCH_BLOCKS];
+   int                  cipher[GCM_BATCH_BLOCKS];
+} _gcm_batch;
+
+#ifdef LTC_GCM_AESNI
+/* longer packets are faster in the stitched AES-GCM code */
+#define GCM_BATCH_STITCHED 128
+#endif
+
+/* GHASH data, the last block is padded with zeros */
+static void _gcm_batch_ghash(const gcm_key *key, unsigned char *X, const unsigned char *in, unsigned long inlen)
+{
+   unsigned long n, y;
+
+#ifdef LTC_GCM_PCLMUL
+   if ((key->simd & LTC_GCM_SIMD_HPOW) && gcm_pclmul_is_supported()) {
+      gcm_pclmul_ghash(X, key->Hpow[0], in, inlen);
+      return;
+   }
+#endif
+   while (inlen > 0) {
+      n = MIN(inlen, 16);
+      for (y = 0; y < n; y++) {
+         X[y] ^= in[y];
+      }
+      gcm_key_mult_h(key, X);
+      in    += n;
+      inlen -= n;
+   }
+}
+
+static void _gcm_batch_xor(unsigned char *out, const unsigned char *in, const unsigned char *ks, unsigned long len)
+{
+   unsigned long x = 0;
+#ifdef LTC_FAST
+   unsigned long y;
+
+   for (; x < (len & ~15uL); x += 16) {
+      for (y = 0; y < 16; y += sizeof(LTC_FAST_TYPE)) {
+         *(LTC_FAST_TYPE_PTR_CAST(&out[x + y])) = *(LTC_FAST_TYPE_PTR_CAST(&in[x + y])) ^
+                                                  *(LTC_FAST_TYPE_PTR_CAST(&ks[x + y]));
+      }
+   }
+#endif
+   for (; x < len; x++) {
+      out[x] = in[x] ^ ks[x];
+   }
+}
+
+static int _gcm_batch_check(const aead_packet *p, int direction)
+{
+   const gcm_key *key = p->key.gcm;
+   int err;
+
+   if (p->mode != LTC_AEAD_GCM || key == NULL || p->nonce == NULL || p->noncelen == 0 ||
+       p->taglen == 0 || p->taglen > 16 || p->tag == NULL || (p->adatalen > 0 && p->adata == NULL) ||
+       (p->inlen > 0 && (p->in == NULL || p->out == NULL))) {
+      return CRYPT_INVALID_ARG;
+   }
+   if (direction != LTC_ENCRYPT && direction != LTC_DECRYPT) {
+      return CRYPT_INVALID_ARG;
+   }
+   if ((err = cipher_is_valid(key->cipher)) != CRYPT_OK) {
+      return err;
+   }
+   return CRYPT_OK;
+}
+
+/* whether the packet is processed on its own by the stitched AES-GCM code */
+static int _gcm_batch_stitched(const aead_packet *p)
+{
+#ifdef LTC_GCM_AESNI
+   const gcm_key *key = p->key.gcm;
+
+   return p->inlen >= GCM_BATCH_STITCHED && (key->simd & LTC_GCM_SIMD_HPOW) && (key->simd & LTC_GCM_SIMD_AES) &&
+          gcm_aesni_is_supported();
+#else
+   LTC_UNUSED_PARAM(p);
+   return 0;
+#endif
+}
+
+/* compute the counter blocks Y_0 ... Y_{blocks-1} */
+static void _gcm_batch_counters(const aead_packet *p, unsigned char *ctr, unsigned long blocks)
+{
+   const gcm_key *key = p->key.gcm;
+   unsigned char  Y[16];
+   unsigned long  x;
+   ulong32        c;
+
+   if (p->noncelen == 12) {
+      XMEMCPY(Y, p->nonce, 12);
+      STORE32H(1, Y + 12);
+   } else {
+      /* Y_0 = GHASH(IV || 0^s || 0^64 || [len(IV)]_64) */
+      zeromem(Y, 16);
+      _gcm_batch_ghash(key, Y, p->nonce, p->noncelen);
+      zeromem(ctr, 8);
+      STORE64H((ulong64)p->noncelen * CONST64(8), ctr + 8);
+      _gcm_batch_ghash(key, Y, ctr, 16);
+   }
+   LOAD32H(c, Y + 12);
+   for (x = 0; x < blocks; x++) {
+      XMEMCPY(ctr + 16 * x, Y, 12);
+      STORE32H(c, ctr + 16 * x + 12);
+      c = (c + 1) & 0xFFFFFFFFUL;
+   }
+}
+
+/* finish a packet with its encrypted counter blocks */
+static int _gcm_batch_finish(const aead_packet *p, const unsigned char *ks, int direction)
+{
+   const gcm_key *key = p->key.gcm;
+   unsigned char  X[16], T[16];
+   int            x;
+
+   zeromem(X, 16);
+   _gcm_batch_ghash(key, X, p->adata, p->adatalen);
+   if (direction == LTC_ENCRYPT) {
+      _gcm_batch_xor(p->out, p->in, ks + 16, p->inlen);
+      _gcm_batch_ghash(key, X, p->out, p->inlen);
+   } else {
+      _gcm_batch_ghash(key, X, p->in, p->inlen);
+   }
+   STORE64H((ulong64)p->adatalen * CONST64(8), T);
+   STORE64H((ulong64)p->inlen * CONST64(8), T + 8);
+   _gcm_batch_ghash(key, X, T, 16);
+   for (x = 0; x < 16; x++) {
+      T[x] = X[x] ^ ks[x];
+   }
+
+   if (direction == LTC_ENCRYPT) {
+      XMEMCPY(p->tag, T, p->taglen);
+   } else {
+      if (XMEM_NEQ(T, p->tag, p->taglen) != 0) {
+         if (p->inlen > 0) {
+            zeromem(p->out, p->inlen);
+         }
+         return CRYPT_ERROR;
+      }
+      _gcm_batch_xor(p->out, p->in, ks + 16, p->inlen);
+   }
+#ifdef LTC_CLEAN_STACK
+   zeromem(X, sizeof(X));
+   zeromem(T, sizeof(T));
+#endif
+   return CRYPT_OK;
+}
+
+/* a packet which is too long for a batch or processed by the stitched code */
+static int _gcm_batch_single(const aead_packet *p, int direction)
+{
+   gcm_msg       msg;
+   unsigned char T[16];
+   unsigned long Tlen = p->taglen;
+   int           err;
+
+   if ((err = gcm_msg_init(&msg, p->key.gcm)) != CRYPT_OK) {
+      goto LBL_ERR;
+   }
+   if ((err = gcm_msg_add_iv(&msg, p->nonce, p->noncelen)) != CRYPT_OK) {
+      goto LBL_ERR;
+   }
+   if ((err = gcm_msg_add_aad(&msg, p->adata, p->adatalen)) != CRYPT_OK) {
+      goto LBL_ERR;
+   }
+   if (direction == LTC_ENCRYPT) {
+      err = gcm_msg_process(&msg, (unsigned char *)p->in, p->inlen, p->out, GCM_ENCRYPT);
+   } else {
+      err = gcm_msg_process(&msg, p->out, p->inlen, (unsigned char *)p->in, GCM_DECRYPT);
+   }
+   if (err != CRYPT_OK) {
+      goto LBL_ERR;
+   }
+   if ((err = gcm_msg_done(&msg, T, &Tlen)) != CRYPT_OK) {
+      goto LBL_ERR;
+   }
+   if (direction == LTC_ENCRYPT) {
+      XMEMCPY(p->tag, T, p->taglen);
+   } else if (XMEM_NEQ(T, p->tag, p->taglen) != 0) {
+      zeromem(p->out, p->inlen);
+      err = CRYPT_ERROR;
+   }
+
+LBL_ERR:
+#ifdef LTC_CLEAN_STACK
+   zeromem(&msg, sizeof(msg));
+   zeromem(T, sizeof(T));
+#endif
+   return err;
+}
+
+/**
+   Encrypt or decrypt a batch of independent GCM packets
+   @param pkt       The packets, their mode is LTC_AEAD_GCM
+   @param n         The number of packets
+   @param direction LTC_ENCRYPT or LTC_DECRYPT
+   @return CRYPT_OK if all packets were successful, otherwise the error of the first packet which failed
+*/
+int gcm_memory_batch(aead_packet *pkt, unsigned long n, int direction)
+{
+   _gcm_batch    *b;
+   unsigned long  i, j, k, blocks, need;
+   int            err, ret;
+
+   LTC_ARGCHK(pkt != NULL || n == 0);
+
+   b = XMALLOC(sizeof(*b));
+   if (b == NULL) {
+      return CRYPT_MEM;
+   }
+
+   ret = CRYPT_OK;
+   for (i = 0; i < n; i = j) {
+      /* collect the counter blocks of as many packets as fit */
+      blocks = 0;
+      for (j = i; j < n; j++) {
+         need = 1 + (pkt[j].inlen + 15) / 16;
+         if (blocks + need > GCM_BATCH_BLOCKS) {
+            break;
+         }
+         if ((pkt[j].err = _gcm_batch_check(&pkt[j], direction)) != CRYPT_OK) {
+            continue;
+         }
+         if (_gcm_batch_stitched(&pkt[j])) {
+            pkt[j].err = _gcm_batch_single(&pkt[j], direction);
+            continue;
+         }
+         _gcm_batch_counters(&pkt[j], b->ctr[blocks], need);
+         for (k = blocks; k < blocks + need; k++) {
+            b->skey[k]   = &pkt[j].key.gcm->K;
+            b->cipher[k] = pkt[j].key.gcm->cipher;
+         }
+         blocks += need;
+      }
+
+      if (j == i) {
+         /* the packet doesn't fit, process it on its own */
+         if ((pkt[j].err = _gcm_batch_check(&pkt[j], direction)) == CRYPT_OK) {
+            pkt[j].err = _gcm_batch_single(&pkt[j], direction);
+         }
+         j++;
+      } else {
+         err = aead_int_ecb_multi(b->ctr[0], b->ks[0], blocks, b->skey, b->cipher, LTC_ENCRYPT);
+         for (k = i, blocks = 0; k < j; k++) {
+            if (pkt[k].err != CRYPT_OK || _gcm_batch_stitched(&pkt[k])) {
+               continue;
+            }
+            if (err != CRYPT_OK) {
+               pkt[k].err = err;
+               continue;
+            }
+            pkt[k].err = _gcm_batch_finish(&pkt[k], b->ks[blocks], direction);
+            blocks += 1 + (pkt[k].inlen + 15) / 16;
+         }
+      }
+
+      for (k = i; k < j; k++) {
+         if (ret == CRYPT_OK && pkt[k].err != CRYPT_OK) {
+            ret = pkt[k].err;
+         }
+      }
+   }
+
+#ifdef LTC_CLEAN_STACK
+   zeromem(b, sizeof(*b));
+#endif
+   XFREE(b);
+   return ret;
+}
+
+#endif
+
+/* ref:         $Format:%D$ */
+/* git commit:  $Format:%H$ */
+/* commit time: $Format:%ai$ */
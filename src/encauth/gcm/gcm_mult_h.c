@@ -14,42 +14,97 @@
 #include "tomcrypt_private.h"
 
 #if defined(LTC_GCM_MODE)
+
+#ifdef LTC_GCM_TABLES_4BIT
+/* the reduction of the 4 bits shifted out, multiplied by 2^-48 */
+static const ulong64 last4[16] = {
+   CONST64(0x0000), CONST64(0x1c20), CONST64(0x3840), CONST64(0x2460),
+   CONST64(0x7080), CONST64(0x6ca0), CONST64(0x48c0), CONST64(0x54e0),
+   CONST64(0xe100), CONST64(0xfd20), CONST64(0xd940), CONST64(0xc560),
+   CONST64(0x9180), CONST64(0x8da0), CONST64(0xa9c0), CONST64(0xb5e0)
+};
+#endif
+
 /**
   GCM multiply by H
-  @param gcm   The GCM state which holds the H value
+  @param key   The GCM key which holds the H value
   @param I     The value to multiply H by
  */
-void gcm_mult_h(const gcm_state *gcm, unsigned char *I)
+void gcm_key_mult_h(const gcm_key *key, unsigned char *I)
 {
    unsigned char T[16];
 #ifdef LTC_GCM_TABLES
    int x;
+#ifndef LTC_GCM_TABLES_SSE2
+   int y;
+#endif
+#endif
+#ifdef LTC_GCM_TABLES_4BIT
+   int x;
+   ulong64 zh, zl, r;
+   unsigned char n;
+#endif
+#ifdef LTC_GCM_PCLMUL
+   if (key->simd & LTC_GCM_SIMD_HPOW) {
+      if (gcm_pclmul_is_supported()) {
+         gcm_pclmul_mult_h(I, key->Hpow[0]);
+      } else {
+         /* gcm_key_init() didn't compute the tables */
+         gcm_gf_mult(key->H, I, T);
+         XMEMCPY(I, T, 16);
+      }
+      return;
+   }
+#endif
+#ifdef LTC_GCM_TABLES
 #ifdef LTC_GCM_TABLES_SSE2
-   asm("movdqa (%0),%%xmm0"::"r"(&gcm->PC[0][I[0]][0]));
+   asm("movdqa (%0),%%xmm0"::"r"(&key->PC[0][I[0]][0]));
    for (x = 1; x < 16; x++) {
-      asm("pxor (%0),%%xmm0"::"r"(&gcm->PC[x][I[x]][0]));
+      asm("pxor (%0),%%xmm0"::"r"(&key->PC[x][I[x]][0]));
    }
    asm("movdqa %%xmm0,(%0)"::"r"(&T));
 #else
-   int y;
-   XMEMCPY(T, &gcm->PC[0][I[0]][0], 16);
+   XMEMCPY(T, &key->PC[0][I[0]][0], 16);
    for (x = 1; x < 16; x++) {
 #ifdef LTC_FAST
        for (y = 0; y < 16; y += sizeof(LTC_FAST_TYPE)) {
-           *(LTC_FAST_TYPE_PTR_CAST(T + y)) ^= *(LTC_FAST_TYPE_PTR_CAST(&gcm->PC[x][I[x]][y]));
+           *(LTC_FAST_TYPE_PTR_CAST(T + y)) ^= *(LTC_FAST_TYPE_PTR_CAST(&key->PC[x][I[x]][y]));
        }
 #else
        for (y = 0; y < 16; y++) {
-           T[y] ^= gcm->PC[x][I[x]][y];
+           T[y] ^= key->PC[x][I[x]][y];
        }
 #endif /* LTC_FAST */
    }
 #endif /* LTC_GCM_TABLES_SSE2 */
+#elif defined(LTC_GCM_TABLES_4BIT)
+   /* Horner's rule over the nibbles, starting with the last one */
+   zh = zl = 0;
+   for (x = 31; x >= 0; x--) {
+      n  = (x & 1) ? (I[x >> 1] & 15) : (I[x >> 1] >> 4);
+      r  = zl & 15;
+      zl = (zh << 60) | (zl >> 4);
+      zh = (zh >> 4) ^ (last4[r] << 48);
+      zh ^= key->HH[n];
+      zl ^= key->HL[n];
+   }
+   STORE64H(zh, T);
+   STORE64H(zl, T + 8);
 #else
-   gcm_gf_mult(gcm->H, I, T);
+   gcm_gf_mult(key->H, I, T);
 #endif
    XMEMCPY(I, T, 16);
 }
+
+/**
+  GCM multiply by H
+  @param gcm   The GCM state which holds the H value
+  @param I     The value to multiply H by
+ */
+void gcm_mult_h(const gcm_state *gcm, unsigned char *I)
+{
+   gcm_key_mult_h(&gcm->key, I);
+}
 #endif
 
 /* ref:         $Format:%D$ */
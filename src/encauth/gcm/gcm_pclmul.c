@@ -0,0 +1,131 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ */
+
+/**
+   @file gcm_pclmul.c
+   GHASH using the PCLMULQDQ instruction of x86-64 CPUs
+
+   The powers of H are precomputed by gcm_init(), which allows to sum up the
+   unreduced products of eight blocks and reduce them only once:
+
+   X = (X + d_0) * H^8 + d_1 * H^7 + ... + d_7 * H
+
+   GHASH works on byte reflected blocks as described in "Intel Carry-Less
+   Multiplication Instruction and its Usage for Computing the GCM Mode" by
+   S. Gueron and M. Kounavis.
+*/
+#include "tomcrypt_private.h"
+
+#ifdef LTC_GCM_PCLMUL
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <wmmintrin.h>
+#include <tmmintrin.h>
+#endif
+#include "gcm_clmul.h"
+
+#define PCLMUL_TARGET LTC_ATTRIBUTE_TARGET("pclmul,ssse3")
+
+#define PCLMUL_LOAD(p)      _mm_loadu_si128((const __m128i *)(const void *)(p))
+#define PCLMUL_STORE(p, v)  _mm_storeu_si128((__m128i *)(void *)(p), (v))
+
+/**
+  Check whether the CPU supports the PCLMULQDQ code path
+  @return 1 if supported, 0 otherwise
+*/
+int gcm_pclmul_is_supported(void)
+{
+   return ltc_cpu_has(LTC_CPU_PCLMUL | LTC_CPU_SSSE3);
+}
+
+/**
+  Precompute the powers of H
+  @param Hpow   [out] H^16 ... H^1, 256 bytes
+  @param H      The hash key
+*/
+PCLMUL_TARGET
+void gcm_pclmul_init(unsigned char *Hpow, const unsigned char *H)
+{
+   __m128i h, p, lo, mid, hi;
+   int i;
+
+   h = _reflect(PCLMUL_LOAD(H));
+   p = h;
+   PCLMUL_STORE(Hpow + 16 * 15, p);
+   for (i = 14; i >= 0; i--) {
+      lo = mid = hi = _mm_setzero_si128();
+      _mul_add(p, h, &lo, &mid, &hi);
+      p = _fold(lo, mid, hi);
+      PCLMUL_STORE(Hpow + 16 * i, p);
+   }
+}
+
+/**
+  GCM multiply by H
+  @param I      [in/out] The value to multiply H by
+  @param Hpow   The powers of H
+*/
+PCLMUL_TARGET
+void gcm_pclmul_mult_h(unsigned char *I, const unsigned char *Hpow)
+{
+   __m128i lo, mid, hi;
+
+   lo = mid = hi = _mm_setzero_si128();
+   _mul_add(_reflect(PCLMUL_LOAD(I)), PCLMUL_LOAD(Hpow + 16 * 15), &lo, &mid, &hi);
+   PCLMUL_STORE(I, _reflect(_fold(lo, mid, hi)));
+}
+
+/**
+  GHASH data, the last block is padded with zeros
+  @param X      [in/out] The GHASH accumulator
+  @param Hpow   The powers of H
+  @param in     The data
+  @param inlen  The length of the data
+*/
+PCLMUL_TARGET
+void gcm_pclmul_ghash(unsigned char *X, const unsigned char *Hpow, const unsigned char *in, unsigned long inlen)
+{
+   __m128i x, d, lo, mid, hi;
+   unsigned char buf[16];
+   unsigned long n, k;
+   const unsigned char *p;
+
+   x = _reflect(PCLMUL_LOAD(X));
+   while (inlen > 0) {
+      n = (inlen < 128) ? inlen : 128;
+      p = Hpow + 16 * (16 - (n + 15) / 16);
+      lo = mid = hi = _mm_setzero_si128();
+      for (k = 0; k < n; k += 16) {
+         if (n - k >= 16) {
+            d = PCLMUL_LOAD(in + k);
+         } else {
+            zeromem(buf, sizeof(buf));
+            XMEMCPY(buf, in + k, n - k);
+            d = PCLMUL_LOAD(buf);
+         }
+         d = _reflect(d);
+         if (k == 0) {
+            d = _mm_xor_si128(d, x);
+         }
+         _mul_add(d, PCLMUL_LOAD(p + k), &lo, &mid, &hi);
+      }
+      x = _fold(lo, mid, hi);
+      in    += n;
+      inlen -= n;
+   }
+   PCLMUL_STORE(X, _reflect(x));
+}
+
+#endif
+
+/* ref:         $Format:%D$ */
+/* git commit:  $Format:%H$ */
+/* commit time: $Format:%ai$ */
@@ -17,23 +17,27 @@
 
 /**
   Process plaintext/ciphertext through GCM
-  @param gcm       The GCM state
+  @param gcm       The GCM message state
   @param pt        The plaintext
   @param ptlen     The plaintext length (ciphertext length is the same)
   @param ct        The ciphertext
   @param direction Encrypt or Decrypt mode (GCM_ENCRYPT or GCM_DECRYPT)
   @return CRYPT_OK on success
  */
-int gcm_process(gcm_state *gcm,
-                     unsigned char *pt,     unsigned long ptlen,
-                     unsigned char *ct,
-                     int direction)
+int gcm_msg_process(gcm_msg *gcm,
+                          unsigned char *pt,     unsigned long ptlen,
+                          unsigned char *ct,
+                          int direction)
 {
    unsigned long x;
    int           y, err;
    unsigned char b;
+#ifdef LTC_GCM_PCLMUL
+   unsigned long n, z;
+#endif
 
    LTC_ARGCHK(gcm != NULL);
+   LTC_ARGCHK(gcm->key != NULL);
    if (ptlen > 0) {
       LTC_ARGCHK(pt  != NULL);
       LTC_ARGCHK(ct  != NULL);
@@ -43,7 +47,7 @@ int gcm_process(gcm_state *gcm,
       return CRYPT_INVALID_ARG;
    }
 
-   if ((err = cipher_is_valid(gcm->cipher)) != CRYPT_OK) {
+   if ((err = cipher_is_valid(gcm->key->cipher)) != CRYPT_OK) {
       return err;
    }
 
@@ -54,7 +58,7 @@ int gcm_process(gcm_state *gcm,
 
    if (gcm->mode == LTC_GCM_MODE_IV) {
       /* let's process the IV */
-      if ((err = gcm_add_aad(gcm, NULL, 0)) != CRYPT_OK) return err;
+      if ((err = gcm_msg_add_aad(gcm, NULL, 0)) != CRYPT_OK) return err;
    }
 
    /* in AAD mode? */
@@ -62,7 +66,7 @@ int gcm_process(gcm_state *gcm,
       /* let's process the AAD */
       if (gcm->buflen) {
          gcm->totlen += gcm->buflen * CONST64(8);
-         gcm_mult_h(gcm, gcm->X);
+         gcm_key_mult_h(gcm->key, gcm->X);
       }
 
       /* increment counter */
@@ -70,7 +74,7 @@ int gcm_process(gcm_state *gcm,
           if (++gcm->Y[y] & 255) { break; }
       }
       /* encrypt the counter */
-      if ((err = cipher_descriptor[gcm->cipher].ecb_encrypt(gcm->Y, gcm->buf, &gcm->K)) != CRYPT_OK) {
+      if ((err = cipher_descriptor[gcm->key->cipher].ecb_encrypt(gcm->Y, gcm->buf, &gcm->key->K)) != CRYPT_OK) {
          return err;
       }
 
@@ -83,10 +87,63 @@ int gcm_process(gcm_state *gcm,
    }
 
    x = 0;
+#ifdef LTC_GCM_AESNI
+   if (gcm->buflen == 0 && ptlen >= 16 && (gcm->key->simd & LTC_GCM_SIMD_HPOW) && (gcm->key->simd & LTC_GCM_SIMD_AES) &&
+       gcm_aesni_is_supported()) {
+      /* encrypt and GHASH in a single pass */
+      x = ptlen & ~15uL;
+      if (direction == GCM_ENCRYPT) {
+         err = gcm_aesni_ctr_ghash(&gcm->key->K, gcm->Y, gcm->X, gcm->key->Hpow[0], pt, ct, x, direction);
+      } else {
+         err = gcm_aesni_ctr_ghash(&gcm->key->K, gcm->Y, gcm->X, gcm->key->Hpow[0], ct, pt, x, direction);
+      }
+      if (err != CRYPT_OK) {
+         return err;
+      }
+      gcm->pttotlen += (ulong64)x * CONST64(8);
+      /* encrypt the counter of the next block */
+      if ((err = cipher_descriptor[gcm->key->cipher].ecb_encrypt(gcm->Y, gcm->buf, &gcm->key->K)) != CRYPT_OK) {
+         return err;
+      }
+   }
+#endif
+#ifdef LTC_GCM_PCLMUL
+   if (gcm->buflen == 0 && (gcm->key->simd & LTC_GCM_SIMD_HPOW) && gcm_pclmul_is_supported()) {
+      /* GHASH up to eight blocks at a time */
+      while (x < (ptlen & ~15uL)) {
+         n = MIN((ptlen & ~15uL) - x, 128);
+         if (direction != GCM_ENCRYPT) {
+            gcm_pclmul_ghash(gcm->X, gcm->key->Hpow[0], ct + x, n);
+         }
+         for (z = 0; z < n; z += 16) {
+            /* ctr encrypt */
+            for (y = 0; y < 16; y++) {
+               if (direction == GCM_ENCRYPT) {
+                  ct[x + z + y] = pt[x + z + y] ^ gcm->buf[y];
+               } else {
+                  pt[x + z + y] = ct[x + z + y] ^ gcm->buf[y];
+               }
+            }
+            /* increment counter */
+            for (y = 15; y >= 12; y--) {
+                if (++gcm->Y[y] & 255) { break; }
+            }
+            if ((err = cipher_descriptor[gcm->key->cipher].ecb_encrypt(gcm->Y, gcm->buf, &gcm->key->K)) != CRYPT_OK) {
+               return err;
+            }
+         }
+         if (direction == GCM_ENCRYPT) {
+            gcm_pclmul_ghash(gcm->X, gcm->key->Hpow[0], ct + x, n);
+         }
+         gcm->pttotlen += (ulong64)n * CONST64(8);
+         x += n;
+      }
+   }
+#endif
 #ifdef LTC_FAST
    if (gcm->buflen == 0) {
       if (direction == GCM_ENCRYPT) {
-         for (x = 0; x < (ptlen & ~15); x += 16) {
+         for (; x < (ptlen & ~15); x += 16) {
              /* ctr encrypt */
              for (y = 0; y < 16; y += sizeof(LTC_FAST_TYPE)) {
                  *(LTC_FAST_TYPE_PTR_CAST(&ct[x + y])) = *(LTC_FAST_TYPE_PTR_CAST(&pt[x+y])) ^ *(LTC_FAST_TYPE_PTR_CAST(&gcm->buf[y]));
@@ -94,17 +151,17 @@ int gcm_process(gcm_state *gcm,
              }
              /* GMAC it */
              gcm->pttotlen += 128;
-             gcm_mult_h(gcm, gcm->X);
+             gcm_key_mult_h(gcm->key, gcm->X);
              /* increment counter */
              for (y = 15; y >= 12; y--) {
                  if (++gcm->Y[y] & 255) { break; }
              }
-             if ((err = cipher_descriptor[gcm->cipher].ecb_encrypt(gcm->Y, gcm->buf, &gcm->K)) != CRYPT_OK) {
+             if ((err = cipher_descriptor[gcm->key->cipher].ecb_encrypt(gcm->Y, gcm->buf, &gcm->key->K)) != CRYPT_OK) {
                 return err;
              }
          }
       } else {
-         for (x = 0; x < (ptlen & ~15); x += 16) {
+         for (; x < (ptlen & ~15); x += 16) {
              /* ctr encrypt */
              for (y = 0; y < 16; y += sizeof(LTC_FAST_TYPE)) {
                  *(LTC_FAST_TYPE_PTR_CAST(&gcm->X[y])) ^= *(LTC_FAST_TYPE_PTR_CAST(&ct[x+y]));
@@ -112,12 +169,12 @@ int gcm_process(gcm_state *gcm,
              }
              /* GMAC it */
              gcm->pttotlen += 128;
-             gcm_mult_h(gcm, gcm->X);
+             gcm_key_mult_h(gcm->key, gcm->X);
              /* increment counter */
              for (y = 15; y >= 12; y--) {
                  if (++gcm->Y[y] & 255) { break; }
              }
-             if ((err = cipher_descriptor[gcm->cipher].ecb_encrypt(gcm->Y, gcm->buf, &gcm->K)) != CRYPT_OK) {
+             if ((err = cipher_descriptor[gcm->key->cipher].ecb_encrypt(gcm->Y, gcm->buf, &gcm->key->K)) != CRYPT_OK) {
                 return err;
              }
          }
@@ -129,13 +186,13 @@ int gcm_process(gcm_state *gcm,
    for (; x < ptlen; x++) {
        if (gcm->buflen == 16) {
           gcm->pttotlen += 128;
-          gcm_mult_h(gcm, gcm->X);
+          gcm_key_mult_h(gcm->key, gcm->X);
 
           /* increment counter */
           for (y = 15; y >= 12; y--) {
               if (++gcm->Y[y] & 255) { break; }
           }
-          if ((err = cipher_descriptor[gcm->cipher].ecb_encrypt(gcm->Y, gcm->buf, &gcm->K)) != CRYPT_OK) {
+          if ((err = cipher_descriptor[gcm->key->cipher].ecb_encrypt(gcm->Y, gcm->buf, &gcm->key->K)) != CRYPT_OK) {
              return err;
           }
           gcm->buflen = 0;
@@ -153,6 +210,25 @@ int gcm_process(gcm_state *gcm,
    return CRYPT_OK;
 }
 
+/**
+  Process plaintext/ciphertext through GCM
+  @param gcm       The GCM state
+  @param pt        The plaintext
+  @param ptlen     The plaintext length (ciphertext length is the same)
+  @param ct        The ciphertext
+  @param direction Encrypt or Decrypt mode (GCM_ENCRYPT or GCM_DECRYPT)
+  @return CRYPT_OK on success
+ */
+int gcm_process(gcm_state *gcm,
+                     unsigned char *pt,     unsigned long ptlen,
+                     unsigned char *ct,
+                     int direction)
+{
+   LTC_ARGCHK(gcm != NULL);
+   gcm->msg.key = &gcm->key;
+   return gcm_msg_process(&gcm->msg, pt, ptlen, ct, direction);
+}
+
 #endif
 
 /* ref:         $Format:%D$ */
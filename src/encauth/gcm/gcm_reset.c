@@ -16,14 +16,17 @@
 #ifdef LTC_GCM_MODE
 
 /**
-  Reset a GCM state to as if you just called gcm_init().  This saves the initialization time.
-  @param gcm   The GCM state to reset
+  Start a new message
+  @param gcm   The GCM message state to initialize
+  @param key   The expanded key, it must stay valid until the message is done
   @return CRYPT_OK on success
 */
-int gcm_reset(gcm_state *gcm)
+int gcm_msg_init(gcm_msg *gcm, const gcm_key *key)
 {
    LTC_ARGCHK(gcm != NULL);
+   LTC_ARGCHK(key != NULL);
 
+   gcm->key      = key;
    zeromem(gcm->buf, sizeof(gcm->buf));
    zeromem(gcm->X,   sizeof(gcm->X));
    gcm->mode     = LTC_GCM_MODE_IV;
@@ -35,6 +38,17 @@ int gcm_reset(gcm_state *gcm)
    return CRYPT_OK;
 }
 
+/**
+  Reset a GCM state to as if you just called gcm_init().  This saves the initialization time.
+  @param gcm   The GCM state to reset
+  @return CRYPT_OK on success
+*/
+int gcm_reset(gcm_state *gcm)
+{
+   LTC_ARGCHK(gcm != NULL);
+   return gcm_msg_init(&gcm->msg, &gcm->key);
+}
+
 #endif
 
 /* ref:         $Format:%D$ */
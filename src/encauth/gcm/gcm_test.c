@@ -15,6 +15,224 @@
 
 #ifdef LTC_GCM_MODE
 
+#if defined(LTC_TEST) && defined(LTC_AMD64_SIMD)
+/* encrypt with the code paths allowed by the CPU feature mask */
+static int _gcm_simd_encrypt(gcm_state *gcm, int idx, unsigned long mask, int incremental,
+                             const unsigned char *key, int keylen, const unsigned char *IV, unsigned long IVlen,
+                             const unsigned char *A, unsigned long Alen, const unsigned char *Y,
+                             const unsigned char *P, unsigned long len, unsigned char *C, unsigned char *T)
+{
+   unsigned long taglen = 16, x;
+   int err;
+
+   mask = ltc_cpu_mask(mask);
+   if (!incremental) {
+      err = gcm_memory(idx, key, keylen, IV, IVlen, A, Alen, (unsigned char*)P, len, C, T, &taglen, GCM_ENCRYPT);
+      goto LBL_ERR;
+   }
+   /* the bulk of the data goes through gcm_process() */
+   if ((err = gcm_init(gcm, idx, key, keylen)) != CRYPT_OK)                    goto LBL_ERR;
+   if ((err = gcm_add_iv(gcm, IV, IVlen)) != CRYPT_OK)                         goto LBL_ERR;
+   if ((err = gcm_add_aad(gcm, A, Alen)) != CRYPT_OK)                          goto LBL_ERR;
+   if (Y != NULL) {
+      /* start with the given counter */
+      XMEMCPY(gcm->msg.Y, Y, 16);
+   }
+   x = (len / 2) & ~15uL;
+   if ((err = gcm_process(gcm, (unsigned char*)P, x, C, GCM_ENCRYPT)) != CRYPT_OK) goto LBL_ERR;
+   if ((err = gcm_process(gcm, (unsigned char*)P + x, len - x, C + x, GCM_ENCRYPT)) != CRYPT_OK) goto LBL_ERR;
+   err = gcm_done(gcm, T, &taglen);
+LBL_ERR:
+   ltc_cpu_mask(mask);
+   return err;
+}
+
+/* compare the SIMD code paths with the generic code */
+static int _gcm_simd_test(gcm_state *gcm, int idx)
+{
+   static const unsigned long lens[] = { 0, 1, 15, 16, 17, 64, 255, 256, 257, 511, 600 };
+   static const unsigned long masks[] = {
+      ~0UL,
+#ifdef LTC_GCM_VAES
+      ~(LTC_CPU_VAES | LTC_CPU_VPCLMULQDQ | LTC_CPU_AVX512),
+#endif
+#ifdef LTC_GCM_AESNI
+      ~LTC_CPU_AESNI,
+#endif
+   };
+   static const unsigned char Y[16] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 0xFF, 0xFF, 0xFF, 0xF0 };
+   unsigned char key[32], IV[60], A[300], P[600], C[2][600], T[2][16];
+   unsigned long x, m, len, IVlen, Alen, taglen, mask;
+   int keylen, k, err;
+
+   for (x = 0; x < sizeof(P); x++) {
+      P[x] = (unsigned char)(x * 7 + 3);
+   }
+   for (x = 0; x < sizeof(A); x++) {
+      A[x] = (unsigned char)(x * 11 + 5);
+   }
+   for (x = 0; x < sizeof(IV); x++) {
+      IV[x] = (unsigned char)(x * 13 + 1);
+   }
+   for (x = 0; x < sizeof(key); x++) {
+      key[x] = (unsigned char)(x * 17 + 9);
+   }
+
+   for (x = 0; x < sizeof(lens)/sizeof(lens[0]); x++) {
+      len    = lens[x];
+      keylen = 16 + 8 * (int)(x % 3);
+      IVlen  = (x & 1) ? 12 : 1 + x * 5;
+      Alen   = (len * 3) % 300;
+      if ((err = _gcm_simd_encrypt(gcm, idx, 0, 0, key, keylen, IV, IVlen, A, Alen, NULL, P, len, C[0], T[0])) != CRYPT_OK) {
+         return err;
+      }
+      for (m = 0; m < sizeof(masks)/sizeof(masks[0]); m++) {
+         for (k = 0; k < 2; k++) {
+            if ((err = _gcm_simd_encrypt(gcm, idx, masks[m], k, key, keylen, IV, IVlen, A, Alen, NULL, P, len, C[1], T[1])) != CRYPT_OK) {
+               return err;
+            }
+            if (compare_testvector(C[1], len, C[0], len, "GCM SIMD CT", (int)(x * 10 + m * 2 + k)) ||
+                compare_testvector(T[1], 16, T[0], 16, "GCM SIMD Tag", (int)(x * 10 + m * 2 + k))) {
+               return CRYPT_FAIL_TESTVECTOR;
+            }
+         }
+         mask = ltc_cpu_mask(masks[m]);
+         taglen = 16;
+         err = gcm_memory(idx, key, keylen, IV, IVlen, A, Alen, C[1], len, C[0], T[0], &taglen, GCM_DECRYPT);
+         ltc_cpu_mask(mask);
+         if (err != CRYPT_OK) {
+            return err;
+         }
+         if (compare_testvector(C[1], len, P, len, "GCM SIMD PT", (int)(x * 10 + m))) {
+            return CRYPT_FAIL_TESTVECTOR;
+         }
+      }
+   }
+
+   /* the 32-bit counter wraps around */
+   if ((err = _gcm_simd_encrypt(gcm, idx, 0, 1, key, 16, IV, 12, A, 20, Y, P, sizeof(P), C[0], T[0])) != CRYPT_OK) {
+      return err;
+   }
+   for (m = 0; m < sizeof(masks)/sizeof(masks[0]); m++) {
+      if ((err = _gcm_simd_encrypt(gcm, idx, masks[m], 1, key, 16, IV, 12, A, 20, Y, P, sizeof(P), C[1], T[1])) != CRYPT_OK) {
+         return err;
+      }
+      if (compare_testvector(C[1], sizeof(P), C[0], sizeof(P), "GCM SIMD wrap CT", (int)m) ||
+          compare_testvector(T[1], 16, T[0], 16, "GCM SIMD wrap Tag", (int)m)) {
+         return CRYPT_FAIL_TESTVECTOR;
+      }
+   }
+
+   return CRYPT_OK;
+}
+#endif
+
+#ifdef LTC_TEST
+#define GCM_BATCH_TEST_PACKETS 40
+#define GCM_BATCH_TEST_BIG     5000
+
+typedef struct {
+   gcm_key       key[3];
+   aead_packet   pkt[GCM_BATCH_TEST_PACKETS];
+   unsigned char P[GCM_BATCH_TEST_BIG + GCM_BATCH_TEST_PACKETS], C[2][GCM_BATCH_TEST_BIG], D[GCM_BATCH_TEST_PACKETS][200];
+   unsigned char IV[64], A[64], T[2][GCM_BATCH_TEST_PACKETS][16];
+} _gcm_batch_test_state;
+
+/* compare a batch of packets under different keys and nonces with gcm_key_memory() */
+static int _gcm_batch_test(int idx)
+{
+   _gcm_batch_test_state *s;
+   unsigned char kb[32];
+   unsigned long x, y, len, taglen;
+   int err;
+#ifdef LTC_AMD64_SIMD
+   unsigned long mask;
+#endif
+
+   if ((s = XCALLOC(1, sizeof(*s))) == NULL) {
+      return CRYPT_MEM;
+   }
+   for (x = 0; x < sizeof(s->P); x++) {
+      s->P[x] = (unsigned char)(x * 7 + 3);
+   }
+   for (x = 0; x < sizeof(s->A); x++) {
+      s->A[x] = (unsigned char)(x * 11 + 5);
+      s->IV[x] = (unsigned char)(x * 13 + 1);
+   }
+   for (x = 0; x < 3; x++) {
+      for (y = 0; y < sizeof(kb); y++) {
+         kb[y] = (unsigned char)(x * 31 + y * 17 + 9);
+      }
+      if ((err = gcm_key_init(&s->key[x], idx, kb, 16 + 8 * (int)x)) != CRYPT_OK) {
+         goto LBL_ERR;
+      }
+   }
+
+   for (x = 0; x < GCM_BATCH_TEST_PACKETS; x++) {
+      len = (x == GCM_BATCH_TEST_PACKETS / 2) ? GCM_BATCH_TEST_BIG : (x * 13) % 200;
+      s->pkt[x].mode     = LTC_AEAD_GCM;
+      s->pkt[x].key.gcm  = &s->key[x % 3];
+      s->pkt[x].nonce    = s->IV + x % 7;
+      s->pkt[x].noncelen = (x % 4 == 0) ? 1 + x : 12;
+      s->pkt[x].adata    = s->A + x % 5;
+      s->pkt[x].adatalen = (x * 7) % 50;
+      s->pkt[x].in       = s->P + x;
+      s->pkt[x].inlen    = len;
+      s->pkt[x].out      = (len > 200) ? s->C[1] : s->D[x];
+      s->pkt[x].tag      = s->T[1][x];
+      s->pkt[x].taglen   = 16 - x % 4;
+   }
+   if ((err = aead_encrypt_batch(LTC_AEAD_GCM, s->pkt, GCM_BATCH_TEST_PACKETS)) != CRYPT_OK) {
+      goto LBL_ERR;
+   }
+   for (x = 0; x < GCM_BATCH_TEST_PACKETS; x++) {
+      taglen = 16;
+      if ((err = gcm_key_memory(&s->key[x % 3], s->pkt[x].nonce, s->pkt[x].noncelen, s->pkt[x].adata, s->pkt[x].adatalen,
+                                s->P + x, s->pkt[x].inlen, s->C[0], s->T[0][x], &taglen, GCM_ENCRYPT)) != CRYPT_OK) {
+         goto LBL_ERR;
+      }
+      if (compare_testvector(s->pkt[x].out, s->pkt[x].inlen, s->C[0], s->pkt[x].inlen, "GCM batch CT", (int)x) ||
+          compare_testvector(s->T[1][x], s->pkt[x].taglen, s->T[0][x], s->pkt[x].taglen, "GCM batch Tag", (int)x)) {
+         err = CRYPT_FAIL_TESTVECTOR;
+         goto LBL_ERR;
+      }
+   }
+
+   /* decrypt in place, one of the tags is wrong */
+   s->T[1][5][0] ^= 1;
+   for (x = 0; x < GCM_BATCH_TEST_PACKETS; x++) {
+      s->pkt[x].in = s->pkt[x].out;
+   }
+#ifdef LTC_AMD64_SIMD
+   mask = ltc_cpu_mask(~LTC_CPU_AESNI);
+#endif
+   err = aead_decrypt_batch(LTC_AEAD_GCM, s->pkt, GCM_BATCH_TEST_PACKETS);
+#ifdef LTC_AMD64_SIMD
+   ltc_cpu_mask(mask);
+#endif
+   if (err != CRYPT_ERROR || s->pkt[5].err != CRYPT_ERROR) {
+      err = CRYPT_FAIL_TESTVECTOR;
+      goto LBL_ERR;
+   }
+   for (x = 0; x < GCM_BATCH_TEST_PACKETS; x++) {
+      XMEMSET(s->C[0], 0, s->pkt[x].inlen);
+      if (compare_testvector(s->pkt[x].out, s->pkt[x].inlen, x == 5 ? s->C[0] : s->P + x, s->pkt[x].inlen, "GCM batch PT", (int)x) ||
+          (x != 5 && s->pkt[x].err != CRYPT_OK)) {
+         err = CRYPT_FAIL_TESTVECTOR;
+         goto LBL_ERR;
+      }
+   }
+   err = CRYPT_OK;
+
+LBL_ERR:
+   for (x = 0; x < 3; x++) {
+      gcm_key_done(&s->key[x]);
+   }
+   XFREE(s);
+   return err;
+}
+#endif
+
 /**
   Test the GCM code
   @return CRYPT_OK on success
@@ -323,9 +541,10 @@ int gcm_test(void)
 /* rest of test cases are the same except AES key size changes... ignored... */
 };
    int           idx, err;
-   unsigned long x, y;
+   unsigned long x, y, z;
    unsigned char out[2][128], T[2][16];
    gcm_state gcm;
+   gcm_msg m[2];
 
    /* find aes */
    idx = find_cipher("aes");
@@ -375,6 +594,57 @@ int gcm_test(void)
        if (compare_testvector(out[1], tests[x].ptlen, tests[x].P, tests[x].ptlen, "GCM PT", x)) {
           return CRYPT_FAIL_TESTVECTOR;
        }
+
+       /* one expanded key, two messages at once */
+       if ((err = gcm_key_init(&gcm.key, idx, tests[x].K, tests[x].keylen)) != CRYPT_OK) {
+          return err;
+       }
+       for (z = 0; z < 2; z++) {
+          if ((err = gcm_msg_init(&m[z], &gcm.key)) != CRYPT_OK)                      return err;
+          if ((err = gcm_msg_add_iv(&m[z], tests[x].IV, tests[x].IVlen)) != CRYPT_OK) return err;
+          if ((err = gcm_msg_add_aad(&m[z], tests[x].A, tests[x].alen)) != CRYPT_OK)  return err;
+       }
+       for (z = 0; z < 2; z++) {
+          if ((err = gcm_msg_process(&m[z], (unsigned char*)tests[x].P, MIN(tests[x].ptlen, 17), out[z], GCM_ENCRYPT)) != CRYPT_OK) {
+             return err;
+          }
+       }
+       for (z = 0; z < 2; z++) {
+          if ((err = gcm_msg_process(&m[z], (unsigned char*)tests[x].P + MIN(tests[x].ptlen, 17), tests[x].ptlen - MIN(tests[x].ptlen, 17),
+                                     out[z] + MIN(tests[x].ptlen, 17), GCM_ENCRYPT)) != CRYPT_OK) {
+             return err;
+          }
+          y = sizeof(T[z]);
+          if ((err = gcm_msg_done(&m[z], T[z], &y)) != CRYPT_OK) {
+             return err;
+          }
+          if (compare_testvector(out[z], tests[x].ptlen, tests[x].C, tests[x].ptlen, "GCM msg CT", (int)(x * 2 + z)) ||
+              compare_testvector(T[z], y, tests[x].T, 16, "GCM msg Tag", (int)(x * 2 + z))) {
+             return CRYPT_FAIL_TESTVECTOR;
+          }
+       }
+       y = sizeof(T[1]);
+       XMEMCPY(T[1], tests[x].T, 16);
+       if ((err = gcm_key_memory(&gcm.key, tests[x].IV, tests[x].IVlen,
+                                 tests[x].A, tests[x].alen,
+                                 out[1], tests[x].ptlen,
+                                 (unsigned char*)tests[x].C, T[1], &y, GCM_DECRYPT)) != CRYPT_OK) {
+          return err;
+       }
+       if (compare_testvector(out[1], tests[x].ptlen, tests[x].P, tests[x].ptlen, "GCM key PT", x)) {
+          return CRYPT_FAIL_TESTVECTOR;
+       }
+       gcm_key_done(&gcm.key);
+   }
+
+#ifdef LTC_AMD64_SIMD
+   if ((err = _gcm_simd_test(&gcm, idx)) != CRYPT_OK) {
+      return err;
+   }
+#endif
+
+   if ((err = _gcm_batch_test(idx)) != CRYPT_OK) {
+      return err;
    }
 
    /* wycheproof failing test - https://github.com/libtom/libtomcrypt/pull/451 */
@@ -0,0 +1,233 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ */
+
+/**
+   @file gcm_vaes.c
+   AES-GCM using the VAES and VPCLMULQDQ instructions of AVX-512 CPUs
+
+   Sixteen counter blocks are encrypted per iteration in four ZMM registers
+   and the ciphertext is folded into GHASH with the powers H^16 ... H^1
+   precomputed by gcm_pclmul_init(), so there's a single reduction per 256
+   bytes.
+
+   GHASH works on byte reflected blocks as described in "Intel Carry-Less
+   Multiplication Instruction and its Usage for Computing the GCM Mode" by
+   S. Gueron and M. Kounavis.
+*/
+#include "tomcrypt_private.h"
+
+#ifdef LTC_GCM_VAES
+
+/* the AVX-512 reduction macros of GCC mix declarations and code */
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wdeclaration-after-statement"
+#endif
+#include <immintrin.h>
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+#include "gcm_clmul.h"
+
+#define VAES_TARGET LTC_ATTRIBUTE_TARGET("avx2,avx512f,avx512bw,avx512vl,vaes,vpclmulqdq,pclmul,aes")
+
+#define VAES_LOAD(p)       _mm_loadu_si128((const __m128i *)(const void *)(p))
+#define VAES_STORE(p, v)   _mm_storeu_si128((__m128i *)(void *)(p), (v))
+#define VAES_LOAD4(p)      _mm512_loadu_si512((const void *)(p))
+#define VAES_STORE4(p, v)  _mm512_storeu_si512((void *)(p), (v))
+
+/* mask of the first n bytes of a ZMM register, n < 64 */
+#define VAES_MASK(n)       ((__mmask64)((CONST64(1) << (n)) - 1))
+
+/**
+  Check whether the CPU supports the VAES code path
+  @return 1 if supported, 0 otherwise
+*/
+int gcm_vaes_is_supported(void)
+{
+   return ltc_cpu_has(LTC_CPU_AESNI | LTC_CPU_PCLMUL | LTC_CPU_AVX2 | LTC_CPU_AVX512 |
+                      LTC_CPU_VAES | LTC_CPU_VPCLMULQDQ);
+}
+
+/* the XOR of the four 128 bit lanes */
+VAES_TARGET
+static LTC_INLINE __m128i _lanes_xor(__m512i x)
+{
+   __m256i y;
+   y = _mm256_xor_si256(_mm512_castsi512_si256(x), _mm512_extracti64x4_epi64(x, 1));
+   return _mm_xor_si128(_mm256_castsi256_si128(y), _mm256_extracti128_si256(y, 1));
+}
+
+/*
+   X = (X + d_0) * H^n + d_1 * H^(n-1) + ... + d_(n-1) * H
+
+   d holds the n = len/16 (rounded up) reflected blocks, zero padded to
+   four ZMM registers.
+*/
+VAES_TARGET
+static LTC_INLINE __m128i _ghash(__m128i x, const unsigned char *Hpow, __m512i *d, unsigned long len)
+{
+   __m512i h, lo, mid, hi;
+   __m128i l, m, u;
+   unsigned long n, k;
+   const unsigned char *p;
+
+   n = (len + 15) / 16;
+   p = Hpow + 16 * (16 - n);
+   d[0] = _mm512_xor_si512(d[0], _mm512_inserti32x4(_mm512_setzero_si512(), x, 0));
+   lo = mid = hi = _mm512_setzero_si512();
+   for (k = 0; k < 4 && 4 * k < n; k++) {
+      if (n - 4 * k >= 4) {
+         h = VAES_LOAD4(p + 64 * k);
+      } else {
+         h = _mm512_maskz_loadu_epi64((__mmask8)((1u << (2 * (n - 4 * k))) - 1), p + 64 * k);
+      }
+      lo  = _mm512_xor_si512(lo, _mm512_clmulepi64_epi128(d[k], h, 0x00));
+      hi  = _mm512_xor_si512(hi, _mm512_clmulepi64_epi128(d[k], h, 0x11));
+      mid = _mm512_ternarylogic_epi64(mid, _mm512_clmulepi64_epi128(d[k], h, 0x01),
+                                           _mm512_clmulepi64_epi128(d[k], h, 0x10), 0x96);
+   }
+   l = _lanes_xor(lo);
+   m = _lanes_xor(mid);
+   u = _lanes_xor(hi);
+   l = _mm_xor_si128(l, _mm_slli_si128(m, 8));
+   u = _mm_xor_si128(u, _mm_srli_si128(m, 8));
+   return _reduce(l, u);
+}
+
+/**
+  GHASH data, the last block is padded with zeros
+  @param X      [in/out] The GHASH accumulator
+  @param Hpow   The powers of H
+  @param in     The data
+  @param inlen  The length of the data
+*/
+VAES_TARGET
+void gcm_vaes_ghash(unsigned char *X, const unsigned char *Hpow, const unsigned char *in, unsigned long inlen)
+{
+   __m512i bswap, d[4];
+   __m128i x;
+   unsigned long n, k;
+
+   bswap = _mm512_broadcast_i32x4(_mm_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0));
+   x = _reflect(VAES_LOAD(X));
+   while (inlen > 0) {
+      n = (inlen < 256) ? inlen : 256;
+      for (k = 0; k < 4; k++) {
+         if (64 * k + 64 <= n) {
+            d[k] = _mm512_shuffle_epi8(VAES_LOAD4(in + 64 * k), bswap);
+         } else if (64 * k < n) {
+            d[k] = _mm512_shuffle_epi8(_mm512_maskz_loadu_epi8(VAES_MASK(n - 64 * k), in + 64 * k), bswap);
+         } else {
+            d[k] = _mm512_setzero_si512();
+         }
+      }
+      x = _ghash(x, Hpow, d, n);
+      in    += n;
+      inlen -= n;
+   }
+   VAES_STORE(X, _reflect(x));
+}
+
+/**
+  Encrypt or decrypt in CTR mode (32-bit counter) and GHASH the ciphertext
+  @param skey       The AES key as scheduled
+  @param Y          [in/out] The counter of the first block, the counter of the next block on output
+  @param X          [in/out] The GHASH accumulator
+  @param Hpow       The powers of H
+  @param in         The input
+  @param out        [out] The output, may be the same buffer as in
+  @param len        The length of the data, a partial last block is padded with zeros for GHASH
+  @param direction  GCM_ENCRYPT or GCM_DECRYPT
+  @return CRYPT_OK if successful
+*/
+VAES_TARGET
+int gcm_vaes_ctr_ghash(const symmetric_key *skey, unsigned char *Y, unsigned char *X, const unsigned char *Hpow,
+                       const unsigned char *in, unsigned char *out, unsigned long len, int direction)
+{
+   __m512i K[15], bswap, ctr, inc, c[4], d[4];
+   __m128i bswap32, x, y;
+   __mmask64 mask;
+   unsigned long n, k;
+   int i, Nr;
+
+   Nr = skey->rijndael.Nr;
+   if (Nr != 10 && Nr != 12 && Nr != 14) {
+      return CRYPT_INVALID_ROUNDS;
+   }
+   /* the key schedule is stored as big-endian words */
+   bswap32 = _mm_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+   for (i = 0; i <= Nr; i++) {
+      K[i] = _mm512_broadcast_i32x4(_mm_shuffle_epi8(VAES_LOAD(skey->rijndael.eK + 4 * i), bswap32));
+   }
+
+   bswap = _mm512_broadcast_i32x4(_mm_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0));
+   x = _reflect(VAES_LOAD(X));
+   /* reflected, the 32-bit counter is the lowest dword and wraps around on its own */
+   y = _reflect(VAES_LOAD(Y));
+   ctr = _mm512_add_epi32(_mm512_broadcast_i32x4(y), _mm512_setr_epi32(0, 0, 0, 0, 1, 0, 0, 0, 2, 0, 0, 0, 3, 0, 0, 0));
+   inc = _mm512_setr_epi32(4, 0, 0, 0, 4, 0, 0, 0, 4, 0, 0, 0, 4, 0, 0, 0);
+
+   while (len > 0) {
+      n = (len < 256) ? len : 256;
+
+      for (k = 0; k < 4; k++) {
+         c[k] = _mm512_xor_si512(_mm512_shuffle_epi8(ctr, bswap), K[0]);
+         ctr  = _mm512_add_epi32(ctr, inc);
+      }
+      for (i = 1; i < Nr; i++) {
+         for (k = 0; k < 4; k++) {
+            c[k] = _mm512_aesenc_epi128(c[k], K[i]);
+         }
+      }
+      for (k = 0; k < 4; k++) {
+         c[k] = _mm512_aesenclast_epi128(c[k], K[Nr]);
+      }
+
+      if (n == 256) {
+         for (k = 0; k < 4; k++) {
+            d[k] = VAES_LOAD4(in + 64 * k);
+            c[k] = _mm512_xor_si512(c[k], d[k]);
+            VAES_STORE4(out + 64 * k, c[k]);
+            d[k] = _mm512_shuffle_epi8(direction == GCM_ENCRYPT ? c[k] : d[k], bswap);
+         }
+      } else {
+         for (k = 0; k < 4; k++) {
+            if (64 * k >= n) {
+               d[k] = _mm512_setzero_si512();
+               continue;
+            }
+            mask = (n - 64 * k >= 64) ? (__mmask64)~CONST64(0) : VAES_MASK(n - 64 * k);
+            d[k] = _mm512_maskz_loadu_epi8(mask, in + 64 * k);
+            c[k] = _mm512_maskz_mov_epi8(mask, _mm512_xor_si512(c[k], d[k]));
+            _mm512_mask_storeu_epi8(out + 64 * k, mask, c[k]);
+            d[k] = _mm512_shuffle_epi8(direction == GCM_ENCRYPT ? c[k] : d[k], bswap);
+         }
+      }
+      x = _ghash(x, Hpow, d, n);
+
+      y = _mm_add_epi32(y, _mm_cvtsi32_si128((int)((n + 15) / 16)));
+      in  += n;
+      out += n;
+      len -= n;
+   }
+
+   VAES_STORE(X, _reflect(x));
+   VAES_STORE(Y, _reflect(y));
+#ifdef LTC_CLEAN_STACK
+   zeromem(K, sizeof(K));
+#endif
+   return CRYPT_OK;
+}
+
+#endif
+
+/* ref:         $Format:%D$ */
+/* git commit:  $Format:%H$ */
+/* commit time: $Format:%ai$ */
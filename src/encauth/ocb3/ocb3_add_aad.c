@@ -21,17 +21,17 @@
    @param aad_block  [in] AAD data (block_len size)
    @return CRYPT_OK if successful
 */
-static int _ocb3_int_aad_add_block(ocb3_state *ocb, const unsigned char *aad_block)
+static int _ocb3_int_aad_add_block(ocb3_msg *ocb, const unsigned char *aad_block)
 {
    unsigned char tmp[MAXBLOCKSIZE];
    int err;
 
    /* Offset_i = Offset_{i-1} xor L_{ntz(i)} */
-   ocb3_int_xor_blocks(ocb->aOffset_current, ocb->aOffset_current, ocb->L_[ocb3_int_ntz(ocb->ablock_index)], ocb->block_len);
+   ocb3_int_xor_blocks(ocb->aOffset_current, ocb->aOffset_current, ocb->key->L_[ocb3_int_ntz(ocb->ablock_index)], ocb->block_len);
 
    /* Sum_i = Sum_{i-1} xor ENCIPHER(K, A_i xor Offset_i) */
    ocb3_int_xor_blocks(tmp, aad_block, ocb->aOffset_current, ocb->block_len);
-   if ((err = cipher_descriptor[ocb->cipher].ecb_encrypt(tmp, tmp, &ocb->key)) != CRYPT_OK) {
+   if ((err = cipher_descriptor[ocb->cipher].ecb_encrypt(tmp, tmp, &ocb->key->key)) != CRYPT_OK) {
      return err;
    }
    ocb3_int_xor_blocks(ocb->aSum_current, ocb->aSum_current, tmp, ocb->block_len);
@@ -43,18 +43,19 @@ static int _ocb3_int_aad_add_block(ocb3_state *ocb, const unsigned char *aad_blo
 
 /**
    Add AAD - additional associated data
-   @param ocb       The OCB state
+   @param ocb       The OCB message state
    @param aad       The AAD data
    @param aadlen    The size of AAD data (octets)
    @return CRYPT_OK if successful
 */
-int ocb3_add_aad(ocb3_state *ocb, const unsigned char *aad, unsigned long aadlen)
+int ocb3_msg_add_aad(ocb3_msg *ocb, const unsigned char *aad, unsigned long aadlen)
 {
    int err, x, full_blocks, full_blocks_len, last_block_len;
    unsigned char *data;
    unsigned long datalen, l;
 
    LTC_ARGCHK(ocb != NULL);
+   LTC_ARGCHK(ocb->key != NULL);
    if (aadlen == 0) return CRYPT_OK;
    LTC_ARGCHK(aad != NULL);
 
@@ -99,6 +100,20 @@ int ocb3_add_aad(ocb3_state *ocb, const unsigned char *aad, unsigned long aadlen
    return CRYPT_OK;
 }
 
+/**
+   Add AAD - additional associated data
+   @param ocb       The OCB state
+   @param aad       The AAD data
+   @param aadlen    The size of AAD data (octets)
+   @return CRYPT_OK if successful
+*/
+int ocb3_add_aad(ocb3_state *ocb, const unsigned char *aad, unsigned long aadlen)
+{
+   LTC_ARGCHK(ocb != NULL);
+   ocb->msg.key = &ocb->key;
+   return ocb3_msg_add_aad(&ocb->msg, aad, aadlen);
+}
+
 #endif
 
 /* ref:         $Format:%D$ */
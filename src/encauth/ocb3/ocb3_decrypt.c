@@ -17,19 +17,20 @@
 
 /**
    Decrypt blocks of ciphertext with OCB
-   @param ocb     The OCB state
+   @param ocb     The OCB message state
    @param ct      The ciphertext (length multiple of the block size of the block cipher)
    @param ctlen   The length of the input (octets)
    @param pt      [out] The plaintext (length of ct)
    @return CRYPT_OK if successful
 */
-int ocb3_decrypt(ocb3_state *ocb, const unsigned char *ct, unsigned long ctlen, unsigned char *pt)
+int ocb3_msg_decrypt(ocb3_msg *ocb, const unsigned char *ct, unsigned long ctlen, unsigned char *pt)
 {
    unsigned char tmp[MAXBLOCKSIZE];
    int err, i, full_blocks;
    unsigned char *pt_b, *ct_b;
 
    LTC_ARGCHK(ocb != NULL);
+   LTC_ARGCHK(ocb->key != NULL);
    if (ctlen == 0) return CRYPT_OK; /* no data, nothing to do */
    LTC_ARGCHK(ct != NULL);
    LTC_ARGCHK(pt != NULL);
@@ -51,13 +52,13 @@ int ocb3_decrypt(ocb3_state *ocb, const unsigned char *ct, unsigned long ctlen,
      ct_b = (unsigned char *)ct+i*ocb->block_len;
 
      /* ocb->Offset_current[] = ocb->Offset_current[] ^ Offset_{ntz(block_index)} */
-     ocb3_int_xor_blocks(ocb->Offset_current, ocb->Offset_current, ocb->L_[ocb3_int_ntz(ocb->block_index)], ocb->block_len);
+     ocb3_int_xor_blocks(ocb->Offset_current, ocb->Offset_current, ocb->key->L_[ocb3_int_ntz(ocb->block_index)], ocb->block_len);
 
      /* tmp[] = ct[] XOR ocb->Offset_current[] */
      ocb3_int_xor_blocks(tmp, ct_b, ocb->Offset_current, ocb->block_len);
 
      /* decrypt */
-     if ((err = cipher_descriptor[ocb->cipher].ecb_decrypt(tmp, tmp, &ocb->key)) != CRYPT_OK) {
+     if ((err = cipher_descriptor[ocb->cipher].ecb_decrypt(tmp, tmp, &ocb->key->key)) != CRYPT_OK) {
         goto LBL_ERR;
      }
 
@@ -79,6 +80,21 @@ LBL_ERR:
    return err;
 }
 
+/**
+   Decrypt blocks of ciphertext with OCB
+   @param ocb     The OCB state
+   @param ct      The ciphertext (length multiple of the block size of the block cipher)
+   @param ctlen   The length of the input (octets)
+   @param pt      [out] The plaintext (length of ct)
+   @return CRYPT_OK if successful
+*/
+int ocb3_decrypt(ocb3_state *ocb, const unsigned char *ct, unsigned long ctlen, unsigned char *pt)
+{
+   LTC_ARGCHK(ocb != NULL);
+   ocb->msg.key = &ocb->key;
+   return ocb3_msg_decrypt(&ocb->msg, ct, ctlen, pt);
+}
+
 #endif
 
 /* ref:         $Format:%D$ */
@@ -17,19 +17,20 @@
 
 /**
    Finish an OCB (decryption) stream
-   @param ocb    The OCB state
+   @param ocb    The OCB message state
    @param ct     The remaining ciphertext
    @param ctlen  The length of the ciphertext (octets)
    @param pt     [out] The output buffer
    @return CRYPT_OK if successful
 */
-int ocb3_decrypt_last(ocb3_state *ocb, const unsigned char *ct, unsigned long ctlen, unsigned char *pt)
+int ocb3_msg_decrypt_last(ocb3_msg *ocb, const unsigned char *ct, unsigned long ctlen, unsigned char *pt)
 {
    unsigned char iOffset_star[MAXBLOCKSIZE];
    unsigned char iPad[MAXBLOCKSIZE];
    int err, x, full_blocks, full_blocks_len, last_block_len;
 
    LTC_ARGCHK(ocb != NULL);
+   LTC_ARGCHK(ocb->key != NULL);
    if (ct == NULL) LTC_ARGCHK(ctlen == 0);
    if (ctlen != 0) {
       LTC_ARGCHK(ct    != NULL);
@@ -46,17 +47,17 @@ int ocb3_decrypt_last(ocb3_state *ocb, const unsigned char *ct, unsigned long ct
 
    /* process full blocks first */
    if (full_blocks>0) {
-     if ((err = ocb3_decrypt(ocb, ct, full_blocks_len, pt)) != CRYPT_OK) {
+     if ((err = ocb3_msg_decrypt(ocb, ct, full_blocks_len, pt)) != CRYPT_OK) {
        goto LBL_ERR;
      }
    }
 
    if (last_block_len>0) {
      /* Offset_* = Offset_m xor L_* */
-     ocb3_int_xor_blocks(iOffset_star, ocb->Offset_current, ocb->L_star, ocb->block_len);
+     ocb3_int_xor_blocks(iOffset_star, ocb->Offset_current, ocb->key->L_star, ocb->block_len);
 
      /* Pad = ENCIPHER(K, Offset_*) */
-     if ((err = cipher_descriptor[ocb->cipher].ecb_encrypt(iOffset_star, iPad, &ocb->key)) != CRYPT_OK) {
+     if ((err = cipher_descriptor[ocb->cipher].ecb_encrypt(iOffset_star, iPad, &ocb->key->key)) != CRYPT_OK) {
        goto LBL_ERR;
      }
 
@@ -76,9 +77,9 @@ int ocb3_decrypt_last(ocb3_state *ocb, const unsigned char *ct, unsigned long ct
      /* Tag = ENCIPHER(K, Checksum_* xor Offset_* xor L_$) xor HASH(K,A) */
      /* at this point we calculate only: Tag_part = ENCIPHER(K, Checksum_* xor Offset_* xor L_$) */
      for(x=0; x<ocb->block_len; x++) {
-       ocb->tag_part[x] = (ocb->checksum[x] ^ iOffset_star[x]) ^ ocb->L_dollar[x];
+       ocb->tag_part[x] = (ocb->checksum[x] ^ iOffset_star[x]) ^ ocb->key->L_dollar[x];
      }
-     if ((err = cipher_descriptor[ocb->cipher].ecb_encrypt(ocb->tag_part, ocb->tag_part, &ocb->key)) != CRYPT_OK) {
+     if ((err = cipher_descriptor[ocb->cipher].ecb_encrypt(ocb->tag_part, ocb->tag_part, &ocb->key->key)) != CRYPT_OK) {
        goto LBL_ERR;
      }
    }
@@ -86,9 +87,9 @@ int ocb3_decrypt_last(ocb3_state *ocb, const unsigned char *ct, unsigned long ct
      /* Tag = ENCIPHER(K, Checksum_m xor Offset_m xor L_$) xor HASH(K,A) */
      /* at this point we calculate only: Tag_part = ENCIPHER(K, Checksum_m xor Offset_m xor L_$) */
      for(x=0; x<ocb->block_len; x++) {
-       ocb->tag_part[x] = (ocb->checksum[x] ^ ocb->Offset_current[x]) ^ ocb->L_dollar[x];
+       ocb->tag_part[x] = (ocb->checksum[x] ^ ocb->Offset_current[x]) ^ ocb->key->L_dollar[x];
      }
-     if ((err = cipher_descriptor[ocb->cipher].ecb_encrypt(ocb->tag_part, ocb->tag_part, &ocb->key)) != CRYPT_OK) {
+     if ((err = cipher_descriptor[ocb->cipher].ecb_encrypt(ocb->tag_part, ocb->tag_part, &ocb->key->key)) != CRYPT_OK) {
        goto LBL_ERR;
      }
    }
@@ -104,6 +105,21 @@ LBL_ERR:
    return err;
 }
 
+/**
+   Finish an OCB (decryption) stream
+   @param ocb    The OCB state
+   @param ct     The remaining ciphertext
+   @param ctlen  The length of the ciphertext (octets)
+   @param pt     [out] The output buffer
+   @return CRYPT_OK if successful
+*/
+int ocb3_decrypt_last(ocb3_state *ocb, const unsigned char *ct, unsigned long ctlen, unsigned char *pt)
+{
+   LTC_ARGCHK(ocb != NULL);
+   ocb->msg.key = &ocb->key;
+   return ocb3_msg_decrypt_last(&ocb->msg, ct, ctlen, pt);
+}
+
 #endif
 
 /* ref:         $Format:%D$ */
@@ -16,10 +16,8 @@
 #ifdef LTC_OCB3_MODE
 
 /**
-   Decrypt and compare the tag with OCB
-   @param cipher     The index of the cipher desired
-   @param key        The secret key
-   @param keylen     The length of the secret key (octets)
+   Decrypt and compare the tag with OCB and an expanded key
+   @param key        The expanded key
    @param nonce      The session nonce (length of the block size of the block cipher)
    @param noncelen   The length of the nonce (octets)
    @param adata      The AAD - additional associated data
@@ -32,8 +30,7 @@
    @param stat       [out] The result of the tag comparison (1==valid, 0==invalid)
    @return CRYPT_OK if successful regardless of the tag comparison
 */
-int ocb3_decrypt_verify_memory(int cipher,
-    const unsigned char *key,    unsigned long keylen,
+int ocb3_key_decrypt_verify_memory(const ocb3_key *key,
     const unsigned char *nonce,  unsigned long noncelen,
     const unsigned char *adata,  unsigned long adatalen,
     const unsigned char *ct,     unsigned long ctlen,
@@ -42,8 +39,8 @@ int ocb3_decrypt_verify_memory(int cipher,
           int           *stat)
 {
    int            err;
-   ocb3_state     *ocb;
-   unsigned char *buf;
+   ocb3_msg       ocb;
+   unsigned char  buf[MAXBLOCKSIZE];
    unsigned long  buflen;
 
    LTC_ARGCHK(stat    != NULL);
@@ -54,35 +51,22 @@ int ocb3_decrypt_verify_memory(int cipher,
    /* limit taglen */
    taglen = MIN(taglen, MAXBLOCKSIZE);
 
-   /* allocate memory */
-   buf = XMALLOC(taglen);
-   ocb = XMALLOC(sizeof(ocb3_state));
-   if (ocb == NULL || buf == NULL) {
-      if (ocb != NULL) {
-         XFREE(ocb);
-      }
-      if (buf != NULL) {
-         XFREE(buf);
-      }
-      return CRYPT_MEM;
-   }
-
-   if ((err = ocb3_init(ocb, cipher, key, keylen, nonce, noncelen, taglen)) != CRYPT_OK) {
+   if ((err = ocb3_msg_init(&ocb, key, nonce, noncelen, taglen)) != CRYPT_OK) {
       goto LBL_ERR;
    }
 
    if (adata != NULL || adatalen != 0) {
-      if ((err = ocb3_add_aad(ocb, adata, adatalen)) != CRYPT_OK) {
+      if ((err = ocb3_msg_add_aad(&ocb, adata, adatalen)) != CRYPT_OK) {
          goto LBL_ERR;
       }
    }
 
-   if ((err = ocb3_decrypt_last(ocb, ct, ctlen, pt)) != CRYPT_OK) {
+   if ((err = ocb3_msg_decrypt_last(&ocb, ct, ctlen, pt)) != CRYPT_OK) {
       goto LBL_ERR;
    }
 
    buflen = taglen;
-   if ((err = ocb3_done(ocb, buf, &buflen)) != CRYPT_OK) {
+   if ((err = ocb3_msg_done(&ocb, buf, &buflen)) != CRYPT_OK) {
       goto LBL_ERR;
    }
 
@@ -95,11 +79,65 @@ int ocb3_decrypt_verify_memory(int cipher,
 
 LBL_ERR:
 #ifdef LTC_CLEAN_STACK
-   zeromem(ocb, sizeof(ocb3_state));
+   zeromem(&ocb, sizeof(ocb));
+   zeromem(buf, sizeof(buf));
+#endif
+
+   return err;
+}
+
+/**
+   Decrypt and compare the tag with OCB
+   @param cipher     The index of the cipher desired
+   @param key        The secret key
+   @param keylen     The length of the secret key (octets)
+   @param nonce      The session nonce (length of the block size of the block cipher)
+   @param noncelen   The length of the nonce (octets)
+   @param adata      The AAD - additional associated data
+   @param adatalen   The length of AAD (octets)
+   @param ct         The ciphertext
+   @param ctlen      The length of the ciphertext (octets)
+   @param pt         [out] The plaintext
+   @param tag        The tag to compare against
+   @param taglen     The length of the tag (octets)
+   @param stat       [out] The result of the tag comparison (1==valid, 0==invalid)
+   @return CRYPT_OK if successful regardless of the tag comparison
+*/
+int ocb3_decrypt_verify_memory(int cipher,
+    const unsigned char *key,    unsigned long keylen,
+    const unsigned char *nonce,  unsigned long noncelen,
+    const unsigned char *adata,  unsigned long adatalen,
+    const unsigned char *ct,     unsigned long ctlen,
+          unsigned char *pt,
+    const unsigned char *tag,    unsigned long taglen,
+          int           *stat)
+{
+   int            err;
+   ocb3_key       *ocb;
+
+   LTC_ARGCHK(stat    != NULL);
+
+   /* default to zero */
+   *stat = 0;
+
+   /* allocate memory */
+   ocb = XMALLOC(sizeof(ocb3_key));
+   if (ocb == NULL) {
+      return CRYPT_MEM;
+   }
+
+   if ((err = ocb3_key_init(ocb, cipher, key, keylen)) != CRYPT_OK) {
+      goto LBL_ERR;
+   }
+
+   err = ocb3_key_decrypt_verify_memory(ocb, nonce, noncelen, adata, adatalen, ct, ctlen, pt, tag, taglen, stat);
+
+LBL_ERR:
+#ifdef LTC_CLEAN_STACK
+   zeromem(ocb, sizeof(ocb3_key));
 #endif
 
    XFREE(ocb);
-   XFREE(buf);
    return err;
 }
 
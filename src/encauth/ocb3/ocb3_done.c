@@ -17,17 +17,18 @@
 
 /**
    Finish OCB processing and compute the tag
-   @param ocb     The OCB state
+   @param ocb     The OCB message state
    @param tag     [out] The destination for the authentication tag
    @param taglen  [in/out] The max size and resulting size of the authentication tag
    @return CRYPT_OK if successful
 */
-int ocb3_done(ocb3_state *ocb, unsigned char *tag, unsigned long *taglen)
+int ocb3_msg_done(ocb3_msg *ocb, unsigned char *tag, unsigned long *taglen)
 {
    unsigned char tmp[MAXBLOCKSIZE];
    int err, x;
 
    LTC_ARGCHK(ocb    != NULL);
+   LTC_ARGCHK(ocb->key != NULL);
    LTC_ARGCHK(tag    != NULL);
    LTC_ARGCHK(taglen != NULL);
    if ((err = cipher_is_valid(ocb->cipher)) != CRYPT_OK) {
@@ -44,7 +45,7 @@ int ocb3_done(ocb3_state *ocb, unsigned char *tag, unsigned long *taglen)
 
    if (ocb->adata_buffer_bytes>0) {
      /* Offset_* = Offset_m xor L_* */
-     ocb3_int_xor_blocks(ocb->aOffset_current, ocb->aOffset_current, ocb->L_star, ocb->block_len);
+     ocb3_int_xor_blocks(ocb->aOffset_current, ocb->aOffset_current, ocb->key->L_star, ocb->block_len);
 
      /* CipherInput = (A_* || 1 || zeros(127-bitlen(A_*))) xor Offset_* */
      ocb3_int_xor_blocks(tmp, ocb->adata_buffer, ocb->aOffset_current, ocb->adata_buffer_bytes);
@@ -58,7 +59,7 @@ int ocb3_done(ocb3_state *ocb, unsigned char *tag, unsigned long *taglen)
      }
 
      /* Sum = Sum_m xor ENCIPHER(K, CipherInput) */
-     if ((err = cipher_descriptor[ocb->cipher].ecb_encrypt(tmp, tmp, &ocb->key)) != CRYPT_OK) {
+     if ((err = cipher_descriptor[ocb->cipher].ecb_encrypt(tmp, tmp, &ocb->key->key)) != CRYPT_OK) {
        goto LBL_ERR;
      }
      ocb3_int_xor_blocks(ocb->aSum_current, ocb->aSum_current, tmp, ocb->block_len);
@@ -85,6 +86,20 @@ LBL_ERR:
    return err;
 }
 
+/**
+   Finish OCB processing and compute the tag
+   @param ocb     The OCB state
+   @param tag     [out] The destination for the authentication tag
+   @param taglen  [in/out] The max size and resulting size of the authentication tag
+   @return CRYPT_OK if successful
+*/
+int ocb3_done(ocb3_state *ocb, unsigned char *tag, unsigned long *taglen)
+{
+   LTC_ARGCHK(ocb != NULL);
+   ocb->msg.key = &ocb->key;
+   return ocb3_msg_done(&ocb->msg, tag, taglen);
+}
+
 #endif
 
 /* ref:         $Format:%D$ */
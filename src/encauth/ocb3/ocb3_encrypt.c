@@ -17,19 +17,20 @@
 
 /**
    Encrypt blocks of data with OCB
-   @param ocb     The OCB state
+   @param ocb     The OCB message state
    @param pt      The plaintext (length multiple of the block size of the block cipher)
    @param ptlen   The length of the input (octets)
    @param ct      [out] The ciphertext (same size as the pt)
    @return CRYPT_OK if successful
 */
-int ocb3_encrypt(ocb3_state *ocb, const unsigned char *pt, unsigned long ptlen, unsigned char *ct)
+int ocb3_msg_encrypt(ocb3_msg *ocb, const unsigned char *pt, unsigned long ptlen, unsigned char *ct)
 {
    unsigned char tmp[MAXBLOCKSIZE];
    int err, i, full_blocks;
    unsigned char *pt_b, *ct_b;
 
    LTC_ARGCHK(ocb != NULL);
+   LTC_ARGCHK(ocb->key != NULL);
    if (ptlen == 0) return CRYPT_OK; /* no data, nothing to do */
    LTC_ARGCHK(pt != NULL);
    LTC_ARGCHK(ct != NULL);
@@ -51,13 +52,13 @@ int ocb3_encrypt(ocb3_state *ocb, const unsigned char *pt, unsigned long ptlen,
      ct_b = (unsigned char *)ct+i*ocb->block_len;
 
      /* ocb->Offset_current[] = ocb->Offset_current[] ^ Offset_{ntz(block_index)} */
-     ocb3_int_xor_blocks(ocb->Offset_current, ocb->Offset_current, ocb->L_[ocb3_int_ntz(ocb->block_index)], ocb->block_len);
+     ocb3_int_xor_blocks(ocb->Offset_current, ocb->Offset_current, ocb->key->L_[ocb3_int_ntz(ocb->block_index)], ocb->block_len);
 
      /* tmp[] = pt[] XOR ocb->Offset_current[] */
      ocb3_int_xor_blocks(tmp, pt_b, ocb->Offset_current, ocb->block_len);
 
      /* encrypt */
-     if ((err = cipher_descriptor[ocb->cipher].ecb_encrypt(tmp, tmp, &ocb->key)) != CRYPT_OK) {
+     if ((err = cipher_descriptor[ocb->cipher].ecb_encrypt(tmp, tmp, &ocb->key->key)) != CRYPT_OK) {
         goto LBL_ERR;
      }
 
@@ -79,6 +80,21 @@ LBL_ERR:
    return err;
 }
 
+/**
+   Encrypt blocks of data with OCB
+   @param ocb     The OCB state
+   @param pt      The plaintext (length multiple of the block size of the block cipher)
+   @param ptlen   The length of the input (octets)
+   @param ct      [out] The ciphertext (same size as the pt)
+   @return CRYPT_OK if successful
+*/
+int ocb3_encrypt(ocb3_state *ocb, const unsigned char *pt, unsigned long ptlen, unsigned char *ct)
+{
+   LTC_ARGCHK(ocb != NULL);
+   ocb->msg.key = &ocb->key;
+   return ocb3_msg_encrypt(&ocb->msg, pt, ptlen, ct);
+}
+
 #endif
 
 /* ref:         $Format:%D$ */
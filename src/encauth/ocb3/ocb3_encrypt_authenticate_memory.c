@@ -15,6 +15,56 @@
 
 #ifdef LTC_OCB3_MODE
 
+/**
+   Encrypt and generate an authentication code for a buffer of memory with an expanded key
+   @param key        The expanded key
+   @param nonce      The session nonce (length of the block ciphers block size)
+   @param noncelen   The length of the nonce (octets)
+   @param adata      The AAD - additional associated data
+   @param adatalen   The length of AAD (octets)
+   @param pt         The plaintext
+   @param ptlen      The length of the plaintext (octets)
+   @param ct         [out] The ciphertext
+   @param tag        [out] The authentication tag
+   @param taglen     [in/out] The max size and resulting size of the authentication tag
+   @return CRYPT_OK if successful
+*/
+int ocb3_key_encrypt_authenticate_memory(const ocb3_key *key,
+    const unsigned char *nonce,  unsigned long noncelen,
+    const unsigned char *adata,  unsigned long adatalen,
+    const unsigned char *pt,     unsigned long ptlen,
+          unsigned char *ct,
+          unsigned char *tag,    unsigned long *taglen)
+{
+   int err;
+   ocb3_msg ocb;
+
+   LTC_ARGCHK(taglen != NULL);
+
+   if ((err = ocb3_msg_init(&ocb, key, nonce, noncelen, *taglen)) != CRYPT_OK) {
+      goto LBL_ERR;
+   }
+
+   if (adata != NULL || adatalen != 0) {
+      if ((err = ocb3_msg_add_aad(&ocb, adata, adatalen)) != CRYPT_OK) {
+         goto LBL_ERR;
+      }
+   }
+
+   if ((err = ocb3_msg_encrypt_last(&ocb, pt, ptlen, ct)) != CRYPT_OK) {
+      goto LBL_ERR;
+   }
+
+   err = ocb3_msg_done(&ocb, tag, taglen);
+
+LBL_ERR:
+#ifdef LTC_CLEAN_STACK
+   zeromem(&ocb, sizeof(ocb));
+#endif
+
+   return err;
+}
+
 /**
    Encrypt and generate an authentication code for a buffer of memory
    @param cipher     The index of the cipher desired
@@ -40,35 +90,25 @@ int ocb3_encrypt_authenticate_memory(int cipher,
           unsigned char *tag,    unsigned long *taglen)
 {
    int err;
-   ocb3_state *ocb;
+   ocb3_key *ocb;
 
    LTC_ARGCHK(taglen != NULL);
 
    /* allocate memory */
-   ocb = XMALLOC(sizeof(ocb3_state));
+   ocb = XMALLOC(sizeof(ocb3_key));
    if (ocb == NULL) {
       return CRYPT_MEM;
    }
 
-   if ((err = ocb3_init(ocb, cipher, key, keylen, nonce, noncelen, *taglen)) != CRYPT_OK) {
-      goto LBL_ERR;
-   }
-
-   if (adata != NULL || adatalen != 0) {
-      if ((err = ocb3_add_aad(ocb, adata, adatalen)) != CRYPT_OK) {
-         goto LBL_ERR;
-      }
-   }
-
-   if ((err = ocb3_encrypt_last(ocb, pt, ptlen, ct)) != CRYPT_OK) {
+   if ((err = ocb3_key_init(ocb, cipher, key, keylen)) != CRYPT_OK) {
       goto LBL_ERR;
    }
 
-   err = ocb3_done(ocb, tag, taglen);
+   err = ocb3_key_encrypt_authenticate_memory(ocb, nonce, noncelen, adata, adatalen, pt, ptlen, ct, tag, taglen);
 
 LBL_ERR:
 #ifdef LTC_CLEAN_STACK
-   zeromem(ocb, sizeof(ocb3_state));
+   zeromem(ocb, sizeof(ocb3_key));
 #endif
 
    XFREE(ocb);
@@ -15,49 +15,21 @@
 
 #ifdef LTC_OCB3_MODE
 
-static void _ocb3_int_calc_offset_zero(ocb3_state *ocb, const unsigned char *nonce, unsigned long noncelen, unsigned long taglen)
+static void _ocb3_int_calc_offset_zero(ocb3_msg *ocb, const unsigned char *nonce, unsigned long noncelen, unsigned long taglen)
 {
-   int x, y, bottom;
-   int idx, shift;
+   int bottom;
    unsigned char iNonce[MAXBLOCKSIZE];
    unsigned char iKtop[MAXBLOCKSIZE];
-   unsigned char iStretch[MAXBLOCKSIZE+8];
 
-   /* Nonce = zeros(127-bitlen(N)) || 1 || N          */
-   zeromem(iNonce, sizeof(iNonce));
-   for (x = ocb->block_len-1, y=0; y<(int)noncelen; x--, y++) {
-     iNonce[x] = nonce[noncelen-y-1];
-   }
-   iNonce[x] = 0x01;
-   iNonce[0] |= ((taglen*8) % 128) << 1;
-
-   /* bottom = str2num(Nonce[123..128])               */
-   bottom = iNonce[ocb->block_len-1] & 0x3F;
+   ocb3_int_nonce_block(iNonce, &bottom, ocb->block_len, nonce, noncelen, taglen);
 
    /* Ktop = ENCIPHER(K, Nonce[1..122] || zeros(6))   */
-   iNonce[ocb->block_len-1] = iNonce[ocb->block_len-1] & 0xC0;
-   if ((cipher_descriptor[ocb->cipher].ecb_encrypt(iNonce, iKtop, &ocb->key)) != CRYPT_OK) {
+   if ((cipher_descriptor[ocb->cipher].ecb_encrypt(iNonce, iKtop, &ocb->key->key)) != CRYPT_OK) {
       zeromem(ocb->Offset_current, ocb->block_len);
       return;
    }
 
-   /* Stretch = Ktop || (Ktop[1..64] xor Ktop[9..72]) */
-   for (x = 0; x < ocb->block_len; x++) {
-     iStretch[x] = iKtop[x];
-   }
-   for (y = 0; y < 8; y++) {
-     iStretch[x+y] = iKtop[y] ^ iKtop[y+1];
-   }
-
-   /* Offset_0 = Stretch[1+bottom..128+bottom]        */
-   idx = bottom / 8;
-   shift = (bottom % 8);
-   for (x = 0; x < ocb->block_len; x++) {
-      ocb->Offset_current[x] = iStretch[idx+x] << shift;
-      if (shift > 0) {
-        ocb->Offset_current[x] |= iStretch[idx+x+1] >> (8-shift);
-      }
-   }
+   ocb3_int_offset_zero(ocb->Offset_current, iKtop, bottom, ocb->block_len);
 }
 
 static const struct {
@@ -75,27 +47,21 @@ static const struct {
 };
 
 /**
-   Initialize an OCB context
-   @param ocb       [out] The destination of the OCB state
+   Expand an OCB key, the result can be used for several messages
+   @param ocb       [out] The destination of the expanded key
    @param cipher    The index of the desired cipher
    @param key       The secret key
    @param keylen    The length of the secret key (octets)
-   @param nonce     The session nonce
-   @param noncelen  The length of the session nonce (octets, up to 15)
-   @param taglen    The length of the tag (octets, up to 16)
    @return CRYPT_OK if successful
 */
-int ocb3_init(ocb3_state *ocb, int cipher,
-             const unsigned char *key, unsigned long keylen,
-             const unsigned char *nonce, unsigned long noncelen,
-             unsigned long taglen)
+int ocb3_key_init(ocb3_key *ocb, int cipher,
+                  const unsigned char *key, unsigned long keylen)
 {
    int poly, x, y, m, err;
    unsigned char *previous, *current;
 
    LTC_ARGCHK(ocb   != NULL);
    LTC_ARGCHK(key   != NULL);
-   LTC_ARGCHK(nonce != NULL);
 
    /* valid cipher? */
    if ((err = cipher_is_valid(cipher)) != CRYPT_OK) {
@@ -103,23 +69,11 @@ int ocb3_init(ocb3_state *ocb, int cipher,
    }
    ocb->cipher = cipher;
 
-   /* Valid Nonce?
-    * As of RFC7253: "string of no more than 120 bits" */
-   if (noncelen > (120/8)) {
-      return CRYPT_INVALID_ARG;
-   }
-
    /* The blockcipher must have a 128-bit blocksize */
    if (cipher_descriptor[cipher].block_length != 16) {
       return CRYPT_INVALID_ARG;
    }
 
-   /* The TAGLEN may be any value up to 128 (bits) */
-   if (taglen > 16) {
-      return CRYPT_INVALID_ARG;
-   }
-   ocb->tag_len = taglen;
-
    /* determine which polys to use */
    ocb->block_len = cipher_descriptor[cipher].block_length;
    x = (int)(sizeof(polys)/sizeof(polys[0]));
@@ -171,6 +125,49 @@ int ocb3_init(ocb3_state *ocb, int cipher,
       }
    }
 
+   return CRYPT_OK;
+}
+
+/**
+   Start a new message with an expanded key
+   @param ocb       [out] The destination of the OCB message state
+   @param key       The expanded key, it must stay valid until the message is done
+   @param nonce     The session nonce
+   @param noncelen  The length of the session nonce (octets, up to 15)
+   @param taglen    The length of the tag (octets, up to 16)
+   @return CRYPT_OK if successful
+*/
+int ocb3_msg_init(ocb3_msg *ocb, const ocb3_key *key,
+                  const unsigned char *nonce, unsigned long noncelen,
+                  unsigned long taglen)
+{
+   int err;
+
+   LTC_ARGCHK(ocb   != NULL);
+   LTC_ARGCHK(key   != NULL);
+   LTC_ARGCHK(nonce != NULL);
+
+   /* valid cipher? */
+   if ((err = cipher_is_valid(key->cipher)) != CRYPT_OK) {
+      return err;
+   }
+
+   /* Valid Nonce?
+    * As of RFC7253: "string of no more than 120 bits" */
+   if (noncelen > (120/8)) {
+      return CRYPT_INVALID_ARG;
+   }
+
+   /* The TAGLEN may be any value up to 128 (bits) */
+   if (taglen > 16) {
+      return CRYPT_INVALID_ARG;
+   }
+
+   ocb->key       = key;
+   ocb->cipher    = key->cipher;
+   ocb->block_len = key->block_len;
+   ocb->tag_len   = taglen;
+
    /* initialize ocb->Offset_current = Offset_0 */
    _ocb3_int_calc_offset_zero(ocb, nonce, noncelen, taglen);
 
@@ -189,6 +186,45 @@ int ocb3_init(ocb3_state *ocb, int cipher,
    return CRYPT_OK;
 }
 
+/**
+   Initialize an OCB context
+   @param ocb       [out] The destination of the OCB state
+   @param cipher    The index of the desired cipher
+   @param key       The secret key
+   @param keylen    The length of the secret key (octets)
+   @param nonce     The session nonce
+   @param noncelen  The length of the session nonce (octets, up to 15)
+   @param taglen    The length of the tag (octets, up to 16)
+   @return CRYPT_OK if successful
+*/
+int ocb3_init(ocb3_state *ocb, int cipher,
+             const unsigned char *key, unsigned long keylen,
+             const unsigned char *nonce, unsigned long noncelen,
+             unsigned long taglen)
+{
+   int err;
+
+   LTC_ARGCHK(ocb   != NULL);
+   LTC_ARGCHK(key   != NULL);
+   LTC_ARGCHK(nonce != NULL);
+
+   /* Valid Nonce?
+    * As of RFC7253: "string of no more than 120 bits" */
+   if (noncelen > (120/8)) {
+      return CRYPT_INVALID_ARG;
+   }
+
+   /* The TAGLEN may be any value up to 128 (bits) */
+   if (taglen > 16) {
+      return CRYPT_INVALID_ARG;
+   }
+
+   if ((err = ocb3_key_init(&ocb->key, cipher, key, keylen)) != CRYPT_OK) {
+      return err;
+   }
+   return ocb3_msg_init(&ocb->msg, &ocb->key, nonce, noncelen, taglen);
+}
+
 #endif
 
 /* ref:         $Format:%D$ */
@@ -0,0 +1,83 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ */
+
+/**
+   @file ocb3_int_offset_zero.c
+   OCB implementation, INTERNAL ONLY helper, by Tom St Denis
+*/
+#include "tomcrypt_private.h"
+
+#ifdef LTC_OCB3_MODE
+
+/**
+   Format the nonce, the result has to be encrypted to get Ktop (internal function)
+   @param iNonce     [out] The block to encrypt (block_len octets)
+   @param bottom     [out] The last six bits of the nonce
+   @param block_len  The block length of the cipher
+   @param nonce      The session nonce
+   @param noncelen   The length of the session nonce (octets)
+   @param taglen     The length of the tag (octets)
+*/
+void ocb3_int_nonce_block(unsigned char *iNonce, int *bottom, int block_len,
+                          const unsigned char *nonce, unsigned long noncelen, unsigned long taglen)
+{
+   int x, y;
+
+   /* Nonce = zeros(127-bitlen(N)) || 1 || N          */
+   zeromem(iNonce, block_len);
+   for (x = block_len-1, y=0; y<(int)noncelen; x--, y++) {
+     iNonce[x] = nonce[noncelen-y-1];
+   }
+   iNonce[x] = 0x01;
+   iNonce[0] |= ((taglen*8) % 128) << 1;
+
+   /* bottom = str2num(Nonce[123..128])               */
+   *bottom = iNonce[block_len-1] & 0x3F;
+
+   /* Ktop = ENCIPHER(K, Nonce[1..122] || zeros(6))   */
+   iNonce[block_len-1] = iNonce[block_len-1] & 0xC0;
+}
+
+/**
+   Compute Offset_0 (internal function)
+   @param Offset     [out] Offset_0 (block_len octets)
+   @param iKtop      Ktop, the encrypted nonce block
+   @param bottom     The last six bits of the nonce
+   @param block_len  The block length of the cipher
+*/
+void ocb3_int_offset_zero(unsigned char *Offset, const unsigned char *iKtop, int bottom, int block_len)
+{
+   int x, y;
+   int idx, shift;
+   unsigned char iStretch[MAXBLOCKSIZE+8];
+
+   /* Stretch = Ktop || (Ktop[1..64] xor Ktop[9..72]) */
+   for (x = 0; x < block_len; x++) {
+     iStretch[x] = iKtop[x];
+   }
+   for (y = 0; y < 8; y++) {
+     iStretch[x+y] = iKtop[y] ^ iKtop[y+1];
+   }
+
+   /* Offset_0 = Stretch[1+bottom..128+bottom]        */
+   idx = bottom / 8;
+   shift = (bottom % 8);
+   for (x = 0; x < block_len; x++) {
+      Offset[x] = iStretch[idx+x] << shift;
+      if (shift > 0) {
+        Offset[x] |= iStretch[idx+x+1] >> (8-shift);
+      }
+   }
+}
+
+#endif
+
+/* ref:         $Format:%D$ */
+/* git commit:  $Format:%H$ */
+/* commit time: $Format:%ai$ */
@@ -0,0 +1,316 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ */
+
+/**
+   @file ocb3_memory_batch.c
+   OCB implementation, process a batch of packets
+
+   All block cipher calls of OCB3 are independent of each other within a
+   stage of the computation, so they're collected for all packets and done
+   in three passes: the nonces, the AAD and message blocks and the tags.
+*/
+#include "tomcrypt_private.h"
+
+#ifdef LTC_OCB3_MODE
+
+/* the number of blocks which are encrypted at once */
+#define OCB3_BATCH_BLOCKS 256
+
+typedef struct {
+   unsigned char        dat[OCB3_BATCH_BLOCKS][16];      /* the message blocks */
+   unsigned char        off[OCB3_BATCH_BLOCKS][16];      /* their offsets */
+   unsigned char        aux[OCB3_BATCH_BLOCKS][16];      /* the nonces, AAD blocks and pads */
+   unsigned char        offset[OCB3_BATCH_BLOCKS][16];   /* the current offset of each packet, later HASH(K,A) */
+   unsigned char        sum[OCB3_BATCH_BLOCKS][16];      /* the checksum of each packet, later the tag */
+   int                  bottom[OCB3_BATCH_BLOCKS];
+   const symmetric_key *dkey[OCB3_BATCH_BLOCKS];
+   const symmetric_key *akey[OCB3_BATCH_BLOCKS];
+   int                  dcipher[OCB3_BATCH_BLOCKS];
+   int                  acipher[OCB3_BATCH_BLOCKS];
+} _ocb3_batch;
+
+/* out = a xor b for one block of 16 octets */
+static LTC_INLINE void _ocb3_batch_xor(unsigned char *out, const unsigned char *a, const unsigned char *b)
+{
+#ifdef LTC_FAST
+   unsigned long x;
+
+   for (x = 0; x < 16; x += sizeof(LTC_FAST_TYPE)) {
+      *(LTC_FAST_TYPE_PTR_CAST(&out[x])) = *(LTC_FAST_TYPE_PTR_CAST(&a[x])) ^ *(LTC_FAST_TYPE_PTR_CAST(&b[x]));
+   }
+#else
+   ocb3_int_xor_blocks(out, a, b, 16);
+#endif
+}
+
+static int _ocb3_batch_check(const aead_packet *p, int direction)
+{
+   const ocb3_key *key = p->key.ocb3;
+   int err;
+
+   if (p->mode != LTC_AEAD_OCB3 || key == NULL || p->nonce == NULL || p->noncelen > (120/8) ||
+       p->taglen == 0 || p->taglen > 16 || p->tag == NULL || (p->adatalen > 0 && p->adata == NULL) ||
+       (p->inlen > 0 && (p->in == NULL || p->out == NULL))) {
+      return CRYPT_INVALID_ARG;
+   }
+   if (direction != LTC_ENCRYPT && direction != LTC_DECRYPT) {
+      return CRYPT_INVALID_ARG;
+   }
+   if ((err = cipher_is_valid(key->cipher)) != CRYPT_OK) {
+      return err;
+   }
+   if (key->block_len != 16) {
+      return CRYPT_INVALID_ARG;
+   }
+   return CRYPT_OK;
+}
+
+/* the number of AAD blocks plus the pad of the last message block */
+static unsigned long _ocb3_batch_aux_blocks(const aead_packet *p)
+{
+   return (p->adatalen + 15) / 16 + ((p->inlen % 16) != 0 ? 1 : 0);
+}
+
+/* a packet which is too long for a batch */
+static int _ocb3_batch_single(const aead_packet *p, int direction)
+{
+   unsigned long taglen = p->taglen;
+   int           err, stat;
+
+   if (direction == LTC_ENCRYPT) {
+      return ocb3_key_encrypt_authenticate_memory(p->key.ocb3, p->nonce, p->noncelen, p->adata, p->adatalen,
+                                                  p->in, p->inlen, p->out, p->tag, &taglen);
+   }
+   if ((err = ocb3_key_decrypt_verify_memory(p->key.ocb3, p->nonce, p->noncelen, p->adata, p->adatalen,
+                                             p->in, p->inlen, p->out, p->tag, p->taglen, &stat)) != CRYPT_OK) {
+      return err;
+   }
+   if (stat != 1) {
+      zeromem(p->out, p->inlen);
+      return CRYPT_ERROR;
+   }
+   return CRYPT_OK;
+}
+
+/* process the packets i..j-1 */
+static int _ocb3_batch_run(_ocb3_batch *b, aead_packet *pkt, unsigned long i, unsigned long j, int direction)
+{
+   const ocb3_key *key;
+   unsigned char   tmp[16];
+   unsigned long   k, r, a, d, x, full, last;
+   int             err;
+
+   /* Ktop = ENCIPHER(K, Nonce[1..122] || zeros(6)) */
+   for (k = i, r = 0; k < j; k++) {
+      if (pkt[k].err != CRYPT_OK) continue;
+      key = pkt[k].key.ocb3;
+      ocb3_int_nonce_block(b->aux[r], &b->bottom[r], 16, pkt[k].nonce, pkt[k].noncelen, pkt[k].taglen);
+      b->akey[r]    = &key->key;
+      b->acipher[r] = key->cipher;
+      r++;
+   }
+   if ((err = aead_int_ecb_multi(b->aux[0], b->aux[0], r, b->akey, b->acipher, LTC_ENCRYPT)) != CRYPT_OK) {
+      return err;
+   }
+
+   /* Offset_0 of all packets, before aux is overwritten */
+   for (x = 0; x < r; x++) {
+      ocb3_int_offset_zero(b->offset[x], b->aux[x], b->bottom[x], 16);
+      zeromem(b->sum[x], 16);
+   }
+
+   /* the inputs of the AAD and message blocks */
+   for (k = i, r = 0, a = 0, d = 0; k < j; k++) {
+      if (pkt[k].err != CRYPT_OK) continue;
+      key = pkt[k].key.ocb3;
+
+      /* A_i xor Offset_i, tmp is the AAD offset */
+      zeromem(tmp, 16);
+      full = pkt[k].adatalen / 16;
+      for (x = 0; x < full; x++, a++) {
+         _ocb3_batch_xor(tmp, tmp, key->L_[ocb3_int_ntz(x + 1)]);
+         _ocb3_batch_xor(b->aux[a], pkt[k].adata + 16 * x, tmp);
+         b->akey[a]    = &key->key;
+         b->acipher[a] = key->cipher;
+      }
+      last = pkt[k].adatalen % 16;
+      if (last != 0) {
+         /* (A_* || 1 || zeros(127-bitlen(A_*))) xor Offset_* */
+         _ocb3_batch_xor(tmp, tmp, key->L_star);
+         ocb3_int_xor_blocks(b->aux[a], pkt[k].adata + 16 * full, tmp, last);
+         b->aux[a][last] = 0x80 ^ tmp[last];
+         XMEMCPY(b->aux[a] + last + 1, tmp + last + 1, 15 - last);
+         b->akey[a]    = &key->key;
+         b->acipher[a] = key->cipher;
+         a++;
+      }
+
+      /* P_i xor Offset_i, the checksum of the plaintext is computed now when encrypting */
+      full = pkt[k].inlen / 16;
+      for (x = 0; x < full; x++, d++) {
+         _ocb3_batch_xor(b->offset[r], b->offset[r], key->L_[ocb3_int_ntz(x + 1)]);
+         XMEMCPY(b->off[d], b->offset[r], 16);
+         _ocb3_batch_xor(b->dat[d], pkt[k].in + 16 * x, b->offset[r]);
+         if (direction == LTC_ENCRYPT) {
+            _ocb3_batch_xor(b->sum[r], b->sum[r], pkt[k].in + 16 * x);
+         }
+         b->dkey[d]    = &key->key;
+         b->dcipher[d] = key->cipher;
+      }
+      if ((pkt[k].inlen % 16) != 0) {
+         /* Pad = ENCIPHER(K, Offset_*) */
+         _ocb3_batch_xor(b->offset[r], b->offset[r], key->L_star);
+         XMEMCPY(b->aux[a], b->offset[r], 16);
+         b->akey[a]    = &key->key;
+         b->acipher[a] = key->cipher;
+         a++;
+      }
+      r++;
+   }
+   if ((err = aead_int_ecb_multi(b->aux[0], b->aux[0], a, b->akey, b->acipher, LTC_ENCRYPT)) != CRYPT_OK) {
+      return err;
+   }
+   if ((err = aead_int_ecb_multi(b->dat[0], b->dat[0], d, b->dkey, b->dcipher, direction)) != CRYPT_OK) {
+      return err;
+   }
+
+   /* the output, HASH(K,A) and the inputs of the tags */
+   for (k = i, r = 0, a = 0, d = 0; k < j; k++) {
+      if (pkt[k].err != CRYPT_OK) continue;
+      key = pkt[k].key.ocb3;
+
+      zeromem(tmp, 16);
+      for (x = 0; x < (pkt[k].adatalen + 15) / 16; x++, a++) {
+         _ocb3_batch_xor(tmp, tmp, b->aux[a]);
+      }
+
+      full = pkt[k].inlen / 16;
+      for (x = 0; x < full; x++, d++) {
+         _ocb3_batch_xor(pkt[k].out + 16 * x, b->dat[d], b->off[d]);
+         if (direction == LTC_DECRYPT) {
+            _ocb3_batch_xor(b->sum[r], b->sum[r], pkt[k].out + 16 * x);
+         }
+      }
+      last = pkt[k].inlen % 16;
+      if (last != 0) {
+         /* C_* = P_* xor Pad[1..bitlen(P_*)], Checksum_* = Checksum_m xor (P_* || 1 || zeros(127-bitlen(P_*))) */
+         if (direction == LTC_ENCRYPT) {
+            ocb3_int_xor_blocks(b->sum[r], b->sum[r], pkt[k].in + 16 * full, last);
+         }
+         ocb3_int_xor_blocks(pkt[k].out + 16 * full, pkt[k].in + 16 * full, b->aux[a], last);
+         if (direction == LTC_DECRYPT) {
+            ocb3_int_xor_blocks(b->sum[r], b->sum[r], pkt[k].out + 16 * full, last);
+         }
+         b->sum[r][last] ^= 0x80;
+         a++;
+      }
+
+      /* Tag = ENCIPHER(K, Checksum xor Offset xor L_$) xor HASH(K,A) */
+      for (x = 0; x < 16; x++) {
+         b->sum[r][x] ^= b->offset[r][x] ^ key->L_dollar[x];
+      }
+      XMEMCPY(b->offset[r], tmp, 16);
+      b->akey[r]    = &key->key;
+      b->acipher[r] = key->cipher;
+      r++;
+   }
+   if ((err = aead_int_ecb_multi(b->sum[0], b->sum[0], r, b->akey, b->acipher, LTC_ENCRYPT)) != CRYPT_OK) {
+      return err;
+   }
+
+   for (k = i, r = 0; k < j; k++) {
+      if (pkt[k].err != CRYPT_OK) continue;
+      _ocb3_batch_xor(b->sum[r], b->sum[r], b->offset[r]);
+      if (direction == LTC_ENCRYPT) {
+         XMEMCPY(pkt[k].tag, b->sum[r], pkt[k].taglen);
+      } else if (XMEM_NEQ(b->sum[r], pkt[k].tag, pkt[k].taglen) != 0) {
+         if (pkt[k].inlen > 0) {
+            zeromem(pkt[k].out, pkt[k].inlen);
+         }
+         pkt[k].err = CRYPT_ERROR;
+      }
+      r++;
+   }
+
+#ifdef LTC_CLEAN_STACK
+   zeromem(tmp, sizeof(tmp));
+#endif
+   return CRYPT_OK;
+}
+
+/**
+   Encrypt or decrypt a batch of independent OCB3 packets
+   @param pkt       The packets, their mode is LTC_AEAD_OCB3
+   @param n         The number of packets
+   @param direction LTC_ENCRYPT or LTC_DECRYPT
+   @return CRYPT_OK if all packets were successful, otherwise the error of the first packet which failed
+*/
+int ocb3_memory_batch(aead_packet *pkt, unsigned long n, int direction)
+{
+   _ocb3_batch   *b;
+   unsigned long  i, j, k, packets, auxs, dats;
+   int            err, ret;
+
+   LTC_ARGCHK(pkt != NULL || n == 0);
+
+   b = XMALLOC(sizeof(*b));
+   if (b == NULL) {
+      return CRYPT_MEM;
+   }
+
+   ret = CRYPT_OK;
+   for (i = 0; i < n; i = j) {
+      /* collect as many packets as fit */
+      packets = auxs = dats = 0;
+      for (j = i; j < n && packets < OCB3_BATCH_BLOCKS; j++) {
+         if (auxs + _ocb3_batch_aux_blocks(&pkt[j]) > OCB3_BATCH_BLOCKS ||
+             dats + pkt[j].inlen / 16 > OCB3_BATCH_BLOCKS) {
+            break;
+         }
+         if ((pkt[j].err = _ocb3_batch_check(&pkt[j], direction)) != CRYPT_OK) {
+            continue;
+         }
+         packets++;
+         auxs += _ocb3_batch_aux_blocks(&pkt[j]);
+         dats += pkt[j].inlen / 16;
+      }
+
+      if (j == i) {
+         /* the packet doesn't fit, process it on its own */
+         if ((pkt[j].err = _ocb3_batch_check(&pkt[j], direction)) == CRYPT_OK) {
+            pkt[j].err = _ocb3_batch_single(&pkt[j], direction);
+         }
+         j++;
+      } else if ((err = _ocb3_batch_run(b, pkt, i, j, direction)) != CRYPT_OK) {
+         for (k = i; k < j; k++) {
+            if (pkt[k].err == CRYPT_OK) {
+               pkt[k].err = err;
+            }
+         }
+      }
+
+      for (k = i; k < j; k++) {
+         if (ret == CRYPT_OK && pkt[k].err != CRYPT_OK) {
+            ret = pkt[k].err;
+         }
+      }
+   }
+
+#ifdef LTC_CLEAN_STACK
+   zeromem(b, sizeof(*b));
+#endif
+   XFREE(b);
+   return ret;
+}
+
+#endif
+
+/* ref:         $Format:%D$ */
+/* git commit:  $Format:%H$ */
+/* commit time: $Format:%ai$ */
@@ -15,6 +15,103 @@
 
 #ifdef LTC_OCB3_MODE
 
+#ifdef LTC_TEST
+#define OCB3_BATCH_TEST_PACKETS 40
+#define OCB3_BATCH_TEST_BIG     5000
+
+typedef struct {
+   ocb3_key      key[3];
+   aead_packet   pkt[OCB3_BATCH_TEST_PACKETS];
+   unsigned char P[OCB3_BATCH_TEST_BIG + OCB3_BATCH_TEST_PACKETS], C[2][OCB3_BATCH_TEST_BIG], D[OCB3_BATCH_TEST_PACKETS][128];
+   unsigned char N[32], A[64], T[2][OCB3_BATCH_TEST_PACKETS][16];
+} _ocb3_batch_test_state;
+
+/* compare a batch of packets under different keys and nonces with ocb3_key_encrypt_authenticate_memory() */
+static int _ocb3_batch_test(int idx)
+{
+   _ocb3_batch_test_state *s;
+   unsigned char kb[32];
+   unsigned long x, y, len, taglen;
+   int err;
+
+   if ((s = XCALLOC(1, sizeof(*s))) == NULL) {
+      return CRYPT_MEM;
+   }
+   for (x = 0; x < sizeof(s->P); x++) {
+      s->P[x] = (unsigned char)(x * 7 + 3);
+   }
+   for (x = 0; x < sizeof(s->A); x++) {
+      s->A[x] = (unsigned char)(x * 11 + 5);
+   }
+   for (x = 0; x < sizeof(s->N); x++) {
+      s->N[x] = (unsigned char)(x * 13 + 1);
+   }
+   for (x = 0; x < 3; x++) {
+      for (y = 0; y < sizeof(kb); y++) {
+         kb[y] = (unsigned char)(x * 31 + y * 17 + 9);
+      }
+      if ((err = ocb3_key_init(&s->key[x], idx, kb, 16 + 8 * (int)x)) != CRYPT_OK) {
+         goto LBL_ERR;
+      }
+   }
+
+   for (x = 0; x < OCB3_BATCH_TEST_PACKETS; x++) {
+      len = (x == OCB3_BATCH_TEST_PACKETS / 2) ? OCB3_BATCH_TEST_BIG : (x * 13) % 100;
+      s->pkt[x].mode     = LTC_AEAD_OCB3;
+      s->pkt[x].key.ocb3 = &s->key[x % 3];
+      s->pkt[x].nonce    = s->N + x % 7;
+      s->pkt[x].noncelen = 1 + x % 15;
+      s->pkt[x].adata    = s->A + x % 5;
+      s->pkt[x].adatalen = (x * 7) % 50;
+      s->pkt[x].in       = s->P + x;
+      s->pkt[x].inlen    = len;
+      s->pkt[x].out      = (len > 128) ? s->C[1] : s->D[x];
+      s->pkt[x].tag      = s->T[1][x];
+      s->pkt[x].taglen   = 16 - x % 4;
+   }
+   if ((err = aead_encrypt_batch(LTC_AEAD_OCB3, s->pkt, OCB3_BATCH_TEST_PACKETS)) != CRYPT_OK) {
+      goto LBL_ERR;
+   }
+   for (x = 0; x < OCB3_BATCH_TEST_PACKETS; x++) {
+      taglen = s->pkt[x].taglen;
+      if ((err = ocb3_key_encrypt_authenticate_memory(&s->key[x % 3], s->pkt[x].nonce, s->pkt[x].noncelen,
+                                                      s->pkt[x].adata, s->pkt[x].adatalen, s->P + x, s->pkt[x].inlen,
+                                                      s->C[0], s->T[0][x], &taglen)) != CRYPT_OK) {
+         goto LBL_ERR;
+      }
+      if (compare_testvector(s->pkt[x].out, s->pkt[x].inlen, s->C[0], s->pkt[x].inlen, "OCB3 batch CT", (int)x) ||
+          compare_testvector(s->T[1][x], s->pkt[x].taglen, s->T[0][x], taglen, "OCB3 batch Tag", (int)x)) {
+         err = CRYPT_FAIL_TESTVECTOR;
+         goto LBL_ERR;
+      }
+   }
+
+   /* decrypt in place, one of the tags is wrong */
+   s->T[1][5][0] ^= 1;
+   for (x = 0; x < OCB3_BATCH_TEST_PACKETS; x++) {
+      s->pkt[x].in = s->pkt[x].out;
+   }
+   err = aead_decrypt_batch(LTC_AEAD_OCB3, s->pkt, OCB3_BATCH_TEST_PACKETS);
+   if (err != CRYPT_ERROR || s->pkt[5].err != CRYPT_ERROR) {
+      err = CRYPT_FAIL_TESTVECTOR;
+      goto LBL_ERR;
+   }
+   for (x = 0; x < OCB3_BATCH_TEST_PACKETS; x++) {
+      XMEMSET(s->C[0], 0, s->pkt[x].inlen);
+      if (compare_testvector(s->pkt[x].out, s->pkt[x].inlen, x == 5 ? s->C[0] : s->P + x, s->pkt[x].inlen, "OCB3 batch PT", (int)x) ||
+          (x != 5 && s->pkt[x].err != CRYPT_OK)) {
+         err = CRYPT_FAIL_TESTVECTOR;
+         goto LBL_ERR;
+      }
+   }
+   err = CRYPT_OK;
+
+LBL_ERR:
+   XFREE(s);
+   return err;
+}
+#endif
+
 /**
    Test the OCB protocol
    @return CRYPT_OK if successful
@@ -206,7 +303,9 @@ int ocb3_test(void)
    unsigned long len;
    unsigned char outct[MAXBLOCKSIZE]  = { 0 };
    unsigned char outtag[MAXBLOCKSIZE] = { 0 };
+   unsigned char outpt[MAXBLOCKSIZE]  = { 0 };
    ocb3_state ocb;
+   ocb3_msg m[2];
 
     /* AES can be under rijndael or aes... try to find it */
     if ((idx = find_cipher("aes")) == -1) {
@@ -298,6 +397,31 @@ int ocb3_test(void)
     if (compare_testvector(outct, sizeof(C), P, sizeof(P), "OCB3 PT", x))          return CRYPT_FAIL_TESTVECTOR;
     if (compare_testvector(outtag, len, T, sizeof(T), "OCB3 Tag.dec", x))          return CRYPT_FAIL_TESTVECTOR;
 
+    /* RFC 7253 - test vector with a tag length of 96 bits - part 3, one expanded key used by two interleaved messages */
+    x = 101;
+    if ((err = ocb3_key_init(&ocb.key, idx, K, sizeof(K))) != CRYPT_OK)                       return err;
+    if ((err = ocb3_msg_init(&m[0], &ocb.key, N, sizeof(N), 12)) != CRYPT_OK)                return err;
+    if ((err = ocb3_msg_init(&m[1], &ocb.key, N, sizeof(N), 12)) != CRYPT_OK)                return err;
+    if ((err = ocb3_msg_add_aad(&m[0], A, sizeof(A))) != CRYPT_OK)                           return err;
+    if ((err = ocb3_msg_add_aad(&m[1], A, sizeof(A))) != CRYPT_OK)                           return err;
+    if ((err = ocb3_msg_encrypt(&m[0], P, 16, outct)) != CRYPT_OK)                           return err;
+    if ((err = ocb3_msg_decrypt(&m[1], C, 32, outpt)) != CRYPT_OK)                           return err;
+    if ((err = ocb3_msg_encrypt_last(&m[0], P+16, sizeof(P)-16, outct+16)) != CRYPT_OK)      return err;
+    if ((err = ocb3_msg_decrypt_last(&m[1], C+32, sizeof(C)-32, outpt+32)) != CRYPT_OK)      return err;
+    len = sizeof(outtag);
+    if ((err = ocb3_msg_done(&m[0], outtag, &len)) != CRYPT_OK)                              return err;
+    if (compare_testvector(outct, sizeof(P), C, sizeof(C), "OCB3 CT", x))                    return CRYPT_FAIL_TESTVECTOR;
+    if (compare_testvector(outtag, len, T, sizeof(T), "OCB3 Tag.enc", x))                    return CRYPT_FAIL_TESTVECTOR;
+    len = sizeof(outtag);
+    if ((err = ocb3_msg_done(&m[1], outtag, &len)) != CRYPT_OK)                              return err;
+    if (compare_testvector(outpt, sizeof(C), P, sizeof(P), "OCB3 PT", x))                    return CRYPT_FAIL_TESTVECTOR;
+    if (compare_testvector(outtag, len, T, sizeof(T), "OCB3 Tag.dec", x))                    return CRYPT_FAIL_TESTVECTOR;
+    if ((err = ocb3_key_decrypt_verify_memory(&ocb.key, N, sizeof(N), A, sizeof(A), C, sizeof(C),
+                                              outpt, T, sizeof(T), &res)) != CRYPT_OK)       return err;
+    if ((res != 1) || compare_testvector(outpt, sizeof(C), P, sizeof(P), "OCB3", x))         return CRYPT_FAIL_TESTVECTOR;
+
+    if ((err = _ocb3_batch_test(idx)) != CRYPT_OK)                                           return err;
+
     return CRYPT_OK;
 #endif /* LTC_TEST */
 }
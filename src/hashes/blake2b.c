@@ -129,6 +129,23 @@ const struct ltc_hash_descriptor blake2b_512_desc =
     NULL
 };
 
+#ifdef LTC_BLAKE2BP
+const struct ltc_hash_descriptor blake2bp_512_desc =
+{
+    "blake2bp-512",
+    33,
+    64,
+    128,
+    { 0 },
+    0,
+    &blake2bp_512_init,
+    &blake2bp_process,
+    &blake2bp_done,
+    &blake2bp_512_test,
+    NULL
+};
+#endif
+
 static const ulong64 blake2b_IV[8] =
 {
   CONST64(0x6a09e667f3bcc908), CONST64(0xbb67ae8584caa73b),
@@ -314,6 +331,13 @@ static int blake2b_compress(hash_state *md, const unsigned char *buf)
    ulong64 v[16];
    unsigned long i;
 
+#ifdef LTC_BLAKE2_SIMD
+   if (ltc_cpu_has(LTC_CPU_AVX2)) {
+      blake2b_avx2_compress(md, buf);
+      return CRYPT_OK;
+   }
+#endif
+
    for (i = 0; i < 16; ++i) {
       LOAD64L(m[i], buf + i * sizeof(m[i]));
    }
@@ -439,6 +463,255 @@ int blake2b_done(hash_state *md, unsigned char *out)
    return CRYPT_OK;
 }
 
+#ifdef LTC_BLAKE2BP
+
+enum {
+   BLAKE2BP_PARALLELISM = 4,
+   BLAKE2BP_STRIPEBYTES = BLAKE2BP_PARALLELISM * BLAKE2B_BLOCKBYTES
+};
+
+/* the number of octets the leaf i compressed, the leaves in front of buflen
+ * already compressed the block of the previous stripe if pending is set
+ */
+static ulong64 blake2bp_leaf_count(const hash_state *md, unsigned long i)
+{
+   if (md->blake2bp.pending && md->blake2bp.buflen > i * BLAKE2B_BLOCKBYTES) {
+      return md->blake2bp.t + BLAKE2B_BLOCKBYTES;
+   }
+   return md->blake2bp.t;
+}
+
+/* compress the next block of the leaf i, len octets of buf, zero padded if it is the last one */
+static void blake2bp_compress_leaf(hash_state *md, unsigned long i, const unsigned char *buf, unsigned long len, int last)
+{
+   hash_state leaf;
+   unsigned char block[BLAKE2B_BLOCKBYTES];
+   unsigned long w;
+
+   for (w = 0; w < 8; ++w) {
+      leaf.blake2b.h[w] = md->blake2bp.h[BLAKE2BP_PARALLELISM * w + i];
+   }
+   leaf.blake2b.t[0] = blake2bp_leaf_count(md, i) + len;
+   leaf.blake2b.t[1] = 0;
+   leaf.blake2b.f[0] = last ? CONST64(0xffffffffffffffff) : 0;
+   leaf.blake2b.f[1] = (last && i == BLAKE2BP_PARALLELISM - 1) ? CONST64(0xffffffffffffffff) : 0;
+
+   XMEMSET(block, 0, sizeof(block));
+   XMEMCPY(block, buf, len);
+   blake2b_compress(&leaf, block);
+
+   for (w = 0; w < 8; ++w) {
+      md->blake2bp.h[BLAKE2BP_PARALLELISM * w + i] = leaf.blake2b.h[w];
+   }
+#ifdef LTC_CLEAN_STACK
+   zeromem(&leaf, sizeof(leaf));
+   zeromem(block, sizeof(block));
+#endif
+}
+
+/* compress a block of each leaf, stripes times, none of them is the last one */
+static void blake2bp_compress_stripes(hash_state *md, const unsigned char *in, unsigned long stripes)
+{
+   unsigned long i;
+
+#ifdef LTC_BLAKE2_SIMD
+   if (ltc_cpu_has(LTC_CPU_AVX2)) {
+      blake2b_avx2_compress4(md->blake2bp.h, &md->blake2bp.t, in, stripes);
+      return;
+   }
+#endif
+   while (stripes-- > 0) {
+      for (i = 0; i < BLAKE2BP_PARALLELISM; ++i) {
+         blake2bp_compress_leaf(md, i, in + i * BLAKE2B_BLOCKBYTES, BLAKE2B_BLOCKBYTES, 0);
+      }
+      md->blake2bp.t += BLAKE2B_BLOCKBYTES;
+      in += BLAKE2BP_STRIPEBYTES;
+   }
+}
+
+/**
+   Initialize the BLAKE2bp hash/MAC state
+
+      The input is split into blocks of 128 octets which are hashed by four
+      BLAKE2b leaves in turns, the root hashes the digests of the leaves.
+
+   @param md      The hash state you wish to initialize
+   @param outlen  The desired output-length
+   @param key     The key of the MAC
+   @param keylen  The length of the key
+   @return CRYPT_OK if successful
+*/
+int blake2bp_init(hash_state *md, unsigned long outlen, const unsigned char *key, unsigned long keylen)
+{
+   unsigned char P[BLAKE2B_PARAM_SIZE];
+   unsigned long i, w;
+   ulong64 tmp;
+
+   LTC_ARGCHK(md != NULL);
+
+   if ((!outlen) || (outlen > BLAKE2B_OUTBYTES)) {
+      return CRYPT_INVALID_ARG;
+   }
+   if ((key && !keylen) || (keylen && !key) || (keylen > BLAKE2B_KEYBYTES)) {
+      return CRYPT_INVALID_ARG;
+   }
+
+   XMEMSET(&md->blake2bp, 0, sizeof(md->blake2bp));
+   XMEMSET(P, 0, sizeof(P));
+
+   P[O_DIGEST_LENGTH] = (unsigned char)outlen;
+   P[O_KEY_LENGTH] = (unsigned char)keylen;
+   P[O_FANOUT] = BLAKE2BP_PARALLELISM;
+   P[O_DEPTH] = 2;
+   P[O_INNER_LENGTH] = BLAKE2B_OUTBYTES;
+
+   for (i = 0; i < BLAKE2BP_PARALLELISM; ++i) {
+      P[O_NODE_OFFSET] = (unsigned char)i;
+      for (w = 0; w < 8; ++w) {
+         LOAD64L(tmp, P + w * 8);
+         md->blake2bp.h[BLAKE2BP_PARALLELISM * w + i] = blake2b_IV[w] ^ tmp;
+      }
+   }
+   md->blake2bp.outlen = (unsigned char)outlen;
+   md->blake2bp.keylen = (unsigned char)keylen;
+
+   if (key) {
+      /* the key block of every leaf, compressed once the leaf gets more data */
+      for (i = 0; i < BLAKE2BP_PARALLELISM; ++i) {
+         XMEMCPY(md->blake2bp.buf + i * BLAKE2B_BLOCKBYTES, key, keylen);
+      }
+      md->blake2bp.pending = 1;
+   }
+
+   return CRYPT_OK;
+}
+
+/**
+   Initialize the hash state
+   @param md   The hash state you wish to initialize
+   @return CRYPT_OK if successful
+*/
+int blake2bp_512_init(hash_state *md) { return blake2bp_init(md, 64, NULL, 0); }
+
+/**
+   Process a block of memory through the hash
+   @param md     The hash state
+   @param in     The data to hash
+   @param inlen  The length of the data (octets)
+   @return CRYPT_OK if successful
+*/
+int blake2bp_process(hash_state *md, const unsigned char *in, unsigned long inlen)
+{
+   unsigned long i, n;
+
+   LTC_ARGCHK(md != NULL);
+   LTC_ARGCHK(in != NULL);
+
+   if (md->blake2bp.buflen > sizeof(md->blake2bp.buf)) {
+      return CRYPT_INVALID_ARG;
+   }
+
+   /* the slot i of buf holds the data of the leaf i.  A leaf compresses a
+    * block only once it gets more data, as the last block is compressed
+    * differently.  So the slots behind buflen still hold the blocks of the
+    * previous stripe if pending is set.
+    */
+   while (inlen > 0) {
+      if (md->blake2bp.buflen == BLAKE2BP_STRIPEBYTES) {
+         if (md->blake2bp.pending) {
+            md->blake2bp.t += BLAKE2B_BLOCKBYTES;
+         }
+         md->blake2bp.buflen = 0;
+         md->blake2bp.pending = 1;
+      }
+      if (md->blake2bp.buflen == 0 && inlen > (BLAKE2BP_PARALLELISM - 1) * BLAKE2B_BLOCKBYTES) {
+         /* every leaf gets more data, so whole stripes can be compressed at once */
+         if (md->blake2bp.pending) {
+            blake2bp_compress_stripes(md, md->blake2bp.buf, 1);
+            md->blake2bp.pending = 0;
+         }
+         n = (inlen - (BLAKE2BP_PARALLELISM - 1) * BLAKE2B_BLOCKBYTES - 1) / BLAKE2BP_STRIPEBYTES;
+         if (n > 0) {
+            blake2bp_compress_stripes(md, in, n);
+            in += n * BLAKE2BP_STRIPEBYTES;
+            inlen -= n * BLAKE2BP_STRIPEBYTES;
+         }
+      }
+      i = md->blake2bp.buflen / BLAKE2B_BLOCKBYTES;
+      if (md->blake2bp.buflen % BLAKE2B_BLOCKBYTES == 0 && md->blake2bp.pending) {
+         blake2bp_compress_leaf(md, i, md->blake2bp.buf + i * BLAKE2B_BLOCKBYTES, BLAKE2B_BLOCKBYTES, 0);
+      }
+      n = MIN(inlen, BLAKE2B_BLOCKBYTES - md->blake2bp.buflen % BLAKE2B_BLOCKBYTES);
+      XMEMCPY(md->blake2bp.buf + md->blake2bp.buflen, in, n);
+      md->blake2bp.buflen += n;
+      in += n;
+      inlen -= n;
+   }
+   return CRYPT_OK;
+}
+
+/**
+   Terminate the hash to get the digest
+   @param md  The hash state
+   @param out [out] The destination of the hash (size depending on the length used on init)
+   @return CRYPT_OK if successful
+*/
+int blake2bp_done(hash_state *md, unsigned char *out)
+{
+   unsigned char P[BLAKE2B_PARAM_SIZE];
+   unsigned char leaves[BLAKE2BP_PARALLELISM * BLAKE2B_OUTBYTES];
+   hash_state root;
+   unsigned long i, w, len;
+   int err;
+
+   LTC_ARGCHK(md != NULL);
+   LTC_ARGCHK(out != NULL);
+
+   if (md->blake2bp.buflen > sizeof(md->blake2bp.buf)) {
+      return CRYPT_INVALID_ARG;
+   }
+
+   /* the last block of every leaf, it may be empty */
+   for (i = 0; i < BLAKE2BP_PARALLELISM; ++i) {
+      if (md->blake2bp.buflen > i * BLAKE2B_BLOCKBYTES) {
+         len = MIN(md->blake2bp.buflen - i * BLAKE2B_BLOCKBYTES, BLAKE2B_BLOCKBYTES);
+      } else {
+         len = md->blake2bp.pending ? BLAKE2B_BLOCKBYTES : 0;
+      }
+      blake2bp_compress_leaf(md, i, md->blake2bp.buf + i * BLAKE2B_BLOCKBYTES, len, 1);
+      for (w = 0; w < 8; ++w) {
+         STORE64L(md->blake2bp.h[BLAKE2BP_PARALLELISM * w + i], leaves + i * BLAKE2B_OUTBYTES + w * 8);
+      }
+   }
+
+   XMEMSET(P, 0, sizeof(P));
+   P[O_DIGEST_LENGTH] = (unsigned char)md->blake2bp.outlen;
+   P[O_KEY_LENGTH] = md->blake2bp.keylen;
+   P[O_FANOUT] = BLAKE2BP_PARALLELISM;
+   P[O_DEPTH] = 2;
+   P[O_NODE_DEPTH] = 1;
+   P[O_INNER_LENGTH] = BLAKE2B_OUTBYTES;
+
+   if ((err = blake2b_init_param(&root, P)) != CRYPT_OK) {
+      goto LBL_ERR;
+   }
+   root.blake2b.last_node = 1;
+   if ((err = blake2b_process(&root, leaves, sizeof(leaves))) != CRYPT_OK) {
+      goto LBL_ERR;
+   }
+   err = blake2b_done(&root, out);
+
+LBL_ERR:
+   zeromem(md, sizeof(hash_state));
+#ifdef LTC_CLEAN_STACK
+   zeromem(leaves, sizeof(leaves));
+   zeromem(&root, sizeof(root));
+#endif
+   return err;
+}
+
+#endif /* LTC_BLAKE2BP */
+
 /**
   Self-test the hash
   @return CRYPT_OK if successful, CRYPT_NOP if self-tests have been disabled
@@ -486,8 +759,12 @@ int blake2b_512_test(void)
          return CRYPT_FAIL_TESTVECTOR;
       }
    }
+#ifdef LTC_AMD64_SIMD
+   return hash_test_cpu(&blake2b_512_desc);
+#else
    return CRYPT_OK;
 #endif
+#endif
 }
 
 /**
@@ -631,6 +908,121 @@ int blake2b_160_test(void)
 #endif
 }
 
+#ifdef LTC_BLAKE2BP
+/**
+  Self-test the hash
+  @return CRYPT_OK if successful, CRYPT_NOP if self-tests have been disabled
+*/
+int blake2bp_512_test(void)
+{
+#ifndef LTC_TEST
+   return CRYPT_NOP;
+#else
+   /* the messages are x * 13 + 5, the keys 0, 1, 2, ... */
+   static const struct {
+      unsigned long msglen, keylen;
+      unsigned char hash[64];
+   } tests[] = {
+      { 0, 0,
+        { 0xb5, 0xef, 0x81, 0x1a, 0x80, 0x38, 0xf7, 0x0b,
+          0x62, 0x8f, 0xa8, 0xb2, 0x94, 0xda, 0xae, 0x74,
+          0x92, 0xb1, 0xeb, 0xe3, 0x43, 0xa8, 0x0e, 0xaa,
+          0xbb, 0xf1, 0xf6, 0xae, 0x66, 0x4d, 0xd6, 0x7b,
+          0x9d, 0x90, 0xb0, 0x12, 0x07, 0x91, 0xea, 0xb8,
+          0x1d, 0xc9, 0x69, 0x85, 0xf2, 0x88, 0x49, 0xf6,
+          0xa3, 0x05, 0x18, 0x6a, 0x85, 0x50, 0x1b, 0x40,
+          0x51, 0x14, 0xbf, 0xa6, 0x78, 0xdf, 0x93, 0x80 } },
+      { 3, 0,
+        { 0x93, 0x00, 0xda, 0xa9, 0xf2, 0x2d, 0xcd, 0x90,
+          0xbd, 0xdc, 0x09, 0xcf, 0xab, 0x43, 0x0e, 0x19,
+          0xf6, 0x79, 0x2e, 0x72, 0x83, 0x98, 0x75, 0xf5,
+          0x16, 0x3b, 0xae, 0xc2, 0x36, 0x12, 0x9d, 0xe8,
+          0xd2, 0x6a, 0xb5, 0x75, 0x3e, 0x89, 0xb0, 0xe2,
+          0xc6, 0x20, 0x03, 0x5f, 0xea, 0xc6, 0xdd, 0xb0,
+          0x52, 0xb2, 0x54, 0xb9, 0x51, 0xed, 0x42, 0xd5,
+          0x4f, 0x0a, 0x31, 0x9c, 0xe4, 0x68, 0x98, 0xe5 } },
+      { 512, 0,
+        { 0x44, 0xe9, 0x75, 0xba, 0x9a, 0x0a, 0x9d, 0xc4,
+          0x8d, 0x81, 0x57, 0x67, 0x44, 0x76, 0xb0, 0x6f,
+          0x51, 0x2d, 0xf9, 0x5e, 0xde, 0x78, 0xbe, 0xeb,
+          0xe8, 0x3f, 0xe6, 0xea, 0xb9, 0x7a, 0xa3, 0x42,
+          0x59, 0x3e, 0x1d, 0xe6, 0x2a, 0xc1, 0xef, 0xe8,
+          0x6a, 0x3f, 0x35, 0xf7, 0x37, 0x6f, 0xd0, 0x32,
+          0xc9, 0x20, 0xb1, 0xff, 0x8d, 0xc2, 0x29, 0xe7,
+          0xb4, 0xf9, 0x2a, 0xd9, 0x20, 0x95, 0xf8, 0xf7 } },
+      { 1000, 0,
+        { 0xba, 0x63, 0x7c, 0x59, 0x8b, 0x14, 0x6c, 0xaa,
+          0x32, 0x8e, 0x18, 0x86, 0x9f, 0x41, 0x7e, 0xf9,
+          0x21, 0xee, 0xd6, 0x6b, 0xa3, 0x79, 0x48, 0x40,
+          0x73, 0x4b, 0x90, 0x46, 0x28, 0x6a, 0xb7, 0x91,
+          0x01, 0x2e, 0x95, 0x62, 0x01, 0xdc, 0x96, 0x37,
+          0x6a, 0x3f, 0x4e, 0x51, 0xe2, 0x23, 0x5a, 0xa5,
+          0x41, 0xa9, 0xf4, 0xd7, 0xdd, 0x0f, 0x03, 0xec,
+          0x84, 0x3d, 0x29, 0x20, 0x06, 0x07, 0x5a, 0x0d } },
+      { 0, 64,
+        { 0x9d, 0x94, 0x61, 0x07, 0x3e, 0x4e, 0xb6, 0x40,
+          0xa2, 0x55, 0x35, 0x7b, 0x83, 0x9f, 0x39, 0x4b,
+          0x83, 0x8c, 0x6f, 0xf5, 0x7c, 0x9b, 0x68, 0x6a,
+          0x3f, 0x76, 0x10, 0x7c, 0x10, 0x66, 0x72, 0x8f,
+          0x3c, 0x99, 0x56, 0xbd, 0x78, 0x5c, 0xbc, 0x3b,
+          0xf7, 0x9d, 0xc2, 0xab, 0x57, 0x8c, 0x5a, 0x0c,
+          0x06, 0x3b, 0x9d, 0x9c, 0x40, 0x58, 0x48, 0xde,
+          0x1d, 0xbe, 0x82, 0x1c, 0xd0, 0x5c, 0x94, 0x0a } },
+      { 1000, 64,
+        { 0x99, 0x2e, 0x23, 0x51, 0x3e, 0xa8, 0x8c, 0xc3,
+          0xa7, 0x18, 0xa1, 0x31, 0x09, 0xad, 0xed, 0x97,
+          0x2d, 0x94, 0x22, 0x5c, 0x43, 0x49, 0x18, 0x60,
+          0xd4, 0xfa, 0x2e, 0xee, 0xb9, 0x85, 0x31, 0x14,
+          0x92, 0xf5, 0xa6, 0xd0, 0x41, 0xa8, 0x4e, 0xd9,
+          0xf4, 0xc6, 0xf3, 0x20, 0x2d, 0xfa, 0x04, 0xc9,
+          0xe5, 0x18, 0xec, 0x0e, 0x58, 0x1e, 0x24, 0x59,
+          0x54, 0xcc, 0x97, 0x50, 0x08, 0x68, 0xd0, 0xad } },
+   };
+   static const unsigned long pieces[] = { 1, 127, 128, 385, 512, 7, 900 };
+   unsigned char msg[1000], key[64], tmp[64];
+   unsigned long x, y, k;
+   int i, j;
+#ifdef LTC_BLAKE2_SIMD
+   unsigned long mask;
+#endif
+   hash_state md;
+
+   for (x = 0; x < sizeof(msg); x++) {
+      msg[x] = (unsigned char)(x * 13 + 5);
+   }
+   for (x = 0; x < sizeof(key); x++) {
+      key[x] = (unsigned char)x;
+   }
+
+   for (i = 0; i < (int)(sizeof(tests) / sizeof(tests[0])); i++) {
+      /* in one piece, in pieces of different sizes and without SIMD */
+      for (j = 0; j < 3; j++) {
+#ifdef LTC_BLAKE2_SIMD
+         mask = ltc_cpu_mask(j == 2 ? 0 : ~0UL);
+#endif
+         blake2bp_init(&md, 64, tests[i].keylen ? key : NULL, tests[i].keylen);
+         if (j == 1) {
+            for (x = k = 0; x < tests[i].msglen; x += y, k++) {
+               y = MIN(pieces[k % (sizeof(pieces) / sizeof(pieces[0]))], tests[i].msglen - x);
+               blake2bp_process(&md, msg + x, y);
+            }
+         } else {
+            blake2bp_process(&md, msg, tests[i].msglen);
+         }
+         blake2bp_done(&md, tmp);
+#ifdef LTC_BLAKE2_SIMD
+         ltc_cpu_mask(mask);
+#endif
+         if (compare_testvector(tmp, sizeof(tmp), tests[i].hash, sizeof(tests[i].hash), "BLAKE2BP_512", i * 3 + j)) {
+            return CRYPT_FAIL_TESTVECTOR;
+         }
+      }
+   }
+   return CRYPT_OK;
+#endif
+}
+#endif /* LTC_BLAKE2BP */
+
 #endif
 
 /* ref:         $Format:%D$ */
@@ -0,0 +1,247 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ */
+
+/**
+   @file blake2b_simd.c
+   BLAKE2b compression using the AVX2 instructions of x86-64 CPUs
+
+   Each row of the 4x4 state matrix is held in one register, so the four G
+   functions of a column or diagonal step run side by side.  The rows are
+   rotated against each other between the column and the diagonal steps.
+
+   The leaves of BLAKE2bp are compressed four at once instead, each 64-bit
+   lane of a register belongs to one of them.
+*/
+#include "tomcrypt_private.h"
+
+#if defined(LTC_BLAKE2_SIMD) && defined(LTC_BLAKE2B)
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+/* the AVX-512 macros of GCC mix declarations and code */
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wdeclaration-after-statement"
+#endif
+#include <immintrin.h>
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+#endif
+
+#define AVX2_TARGET LTC_ATTRIBUTE_TARGET("avx2")
+
+#define AVX2_LOAD(p)      _mm256_loadu_si256((const __m256i *)(const void *)(p))
+#define AVX2_STORE(p, v)  _mm256_storeu_si256((__m256i *)(void *)(p), (v))
+
+static const ulong64 blake2b_IV[8] = {
+   CONST64(0x6a09e667f3bcc908), CONST64(0xbb67ae8584caa73b),
+   CONST64(0x3c6ef372fe94f82b), CONST64(0xa54ff53a5f1d36f1),
+   CONST64(0x510e527fade682d1), CONST64(0x9b05688c2b3e6c1f),
+   CONST64(0x1f83d9abfb41bd6b), CONST64(0x5be0cd19137e2179)
+};
+
+static const unsigned char blake2b_sigma[12][16] = {
+   {  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14, 15 },
+   { 14, 10,  4,  8,  9, 15, 13,  6,  1, 12,  0,  2, 11,  7,  5,  3 },
+   { 11,  8, 12,  0,  5,  2, 15, 13, 10, 14,  3,  6,  7,  1,  9,  4 },
+   {  7,  9,  3,  1, 13, 12, 11, 14,  2,  6,  5, 10,  4,  0, 15,  8 },
+   {  9,  0,  5,  7,  2,  4, 10, 15, 14,  1, 11, 12,  6,  8,  3, 13 },
+   {  2, 12,  6, 10,  0, 11,  8,  3,  4, 13,  7,  5, 15, 14,  1,  9 },
+   { 12,  5,  1, 15, 14, 13,  4, 10,  0,  7,  6,  3,  9,  2,  8, 11 },
+   { 13, 11,  7, 14, 12,  1,  3,  9,  5,  0, 15,  4,  8,  6,  2, 10 },
+   {  6, 15, 14,  9, 11,  3,  0,  8, 12,  2, 13,  7,  1,  4, 10,  5 },
+   { 10,  2,  8,  4,  7,  6,  1,  5, 15, 11,  9, 14,  3, 12, 13,  0 },
+   {  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14, 15 },
+   { 14, 10,  4,  8,  9, 15, 13,  6,  1, 12,  0,  2, 11,  7,  5,  3 }
+};
+
+/* the message words sigma[r][i], sigma[r][i+2], sigma[r][i+4] and sigma[r][i+6] */
+#define MSG(r, i) _mm256_setr_epi64x((long long)m[blake2b_sigma[r][(i)]],     (long long)m[blake2b_sigma[r][(i) + 2]], \
+                                     (long long)m[blake2b_sigma[r][(i) + 4]], (long long)m[blake2b_sigma[r][(i) + 6]])
+
+/* four G functions, on the columns or on the diagonals */
+#define G4(m0, m1)                                                          \
+   a = _mm256_add_epi64(_mm256_add_epi64(a, b), (m0));                      \
+   d = _mm256_shuffle_epi32(_mm256_xor_si256(d, a), _MM_SHUFFLE(2, 3, 0, 1)); \
+   c = _mm256_add_epi64(c, d);                                              \
+   b = _mm256_shuffle_epi8(_mm256_xor_si256(b, c), rot24);                  \
+   a = _mm256_add_epi64(_mm256_add_epi64(a, b), (m1));                      \
+   d = _mm256_shuffle_epi8(_mm256_xor_si256(d, a), rot16);                  \
+   c = _mm256_add_epi64(c, d);                                              \
+   b = _mm256_xor_si256(b, c);                                              \
+   b = _mm256_xor_si256(_mm256_srli_epi64(b, 63), _mm256_add_epi64(b, b));
+
+#define ROUND(r)                                                            \
+   G4(MSG(r, 0), MSG(r, 1))                                                 \
+   b = _mm256_permute4x64_epi64(b, _MM_SHUFFLE(0, 3, 2, 1));                \
+   c = _mm256_permute4x64_epi64(c, _MM_SHUFFLE(1, 0, 3, 2));                \
+   d = _mm256_permute4x64_epi64(d, _MM_SHUFFLE(2, 1, 0, 3));                \
+   G4(MSG(r, 8), MSG(r, 9))                                                 \
+   b = _mm256_permute4x64_epi64(b, _MM_SHUFFLE(2, 1, 0, 3));                \
+   c = _mm256_permute4x64_epi64(c, _MM_SHUFFLE(1, 0, 3, 2));                \
+   d = _mm256_permute4x64_epi64(d, _MM_SHUFFLE(0, 3, 2, 1));
+
+/**
+  Compress a block with AVX2
+  @param md   [in/out] The BLAKE2b state, the counter and the final flags are already set
+  @param buf  The block, 128 octets
+*/
+AVX2_TARGET
+void blake2b_avx2_compress(hash_state *md, const unsigned char *buf)
+{
+   ulong64 m[16];
+   __m256i a, b, c, d, h0, h1, rot16, rot24;
+   unsigned long i;
+
+   rot16 = _mm256_setr_epi8(2, 3, 4, 5, 6, 7, 0, 1, 10, 11, 12, 13, 14, 15, 8, 9,
+                            2, 3, 4, 5, 6, 7, 0, 1, 10, 11, 12, 13, 14, 15, 8, 9);
+   rot24 = _mm256_setr_epi8(3, 4, 5, 6, 7, 0, 1, 2, 11, 12, 13, 14, 15, 8, 9, 10,
+                            3, 4, 5, 6, 7, 0, 1, 2, 11, 12, 13, 14, 15, 8, 9, 10);
+
+   for (i = 0; i < 16; ++i) {
+      LOAD64L(m[i], buf + i * sizeof(m[i]));
+   }
+
+   a = h0 = AVX2_LOAD(md->blake2b.h);
+   b = h1 = AVX2_LOAD(md->blake2b.h + 4);
+   c = AVX2_LOAD(blake2b_IV);
+   d = _mm256_xor_si256(AVX2_LOAD(blake2b_IV + 4),
+                        _mm256_setr_epi64x((long long)md->blake2b.t[0], (long long)md->blake2b.t[1],
+                                           (long long)md->blake2b.f[0], (long long)md->blake2b.f[1]));
+
+   ROUND(0)
+   ROUND(1)
+   ROUND(2)
+   ROUND(3)
+   ROUND(4)
+   ROUND(5)
+   ROUND(6)
+   ROUND(7)
+   ROUND(8)
+   ROUND(9)
+   ROUND(10)
+   ROUND(11)
+
+   AVX2_STORE(md->blake2b.h,     _mm256_xor_si256(h0, _mm256_xor_si256(a, c)));
+   AVX2_STORE(md->blake2b.h + 4, _mm256_xor_si256(h1, _mm256_xor_si256(b, d)));
+
+#ifdef LTC_CLEAN_STACK
+   zeromem(m, sizeof(m));
+#endif
+}
+
+#ifdef LTC_BLAKE2BP
+
+/* G of the four leaves, the words of the state v[] and the message w[] are interleaved */
+#define GX4(a, b, c, d, x, y)                                               \
+   v[a] = _mm256_add_epi64(_mm256_add_epi64(v[a], v[b]), w[x]);             \
+   v[d] = _mm256_shuffle_epi32(_mm256_xor_si256(v[d], v[a]), _MM_SHUFFLE(2, 3, 0, 1)); \
+   v[c] = _mm256_add_epi64(v[c], v[d]);                                     \
+   v[b] = _mm256_shuffle_epi8(_mm256_xor_si256(v[b], v[c]), rot24);         \
+   v[a] = _mm256_add_epi64(_mm256_add_epi64(v[a], v[b]), w[y]);             \
+   v[d] = _mm256_shuffle_epi8(_mm256_xor_si256(v[d], v[a]), rot16);         \
+   v[c] = _mm256_add_epi64(v[c], v[d]);                                     \
+   v[b] = _mm256_xor_si256(v[b], v[c]);                                     \
+   v[b] = _mm256_xor_si256(_mm256_srli_epi64(v[b], 63), _mm256_add_epi64(v[b], v[b]));
+
+#define ROUNDX4(r)                                                          \
+   GX4(0, 4,  8, 12, blake2b_sigma[r][ 0], blake2b_sigma[r][ 1])            \
+   GX4(1, 5,  9, 13, blake2b_sigma[r][ 2], blake2b_sigma[r][ 3])            \
+   GX4(2, 6, 10, 14, blake2b_sigma[r][ 4], blake2b_sigma[r][ 5])            \
+   GX4(3, 7, 11, 15, blake2b_sigma[r][ 6], blake2b_sigma[r][ 7])            \
+   GX4(0, 5, 10, 15, blake2b_sigma[r][ 8], blake2b_sigma[r][ 9])            \
+   GX4(1, 6, 11, 12, blake2b_sigma[r][10], blake2b_sigma[r][11])            \
+   GX4(2, 7,  8, 13, blake2b_sigma[r][12], blake2b_sigma[r][13])            \
+   GX4(3, 4,  9, 14, blake2b_sigma[r][14], blake2b_sigma[r][15])
+
+/**
+  Compress a block of each of four leaves with AVX2, none of them the last one
+  @param h        [in/out] The chaining values, the word w of the leaf i is h[4 * w + i]
+  @param t        [in/out] The number of octets compressed by each leaf, the same for all of them
+  @param in       The blocks, 128 octets for each leaf one after the other
+  @param stripes  The number of times to do this, with the next 512 octets of in
+*/
+AVX2_TARGET
+void blake2b_avx2_compress4(ulong64 *h, ulong64 *t, const unsigned char *in, unsigned long stripes)
+{
+   __m256i v[16], w[16], s[8], r0, r1, r2, r3, t0, t1, t2, t3, cnt, rot16, rot24;
+   int i;
+
+   rot16 = _mm256_setr_epi8(2, 3, 4, 5, 6, 7, 0, 1, 10, 11, 12, 13, 14, 15, 8, 9,
+                            2, 3, 4, 5, 6, 7, 0, 1, 10, 11, 12, 13, 14, 15, 8, 9);
+   rot24 = _mm256_setr_epi8(3, 4, 5, 6, 7, 0, 1, 2, 11, 12, 13, 14, 15, 8, 9, 10,
+                            3, 4, 5, 6, 7, 0, 1, 2, 11, 12, 13, 14, 15, 8, 9, 10);
+
+   for (i = 0; i < 8; i++) {
+      s[i] = AVX2_LOAD(h + 4 * i);
+   }
+
+   while (stripes-- > 0) {
+      /* transpose the message words, w[j] = the word j of the four blocks */
+      for (i = 0; i < 4; i++) {
+         r0 = AVX2_LOAD(in + 32 * i);
+         r1 = AVX2_LOAD(in + 32 * i + 128);
+         r2 = AVX2_LOAD(in + 32 * i + 256);
+         r3 = AVX2_LOAD(in + 32 * i + 384);
+         t0 = _mm256_unpacklo_epi64(r0, r1);
+         t1 = _mm256_unpackhi_epi64(r0, r1);
+         t2 = _mm256_unpacklo_epi64(r2, r3);
+         t3 = _mm256_unpackhi_epi64(r2, r3);
+         w[4 * i + 0] = _mm256_permute2x128_si256(t0, t2, 0x20);
+         w[4 * i + 1] = _mm256_permute2x128_si256(t1, t3, 0x20);
+         w[4 * i + 2] = _mm256_permute2x128_si256(t0, t2, 0x31);
+         w[4 * i + 3] = _mm256_permute2x128_si256(t1, t3, 0x31);
+      }
+
+      *t += 128;
+      cnt = _mm256_set1_epi64x((long long)*t);
+      for (i = 0; i < 8; i++) {
+         v[i] = s[i];
+         v[i + 8] = _mm256_set1_epi64x((long long)blake2b_IV[i]);
+      }
+      v[12] = _mm256_xor_si256(v[12], cnt);
+
+      ROUNDX4(0)
+      ROUNDX4(1)
+      ROUNDX4(2)
+      ROUNDX4(3)
+      ROUNDX4(4)
+      ROUNDX4(5)
+      ROUNDX4(6)
+      ROUNDX4(7)
+      ROUNDX4(8)
+      ROUNDX4(9)
+      ROUNDX4(10)
+      ROUNDX4(11)
+
+      for (i = 0; i < 8; i++) {
+         s[i] = _mm256_xor_si256(s[i], _mm256_xor_si256(v[i], v[i + 8]));
+      }
+      in += 512;
+   }
+
+   for (i = 0; i < 8; i++) {
+      AVX2_STORE(h + 4 * i, s[i]);
+   }
+
+#ifdef LTC_CLEAN_STACK
+   zeromem(v, sizeof(v));
+   zeromem(w, sizeof(w));
+#endif
+}
+
+#endif /* LTC_BLAKE2BP */
+
+#endif
+
+/* ref:         $Format:%D$ */
+/* git commit:  $Format:%H$ */
+/* commit time: $Format:%ai$ */
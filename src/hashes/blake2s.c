@@ -127,6 +127,23 @@ const struct ltc_hash_descriptor blake2s_256_desc =
     NULL
 };
 
+#ifdef LTC_BLAKE2SP
+const struct ltc_hash_descriptor blake2sp_256_desc =
+{
+    "blake2sp-256",
+    34,
+    32,
+    64,
+    { 0 },
+    0,
+    &blake2sp_256_init,
+    &blake2sp_process,
+    &blake2sp_done,
+    &blake2sp_256_test,
+    NULL
+};
+#endif
+
 static const ulong32 blake2s_IV[8] = {
     0x6A09E667UL, 0xBB67AE85UL, 0x3C6EF372UL, 0xA54FF53AUL,
     0x510E527FUL, 0x9B05688CUL, 0x1F83D9ABUL, 0x5BE0CD19UL
@@ -306,6 +323,13 @@ static int blake2s_compress(hash_state *md, const unsigned char *buf)
    ulong32 m[16];
    ulong32 v[16];
 
+#ifdef LTC_BLAKE2_SIMD
+   if (ltc_cpu_has(LTC_CPU_SSE41 | LTC_CPU_SSSE3)) {
+      blake2s_sse41_compress(md, buf);
+      return CRYPT_OK;
+   }
+#endif
+
    for (i = 0; i < 16; ++i) {
       LOAD32L(m[i], buf + i * sizeof(m[i]));
    }
@@ -427,6 +451,257 @@ int blake2s_done(hash_state *md, unsigned char *out)
    return CRYPT_OK;
 }
 
+#ifdef LTC_BLAKE2SP
+
+enum {
+   BLAKE2SP_PARALLELISM = 8,
+   BLAKE2SP_STRIPEBYTES = BLAKE2SP_PARALLELISM * BLAKE2S_BLOCKBYTES
+};
+
+/* the number of octets the leaf i compressed, the leaves in front of buflen
+ * already compressed the block of the previous stripe if pending is set
+ */
+static ulong64 blake2sp_leaf_count(const hash_state *md, unsigned long i)
+{
+   if (md->blake2sp.pending && md->blake2sp.buflen > i * BLAKE2S_BLOCKBYTES) {
+      return md->blake2sp.t + BLAKE2S_BLOCKBYTES;
+   }
+   return md->blake2sp.t;
+}
+
+/* compress the next block of the leaf i, len octets of buf, zero padded if it is the last one */
+static void blake2sp_compress_leaf(hash_state *md, unsigned long i, const unsigned char *buf, unsigned long len, int last)
+{
+   hash_state leaf;
+   unsigned char block[BLAKE2S_BLOCKBYTES];
+   unsigned long w;
+   ulong64 cnt;
+
+   for (w = 0; w < 8; ++w) {
+      leaf.blake2s.h[w] = md->blake2sp.h[BLAKE2SP_PARALLELISM * w + i];
+   }
+   cnt = blake2sp_leaf_count(md, i) + len;
+   leaf.blake2s.t[0] = (ulong32)cnt;
+   leaf.blake2s.t[1] = (ulong32)(cnt >> 32);
+   leaf.blake2s.f[0] = last ? 0xffffffffUL : 0;
+   leaf.blake2s.f[1] = (last && i == BLAKE2SP_PARALLELISM - 1) ? 0xffffffffUL : 0;
+
+   XMEMSET(block, 0, sizeof(block));
+   XMEMCPY(block, buf, len);
+   blake2s_compress(&leaf, block);
+
+   for (w = 0; w < 8; ++w) {
+      md->blake2sp.h[BLAKE2SP_PARALLELISM * w + i] = leaf.blake2s.h[w];
+   }
+#ifdef LTC_CLEAN_STACK
+   zeromem(&leaf, sizeof(leaf));
+   zeromem(block, sizeof(block));
+#endif
+}
+
+/* compress a block of each leaf, stripes times, none of them is the last one */
+static void blake2sp_compress_stripes(hash_state *md, const unsigned char *in, unsigned long stripes)
+{
+   unsigned long i;
+
+#ifdef LTC_BLAKE2_SIMD
+   if (ltc_cpu_has(LTC_CPU_AVX2)) {
+      blake2s_avx2_compress8(md->blake2sp.h, &md->blake2sp.t, in, stripes);
+      return;
+   }
+#endif
+   while (stripes-- > 0) {
+      for (i = 0; i < BLAKE2SP_PARALLELISM; ++i) {
+         blake2sp_compress_leaf(md, i, in + i * BLAKE2S_BLOCKBYTES, BLAKE2S_BLOCKBYTES, 0);
+      }
+      md->blake2sp.t += BLAKE2S_BLOCKBYTES;
+      in += BLAKE2SP_STRIPEBYTES;
+   }
+}
+
+/**
+   Initialize the BLAKE2sp hash/MAC state
+
+      The input is split into blocks of 64 octets which are hashed by eight
+      BLAKE2s leaves in turns, the root hashes the digests of the leaves.
+
+   @param md      The hash state you wish to initialize
+   @param outlen  The desired output-length
+   @param key     The key of the MAC
+   @param keylen  The length of the key
+   @return CRYPT_OK if successful
+*/
+int blake2sp_init(hash_state *md, unsigned long outlen, const unsigned char *key, unsigned long keylen)
+{
+   unsigned char P[BLAKE2S_PARAM_SIZE];
+   unsigned long i, w;
+   ulong32 tmp;
+
+   LTC_ARGCHK(md != NULL);
+
+   if ((!outlen) || (outlen > BLAKE2S_OUTBYTES)) {
+      return CRYPT_INVALID_ARG;
+   }
+   if ((key && !keylen) || (keylen && !key) || (keylen > BLAKE2S_KEYBYTES)) {
+      return CRYPT_INVALID_ARG;
+   }
+
+   XMEMSET(&md->blake2sp, 0, sizeof(md->blake2sp));
+   XMEMSET(P, 0, sizeof(P));
+
+   P[O_DIGEST_LENGTH] = (unsigned char)outlen;
+   P[O_KEY_LENGTH] = (unsigned char)keylen;
+   P[O_FANOUT] = BLAKE2SP_PARALLELISM;
+   P[O_DEPTH] = 2;
+   P[O_INNER_LENGTH] = BLAKE2S_OUTBYTES;
+
+   for (i = 0; i < BLAKE2SP_PARALLELISM; ++i) {
+      P[O_NODE_OFFSET] = (unsigned char)i;
+      for (w = 0; w < 8; ++w) {
+         LOAD32L(tmp, P + w * 4);
+         md->blake2sp.h[BLAKE2SP_PARALLELISM * w + i] = blake2s_IV[w] ^ tmp;
+      }
+   }
+   md->blake2sp.outlen = (unsigned char)outlen;
+   md->blake2sp.keylen = (unsigned char)keylen;
+
+   if (key) {
+      /* the key block of every leaf, compressed once the leaf gets more data */
+      for (i = 0; i < BLAKE2SP_PARALLELISM; ++i) {
+         XMEMCPY(md->blake2sp.buf + i * BLAKE2S_BLOCKBYTES, key, keylen);
+      }
+      md->blake2sp.pending = 1;
+   }
+
+   return CRYPT_OK;
+}
+
+/**
+   Initialize the hash state
+   @param md   The hash state you wish to initialize
+   @return CRYPT_OK if successful
+*/
+int blake2sp_256_init(hash_state *md) { return blake2sp_init(md, 32, NULL, 0); }
+
+/**
+   Process a block of memory through the hash
+   @param md     The hash state
+   @param in     The data to hash
+   @param inlen  The length of the data (octets)
+   @return CRYPT_OK if successful
+*/
+int blake2sp_process(hash_state *md, const unsigned char *in, unsigned long inlen)
+{
+   unsigned long i, n;
+
+   LTC_ARGCHK(md != NULL);
+   LTC_ARGCHK(in != NULL);
+
+   if (md->blake2sp.buflen > sizeof(md->blake2sp.buf)) {
+      return CRYPT_INVALID_ARG;
+   }
+
+   /* the slot i of buf holds the data of the leaf i.  A leaf compresses a
+    * block only once it gets more data, as the last block is compressed
+    * differently.  So the slots behind buflen still hold the blocks of the
+    * previous stripe if pending is set.
+    */
+   while (inlen > 0) {
+      if (md->blake2sp.buflen == BLAKE2SP_STRIPEBYTES) {
+         if (md->blake2sp.pending) {
+            md->blake2sp.t += BLAKE2S_BLOCKBYTES;
+         }
+         md->blake2sp.buflen = 0;
+         md->blake2sp.pending = 1;
+      }
+      if (md->blake2sp.buflen == 0 && inlen > (BLAKE2SP_PARALLELISM - 1) * BLAKE2S_BLOCKBYTES) {
+         /* every leaf gets more data, so whole stripes can be compressed at once */
+         if (md->blake2sp.pending) {
+            blake2sp_compress_stripes(md, md->blake2sp.buf, 1);
+            md->blake2sp.pending = 0;
+         }
+         n = (inlen - (BLAKE2SP_PARALLELISM - 1) * BLAKE2S_BLOCKBYTES - 1) / BLAKE2SP_STRIPEBYTES;
+         if (n > 0) {
+            blake2sp_compress_stripes(md, in, n);
+            in += n * BLAKE2SP_STRIPEBYTES;
+            inlen -= n * BLAKE2SP_STRIPEBYTES;
+         }
+      }
+      i = md->blake2sp.buflen / BLAKE2S_BLOCKBYTES;
+      if (md->blake2sp.buflen % BLAKE2S_BLOCKBYTES == 0 && md->blake2sp.pending) {
+         blake2sp_compress_leaf(md, i, md->blake2sp.buf + i * BLAKE2S_BLOCKBYTES, BLAKE2S_BLOCKBYTES, 0);
+      }
+      n = MIN(inlen, BLAKE2S_BLOCKBYTES - md->blake2sp.buflen % BLAKE2S_BLOCKBYTES);
+      XMEMCPY(md->blake2sp.buf + md->blake2sp.buflen, in, n);
+      md->blake2sp.buflen += n;
+      in += n;
+      inlen -= n;
+   }
+   return CRYPT_OK;
+}
+
+/**
+   Terminate the hash to get the digest
+   @param md  The hash state
+   @param out [out] The destination of the hash (size depending on the length used on init)
+   @return CRYPT_OK if successful
+*/
+int blake2sp_done(hash_state *md, unsigned char *out)
+{
+   unsigned char P[BLAKE2S_PARAM_SIZE];
+   unsigned char leaves[BLAKE2SP_PARALLELISM * BLAKE2S_OUTBYTES];
+   hash_state root;
+   unsigned long i, w, len;
+   int err;
+
+   LTC_ARGCHK(md != NULL);
+   LTC_ARGCHK(out != NULL);
+
+   if (md->blake2sp.buflen > sizeof(md->blake2sp.buf)) {
+      return CRYPT_INVALID_ARG;
+   }
+
+   /* the last block of every leaf, it may be empty */
+   for (i = 0; i < BLAKE2SP_PARALLELISM; ++i) {
+      if (md->blake2sp.buflen > i * BLAKE2S_BLOCKBYTES) {
+         len = MIN(md->blake2sp.buflen - i * BLAKE2S_BLOCKBYTES, BLAKE2S_BLOCKBYTES);
+      } else {
+         len = md->blake2sp.pending ? BLAKE2S_BLOCKBYTES : 0;
+      }
+      blake2sp_compress_leaf(md, i, md->blake2sp.buf + i * BLAKE2S_BLOCKBYTES, len, 1);
+      for (w = 0; w < 8; ++w) {
+         STORE32L(md->blake2sp.h[BLAKE2SP_PARALLELISM * w + i], leaves + i * BLAKE2S_OUTBYTES + w * 4);
+      }
+   }
+
+   XMEMSET(P, 0, sizeof(P));
+   P[O_DIGEST_LENGTH] = (unsigned char)md->blake2sp.outlen;
+   P[O_KEY_LENGTH] = md->blake2sp.keylen;
+   P[O_FANOUT] = BLAKE2SP_PARALLELISM;
+   P[O_DEPTH] = 2;
+   P[O_NODE_DEPTH] = 1;
+   P[O_INNER_LENGTH] = BLAKE2S_OUTBYTES;
+
+   if ((err = blake2s_init_param(&root, P)) != CRYPT_OK) {
+      goto LBL_ERR;
+   }
+   root.blake2s.last_node = 1;
+   if ((err = blake2s_process(&root, leaves, sizeof(leaves))) != CRYPT_OK) {
+      goto LBL_ERR;
+   }
+   err = blake2s_done(&root, out);
+
+LBL_ERR:
+   zeromem(md, sizeof(hash_state));
+#ifdef LTC_CLEAN_STACK
+   zeromem(leaves, sizeof(leaves));
+   zeromem(&root, sizeof(root));
+#endif
+   return err;
+}
+
+#endif /* LTC_BLAKE2SP */
+
 /**
   Self-test the hash
   @return CRYPT_OK if successful, CRYPT_NOP if self-tests have been disabled
@@ -477,8 +752,12 @@ int blake2s_256_test(void)
       }
 
    }
+#ifdef LTC_AMD64_SIMD
+   return hash_test_cpu(&blake2s_256_desc);
+#else
    return CRYPT_OK;
 #endif
+#endif
 }
 
 /**
@@ -606,6 +885,97 @@ int blake2s_128_test(void)
 #endif
 }
 
+#ifdef LTC_BLAKE2SP
+/**
+  Self-test the hash
+  @return CRYPT_OK if successful, CRYPT_NOP if self-tests have been disabled
+*/
+int blake2sp_256_test(void)
+{
+#ifndef LTC_TEST
+   return CRYPT_NOP;
+#else
+   /* the messages are x * 13 + 5, the keys 0, 1, 2, ... */
+   static const struct {
+      unsigned long msglen, keylen;
+      unsigned char hash[32];
+   } tests[] = {
+      { 0, 0,
+        { 0xdd, 0x0e, 0x89, 0x17, 0x76, 0x93, 0x3f, 0x43,
+          0xc7, 0xd0, 0x32, 0xb0, 0x8a, 0x91, 0x7e, 0x25,
+          0x74, 0x1f, 0x8a, 0xa9, 0xa1, 0x2c, 0x12, 0xe1,
+          0xca, 0xc8, 0x80, 0x15, 0x00, 0xf2, 0xca, 0x4f } },
+      { 3, 0,
+        { 0xb8, 0xc1, 0x4f, 0xf9, 0xcb, 0x43, 0x8c, 0x5c,
+          0x3f, 0xd8, 0x84, 0x36, 0xe1, 0x4b, 0x21, 0xb5,
+          0x17, 0xf4, 0xbb, 0x1f, 0x12, 0x96, 0xde, 0xf2,
+          0x6a, 0x01, 0x96, 0xe4, 0x51, 0xb5, 0xc7, 0x0a } },
+      { 512, 0,
+        { 0xd2, 0xc2, 0xe3, 0xbc, 0xf9, 0x15, 0x10, 0x90,
+          0xb4, 0x60, 0xa6, 0xb4, 0x5e, 0xa9, 0x08, 0xb8,
+          0x32, 0x67, 0x3f, 0xa6, 0x1c, 0x0e, 0x4c, 0xda,
+          0x6e, 0x9a, 0xca, 0xcc, 0x5e, 0xe7, 0x47, 0x78 } },
+      { 1000, 0,
+        { 0x48, 0x61, 0x06, 0x2a, 0x05, 0xa8, 0xab, 0x45,
+          0xc9, 0x1c, 0x27, 0xe6, 0xf3, 0x8d, 0xe1, 0xe6,
+          0x8f, 0x5e, 0xa4, 0x53, 0x72, 0xaa, 0xc4, 0x85,
+          0x80, 0xbc, 0xfa, 0xab, 0xa7, 0xf5, 0x68, 0x50 } },
+      { 0, 32,
+        { 0x71, 0x5c, 0xb1, 0x38, 0x95, 0xae, 0xb6, 0x78,
+          0xf6, 0x12, 0x41, 0x60, 0xbf, 0xf2, 0x14, 0x65,
+          0xb3, 0x0f, 0x4f, 0x68, 0x74, 0x19, 0x3f, 0xc8,
+          0x51, 0xb4, 0x62, 0x10, 0x43, 0xf0, 0x9c, 0xc6 } },
+      { 1000, 32,
+        { 0x32, 0xa7, 0x8f, 0x51, 0x38, 0x48, 0xa1, 0xde,
+          0x49, 0x96, 0xcb, 0x0e, 0x0f, 0xcd, 0x19, 0xb9,
+          0xab, 0x78, 0xe1, 0xd5, 0x85, 0x99, 0x3d, 0x60,
+          0x55, 0x36, 0xc5, 0x9d, 0x82, 0x9f, 0x67, 0x06 } },
+   };
+   static const unsigned long pieces[] = { 1, 127, 128, 385, 512, 7, 900 };
+   unsigned char msg[1000], key[32], tmp[32];
+   unsigned long x, y, k;
+   int i, j;
+#ifdef LTC_BLAKE2_SIMD
+   unsigned long mask;
+#endif
+   hash_state md;
+
+   for (x = 0; x < sizeof(msg); x++) {
+      msg[x] = (unsigned char)(x * 13 + 5);
+   }
+   for (x = 0; x < sizeof(key); x++) {
+      key[x] = (unsigned char)x;
+   }
+
+   for (i = 0; i < (int)(sizeof(tests) / sizeof(tests[0])); i++) {
+      /* in one piece, in pieces of different sizes and without SIMD */
+      for (j = 0; j < 3; j++) {
+#ifdef LTC_BLAKE2_SIMD
+         mask = ltc_cpu_mask(j == 2 ? 0 : ~0UL);
+#endif
+         blake2sp_init(&md, 32, tests[i].keylen ? key : NULL, tests[i].keylen);
+         if (j == 1) {
+            for (x = k = 0; x < tests[i].msglen; x += y, k++) {
+               y = MIN(pieces[k % (sizeof(pieces) / sizeof(pieces[0]))], tests[i].msglen - x);
+               blake2sp_process(&md, msg + x, y);
+            }
+         } else {
+            blake2sp_process(&md, msg, tests[i].msglen);
+         }
+         blake2sp_done(&md, tmp);
+#ifdef LTC_BLAKE2_SIMD
+         ltc_cpu_mask(mask);
+#endif
+         if (compare_testvector(tmp, sizeof(tmp), tests[i].hash, sizeof(tests[i].hash), "BLAKE2SP_256", i * 3 + j)) {
+            return CRYPT_FAIL_TESTVECTOR;
+         }
+      }
+   }
+   return CRYPT_OK;
+#endif
+}
+#endif /* LTC_BLAKE2SP */
+
 #endif
 
 /* ref:         $Format:%D$ */
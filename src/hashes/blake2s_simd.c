@@ -0,0 +1,253 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ */
+
+/**
+   @file blake2s_simd.c
+   BLAKE2s compression using the SSE4.1 instructions of x86-64 CPUs
+
+   Each row of the 4x4 state matrix is held in one register, so the four G
+   functions of a column or diagonal step run side by side.  The rows are
+   rotated against each other between the column and the diagonal steps.
+
+   The leaves of BLAKE2sp are compressed eight at once with AVX2 instead,
+   each 32-bit lane of a register belongs to one of them.
+*/
+#include "tomcrypt_private.h"
+
+#if defined(LTC_BLAKE2_SIMD) && defined(LTC_BLAKE2S)
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+/* the AVX-512 macros of GCC mix declarations and code */
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wdeclaration-after-statement"
+#endif
+#include <immintrin.h>
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+#endif
+
+#define SSE41_TARGET LTC_ATTRIBUTE_TARGET("sse4.1,ssse3")
+#define AVX2_TARGET  LTC_ATTRIBUTE_TARGET("avx2")
+
+#define SSE_LOAD(p)      _mm_loadu_si128((const __m128i *)(const void *)(p))
+#define SSE_STORE(p, v)  _mm_storeu_si128((__m128i *)(void *)(p), (v))
+
+static const ulong32 blake2s_IV[8] = {
+   0x6A09E667UL, 0xBB67AE85UL, 0x3C6EF372UL, 0xA54FF53AUL,
+   0x510E527FUL, 0x9B05688CUL, 0x1F83D9ABUL, 0x5BE0CD19UL
+};
+
+static const unsigned char blake2s_sigma[10][16] = {
+   {  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14, 15 },
+   { 14, 10,  4,  8,  9, 15, 13,  6,  1, 12,  0,  2, 11,  7,  5,  3 },
+   { 11,  8, 12,  0,  5,  2, 15, 13, 10, 14,  3,  6,  7,  1,  9,  4 },
+   {  7,  9,  3,  1, 13, 12, 11, 14,  2,  6,  5, 10,  4,  0, 15,  8 },
+   {  9,  0,  5,  7,  2,  4, 10, 15, 14,  1, 11, 12,  6,  8,  3, 13 },
+   {  2, 12,  6, 10,  0, 11,  8,  3,  4, 13,  7,  5, 15, 14,  1,  9 },
+   { 12,  5,  1, 15, 14, 13,  4, 10,  0,  7,  6,  3,  9,  2,  8, 11 },
+   { 13, 11,  7, 14, 12,  1,  3,  9,  5,  0, 15,  4,  8,  6,  2, 10 },
+   {  6, 15, 14,  9, 11,  3,  0,  8, 12,  2, 13,  7,  1,  4, 10,  5 },
+   { 10,  2,  8,  4,  7,  6,  1,  5, 15, 11,  9, 14,  3, 12, 13,  0 }
+};
+
+/* the message words sigma[r][i], sigma[r][i+2], sigma[r][i+4] and sigma[r][i+6] */
+#define MSG(r, i) _mm_setr_epi32((int)m[blake2s_sigma[r][(i)]],     (int)m[blake2s_sigma[r][(i) + 2]], \
+                                 (int)m[blake2s_sigma[r][(i) + 4]], (int)m[blake2s_sigma[r][(i) + 6]])
+
+/* four G functions, on the columns or on the diagonals */
+#define G4(m0, m1)                                                          \
+   a = _mm_add_epi32(_mm_add_epi32(a, b), (m0));                            \
+   d = _mm_shuffle_epi8(_mm_xor_si128(d, a), rot16);                        \
+   c = _mm_add_epi32(c, d);                                                 \
+   b = _mm_xor_si128(b, c);                                                 \
+   b = _mm_or_si128(_mm_srli_epi32(b, 12), _mm_slli_epi32(b, 20));          \
+   a = _mm_add_epi32(_mm_add_epi32(a, b), (m1));                            \
+   d = _mm_shuffle_epi8(_mm_xor_si128(d, a), rot8);                         \
+   c = _mm_add_epi32(c, d);                                                 \
+   b = _mm_xor_si128(b, c);                                                 \
+   b = _mm_or_si128(_mm_srli_epi32(b, 7), _mm_slli_epi32(b, 25));
+
+#define ROUND(r)                                                            \
+   G4(MSG(r, 0), MSG(r, 1))                                                 \
+   b = _mm_shuffle_epi32(b, _MM_SHUFFLE(0, 3, 2, 1));                       \
+   c = _mm_shuffle_epi32(c, _MM_SHUFFLE(1, 0, 3, 2));                       \
+   d = _mm_shuffle_epi32(d, _MM_SHUFFLE(2, 1, 0, 3));                       \
+   G4(MSG(r, 8), MSG(r, 9))                                                 \
+   b = _mm_shuffle_epi32(b, _MM_SHUFFLE(2, 1, 0, 3));                       \
+   c = _mm_shuffle_epi32(c, _MM_SHUFFLE(1, 0, 3, 2));                       \
+   d = _mm_shuffle_epi32(d, _MM_SHUFFLE(0, 3, 2, 1));
+
+/**
+  Compress a block with SSE4.1
+  @param md   [in/out] The BLAKE2s state, the counter and the final flags are already set
+  @param buf  The block, 64 octets
+*/
+SSE41_TARGET
+void blake2s_sse41_compress(hash_state *md, const unsigned char *buf)
+{
+   ulong32 m[16];
+   __m128i a, b, c, d, h0, h1, rot8, rot16;
+   unsigned long i;
+
+   rot8  = _mm_setr_epi8(1, 2, 3, 0, 5, 6, 7, 4, 9, 10, 11, 8, 13, 14, 15, 12);
+   rot16 = _mm_setr_epi8(2, 3, 0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 14, 15, 12, 13);
+
+   for (i = 0; i < 16; ++i) {
+      LOAD32L(m[i], buf + i * sizeof(m[i]));
+   }
+
+   a = h0 = SSE_LOAD(md->blake2s.h);
+   b = h1 = SSE_LOAD(md->blake2s.h + 4);
+   c = SSE_LOAD(blake2s_IV);
+   d = _mm_xor_si128(SSE_LOAD(blake2s_IV + 4),
+                     _mm_setr_epi32((int)md->blake2s.t[0], (int)md->blake2s.t[1],
+                                    (int)md->blake2s.f[0], (int)md->blake2s.f[1]));
+
+   ROUND(0)
+   ROUND(1)
+   ROUND(2)
+   ROUND(3)
+   ROUND(4)
+   ROUND(5)
+   ROUND(6)
+   ROUND(7)
+   ROUND(8)
+   ROUND(9)
+
+   SSE_STORE(md->blake2s.h,     _mm_xor_si128(h0, _mm_xor_si128(a, c)));
+   SSE_STORE(md->blake2s.h + 4, _mm_xor_si128(h1, _mm_xor_si128(b, d)));
+
+#ifdef LTC_CLEAN_STACK
+   zeromem(m, sizeof(m));
+#endif
+}
+
+#ifdef LTC_BLAKE2SP
+
+#define AVX2_LOAD(p)      _mm256_loadu_si256((const __m256i *)(const void *)(p))
+#define AVX2_STORE(p, v)  _mm256_storeu_si256((__m256i *)(void *)(p), (v))
+
+/* G of the eight leaves, the words of the state v[] and the message w[] are interleaved */
+#define GX8(a, b, c, d, x, y)                                               \
+   v[a] = _mm256_add_epi32(_mm256_add_epi32(v[a], v[b]), w[x]);             \
+   v[d] = _mm256_shuffle_epi8(_mm256_xor_si256(v[d], v[a]), rot16);         \
+   v[c] = _mm256_add_epi32(v[c], v[d]);                                     \
+   v[b] = _mm256_xor_si256(v[b], v[c]);                                     \
+   v[b] = _mm256_or_si256(_mm256_srli_epi32(v[b], 12), _mm256_slli_epi32(v[b], 20)); \
+   v[a] = _mm256_add_epi32(_mm256_add_epi32(v[a], v[b]), w[y]);             \
+   v[d] = _mm256_shuffle_epi8(_mm256_xor_si256(v[d], v[a]), rot8);          \
+   v[c] = _mm256_add_epi32(v[c], v[d]);                                     \
+   v[b] = _mm256_xor_si256(v[b], v[c]);                                     \
+   v[b] = _mm256_or_si256(_mm256_srli_epi32(v[b], 7), _mm256_slli_epi32(v[b], 25));
+
+#define ROUNDX8(r)                                                          \
+   GX8(0, 4,  8, 12, blake2s_sigma[r][ 0], blake2s_sigma[r][ 1])            \
+   GX8(1, 5,  9, 13, blake2s_sigma[r][ 2], blake2s_sigma[r][ 3])            \
+   GX8(2, 6, 10, 14, blake2s_sigma[r][ 4], blake2s_sigma[r][ 5])            \
+   GX8(3, 7, 11, 15, blake2s_sigma[r][ 6], blake2s_sigma[r][ 7])            \
+   GX8(0, 5, 10, 15, blake2s_sigma[r][ 8], blake2s_sigma[r][ 9])            \
+   GX8(1, 6, 11, 12, blake2s_sigma[r][10], blake2s_sigma[r][11])            \
+   GX8(2, 7,  8, 13, blake2s_sigma[r][12], blake2s_sigma[r][13])            \
+   GX8(3, 4,  9, 14, blake2s_sigma[r][14], blake2s_sigma[r][15])
+
+/**
+  Compress a block of each of eight leaves with AVX2, none of them the last one
+  @param h        [in/out] The chaining values, the word w of the leaf i is h[8 * w + i]
+  @param t        [in/out] The number of octets compressed by each leaf, the same for all of them
+  @param in       The blocks, 64 octets for each leaf one after the other
+  @param stripes  The number of times to do this, with the next 512 octets of in
+*/
+AVX2_TARGET
+void blake2s_avx2_compress8(ulong32 *h, ulong64 *t, const unsigned char *in, unsigned long stripes)
+{
+   __m256i v[16], w[16], s[8], r[8], a[8], b[8], tlo, thi, rot8, rot16;
+   int i;
+
+   rot8  = _mm256_setr_epi8(1, 2, 3, 0, 5, 6, 7, 4, 9, 10, 11, 8, 13, 14, 15, 12,
+                            1, 2, 3, 0, 5, 6, 7, 4, 9, 10, 11, 8, 13, 14, 15, 12);
+   rot16 = _mm256_setr_epi8(2, 3, 0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 14, 15, 12, 13,
+                            2, 3, 0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 14, 15, 12, 13);
+
+   for (i = 0; i < 8; i++) {
+      s[i] = AVX2_LOAD(h + 8 * i);
+   }
+
+   while (stripes-- > 0) {
+      /* transpose the message words, w[j] = the word j of the eight blocks */
+      for (i = 0; i < 2; i++) {
+         int k;
+         for (k = 0; k < 8; k++) {
+            r[k] = AVX2_LOAD(in + 64 * k + 32 * i);
+         }
+         for (k = 0; k < 8; k += 2) {
+            a[k]     = _mm256_unpacklo_epi32(r[k], r[k + 1]);
+            a[k + 1] = _mm256_unpackhi_epi32(r[k], r[k + 1]);
+         }
+         for (k = 0; k < 8; k += 4) {
+            b[k]     = _mm256_unpacklo_epi64(a[k], a[k + 2]);
+            b[k + 1] = _mm256_unpackhi_epi64(a[k], a[k + 2]);
+            b[k + 2] = _mm256_unpacklo_epi64(a[k + 1], a[k + 3]);
+            b[k + 3] = _mm256_unpackhi_epi64(a[k + 1], a[k + 3]);
+         }
+         for (k = 0; k < 4; k++) {
+            w[8 * i + k]     = _mm256_permute2x128_si256(b[k], b[k + 4], 0x20);
+            w[8 * i + k + 4] = _mm256_permute2x128_si256(b[k], b[k + 4], 0x31);
+         }
+      }
+
+      /* the counter is 64 bits wide, split into its low and high word */
+      *t += 64;
+      tlo = _mm256_set1_epi32((int)(ulong32)*t);
+      thi = _mm256_set1_epi32((int)(ulong32)(*t >> 32));
+
+      for (i = 0; i < 8; i++) {
+         v[i] = s[i];
+         v[i + 8] = _mm256_set1_epi32((int)blake2s_IV[i]);
+      }
+      v[12] = _mm256_xor_si256(v[12], tlo);
+      v[13] = _mm256_xor_si256(v[13], thi);
+
+      ROUNDX8(0)
+      ROUNDX8(1)
+      ROUNDX8(2)
+      ROUNDX8(3)
+      ROUNDX8(4)
+      ROUNDX8(5)
+      ROUNDX8(6)
+      ROUNDX8(7)
+      ROUNDX8(8)
+      ROUNDX8(9)
+
+      for (i = 0; i < 8; i++) {
+         s[i] = _mm256_xor_si256(s[i], _mm256_xor_si256(v[i], v[i + 8]));
+      }
+      in += 512;
+   }
+
+   for (i = 0; i < 8; i++) {
+      AVX2_STORE(h + 8 * i, s[i]);
+   }
+
+#ifdef LTC_CLEAN_STACK
+   zeromem(v, sizeof(v));
+   zeromem(w, sizeof(w));
+#endif
+}
+
+#endif /* LTC_BLAKE2SP */
+
+#endif
+
+/* ref:         $Format:%D$ */
+/* git commit:  $Format:%H$ */
+/* commit time: $Format:%ai$ */
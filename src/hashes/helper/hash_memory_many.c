@@ -0,0 +1,102 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ */
+#include "tomcrypt_private.h"
+
+#ifdef LTC_HASH_HELPERS
+/**
+  @file hash_memory_many.c
+  Hash many independent messages
+*/
+
+/**
+  Hash many independent messages and store their digests.
+  SHA-256 and SHA-224 hash 8 or 16 messages at once with AVX2 or AVX-512,
+  SHA3 and KECCAK 4 messages with AVX2, if that's faster than hashing them
+  one by one.
+  @param hash   The index of the hash you wish to use
+  @param jobs   The messages and where to store their digests, hashsize octets each
+  @param n      The number of jobs
+  @return CRYPT_OK if successful
+*/
+int hash_memory_many(int hash, const hash_job *jobs, unsigned long n)
+{
+    hash_state *md;
+    unsigned long x;
+    int err;
+#ifdef LTC_SHA3_MB
+    unsigned char pad;
+#endif
+
+    LTC_ARGCHK(jobs != NULL);
+
+    if ((err = hash_is_valid(hash)) != CRYPT_OK) {
+        return err;
+    }
+
+    for (x = 0; x < n; x++) {
+        LTC_ARGCHK(jobs[x].in  != NULL);
+        LTC_ARGCHK(jobs[x].out != NULL);
+    }
+
+    md = XMALLOC(sizeof(hash_state));
+    if (md == NULL) {
+       return CRYPT_MEM;
+    }
+
+#ifdef LTC_SHA256_MB
+    if (hash_descriptor[hash].process == sha256_process) {
+       if ((err = hash_descriptor[hash].init(md)) != CRYPT_OK) {
+          goto LBL_ERR;
+       }
+       if ((err = sha256_mb_memory(md->sha256.state, hash_descriptor[hash].hashsize, jobs, n)) != CRYPT_NOP) {
+          goto LBL_ERR;
+       }
+    }
+#endif
+#ifdef LTC_SHA3_MB
+    if (hash_descriptor[hash].process == sha3_process) {
+       if ((err = hash_descriptor[hash].init(md)) != CRYPT_OK) {
+          goto LBL_ERR;
+       }
+       pad = 0x06;
+#ifdef LTC_KECCAK
+       if (hash_descriptor[hash].done == keccak_done) {
+          pad = 0x01;
+       }
+#endif
+       if ((err = sha3_mb_memory(md->sha3.capacity_words, pad, jobs, n, hash_descriptor[hash].hashsize)) != CRYPT_NOP) {
+          goto LBL_ERR;
+       }
+    }
+#endif
+
+    for (x = 0; x < n; x++) {
+       if ((err = hash_descriptor[hash].init(md)) != CRYPT_OK) {
+          goto LBL_ERR;
+       }
+       if ((err = hash_descriptor[hash].process(md, jobs[x].in, jobs[x].inlen)) != CRYPT_OK) {
+          goto LBL_ERR;
+       }
+       if ((err = hash_descriptor[hash].done(md, jobs[x].out)) != CRYPT_OK) {
+          goto LBL_ERR;
+       }
+    }
+LBL_ERR:
+#ifdef LTC_CLEAN_STACK
+    zeromem(md, sizeof(hash_state));
+#endif
+    XFREE(md);
+
+    return err;
+}
+#endif /* #ifdef LTC_HASH_HELPERS */
+
+/* ref:         $Format:%D$ */
+/* git commit:  $Format:%H$ */
+/* commit time: $Format:%ai$ */
@@ -155,6 +155,26 @@ static int sha1_compress(hash_state *md, const unsigned char *buf)
 }
 #endif
 
+/* compress one or more blocks */
+static int sha1_compress_nblocks(hash_state * md, const unsigned char *buf, unsigned long blocks)
+{
+    int err;
+
+#ifdef LTC_SHA_NI
+    if (ltc_cpu_has(LTC_CPU_SHA | LTC_CPU_SSE41 | LTC_CPU_SSSE3)) {
+        sha1_shani_compress(md->sha1.state, buf, blocks);
+        return CRYPT_OK;
+    }
+#endif
+    for (; blocks > 0; blocks--) {
+        if ((err = sha1_compress(md, buf)) != CRYPT_OK) {
+            return err;
+        }
+        buf += 64;
+    }
+    return CRYPT_OK;
+}
+
 /**
    Initialize the hash state
    @param md   The hash state you wish to initialize
@@ -180,7 +200,7 @@ int sha1_init(hash_state * md)
    @param inlen  The length of the data (octets)
    @return CRYPT_OK if successful
 */
-HASH_PROCESS(sha1_process, sha1_compress, sha1, 64)
+HASH_PROCESS_NBLOCKS(sha1_process, sha1_compress_nblocks, sha1, 64)
 
 /**
    Terminate the hash to get the digest
@@ -213,7 +233,7 @@ int sha1_done(hash_state * md, unsigned char *out)
         while (md->sha1.curlen < 64) {
             md->sha1.buf[md->sha1.curlen++] = (unsigned char)0;
         }
-        sha1_compress(md, md->sha1.buf);
+        sha1_compress_nblocks(md, md->sha1.buf, 1);
         md->sha1.curlen = 0;
     }
 
@@ -224,7 +244,7 @@ int sha1_done(hash_state * md, unsigned char *out)
 
     /* store length */
     STORE64H(md->sha1.length, md->sha1.buf+56);
-    sha1_compress(md, md->sha1.buf);
+    sha1_compress_nblocks(md, md->sha1.buf, 1);
 
     /* copy output */
     for (i = 0; i < 5; i++) {
@@ -273,7 +293,11 @@ int  sha1_test(void)
          return CRYPT_FAIL_TESTVECTOR;
       }
   }
+#ifdef LTC_AMD64_SIMD
+  return hash_test_cpu(&sha1_desc);
+#else
   return CRYPT_OK;
+#endif
   #endif
 }
 
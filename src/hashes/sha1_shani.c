@@ -0,0 +1,114 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ */
+
+/**
+   @file sha1_shani.c
+   SHA-1 compression using the SHA extensions of x86-64 CPUs
+
+   SHA1RNDS4 does four rounds on ABCD, E is added to the message words by
+   SHA1NEXTE from the copy of ABCD taken before the previous four rounds.
+*/
+#include "tomcrypt_private.h"
+
+#if defined(LTC_SHA_NI) && defined(LTC_SHA1)
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+/* the AVX-512 macros of GCC mix declarations and code */
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wdeclaration-after-statement"
+#endif
+#include <immintrin.h>
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+#endif
+
+#define SHANI_TARGET LTC_ATTRIBUTE_TARGET("sha,sse4.1,ssse3")
+
+#define SHANI_LOAD(p)      _mm_loadu_si128((const __m128i *)(const void *)(p))
+#define SHANI_STORE(p, v)  _mm_storeu_si128((__m128i *)(void *)(p), (v))
+
+/* rounds 4i .. 4i+3, W[i & 3] holds the words 4i .. 4i+3 of the message schedule */
+#define SHA1_RNDS4(i)                                                              \
+   E[(i) & 1] = _mm_sha1nexte_epu32(E[(i) & 1], W[(i) & 3]);                       \
+   E[((i) + 1) & 1] = ABCD;                                                        \
+   ABCD = _mm_sha1rnds4_epu32(ABCD, E[(i) & 1], (i) / 5)
+/* the words 4i+4 .. 4i+7 */
+#define SHA1_MSG2(i)  W[((i) + 1) & 3] = _mm_sha1msg2_epu32(W[((i) + 1) & 3], W[(i) & 3])
+/* the parts of the words 4i+8 .. 4i+15 which depend on the words 4i .. 4i+3 */
+#define SHA1_MSG1(i)  W[((i) + 3) & 3] = _mm_sha1msg1_epu32(W[((i) + 3) & 3], W[(i) & 3])
+#define SHA1_XOR(i)   W[((i) + 2) & 3] = _mm_xor_si128(W[((i) + 2) & 3], W[(i) & 3])
+
+#define SHA1_STEP(i)  SHA1_RNDS4(i); SHA1_MSG2(i); SHA1_MSG1(i); SHA1_XOR(i);
+
+/**
+  Compress blocks with SHA-NI
+  @param state   [in/out] The SHA-1 state, 5 words
+  @param in      The data
+  @param blocks  The number of 64 octet blocks
+*/
+SHANI_TARGET
+void sha1_shani_compress(ulong32 *state, const unsigned char *in, unsigned long blocks)
+{
+   __m128i ABCD, ABCD_SAVE, E_SAVE, MASK, E[2], W[4];
+   int i;
+
+   MASK = _mm_set_epi64x(0x0001020304050607LL, 0x08090a0b0c0d0e0fLL);
+
+   ABCD = _mm_shuffle_epi32(SHANI_LOAD(state), 0x1B);
+   E[0] = _mm_set_epi32((int)state[4], 0, 0, 0);
+
+   while (blocks-- > 0) {
+      ABCD_SAVE = ABCD;
+      E_SAVE    = E[0];
+
+      for (i = 0; i < 4; i++) {
+         W[i] = _mm_shuffle_epi8(SHANI_LOAD(in + 16 * i), MASK);
+      }
+
+      E[0] = _mm_add_epi32(E[0], W[0]);
+      E[1] = ABCD;
+      ABCD = _mm_sha1rnds4_epu32(ABCD, E[0], 0);
+      SHA1_RNDS4(1);  SHA1_MSG1(1);
+      SHA1_RNDS4(2);  SHA1_MSG1(2);  SHA1_XOR(2);
+      SHA1_STEP(3)
+      SHA1_STEP(4)
+      SHA1_STEP(5)
+      SHA1_STEP(6)
+      SHA1_STEP(7)
+      SHA1_STEP(8)
+      SHA1_STEP(9)
+      SHA1_STEP(10)
+      SHA1_STEP(11)
+      SHA1_STEP(12)
+      SHA1_STEP(13)
+      SHA1_STEP(14)
+      SHA1_STEP(15)
+      SHA1_STEP(16)
+      SHA1_RNDS4(17); SHA1_MSG2(17); SHA1_XOR(17);
+      SHA1_RNDS4(18); SHA1_MSG2(18);
+      SHA1_RNDS4(19);
+
+      E[0] = _mm_sha1nexte_epu32(E[0], E_SAVE);
+      ABCD = _mm_add_epi32(ABCD, ABCD_SAVE);
+      in += 64;
+   }
+
+   SHANI_STORE(state, _mm_shuffle_epi32(ABCD, 0x1B));
+   state[4] = (ulong32)_mm_extract_epi32(E[0], 3);
+}
+
+#endif
+
+/* ref:         $Format:%D$ */
+/* git commit:  $Format:%H$ */
+/* commit time: $Format:%ai$ */
@@ -196,6 +196,26 @@ static int sha256_compress(hash_state * md, const unsigned char *buf)
 }
 #endif
 
+/* compress one or more blocks */
+static int sha256_compress_nblocks(hash_state * md, const unsigned char *buf, unsigned long blocks)
+{
+    int err;
+
+#ifdef LTC_SHA_NI
+    if (ltc_cpu_has(LTC_CPU_SHA | LTC_CPU_SSE41 | LTC_CPU_SSSE3)) {
+        sha256_shani_compress(md->sha256.state, buf, blocks);
+        return CRYPT_OK;
+    }
+#endif
+    for (; blocks > 0; blocks--) {
+        if ((err = sha256_compress(md, buf)) != CRYPT_OK) {
+            return err;
+        }
+        buf += 64;
+    }
+    return CRYPT_OK;
+}
+
 /**
    Initialize the hash state
    @param md   The hash state you wish to initialize
@@ -225,7 +245,7 @@ int sha256_init(hash_state * md)
    @param inlen  The length of the data (octets)
    @return CRYPT_OK if successful
 */
-HASH_PROCESS(sha256_process, sha256_compress, sha256, 64)
+HASH_PROCESS_NBLOCKS(sha256_process, sha256_compress_nblocks, sha256, 64)
 
 /**
    Terminate the hash to get the digest
@@ -259,7 +279,7 @@ int sha256_done(hash_state * md, unsigned char *out)
         while (md->sha256.curlen < 64) {
             md->sha256.buf[md->sha256.curlen++] = (unsigned char)0;
         }
-        sha256_compress(md, md->sha256.buf);
+        sha256_compress_nblocks(md, md->sha256.buf, 1);
         md->sha256.curlen = 0;
     }
 
@@ -270,7 +290,7 @@ int sha256_done(hash_state * md, unsigned char *out)
 
     /* store length */
     STORE64H(md->sha256.length, md->sha256.buf+56);
-    sha256_compress(md, md->sha256.buf);
+    sha256_compress_nblocks(md, md->sha256.buf, 1);
 
     /* copy output */
     for (i = 0; i < 8; i++) {
@@ -321,7 +341,47 @@ int  sha256_test(void)
          return CRYPT_FAIL_TESTVECTOR;
       }
   }
+#ifdef LTC_SHA256_MB
+  {
+      /* 16 and 8 lanes against the generic code, the messages end in different blocks */
+      unsigned char buf[320], out[40][32], ref[32];
+      hash_job jobs[40];
+      unsigned long x, mask;
+      int err;
+
+      for (x = 0; x < sizeof(buf); x++) {
+          buf[x] = (unsigned char)(x * 7 + 3);
+      }
+      for (x = 0; x < 40; x++) {
+          jobs[x].in = buf + x;
+          jobs[x].inlen = 7 * x;
+          jobs[x].out = out[x];
+      }
+      sha256_init(&md);
+      for (i = 0; i < 2; i++) {
+          mask = ltc_cpu_mask(i == 0 ? ~0UL : ~(LTC_CPU_AVX512 | LTC_CPU_SHA));
+          err = sha256_mb_memory(md.sha256.state, 32, jobs, 40);
+          ltc_cpu_mask(mask);
+          if (err == CRYPT_NOP) {
+             continue;
+          }
+          for (x = 0; x < 40; x++) {
+              hash_state md2;
+              sha256_init(&md2);
+              sha256_process(&md2, jobs[x].in, jobs[x].inlen);
+              sha256_done(&md2, ref);
+              if (compare_testvector(out[x], sizeof(out[x]), ref, sizeof(ref), "SHA256 multi-buffer", i * 40 + (int)x)) {
+                 return CRYPT_FAIL_TESTVECTOR;
+              }
+          }
+      }
+  }
+#endif
+#ifdef LTC_AMD64_SIMD
+  return hash_test_cpu(&sha256_desc);
+#else
   return CRYPT_OK;
+#endif
  #endif
 }
 
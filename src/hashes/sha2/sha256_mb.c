@@ -0,0 +1,441 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ */
+
+/**
+   @file sha256_mb.c
+   SHA-256 of many independent messages using the AVX2 and AVX-512
+   instructions of x86-64 CPUs
+
+   Each 32-bit lane of a vector register hashes its own message, 8 of them
+   with AVX2 and 16 with AVX-512.  The state words are kept transposed, the
+   state of lane i is st[i], st[lanes + i] ... st[7 * lanes + i].  As soon as
+   a message is finished its lane is given the next one, so the lanes stay
+   busy until the last messages are hashed.
+*/
+#include "tomcrypt_private.h"
+
+#ifdef LTC_SHA256_MB
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+/* the AVX-512 macros of GCC mix declarations and code */
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wdeclaration-after-statement"
+#endif
+#include <immintrin.h>
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+#endif
+
+#define AVX2_TARGET   LTC_ATTRIBUTE_TARGET("avx2")
+#define AVX512_TARGET LTC_ATTRIBUTE_TARGET("avx2,avx512f")
+
+static const ulong32 K[64] = {
+    0x428a2f98UL, 0x71374491UL, 0xb5c0fbcfUL, 0xe9b5dba5UL, 0x3956c25bUL, 0x59f111f1UL, 0x923f82a4UL, 0xab1c5ed5UL,
+    0xd807aa98UL, 0x12835b01UL, 0x243185beUL, 0x550c7dc3UL, 0x72be5d74UL, 0x80deb1feUL, 0x9bdc06a7UL, 0xc19bf174UL,
+    0xe49b69c1UL, 0xefbe4786UL, 0x0fc19dc6UL, 0x240ca1ccUL, 0x2de92c6fUL, 0x4a7484aaUL, 0x5cb0a9dcUL, 0x76f988daUL,
+    0x983e5152UL, 0xa831c66dUL, 0xb00327c8UL, 0xbf597fc7UL, 0xc6e00bf3UL, 0xd5a79147UL, 0x06ca6351UL, 0x14292967UL,
+    0x27b70a85UL, 0x2e1b2138UL, 0x4d2c6dfcUL, 0x53380d13UL, 0x650a7354UL, 0x766a0abbUL, 0x81c2c92eUL, 0x92722c85UL,
+    0xa2bfe8a1UL, 0xa81a664bUL, 0xc24b8b70UL, 0xc76c51a3UL, 0xd192e819UL, 0xd6990624UL, 0xf40e3585UL, 0x106aa070UL,
+    0x19a4c116UL, 0x1e376c08UL, 0x2748774cUL, 0x34b0bcb5UL, 0x391c0cb3UL, 0x4ed8aa4aUL, 0x5b9cca4fUL, 0x682e6ff3UL,
+    0x748f82eeUL, 0x78a5636fUL, 0x84c87814UL, 0x8cc70208UL, 0x90befffaUL, 0xa4506cebUL, 0xbef9a3f7UL, 0xc67178f2UL
+};
+
+/* one round and the message schedule, the operations are those of the vector type */
+#define SHA256_MB_RND(a, b, c, d, e, f, g, h, i, ADD, SET1, SIGMA0, SIGMA1, CH, MAJ)       \
+   t0 = ADD(ADD(ADD(h, SIGMA1(e)), ADD(CH(e, f, g), SET1((int)K[i]))), W[i]);            \
+   t1 = ADD(SIGMA0(a), MAJ(a, b, c));                                                      \
+   d  = ADD(d, t0);                                                                        \
+   h  = ADD(t0, t1);
+
+#define SHA256_MB_ROUNDS(ADD, SET1, SIGMA0, SIGMA1, CH, MAJ, GAMMA0, GAMMA1)                          \
+   for (i = 16; i < 64; i++) {                                                                        \
+      W[i] = ADD(ADD(GAMMA1(W[i - 2]), W[i - 7]), ADD(GAMMA0(W[i - 15]), W[i - 16]));                 \
+   }                                                                                                  \
+   for (i = 0; i < 64; i += 8) {                                                                      \
+      SHA256_MB_RND(S[0],S[1],S[2],S[3],S[4],S[5],S[6],S[7],i+0, ADD, SET1, SIGMA0, SIGMA1, CH, MAJ) \
+      SHA256_MB_RND(S[7],S[0],S[1],S[2],S[3],S[4],S[5],S[6],i+1, ADD, SET1, SIGMA0, SIGMA1, CH, MAJ) \
+      SHA256_MB_RND(S[6],S[7],S[0],S[1],S[2],S[3],S[4],S[5],i+2, ADD, SET1, SIGMA0, SIGMA1, CH, MAJ) \
+      SHA256_MB_RND(S[5],S[6],S[7],S[0],S[1],S[2],S[3],S[4],i+3, ADD, SET1, SIGMA0, SIGMA1, CH, MAJ) \
+      SHA256_MB_RND(S[4],S[5],S[6],S[7],S[0],S[1],S[2],S[3],i+4, ADD, SET1, SIGMA0, SIGMA1, CH, MAJ) \
+      SHA256_MB_RND(S[3],S[4],S[5],S[6],S[7],S[0],S[1],S[2],i+5, ADD, SET1, SIGMA0, SIGMA1, CH, MAJ) \
+      SHA256_MB_RND(S[2],S[3],S[4],S[5],S[6],S[7],S[0],S[1],i+6, ADD, SET1, SIGMA0, SIGMA1, CH, MAJ) \
+      SHA256_MB_RND(S[1],S[2],S[3],S[4],S[5],S[6],S[7],S[0],i+7, ADD, SET1, SIGMA0, SIGMA1, CH, MAJ) \
+   }
+
+#define AVX2_LOAD(p)        _mm256_loadu_si256((const __m256i *)(const void *)(p))
+#define AVX2_STORE(p, v)    _mm256_storeu_si256((__m256i *)(void *)(p), (v))
+#define AVX2_ADD(a, b)      _mm256_add_epi32((a), (b))
+#define AVX2_SET1(k)        _mm256_set1_epi32(k)
+#define AVX2_ROR(x, n)      _mm256_or_si256(_mm256_srli_epi32((x), (n)), _mm256_slli_epi32((x), 32 - (n)))
+#define AVX2_XOR3(a, b, c)  _mm256_xor_si256(_mm256_xor_si256((a), (b)), (c))
+#define AVX2_SIGMA0(x)      AVX2_XOR3(AVX2_ROR((x), 2), AVX2_ROR((x), 13), AVX2_ROR((x), 22))
+#define AVX2_SIGMA1(x)      AVX2_XOR3(AVX2_ROR((x), 6), AVX2_ROR((x), 11), AVX2_ROR((x), 25))
+#define AVX2_GAMMA0(x)      AVX2_XOR3(AVX2_ROR((x), 7), AVX2_ROR((x), 18), _mm256_srli_epi32((x), 3))
+#define AVX2_GAMMA1(x)      AVX2_XOR3(AVX2_ROR((x), 17), AVX2_ROR((x), 19), _mm256_srli_epi32((x), 10))
+#define AVX2_CH(x, y, z)    _mm256_xor_si256((z), _mm256_and_si256((x), _mm256_xor_si256((y), (z))))
+#define AVX2_MAJ(x, y, z)   _mm256_or_si256(_mm256_and_si256(_mm256_or_si256((x), (y)), (z)), _mm256_and_si256((x), (y)))
+
+#define AVX512_LOAD(p)      _mm512_loadu_si512((const void *)(p))
+#define AVX512_STORE(p, v)  _mm512_storeu_si512((void *)(p), (v))
+#define AVX512_ADD(a, b)    _mm512_add_epi32((a), (b))
+#define AVX512_SET1(k)      _mm512_set1_epi32(k)
+#define AVX512_ROR(x, n)    _mm512_ror_epi32((x), (n))
+#define AVX512_XOR3(a, b, c) _mm512_ternarylogic_epi32((a), (b), (c), 0x96)
+#define AVX512_SIGMA0(x)    AVX512_XOR3(AVX512_ROR((x), 2), AVX512_ROR((x), 13), AVX512_ROR((x), 22))
+#define AVX512_SIGMA1(x)    AVX512_XOR3(AVX512_ROR((x), 6), AVX512_ROR((x), 11), AVX512_ROR((x), 25))
+#define AVX512_GAMMA0(x)    AVX512_XOR3(AVX512_ROR((x), 7), AVX512_ROR((x), 18), _mm512_srli_epi32((x), 3))
+#define AVX512_GAMMA1(x)    AVX512_XOR3(AVX512_ROR((x), 17), AVX512_ROR((x), 19), _mm512_srli_epi32((x), 10))
+#define AVX512_CH(x, y, z)  _mm512_ternarylogic_epi32((x), (y), (z), 0xCA)
+#define AVX512_MAJ(x, y, z) _mm512_ternarylogic_epi32((x), (y), (z), 0xE8)
+
+/* w[j] = the big endian word j of the eight rows r[0..7], r is overwritten */
+#define AVX2_TRANSPOSE(w, r) do {                                                              \
+   __m256i _t[8];                                                                              \
+   int _j;                                                                                     \
+   for (_j = 0; _j < 8; _j++) {                                                                \
+      r[_j] = _mm256_shuffle_epi8(r[_j], bswap);                                               \
+   }                                                                                           \
+   for (_j = 0; _j < 8; _j += 2) {                                                             \
+      _t[_j]     = _mm256_unpacklo_epi32(r[_j], r[_j + 1]);                                    \
+      _t[_j + 1] = _mm256_unpackhi_epi32(r[_j], r[_j + 1]);                                    \
+   }                                                                                           \
+   for (_j = 0; _j < 8; _j += 4) {                                                             \
+      r[_j]     = _mm256_unpacklo_epi64(_t[_j], _t[_j + 2]);                                   \
+      r[_j + 1] = _mm256_unpackhi_epi64(_t[_j], _t[_j + 2]);                                   \
+      r[_j + 2] = _mm256_unpacklo_epi64(_t[_j + 1], _t[_j + 3]);                               \
+      r[_j + 3] = _mm256_unpackhi_epi64(_t[_j + 1], _t[_j + 3]);                               \
+   }                                                                                           \
+   for (_j = 0; _j < 4; _j++) {                                                                \
+      w[_j]     = _mm256_permute2x128_si256(r[_j], r[_j + 4], 0x20);                           \
+      w[_j + 4] = _mm256_permute2x128_si256(r[_j], r[_j + 4], 0x31);                           \
+   }                                                                                           \
+} while (0)
+
+/* compress one block of each of the eight lanes */
+AVX2_TARGET
+static void _sha256_mb_avx2(ulong32 *st, const unsigned char * const *in)
+{
+   __m256i S[8], W[64], R[8], t0, t1, bswap;
+   int i, j;
+
+   bswap = _mm256_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12,
+                            3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+   for (i = 0; i < 2; i++) {
+      for (j = 0; j < 8; j++) {
+         R[j] = AVX2_LOAD(in[j] + 32 * i);
+      }
+      AVX2_TRANSPOSE((W + 8 * i), R);
+   }
+   for (i = 0; i < 8; i++) {
+      S[i] = AVX2_LOAD(st + 8 * i);
+   }
+
+   SHA256_MB_ROUNDS(AVX2_ADD, AVX2_SET1, AVX2_SIGMA0, AVX2_SIGMA1, AVX2_CH, AVX2_MAJ, AVX2_GAMMA0, AVX2_GAMMA1)
+
+   for (i = 0; i < 8; i++) {
+      AVX2_STORE(st + 8 * i, AVX2_ADD(S[i], AVX2_LOAD(st + 8 * i)));
+   }
+}
+
+#ifdef LTC_AMD64_AVX512
+/* compress one block of each of the sixteen lanes */
+AVX512_TARGET
+static void _sha256_mb_avx512(ulong32 *st, const unsigned char * const *in)
+{
+   __m512i S[8], W[64], t0, t1;
+   __m256i lo[8], hi[8], R[8], bswap;
+   int i, j;
+
+   bswap = _mm256_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12,
+                            3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+   for (i = 0; i < 2; i++) {
+      for (j = 0; j < 8; j++) {
+         R[j] = AVX2_LOAD(in[j] + 32 * i);
+      }
+      AVX2_TRANSPOSE(lo, R);
+      for (j = 0; j < 8; j++) {
+         R[j] = AVX2_LOAD(in[j + 8] + 32 * i);
+      }
+      AVX2_TRANSPOSE(hi, R);
+      for (j = 0; j < 8; j++) {
+         W[8 * i + j] = _mm512_inserti64x4(_mm512_castsi256_si512(lo[j]), hi[j], 1);
+      }
+   }
+   for (i = 0; i < 8; i++) {
+      S[i] = AVX512_LOAD(st + 16 * i);
+   }
+
+   SHA256_MB_ROUNDS(AVX512_ADD, AVX512_SET1, AVX512_SIGMA0, AVX512_SIGMA1, AVX512_CH, AVX512_MAJ, AVX512_GAMMA0, AVX512_GAMMA1)
+
+   for (i = 0; i < 8; i++) {
+      AVX512_STORE(st + 16 * i, AVX512_ADD(S[i], AVX512_LOAD(st + 16 * i)));
+   }
+}
+#endif
+
+/* the padding of a 32 octet message after a block of key, the words 8..15 of the block */
+#define SHA256_MB_HMAC_PAD(SET1)                                                               \
+   W[8] = SET1((int)0x80000000UL);                                                             \
+   for (i = 9; i < 15; i++) {                                                                  \
+      W[i] = SET1(0);                                                                          \
+   }                                                                                           \
+   W[15] = SET1((64 + 32) * 8);
+
+/* iterations of HMAC with the same key over the 32 octet values of eight lanes, see sha256_mb_pbkdf2() */
+AVX2_TARGET
+static void _sha256_mb_pbkdf2_avx2(const ulong32 *inner, const ulong32 *outer, ulong32 *tw, unsigned long iterations)
+{
+   __m256i S[8], W[64], T[8], t0, t1;
+   int i;
+
+   SHA256_MB_HMAC_PAD(AVX2_SET1)
+   for (i = 0; i < 8; i++) {
+      W[i] = T[i] = AVX2_LOAD(tw + 8 * i);
+   }
+   while (iterations-- > 0) {
+      for (i = 0; i < 8; i++) {
+         S[i] = AVX2_SET1((int)inner[i]);
+      }
+      SHA256_MB_ROUNDS(AVX2_ADD, AVX2_SET1, AVX2_SIGMA0, AVX2_SIGMA1, AVX2_CH, AVX2_MAJ, AVX2_GAMMA0, AVX2_GAMMA1)
+      for (i = 0; i < 8; i++) {
+         W[i] = AVX2_ADD(S[i], AVX2_SET1((int)inner[i]));
+         S[i] = AVX2_SET1((int)outer[i]);
+      }
+      SHA256_MB_ROUNDS(AVX2_ADD, AVX2_SET1, AVX2_SIGMA0, AVX2_SIGMA1, AVX2_CH, AVX2_MAJ, AVX2_GAMMA0, AVX2_GAMMA1)
+      for (i = 0; i < 8; i++) {
+         W[i] = AVX2_ADD(S[i], AVX2_SET1((int)outer[i]));
+         T[i] = _mm256_xor_si256(T[i], W[i]);
+      }
+   }
+   for (i = 0; i < 8; i++) {
+      AVX2_STORE(tw + 8 * i, T[i]);
+   }
+}
+
+#ifdef LTC_AMD64_AVX512
+/* the same with sixteen lanes */
+AVX512_TARGET
+static void _sha256_mb_pbkdf2_avx512(const ulong32 *inner, const ulong32 *outer, ulong32 *tw, unsigned long iterations)
+{
+   __m512i S[8], W[64], T[8], t0, t1;
+   int i;
+
+   SHA256_MB_HMAC_PAD(AVX512_SET1)
+   for (i = 0; i < 8; i++) {
+      W[i] = T[i] = AVX512_LOAD(tw + 16 * i);
+   }
+   while (iterations-- > 0) {
+      for (i = 0; i < 8; i++) {
+         S[i] = AVX512_SET1((int)inner[i]);
+      }
+      SHA256_MB_ROUNDS(AVX512_ADD, AVX512_SET1, AVX512_SIGMA0, AVX512_SIGMA1, AVX512_CH, AVX512_MAJ, AVX512_GAMMA0, AVX512_GAMMA1)
+      for (i = 0; i < 8; i++) {
+         W[i] = AVX512_ADD(S[i], AVX512_SET1((int)inner[i]));
+         S[i] = AVX512_SET1((int)outer[i]);
+      }
+      SHA256_MB_ROUNDS(AVX512_ADD, AVX512_SET1, AVX512_SIGMA0, AVX512_SIGMA1, AVX512_CH, AVX512_MAJ, AVX512_GAMMA0, AVX512_GAMMA1)
+      for (i = 0; i < 8; i++) {
+         W[i] = AVX512_ADD(S[i], AVX512_SET1((int)outer[i]));
+         T[i] = _mm512_xor_si512(T[i], W[i]);
+      }
+   }
+   for (i = 0; i < 8; i++) {
+      AVX512_STORE(tw + 16 * i, T[i]);
+   }
+}
+#endif
+
+/* a message which is hashed in one of the lanes */
+typedef struct {
+   const unsigned char *in;       /* the next block of the message */
+   unsigned long        blocks;   /* the number of full blocks left */
+   unsigned long        pad;      /* the number of blocks left in buf, 1 or 2 after the full blocks */
+   unsigned char       *out;      /* NULL if the lane is idle */
+   unsigned char        buf[128]; /* the last partial block and the padding, aligned to the end */
+} sha256_mb_lane;
+
+/**
+  Hash many independent messages with SHA-256 or SHA-224
+  @param iv      The initial state, 8 words
+  @param outlen  The length of the digests, 32 or 28 octets
+  @param jobs    The messages and where to store their digests
+  @param n       The number of jobs
+  @return CRYPT_OK if successful, CRYPT_NOP if the messages are hashed faster one by one
+*/
+int sha256_mb_memory(const ulong32 *iv, unsigned long outlen, const hash_job *jobs, unsigned long n)
+{
+   sha256_mb_lane lane[16];
+   const unsigned char *blk[16];
+   ulong32 st[8 * 16];
+   unsigned long lanes, active, next, r, i, j;
+
+   if (!ltc_cpu_has(LTC_CPU_AVX2)) {
+      return CRYPT_NOP;
+   }
+   lanes = 8;
+#ifdef LTC_AMD64_AVX512
+   if (ltc_cpu_has(LTC_CPU_AVX512)) {
+      lanes = 16;
+   }
+#endif
+#ifdef LTC_SHA_NI
+   /* SHA-NI is faster than the eight lanes of AVX2, not than sixteen lanes of AVX-512 */
+   if (lanes == 8 && ltc_cpu_has(LTC_CPU_SHA | LTC_CPU_SSE41 | LTC_CPU_SSSE3)) {
+      return CRYPT_NOP;
+   }
+#endif
+   /* too few messages to fill the lanes */
+   if (n < lanes) {
+      return CRYPT_NOP;
+   }
+
+   XMEMSET(lane, 0, sizeof(lane));
+   active = next = 0;
+
+   for (;;) {
+      /* give the idle lanes the next messages */
+      for (i = 0; i < lanes && next < n; i++) {
+         if (lane[i].out != NULL) {
+            continue;
+         }
+         for (j = 0; j < 8; j++) {
+            st[j * lanes + i] = iv[j];
+         }
+         lane[i].in     = jobs[next].in;
+         lane[i].blocks = jobs[next].inlen / 64;
+         lane[i].out    = jobs[next].out;
+         r = jobs[next].inlen % 64;
+         lane[i].pad = r < 56 ? 1 : 2;
+         zeromem(lane[i].buf + 128 - 64 * lane[i].pad, 64 * lane[i].pad);
+         XMEMCPY(lane[i].buf + 128 - 64 * lane[i].pad, jobs[next].in + 64 * lane[i].blocks, r);
+         lane[i].buf[128 - 64 * lane[i].pad + r] = 0x80;
+         STORE64H((ulong64)jobs[next].inlen << 3, lane[i].buf + 120);
+         active++;
+         next++;
+      }
+      if (active == 0) {
+         break;
+      }
+
+      /* the idle lanes hash garbage which is never stored */
+      for (i = 0; i < lanes; i++) {
+         if (lane[i].out != NULL && lane[i].blocks > 0) {
+            blk[i] = lane[i].in;
+         } else {
+            blk[i] = lane[i].buf + 128 - 64 * (lane[i].out != NULL ? lane[i].pad : 1);
+         }
+      }
+#ifdef LTC_AMD64_AVX512
+      if (lanes == 16) {
+         _sha256_mb_avx512(st, blk);
+      } else
+#endif
+      {
+         _sha256_mb_avx2(st, blk);
+      }
+
+      for (i = 0; i < lanes; i++) {
+         if (lane[i].out == NULL) {
+            continue;
+         }
+         if (lane[i].blocks > 0) {
+            lane[i].blocks--;
+            lane[i].in += 64;
+         } else if (--lane[i].pad == 0) {
+            for (j = 0; j < outlen / 4; j++) {
+               STORE32H(st[j * lanes + i], lane[i].out + 4 * j);
+            }
+            lane[i].out = NULL;
+            active--;
+         }
+      }
+   }
+
+#ifdef LTC_CLEAN_STACK
+   zeromem(lane, sizeof(lane));
+   zeromem(st, sizeof(st));
+#endif
+   return CRYPT_OK;
+}
+
+/**
+  The iterations of PBKDF2 with HMAC-SHA-256, one block of the output per lane
+
+  Every block is U_1 ^ U_2 ^ ... where U_k+1 is the HMAC of U_k, the same
+  key is used in all lanes.
+  @param inner       The state after the inner padded key block, 8 words
+  @param outer       The state after the outer padded key block, 8 words
+  @param t           [in/out] The blocks, U_1 on input and the result on output, 32 octets each
+  @param n           The number of blocks
+  @param iterations  The number of HMACs after U_1
+  @return CRYPT_OK if successful, CRYPT_NOP if the blocks are computed faster one by one
+*/
+int sha256_mb_pbkdf2(const ulong32 *inner, const ulong32 *outer, unsigned char *t, unsigned long n,
+                     unsigned long iterations)
+{
+   ulong32 tw[8 * 16];
+   unsigned long lanes, m, i, j;
+
+   if (!ltc_cpu_has(LTC_CPU_AVX2) || n < 2) {
+      return CRYPT_NOP;
+   }
+   lanes = 8;
+#ifdef LTC_AMD64_AVX512
+   if (ltc_cpu_has(LTC_CPU_AVX512)) {
+      lanes = 16;
+   }
+#endif
+#ifdef LTC_SHA_NI
+   /* a pass of eight lanes costs about as much as four or five blocks with SHA-NI, one of sixteen lanes as three or four */
+   if (ltc_cpu_has(LTC_CPU_SHA | LTC_CPU_SSE41 | LTC_CPU_SSSE3) && n < (lanes == 8 ? 5uL : 4uL)) {
+      return CRYPT_NOP;
+   }
+#endif
+
+   for (; n > 0; n -= m, t += 32 * m) {
+      m = n < lanes ? n : lanes;
+      for (i = 0; i < lanes; i++) {
+         for (j = 0; j < 8; j++) {
+            if (i < m) {
+               LOAD32H(tw[j * lanes + i], t + 32 * i + 4 * j);
+            } else {
+               tw[j * lanes + i] = 0;
+            }
+         }
+      }
+#ifdef LTC_AMD64_AVX512
+      if (lanes == 16) {
+         _sha256_mb_pbkdf2_avx512(inner, outer, tw, iterations);
+      } else
+#endif
+      {
+         _sha256_mb_pbkdf2_avx2(inner, outer, tw, iterations);
+      }
+      for (i = 0; i < m; i++) {
+         for (j = 0; j < 8; j++) {
+            STORE32H(tw[j * lanes + i], t + 32 * i + 4 * j);
+         }
+      }
+   }
+
+#ifdef LTC_CLEAN_STACK
+   zeromem(tw, sizeof(tw));
+#endif
+   return CRYPT_OK;
+}
+
+#endif
+
+/* ref:         $Format:%D$ */
+/* git commit:  $Format:%H$ */
+/* commit time: $Format:%ai$ */
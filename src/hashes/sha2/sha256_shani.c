@@ -0,0 +1,127 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ */
+
+/**
+   @file sha256_shani.c
+   SHA-256 compression using the SHA extensions of x86-64 CPUs
+
+   The state is kept as the two words ABEF and CDGH which SHA256RNDS2 expects,
+   it's only converted from and back to the order of sha256_state once per call.
+*/
+#include "tomcrypt_private.h"
+
+#if defined(LTC_SHA_NI) && defined(LTC_SHA256)
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+/* the AVX-512 macros of GCC mix declarations and code */
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wdeclaration-after-statement"
+#endif
+#include <immintrin.h>
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+#endif
+
+#define SHANI_TARGET LTC_ATTRIBUTE_TARGET("sha,sse4.1,ssse3")
+
+#define SHANI_LOAD(p)      _mm_loadu_si128((const __m128i *)(const void *)(p))
+#define SHANI_STORE(p, v)  _mm_storeu_si128((__m128i *)(void *)(p), (v))
+
+static const ulong32 K[64] = {
+    0x428a2f98UL, 0x71374491UL, 0xb5c0fbcfUL, 0xe9b5dba5UL, 0x3956c25bUL, 0x59f111f1UL, 0x923f82a4UL, 0xab1c5ed5UL,
+    0xd807aa98UL, 0x12835b01UL, 0x243185beUL, 0x550c7dc3UL, 0x72be5d74UL, 0x80deb1feUL, 0x9bdc06a7UL, 0xc19bf174UL,
+    0xe49b69c1UL, 0xefbe4786UL, 0x0fc19dc6UL, 0x240ca1ccUL, 0x2de92c6fUL, 0x4a7484aaUL, 0x5cb0a9dcUL, 0x76f988daUL,
+    0x983e5152UL, 0xa831c66dUL, 0xb00327c8UL, 0xbf597fc7UL, 0xc6e00bf3UL, 0xd5a79147UL, 0x06ca6351UL, 0x14292967UL,
+    0x27b70a85UL, 0x2e1b2138UL, 0x4d2c6dfcUL, 0x53380d13UL, 0x650a7354UL, 0x766a0abbUL, 0x81c2c92eUL, 0x92722c85UL,
+    0xa2bfe8a1UL, 0xa81a664bUL, 0xc24b8b70UL, 0xc76c51a3UL, 0xd192e819UL, 0xd6990624UL, 0xf40e3585UL, 0x106aa070UL,
+    0x19a4c116UL, 0x1e376c08UL, 0x2748774cUL, 0x34b0bcb5UL, 0x391c0cb3UL, 0x4ed8aa4aUL, 0x5b9cca4fUL, 0x682e6ff3UL,
+    0x748f82eeUL, 0x78a5636fUL, 0x84c87814UL, 0x8cc70208UL, 0x90befffaUL, 0xa4506cebUL, 0xbef9a3f7UL, 0xc67178f2UL
+};
+
+/* rounds 4i .. 4i+3, W[i & 3] holds the words 4i .. 4i+3 of the message schedule */
+#define SHA256_RNDS_LO(i)                                                          \
+   MSG = _mm_add_epi32(W[(i) & 3], SHANI_LOAD(K + 4 * (i)));                       \
+   STATE1 = _mm_sha256rnds2_epu32(STATE1, STATE0, MSG)
+#define SHA256_RNDS_HI                                                             \
+   MSG = _mm_shuffle_epi32(MSG, 0x0E);                                             \
+   STATE0 = _mm_sha256rnds2_epu32(STATE0, STATE1, MSG)
+/* the words 4i+4 .. 4i+7 */
+#define SHA256_MSG2(i)                                                             \
+   W[((i) + 1) & 3] = _mm_sha256msg2_epu32(_mm_add_epi32(W[((i) + 1) & 3],          \
+                      _mm_alignr_epi8(W[(i) & 3], W[((i) + 3) & 3], 4)), W[(i) & 3])
+/* the first part of the words 4i+12 .. 4i+15 */
+#define SHA256_MSG1(i)                                                             \
+   W[((i) + 3) & 3] = _mm_sha256msg1_epu32(W[((i) + 3) & 3], W[(i) & 3])
+
+#define SHA256_STEP(i)      SHA256_RNDS_LO(i); SHA256_MSG2(i); SHA256_RNDS_HI; SHA256_MSG1(i);
+
+/**
+  Compress blocks with SHA-NI
+  @param state   [in/out] The SHA-256 state, 8 words
+  @param in      The data
+  @param blocks  The number of 64 octet blocks
+*/
+SHANI_TARGET
+void sha256_shani_compress(ulong32 *state, const unsigned char *in, unsigned long blocks)
+{
+   __m128i STATE0, STATE1, ABEF, CDGH, MSG, TMP, MASK, W[4];
+   int i;
+
+   MASK = _mm_set_epi64x(0x0c0d0e0f08090a0bLL, 0x0405060700010203LL);
+
+   TMP    = _mm_shuffle_epi32(SHANI_LOAD(state), 0xB1);       /* CDAB */
+   STATE1 = _mm_shuffle_epi32(SHANI_LOAD(state + 4), 0x1B);   /* EFGH */
+   STATE0 = _mm_alignr_epi8(TMP, STATE1, 8);                  /* ABEF */
+   STATE1 = _mm_blend_epi16(STATE1, TMP, 0xF0);               /* CDGH */
+
+   while (blocks-- > 0) {
+      ABEF = STATE0;
+      CDGH = STATE1;
+
+      for (i = 0; i < 4; i++) {
+         W[i] = _mm_shuffle_epi8(SHANI_LOAD(in + 16 * i), MASK);
+      }
+
+      SHA256_RNDS_LO(0);  SHA256_RNDS_HI;
+      SHA256_RNDS_LO(1);  SHA256_RNDS_HI; SHA256_MSG1(1);
+      SHA256_RNDS_LO(2);  SHA256_RNDS_HI; SHA256_MSG1(2);
+      SHA256_STEP(3)
+      SHA256_STEP(4)
+      SHA256_STEP(5)
+      SHA256_STEP(6)
+      SHA256_STEP(7)
+      SHA256_STEP(8)
+      SHA256_STEP(9)
+      SHA256_STEP(10)
+      SHA256_STEP(11)
+      SHA256_STEP(12)
+      SHA256_RNDS_LO(13); SHA256_MSG2(13); SHA256_RNDS_HI;
+      SHA256_RNDS_LO(14); SHA256_MSG2(14); SHA256_RNDS_HI;
+      SHA256_RNDS_LO(15); SHA256_RNDS_HI;
+
+      STATE0 = _mm_add_epi32(STATE0, ABEF);
+      STATE1 = _mm_add_epi32(STATE1, CDGH);
+      in += 64;
+   }
+
+   TMP    = _mm_shuffle_epi32(STATE0, 0x1B);                  /* FEBA */
+   STATE1 = _mm_shuffle_epi32(STATE1, 0xB1);                  /* DCHG */
+   SHANI_STORE(state, _mm_blend_epi16(TMP, STATE1, 0xF0));    /* DCBA */
+   SHANI_STORE(state + 4, _mm_alignr_epi8(STATE1, TMP, 8));   /* HGFE */
+}
+
+#endif
+
+/* ref:         $Format:%D$ */
+/* git commit:  $Format:%H$ */
+/* commit time: $Format:%ai$ */
@@ -165,6 +165,26 @@ static int sha512_compress(hash_state * md, const unsigned char *buf)
 }
 #endif
 
+/* compress one or more blocks */
+static int sha512_compress_nblocks(hash_state * md, const unsigned char *buf, unsigned long blocks)
+{
+    int err;
+
+#ifdef LTC_SHA512_AVX2
+    if (ltc_cpu_has(LTC_CPU_AVX2)) {
+        sha512_avx2_compress(md->sha512.state, buf, blocks);
+        return CRYPT_OK;
+    }
+#endif
+    for (; blocks > 0; blocks--) {
+        if ((err = sha512_compress(md, buf)) != CRYPT_OK) {
+            return err;
+        }
+        buf += 128;
+    }
+    return CRYPT_OK;
+}
+
 /**
    Initialize the hash state
    @param md   The hash state you wish to initialize
@@ -193,7 +213,7 @@ int sha512_init(hash_state * md)
    @param inlen  The length of the data (octets)
    @return CRYPT_OK if successful
 */
-HASH_PROCESS(sha512_process, sha512_compress, sha512, 128)
+HASH_PROCESS_NBLOCKS(sha512_process, sha512_compress_nblocks, sha512, 128)
 
 /**
    Terminate the hash to get the digest
@@ -226,7 +246,7 @@ int sha512_done(hash_state * md, unsigned char *out)
         while (md->sha512.curlen < 128) {
             md->sha512.buf[md->sha512.curlen++] = (unsigned char)0;
         }
-        sha512_compress(md, md->sha512.buf);
+        sha512_compress_nblocks(md, md->sha512.buf, 1);
         md->sha512.curlen = 0;
     }
 
@@ -240,7 +260,7 @@ int sha512_done(hash_state * md, unsigned char *out)
 
     /* store length */
     STORE64H(md->sha512.length, md->sha512.buf+120);
-    sha512_compress(md, md->sha512.buf);
+    sha512_compress_nblocks(md, md->sha512.buf, 1);
 
     /* copy output */
     for (i = 0; i < 8; i++) {
@@ -299,7 +319,11 @@ int  sha512_test(void)
          return CRYPT_FAIL_TESTVECTOR;
       }
   }
+#ifdef LTC_AMD64_SIMD
+  return hash_test_cpu(&sha512_desc);
+#else
   return CRYPT_OK;
+#endif
   #endif
 }
 
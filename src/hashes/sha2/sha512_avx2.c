@@ -0,0 +1,183 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ */
+
+/**
+   @file sha512_avx2.c
+   SHA-512 compression using the AVX2 instructions of x86-64 CPUs
+
+   The message schedule of two blocks is computed at once, the low 128-bit
+   half of each register holds two words of the first block and the high
+   half the same two words of the second block.  The words are stored with
+   the round constants already added, and the rounds of both blocks are done
+   with scalar code.  The schedule of the words 16..79 is computed within the
+   rounds of the first block, so the vector and the scalar units work side
+   by side.
+*/
+#include "tomcrypt_private.h"
+
+#ifdef LTC_SHA512_AVX2
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+/* the AVX-512 macros of GCC mix declarations and code */
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wdeclaration-after-statement"
+#endif
+#include <immintrin.h>
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+#endif
+
+#define AVX2_TARGET LTC_ATTRIBUTE_TARGET("avx2")
+
+#define AVX2_LOAD128(p)   _mm_loadu_si128((const __m128i *)(const void *)(p))
+#define AVX2_ROR64(x, n)  _mm256_or_si256(_mm256_srli_epi64((x), (n)), _mm256_slli_epi64((x), 64 - (n)))
+
+static const ulong64 K[80] = {
+CONST64(0x428a2f98d728ae22), CONST64(0x7137449123ef65cd), CONST64(0xb5c0fbcfec4d3b2f), CONST64(0xe9b5dba58189dbbc),
+CONST64(0x3956c25bf348b538), CONST64(0x59f111f1b605d019), CONST64(0x923f82a4af194f9b), CONST64(0xab1c5ed5da6d8118),
+CONST64(0xd807aa98a3030242), CONST64(0x12835b0145706fbe), CONST64(0x243185be4ee4b28c), CONST64(0x550c7dc3d5ffb4e2),
+CONST64(0x72be5d74f27b896f), CONST64(0x80deb1fe3b1696b1), CONST64(0x9bdc06a725c71235), CONST64(0xc19bf174cf692694),
+CONST64(0xe49b69c19ef14ad2), CONST64(0xefbe4786384f25e3), CONST64(0x0fc19dc68b8cd5b5), CONST64(0x240ca1cc77ac9c65),
+CONST64(0x2de92c6f592b0275), CONST64(0x4a7484aa6ea6e483), CONST64(0x5cb0a9dcbd41fbd4), CONST64(0x76f988da831153b5),
+CONST64(0x983e5152ee66dfab), CONST64(0xa831c66d2db43210), CONST64(0xb00327c898fb213f), CONST64(0xbf597fc7beef0ee4),
+CONST64(0xc6e00bf33da88fc2), CONST64(0xd5a79147930aa725), CONST64(0x06ca6351e003826f), CONST64(0x142929670a0e6e70),
+CONST64(0x27b70a8546d22ffc), CONST64(0x2e1b21385c26c926), CONST64(0x4d2c6dfc5ac42aed), CONST64(0x53380d139d95b3df),
+CONST64(0x650a73548baf63de), CONST64(0x766a0abb3c77b2a8), CONST64(0x81c2c92e47edaee6), CONST64(0x92722c851482353b),
+CONST64(0xa2bfe8a14cf10364), CONST64(0xa81a664bbc423001), CONST64(0xc24b8b70d0f89791), CONST64(0xc76c51a30654be30),
+CONST64(0xd192e819d6ef5218), CONST64(0xd69906245565a910), CONST64(0xf40e35855771202a), CONST64(0x106aa07032bbd1b8),
+CONST64(0x19a4c116b8d2d0c8), CONST64(0x1e376c085141ab53), CONST64(0x2748774cdf8eeb99), CONST64(0x34b0bcb5e19b48a8),
+CONST64(0x391c0cb3c5c95a63), CONST64(0x4ed8aa4ae3418acb), CONST64(0x5b9cca4f7763e373), CONST64(0x682e6ff3d6b2b8a3),
+CONST64(0x748f82ee5defb2fc), CONST64(0x78a5636f43172f60), CONST64(0x84c87814a1f0ab72), CONST64(0x8cc702081a6439ec),
+CONST64(0x90befffa23631e28), CONST64(0xa4506cebde82bde9), CONST64(0xbef9a3f7b2c67915), CONST64(0xc67178f2e372532b),
+CONST64(0xca273eceea26619c), CONST64(0xd186b8c721c0c207), CONST64(0xeada7dd6cde0eb1e), CONST64(0xf57d4f7fee6ed178),
+CONST64(0x06f067aa72176fba), CONST64(0x0a637dc5a2c898a6), CONST64(0x113f9804bef90dae), CONST64(0x1b710b35131c471b),
+CONST64(0x28db77f523047d84), CONST64(0x32caab7b40c72493), CONST64(0x3c9ebe0a15c9bebc), CONST64(0x431d67c49c100d4c),
+CONST64(0x4cc5d4becb3e42b6), CONST64(0x597f299cfc657e2a), CONST64(0x5fcb6fab3ad6faec), CONST64(0x6c44198c4a475817)
+};
+
+#define Ch(x,y,z)       (z ^ (x & (y ^ z)))
+#define Maj(x,y,z)      (((x | y) & z) | (x & y))
+#define Sigma0(x)       (ROR64c(x, 28) ^ ROR64c(x, 34) ^ ROR64c(x, 39))
+#define Sigma1(x)       (ROR64c(x, 14) ^ ROR64c(x, 18) ^ ROR64c(x, 41))
+
+/* wk[i] = W[i] + K[i] */
+#define RND(a,b,c,d,e,f,g,h,i)                       \
+     t0 = h + Sigma1(e) + Ch(e, f, g) + wk[i];       \
+     t1 = Sigma0(a) + Maj(a, b, c);                  \
+     d += t0;                                        \
+     h  = t0 + t1;
+
+#define RND8(i)                                      \
+     RND(S[0],S[1],S[2],S[3],S[4],S[5],S[6],S[7],(i)+0) \
+     RND(S[7],S[0],S[1],S[2],S[3],S[4],S[5],S[6],(i)+1) \
+     RND(S[6],S[7],S[0],S[1],S[2],S[3],S[4],S[5],(i)+2) \
+     RND(S[5],S[6],S[7],S[0],S[1],S[2],S[3],S[4],(i)+3) \
+     RND(S[4],S[5],S[6],S[7],S[0],S[1],S[2],S[3],(i)+4) \
+     RND(S[3],S[4],S[5],S[6],S[7],S[0],S[1],S[2],(i)+5) \
+     RND(S[2],S[3],S[4],S[5],S[6],S[7],S[0],S[1],(i)+6) \
+     RND(S[1],S[2],S[3],S[4],S[5],S[6],S[7],S[0],(i)+7)
+
+/* X[j & 7] = the words 2j and 2j+1 of both blocks, j >= 8 */
+#define SCHEDULE(j) do {                                                                            \
+   __m256i _w15, _w7, _s0, _s1;                                                                     \
+   _w15 = _mm256_alignr_epi8(X[((j) + 1) & 7], X[(j) & 7], 8);                                      \
+   _w7  = _mm256_alignr_epi8(X[((j) + 5) & 7], X[((j) + 4) & 7], 8);                                \
+   _s0  = _mm256_xor_si256(_mm256_xor_si256(AVX2_ROR64(_w15, 1), AVX2_ROR64(_w15, 8)),              \
+                           _mm256_srli_epi64(_w15, 7));                                             \
+   _s1  = _mm256_xor_si256(_mm256_xor_si256(AVX2_ROR64(X[((j) + 7) & 7], 19),                       \
+                           AVX2_ROR64(X[((j) + 7) & 7], 61)), _mm256_srli_epi64(X[((j) + 7) & 7], 6)); \
+   X[(j) & 7] = _mm256_add_epi64(_mm256_add_epi64(X[(j) & 7], _w7), _mm256_add_epi64(_s0, _s1));    \
+   _mm_storeu_si128((__m128i *)(void *)(wk + 2 * (j)),                                              \
+                    _mm_add_epi64(_mm256_castsi256_si128(X[(j) & 7]), AVX2_LOAD128(K + 2 * (j))));  \
+   _mm_storeu_si128((__m128i *)(void *)(wk2 + 2 * (j)),                                             \
+                    _mm_add_epi64(_mm256_extracti128_si256(X[(j) & 7], 1), AVX2_LOAD128(K + 2 * (j)))); \
+} while (0)
+
+/**
+  Compress blocks with AVX2
+  @param state   [in/out] The SHA-512 state, 8 words
+  @param in      The data
+  @param blocks  The number of 128 octet blocks
+*/
+AVX2_TARGET
+void sha512_avx2_compress(ulong64 *state, const unsigned char *in, unsigned long blocks)
+{
+   ulong64 S[8], t0, t1, WK[2][80], *wk, *wk2;
+   __m256i X[8], bswap;
+   const unsigned char *in2;
+   int i;
+
+   bswap = _mm256_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8,
+                            7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8);
+
+   while (blocks > 0) {
+      /* a single block is processed in both halves */
+      in2 = blocks > 1 ? in + 128 : in;
+      wk  = WK[0];
+      wk2 = WK[1];
+      for (i = 0; i < 8; i++) {
+         X[i] = _mm256_shuffle_epi8(_mm256_inserti128_si256(_mm256_castsi128_si256(AVX2_LOAD128(in + 16 * i)),
+                                                            AVX2_LOAD128(in2 + 16 * i), 1), bswap);
+         _mm_storeu_si128((__m128i *)(void *)(wk + 2 * i),
+                          _mm_add_epi64(_mm256_castsi256_si128(X[i]), AVX2_LOAD128(K + 2 * i)));
+         _mm_storeu_si128((__m128i *)(void *)(wk2 + 2 * i),
+                          _mm_add_epi64(_mm256_extracti128_si256(X[i], 1), AVX2_LOAD128(K + 2 * i)));
+      }
+
+      /* the first block, with the schedule of the words 16..79 */
+      for (i = 0; i < 8; i++) {
+         S[i] = state[i];
+      }
+      for (i = 0; i < 64; i += 8) {
+         SCHEDULE((i >> 1) + 8);
+         SCHEDULE((i >> 1) + 9);
+         SCHEDULE((i >> 1) + 10);
+         SCHEDULE((i >> 1) + 11);
+         RND8(i)
+      }
+      RND8(64)
+      RND8(72)
+      for (i = 0; i < 8; i++) {
+         state[i] += S[i];
+      }
+
+      if (blocks == 1) {
+         break;
+      }
+
+      /* the second block */
+      wk = wk2;
+      for (i = 0; i < 8; i++) {
+         S[i] = state[i];
+      }
+      for (i = 0; i < 80; i += 8) {
+         RND8(i)
+      }
+      for (i = 0; i < 8; i++) {
+         state[i] += S[i];
+      }
+
+      in += 256;
+      blocks -= 2;
+   }
+
+#ifdef LTC_CLEAN_STACK
+   zeromem(WK, sizeof(WK));
+#endif
+}
+
+#endif
+
+/* ref:         $Format:%D$ */
+/* git commit:  $Format:%H$ */
+/* commit time: $Format:%ai$ */
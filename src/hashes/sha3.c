@@ -152,6 +152,7 @@ static const ulong64 keccakf_rndc[24] = {
    CONST64(0x0000000080000001), CONST64(0x8000000080008008)
 };
 
+#ifdef LTC_SMALL_CODE
 static const unsigned keccakf_rotc[24] = {
    1, 3, 6, 10, 15, 21, 28, 36, 45, 55, 2, 14, 27, 41, 56, 8, 25, 43, 62, 18, 39, 61, 20, 44
 };
@@ -197,6 +198,109 @@ static void keccakf(ulong64 s[25])
       s[0] ^= keccakf_rndc[round];
    }
 }
+#else
+/* One round from the lanes A.. into the lanes E.., the lanes are named by
+ * their row (b, g, k, m, s) and column (a, e, i, o, u).  The lanes be, bi,
+ * go, ki, mi and sa are kept complemented, which turns most of the NOTs of
+ * Chi into ORs, only five NOTs per round are left.
+ */
+#define KECCAK_ROUND(A, E, rc)                                              \
+   Ca = A##ba ^ A##ga ^ A##ka ^ A##ma ^ A##sa;                              \
+   Ce = A##be ^ A##ge ^ A##ke ^ A##me ^ A##se;                              \
+   Ci = A##bi ^ A##gi ^ A##ki ^ A##mi ^ A##si;                              \
+   Co = A##bo ^ A##go ^ A##ko ^ A##mo ^ A##so;                              \
+   Cu = A##bu ^ A##gu ^ A##ku ^ A##mu ^ A##su;                              \
+   Da = Cu ^ ROL64c(Ce, 1);                                                 \
+   De = Ca ^ ROL64c(Ci, 1);                                                 \
+   Di = Ce ^ ROL64c(Co, 1);                                                 \
+   Do = Ci ^ ROL64c(Cu, 1);                                                 \
+   Du = Co ^ ROL64c(Ca, 1);                                                 \
+                                                                            \
+   Ba = A##ba ^ Da;                                                         \
+   Be = ROL64c(A##ge ^ De, 44);                                             \
+   Bi = ROL64c(A##ki ^ Di, 43);                                             \
+   Bo = ROL64c(A##mo ^ Do, 21);                                             \
+   Bu = ROL64c(A##su ^ Du, 14);                                             \
+   E##ba = Ba ^ (Be | Bi) ^ (rc);                                           \
+   E##be = Be ^ (~Bi | Bo);                                                 \
+   E##bi = Bi ^ (Bo & Bu);                                                  \
+   E##bo = Bo ^ (Bu | Ba);                                                  \
+   E##bu = Bu ^ (Ba & Be);                                                  \
+                                                                            \
+   Ba = ROL64c(A##bo ^ Do, 28);                                             \
+   Be = ROL64c(A##gu ^ Du, 20);                                             \
+   Bi = ROL64c(A##ka ^ Da, 3);                                              \
+   Bo = ROL64c(A##me ^ De, 45);                                             \
+   Bu = ROL64c(A##si ^ Di, 61);                                             \
+   E##ga = Ba ^ (Be | Bi);                                                  \
+   E##ge = Be ^ (Bi & Bo);                                                  \
+   E##gi = Bi ^ (Bo | ~Bu);                                                 \
+   E##go = Bo ^ (Bu | Ba);                                                  \
+   E##gu = Bu ^ (Ba & Be);                                                  \
+                                                                            \
+   Ba = ROL64c(A##be ^ De, 1);                                              \
+   Be = ROL64c(A##gi ^ Di, 6);                                              \
+   Bi = ROL64c(A##ko ^ Do, 25);                                             \
+   Bo = ROL64c(A##mu ^ Du, 8);                                              \
+   Bu = ROL64c(A##sa ^ Da, 18);                                             \
+   E##ka = Ba ^ (Be | Bi);                                                  \
+   E##ke = Be ^ (Bi & Bo);                                                  \
+   Bo = ~Bo;                                                                \
+   E##ki = Bi ^ (Bo & Bu);                                                  \
+   E##ko = Bo ^ (Bu | Ba);                                                  \
+   E##ku = Bu ^ (Ba & Be);                                                  \
+                                                                            \
+   Ba = ROL64c(A##bu ^ Du, 27);                                             \
+   Be = ROL64c(A##ga ^ Da, 36);                                             \
+   Bi = ROL64c(A##ke ^ De, 10);                                             \
+   Bo = ROL64c(A##mi ^ Di, 15);                                             \
+   Bu = ROL64c(A##so ^ Do, 56);                                             \
+   E##ma = Ba ^ (Be & Bi);                                                  \
+   E##me = Be ^ (Bi | Bo);                                                  \
+   Bo = ~Bo;                                                                \
+   E##mi = Bi ^ (Bo | Bu);                                                  \
+   E##mo = Bo ^ (Bu & Ba);                                                  \
+   E##mu = Bu ^ (Ba | Be);                                                  \
+                                                                            \
+   Ba = ROL64c(A##bi ^ Di, 62);                                             \
+   Be = ROL64c(A##go ^ Do, 55);                                             \
+   Bi = ROL64c(A##ku ^ Du, 39);                                             \
+   Bo = ROL64c(A##ma ^ Da, 41);                                             \
+   Bu = ROL64c(A##se ^ De, 2);                                              \
+   E##su = Bu ^ (Ba & Be);                                                  \
+   Be = ~Be;                                                                \
+   E##sa = Ba ^ (Be & Bi);                                                  \
+   E##se = Be ^ (Bi | Bo);                                                  \
+   E##si = Bi ^ (Bo & Bu);                                                  \
+   E##so = Bo ^ (Bu | Ba);
+
+static void keccakf(ulong64 s[25])
+{
+   ulong64 Aba, Abe, Abi, Abo, Abu, Aga, Age, Agi, Ago, Agu, Aka, Ake, Aki, Ako, Aku;
+   ulong64 Ama, Ame, Ami, Amo, Amu, Asa, Ase, Asi, Aso, Asu;
+   ulong64 Eba, Ebe, Ebi, Ebo, Ebu, Ega, Ege, Egi, Ego, Egu, Eka, Eke, Eki, Eko, Eku;
+   ulong64 Ema, Eme, Emi, Emo, Emu, Esa, Ese, Esi, Eso, Esu;
+   ulong64 Ba, Be, Bi, Bo, Bu, Ca, Ce, Ci, Co, Cu, Da, De, Di, Do, Du;
+   int round;
+
+   Aba =  s[ 0]; Abe = ~s[ 1]; Abi = ~s[ 2]; Abo =  s[ 3]; Abu =  s[ 4];
+   Aga =  s[ 5]; Age =  s[ 6]; Agi =  s[ 7]; Ago = ~s[ 8]; Agu =  s[ 9];
+   Aka =  s[10]; Ake =  s[11]; Aki = ~s[12]; Ako =  s[13]; Aku =  s[14];
+   Ama =  s[15]; Ame =  s[16]; Ami = ~s[17]; Amo =  s[18]; Amu =  s[19];
+   Asa = ~s[20]; Ase =  s[21]; Asi =  s[22]; Aso =  s[23]; Asu =  s[24];
+
+   for (round = 0; round < SHA3_KECCAK_ROUNDS; round += 2) {
+      KECCAK_ROUND(A, E, keccakf_rndc[round])
+      KECCAK_ROUND(E, A, keccakf_rndc[round + 1])
+   }
+
+   s[ 0] =  Aba; s[ 1] = ~Abe; s[ 2] = ~Abi; s[ 3] =  Abo; s[ 4] =  Abu;
+   s[ 5] =  Aga; s[ 6] =  Age; s[ 7] =  Agi; s[ 8] = ~Ago; s[ 9] =  Agu;
+   s[10] =  Aka; s[11] =  Ake; s[12] = ~Aki; s[13] =  Ako; s[14] =  Aku;
+   s[15] =  Ama; s[16] =  Ame; s[17] = ~Ami; s[18] =  Amo; s[19] =  Amu;
+   s[20] = ~Asa; s[21] =  Ase; s[22] =  Asi; s[23] =  Aso; s[24] =  Asu;
+}
+#endif
 
 static LTC_INLINE int _done(hash_state *md, unsigned char *hash, ulong64 pad)
 {
@@ -330,43 +434,62 @@ int keccak_done(hash_state *md, unsigned char *out)
 #endif
 
 #ifdef LTC_SHA3
-int sha3_shake_done(hash_state *md, unsigned char *out, unsigned long outlen)
+/**
+  Squeeze the next octets of SHAKE output, can be called many times
+  @param md      The hash state
+  @param out     [out] Where to store the output
+  @param outlen  The number of octets to produce
+  @return CRYPT_OK if successful
+*/
+int sha3_shake_squeeze(hash_state *md, unsigned char *out, unsigned long outlen)
 {
-   /* IMPORTANT NOTE: sha3_shake_done can be called many times */
-   unsigned long idx;
+   unsigned long rate;
    unsigned i;
 
    if (outlen == 0) return CRYPT_OK; /* nothing to do */
    LTC_ARGCHK(md  != NULL);
    LTC_ARGCHK(out != NULL);
 
+   rate = (SHA3_KECCAK_SPONGE_WORDS - md->sha3.capacity_words) * 8;
+
    if (!md->sha3.xof_flag) {
       /* shake_xof operation must be done only once */
       md->sha3.s[md->sha3.word_index] ^= (md->sha3.saved ^ (CONST64(0x1F) << (md->sha3.byte_index * 8)));
       md->sha3.s[SHA3_KECCAK_SPONGE_WORDS - md->sha3.capacity_words - 1] ^= CONST64(0x8000000000000000);
       keccakf(md->sha3.s);
-      /* store sha3.s[] as little-endian bytes into sha3.sb */
-      for(i = 0; i < SHA3_KECCAK_SPONGE_WORDS; i++) {
-         STORE64L(md->sha3.s[i], md->sha3.sb + i * 8);
-      }
       md->sha3.byte_index = 0;
       md->sha3.xof_flag = 1;
    }
 
-   for (idx = 0; idx < outlen; idx++) {
-      if(md->sha3.byte_index >= (SHA3_KECCAK_SPONGE_WORDS - md->sha3.capacity_words) * 8) {
+   /* byte_index is the next octet of sha3.s[] to output, rate if the block is used up */
+   while (outlen > 0) {
+      if (md->sha3.byte_index == rate) {
          keccakf(md->sha3.s);
-         /* store sha3.s[] as little-endian bytes into sha3.sb */
-         for(i = 0; i < SHA3_KECCAK_SPONGE_WORDS; i++) {
-            STORE64L(md->sha3.s[i], md->sha3.sb + i * 8);
-         }
          md->sha3.byte_index = 0;
       }
-      out[idx] = md->sha3.sb[md->sha3.byte_index++];
+      if (md->sha3.byte_index == 0 && outlen >= rate) {
+         /* a whole block, stored as little-endian bytes right into out */
+         for (i = 0; i < rate / 8; i++) {
+            STORE64L(md->sha3.s[i], out + i * 8);
+         }
+         md->sha3.byte_index = (unsigned short)rate;
+         out += rate;
+         outlen -= rate;
+      } else {
+         *out++ = (unsigned char)(md->sha3.s[md->sha3.byte_index / 8] >> ((md->sha3.byte_index % 8) * 8));
+         md->sha3.byte_index++;
+         outlen--;
+      }
    }
    return CRYPT_OK;
 }
 
+int sha3_shake_done(hash_state *md, unsigned char *out, unsigned long outlen)
+{
+   /* IMPORTANT NOTE: sha3_shake_done can be called many times */
+   return sha3_shake_squeeze(md, out, outlen);
+}
+
 int sha3_shake_memory(int num, const unsigned char *in, unsigned long inlen, unsigned char *out, const unsigned long *outlen)
 {
    hash_state md;
@@ -379,6 +502,35 @@ int sha3_shake_memory(int num, const unsigned char *in, unsigned long inlen, uns
    if ((err = sha3_shake_done(&md, out, *outlen)) != CRYPT_OK) return err;
    return CRYPT_OK;
 }
+
+/**
+  SHAKE of many independent messages, with AVX2 4 messages at a time
+  @param num     The SHAKE variant, 128 or 256
+  @param jobs    The messages and where to store their outputs
+  @param n       The number of jobs
+  @param outlen  The length of each output (octets)
+  @return CRYPT_OK if successful
+*/
+int sha3_shake_memory_many(int num, const hash_job *jobs, unsigned long n, unsigned long outlen)
+{
+   unsigned long x;
+   int err;
+
+   LTC_ARGCHK(jobs != NULL);
+   if (num != 128 && num != 256) return CRYPT_INVALID_ARG;
+   for (x = 0; x < n; x++) {
+      LTC_ARGCHK(jobs[x].in  != NULL);
+      LTC_ARGCHK(jobs[x].out != NULL);
+   }
+
+#ifdef LTC_SHA3_MB
+   if ((err = sha3_mb_memory(2 * num / (8 * sizeof(ulong64)), 0x1F, jobs, n, outlen)) != CRYPT_NOP) return err;
+#endif
+   for (x = 0; x < n; x++) {
+      if ((err = sha3_shake_memory(num, jobs[x].in, jobs[x].inlen, jobs[x].out, &outlen)) != CRYPT_OK) return err;
+   }
+   return CRYPT_OK;
+}
 #endif
 
 #endif
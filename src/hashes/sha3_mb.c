@@ -0,0 +1,268 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ */
+
+/**
+   @file sha3_mb.c
+   SHA3, Keccak and SHAKE of many independent messages using the AVX2
+   instructions of x86-64 CPUs
+
+   Four Keccak-f[1600] states are permuted at once, each 64-bit lane of a
+   register belongs to one of them (the state word w of instance i is
+   st[4 * w + i]).  A message is absorbed and squeezed in its own instance,
+   and an instance which is done is given the next message right away.
+*/
+#include "tomcrypt_private.h"
+
+#ifdef LTC_SHA3_MB
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+/* the AVX-512 macros of GCC mix declarations and code */
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wdeclaration-after-statement"
+#endif
+#include <immintrin.h>
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+#endif
+
+#define AVX2_TARGET LTC_ATTRIBUTE_TARGET("avx2")
+
+#define AVX2_LOAD(p)      _mm256_loadu_si256((const __m256i *)(const void *)(p))
+#define AVX2_STORE(p, v)  _mm256_storeu_si256((__m256i *)(void *)(p), (v))
+#define AVX2_XOR(a, b)    _mm256_xor_si256((a), (b))
+#define AVX2_XOR5(a, b, c, d, e) AVX2_XOR(AVX2_XOR(AVX2_XOR((a), (b)), AVX2_XOR((c), (d))), (e))
+#define AVX2_ROL(x, n)    _mm256_or_si256(_mm256_slli_epi64((x), (n)), _mm256_srli_epi64((x), 64 - (n)))
+
+static const ulong64 keccakf_rndc[24] = {
+   CONST64(0x0000000000000001), CONST64(0x0000000000008082),
+   CONST64(0x800000000000808a), CONST64(0x8000000080008000),
+   CONST64(0x000000000000808b), CONST64(0x0000000080000001),
+   CONST64(0x8000000080008081), CONST64(0x8000000000008009),
+   CONST64(0x000000000000008a), CONST64(0x0000000000000088),
+   CONST64(0x0000000080008009), CONST64(0x000000008000000a),
+   CONST64(0x000000008000808b), CONST64(0x800000000000008b),
+   CONST64(0x8000000000008089), CONST64(0x8000000000008003),
+   CONST64(0x8000000000008002), CONST64(0x8000000000000080),
+   CONST64(0x000000000000800a), CONST64(0x800000008000000a),
+   CONST64(0x8000000080008081), CONST64(0x8000000000008080),
+   CONST64(0x0000000080000001), CONST64(0x8000000080008008)
+};
+
+/* Chi of the row r from Ba .. Bu, ANDNOT makes lane complementing unnecessary */
+#define KECCAK_X4_CHI(E, r)                                                 \
+   E##r##a = AVX2_XOR(Ba, _mm256_andnot_si256(Be, Bi));                     \
+   E##r##e = AVX2_XOR(Be, _mm256_andnot_si256(Bi, Bo));                     \
+   E##r##i = AVX2_XOR(Bi, _mm256_andnot_si256(Bo, Bu));                     \
+   E##r##o = AVX2_XOR(Bo, _mm256_andnot_si256(Bu, Ba));                     \
+   E##r##u = AVX2_XOR(Bu, _mm256_andnot_si256(Ba, Be));
+
+/* one round from the lanes A.. into the lanes E.., named as in sha3.c */
+#define KECCAK_X4_ROUND(A, E, rc)                                           \
+   Ca = AVX2_XOR5(A##ba, A##ga, A##ka, A##ma, A##sa);                       \
+   Ce = AVX2_XOR5(A##be, A##ge, A##ke, A##me, A##se);                       \
+   Ci = AVX2_XOR5(A##bi, A##gi, A##ki, A##mi, A##si);                       \
+   Co = AVX2_XOR5(A##bo, A##go, A##ko, A##mo, A##so);                       \
+   Cu = AVX2_XOR5(A##bu, A##gu, A##ku, A##mu, A##su);                       \
+   Da = AVX2_XOR(Cu, AVX2_ROL(Ce, 1));                                      \
+   De = AVX2_XOR(Ca, AVX2_ROL(Ci, 1));                                      \
+   Di = AVX2_XOR(Ce, AVX2_ROL(Co, 1));                                      \
+   Do = AVX2_XOR(Ci, AVX2_ROL(Cu, 1));                                      \
+   Du = AVX2_XOR(Co, AVX2_ROL(Ca, 1));                                      \
+                                                                            \
+   Ba = AVX2_XOR(A##ba, Da);                                                \
+   Be = AVX2_ROL(AVX2_XOR(A##ge, De), 44);                                  \
+   Bi = AVX2_ROL(AVX2_XOR(A##ki, Di), 43);                                  \
+   Bo = AVX2_ROL(AVX2_XOR(A##mo, Do), 21);                                  \
+   Bu = AVX2_ROL(AVX2_XOR(A##su, Du), 14);                                  \
+   KECCAK_X4_CHI(E, b)                                                      \
+   E##ba = AVX2_XOR(E##ba, _mm256_set1_epi64x((long long)(rc)));            \
+                                                                            \
+   Ba = AVX2_ROL(AVX2_XOR(A##bo, Do), 28);                                  \
+   Be = AVX2_ROL(AVX2_XOR(A##gu, Du), 20);                                  \
+   Bi = AVX2_ROL(AVX2_XOR(A##ka, Da), 3);                                   \
+   Bo = AVX2_ROL(AVX2_XOR(A##me, De), 45);                                  \
+   Bu = AVX2_ROL(AVX2_XOR(A##si, Di), 61);                                  \
+   KECCAK_X4_CHI(E, g)                                                      \
+                                                                            \
+   Ba = AVX2_ROL(AVX2_XOR(A##be, De), 1);                                   \
+   Be = AVX2_ROL(AVX2_XOR(A##gi, Di), 6);                                   \
+   Bi = AVX2_ROL(AVX2_XOR(A##ko, Do), 25);                                  \
+   Bo = _mm256_shuffle_epi8(AVX2_XOR(A##mu, Du), rol8);                     \
+   Bu = AVX2_ROL(AVX2_XOR(A##sa, Da), 18);                                  \
+   KECCAK_X4_CHI(E, k)                                                      \
+                                                                            \
+   Ba = AVX2_ROL(AVX2_XOR(A##bu, Du), 27);                                  \
+   Be = AVX2_ROL(AVX2_XOR(A##ga, Da), 36);                                  \
+   Bi = AVX2_ROL(AVX2_XOR(A##ke, De), 10);                                  \
+   Bo = AVX2_ROL(AVX2_XOR(A##mi, Di), 15);                                  \
+   Bu = _mm256_shuffle_epi8(AVX2_XOR(A##so, Do), rol56);                    \
+   KECCAK_X4_CHI(E, m)                                                      \
+                                                                            \
+   Ba = AVX2_ROL(AVX2_XOR(A##bi, Di), 62);                                  \
+   Be = AVX2_ROL(AVX2_XOR(A##go, Do), 55);                                  \
+   Bi = AVX2_ROL(AVX2_XOR(A##ku, Du), 39);                                  \
+   Bo = AVX2_ROL(AVX2_XOR(A##ma, Da), 41);                                  \
+   Bu = AVX2_ROL(AVX2_XOR(A##se, De), 2);                                   \
+   KECCAK_X4_CHI(E, s)
+
+/* Keccak-f[1600] of four interleaved states */
+AVX2_TARGET
+static void _keccakf_x4(ulong64 *st)
+{
+   __m256i Aba, Abe, Abi, Abo, Abu, Aga, Age, Agi, Ago, Agu, Aka, Ake, Aki, Ako, Aku;
+   __m256i Ama, Ame, Ami, Amo, Amu, Asa, Ase, Asi, Aso, Asu;
+   __m256i Eba, Ebe, Ebi, Ebo, Ebu, Ega, Ege, Egi, Ego, Egu, Eka, Eke, Eki, Eko, Eku;
+   __m256i Ema, Eme, Emi, Emo, Emu, Esa, Ese, Esi, Eso, Esu;
+   __m256i Ba, Be, Bi, Bo, Bu, Ca, Ce, Ci, Co, Cu, Da, De, Di, Do, Du, rol8, rol56;
+   int round;
+
+   rol8  = _mm256_setr_epi8(7, 0, 1, 2, 3, 4, 5, 6, 15, 8, 9, 10, 11, 12, 13, 14,
+                            7, 0, 1, 2, 3, 4, 5, 6, 15, 8, 9, 10, 11, 12, 13, 14);
+   rol56 = _mm256_setr_epi8(1, 2, 3, 4, 5, 6, 7, 0, 9, 10, 11, 12, 13, 14, 15, 8,
+                            1, 2, 3, 4, 5, 6, 7, 0, 9, 10, 11, 12, 13, 14, 15, 8);
+
+   Aba = AVX2_LOAD(st +  0); Abe = AVX2_LOAD(st +  4); Abi = AVX2_LOAD(st +  8); Abo = AVX2_LOAD(st + 12); Abu = AVX2_LOAD(st + 16);
+   Aga = AVX2_LOAD(st + 20); Age = AVX2_LOAD(st + 24); Agi = AVX2_LOAD(st + 28); Ago = AVX2_LOAD(st + 32); Agu = AVX2_LOAD(st + 36);
+   Aka = AVX2_LOAD(st + 40); Ake = AVX2_LOAD(st + 44); Aki = AVX2_LOAD(st + 48); Ako = AVX2_LOAD(st + 52); Aku = AVX2_LOAD(st + 56);
+   Ama = AVX2_LOAD(st + 60); Ame = AVX2_LOAD(st + 64); Ami = AVX2_LOAD(st + 68); Amo = AVX2_LOAD(st + 72); Amu = AVX2_LOAD(st + 76);
+   Asa = AVX2_LOAD(st + 80); Ase = AVX2_LOAD(st + 84); Asi = AVX2_LOAD(st + 88); Aso = AVX2_LOAD(st + 92); Asu = AVX2_LOAD(st + 96);
+
+   for (round = 0; round < 24; round += 2) {
+      KECCAK_X4_ROUND(A, E, keccakf_rndc[round])
+      KECCAK_X4_ROUND(E, A, keccakf_rndc[round + 1])
+   }
+
+   AVX2_STORE(st +  0, Aba); AVX2_STORE(st +  4, Abe); AVX2_STORE(st +  8, Abi); AVX2_STORE(st + 12, Abo); AVX2_STORE(st + 16, Abu);
+   AVX2_STORE(st + 20, Aga); AVX2_STORE(st + 24, Age); AVX2_STORE(st + 28, Agi); AVX2_STORE(st + 32, Ago); AVX2_STORE(st + 36, Agu);
+   AVX2_STORE(st + 40, Aka); AVX2_STORE(st + 44, Ake); AVX2_STORE(st + 48, Aki); AVX2_STORE(st + 52, Ako); AVX2_STORE(st + 56, Aku);
+   AVX2_STORE(st + 60, Ama); AVX2_STORE(st + 64, Ame); AVX2_STORE(st + 68, Ami); AVX2_STORE(st + 72, Amo); AVX2_STORE(st + 76, Amu);
+   AVX2_STORE(st + 80, Asa); AVX2_STORE(st + 84, Ase); AVX2_STORE(st + 88, Asi); AVX2_STORE(st + 92, Aso); AVX2_STORE(st + 96, Asu);
+}
+
+/* a message which is hashed in one of the instances */
+typedef struct {
+   const unsigned char *in;       /* the part of the message which isn't absorbed yet */
+   unsigned long        inlen;
+   unsigned char       *out;      /* NULL if the instance is idle */
+   unsigned long        outlen;   /* the number of octets which aren't squeezed yet */
+   int                  squeeze;  /* the message is padded, the output follows each permutation */
+} sha3_mb_lane;
+
+/**
+  Hash many independent messages with SHA3, Keccak or SHAKE
+  @param capacity_words  The capacity in 64-bit words, e.g. 8 for SHA3-256 and SHAKE256
+  @param pad             The first padding byte: 0x06 for SHA3, 0x01 for Keccak, 0x1F for SHAKE
+  @param jobs            The messages and where to store their digests
+  @param n               The number of jobs
+  @param outlen          The length of each digest (octets)
+  @return CRYPT_OK if successful, CRYPT_NOP if the messages are hashed faster one by one
+*/
+int sha3_mb_memory(unsigned long capacity_words, unsigned char pad, const hash_job *jobs, unsigned long n,
+                   unsigned long outlen)
+{
+   sha3_mb_lane lane[4];
+   ulong64 st[25 * 4], t;
+   unsigned char blk[200];
+   unsigned long rate, active, next, x, i, w;
+
+   if (!ltc_cpu_has(LTC_CPU_AVX2)) {
+      return CRYPT_NOP;
+   }
+   /* too few messages to fill the lanes */
+   if (n < 4) {
+      return CRYPT_NOP;
+   }
+
+   rate = 200 - 8 * capacity_words;
+   XMEMSET(lane, 0, sizeof(lane));
+   active = next = 0;
+
+   for (;;) {
+      /* give the idle instances the next messages */
+      for (i = 0; i < 4 && next < n; i++) {
+         if (lane[i].out != NULL) {
+            continue;
+         }
+         for (w = 0; w < 25; w++) {
+            st[4 * w + i] = 0;
+         }
+         lane[i].in      = jobs[next].in;
+         lane[i].inlen   = jobs[next].inlen;
+         lane[i].out     = jobs[next].out;
+         lane[i].outlen  = outlen;
+         lane[i].squeeze = 0;
+         active++;
+         next++;
+      }
+      if (active == 0) {
+         break;
+      }
+
+      /* absorb the next block, the last one is padded */
+      for (i = 0; i < 4; i++) {
+         if (lane[i].out == NULL || lane[i].squeeze) {
+            continue;
+         }
+         if (lane[i].inlen >= rate) {
+            for (w = 0; w < rate / 8; w++) {
+               LOAD64L(t, lane[i].in + 8 * w);
+               st[4 * w + i] ^= t;
+            }
+            lane[i].in    += rate;
+            lane[i].inlen -= rate;
+         } else {
+            zeromem(blk, rate);
+            XMEMCPY(blk, lane[i].in, lane[i].inlen);
+            blk[lane[i].inlen] ^= pad;
+            blk[rate - 1] ^= 0x80;
+            for (w = 0; w < rate / 8; w++) {
+               LOAD64L(t, blk + 8 * w);
+               st[4 * w + i] ^= t;
+            }
+            lane[i].squeeze = 1;
+         }
+      }
+
+      _keccakf_x4(st);
+
+      /* squeeze the instances whose messages are padded */
+      for (i = 0; i < 4; i++) {
+         if (lane[i].out == NULL || !lane[i].squeeze) {
+            continue;
+         }
+         x = MIN(rate, lane[i].outlen);
+         for (w = 0; w < (x + 7) / 8; w++) {
+            STORE64L(st[4 * w + i], blk + 8 * w);
+         }
+         XMEMCPY(lane[i].out, blk, x);
+         lane[i].out    += x;
+         lane[i].outlen -= x;
+         if (lane[i].outlen == 0) {
+            lane[i].out = NULL;
+            active--;
+         }
+      }
+   }
+
+#ifdef LTC_CLEAN_STACK
+   zeromem(st, sizeof(st));
+   zeromem(blk, sizeof(blk));
+#endif
+   return CRYPT_OK;
+}
+
+#endif
+
+/* ref:         $Format:%D$ */
+/* git commit:  $Format:%H$ */
+/* commit time: $Format:%ai$ */
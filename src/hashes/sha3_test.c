@@ -160,6 +160,54 @@ int sha3_256_test(void)
       return CRYPT_FAIL_TESTVECTOR;
    }
 
+#ifdef LTC_HASH_HELPERS
+   {
+      /* hash_memory_many() with and without AVX2 against the generic code, the messages end in different blocks */
+#ifdef LTC_AMD64_SIMD
+      const unsigned long masks[] = { ~0UL, ~LTC_CPU_AVX2 };
+      unsigned long mask;
+#else
+      const unsigned long masks[] = { 0 };
+#endif
+      unsigned char msg[420], out[13][256 / 8], ref[256 / 8];
+      hash_job jobs[13];
+      unsigned long x, m;
+      int idx, err;
+
+      if ((idx = register_hash(&sha3_256_desc)) == -1) {
+         return CRYPT_INVALID_HASH;
+      }
+      for (x = 0; x < sizeof(msg); x++) {
+         msg[x] = (unsigned char)(x * 7 + 3);
+      }
+      for (x = 0; x < 13; x++) {
+         jobs[x].in = msg + x;
+         jobs[x].inlen = 34 * x;
+         jobs[x].out = out[x];
+      }
+      for (m = 0; m < sizeof(masks) / sizeof(masks[0]); m++) {
+#ifdef LTC_AMD64_SIMD
+         mask = ltc_cpu_mask(masks[m]);
+         err = hash_memory_many(idx, jobs, 13);
+         ltc_cpu_mask(mask);
+#else
+         err = hash_memory_many(idx, jobs, 13);
+#endif
+         if (err != CRYPT_OK) {
+            return err;
+         }
+         for (x = 0; x < 13; x++) {
+            if ((err = sha3_256_init(&c)) != CRYPT_OK)                           return err;
+            if ((err = sha3_process(&c, jobs[x].in, jobs[x].inlen)) != CRYPT_OK) return err;
+            if ((err = sha3_done(&c, ref)) != CRYPT_OK)                          return err;
+            if (compare_testvector(out[x], sizeof(out[x]), ref, sizeof(ref), "SHA3-256 multi-buffer", (int)(m * 13 + x))) {
+               return CRYPT_FAIL_TESTVECTOR;
+            }
+         }
+      }
+   }
+#endif
+
    return CRYPT_OK;
 #endif
 }
@@ -390,6 +438,68 @@ int sha3_shake_test(void)
       return CRYPT_FAIL_TESTVECTOR;
    }
 
+   /* SHAKE256 squeezed in pieces of different sizes, some of them whole blocks */
+   {
+      unsigned char out[1000], ref[1000];
+      const unsigned long pieces[] = { 1, 135, 136, 7, 272, 136, 300, 13 };
+      unsigned long x, y;
+
+      sha3_shake_init(&c, 256);
+      sha3_shake_process(&c, buf, 100);
+      sha3_shake_squeeze(&c, ref, sizeof(ref));
+      sha3_shake_init(&c, 256);
+      sha3_shake_process(&c, buf, 100);
+      for (x = y = 0; x < sizeof(pieces) / sizeof(pieces[0]); y += pieces[x++]) {
+         sha3_shake_squeeze(&c, out + y, pieces[x]);
+      }
+      if (compare_testvector(out, sizeof(out), ref, sizeof(ref), "SHAKE256 squeeze", 0)) {
+         return CRYPT_FAIL_TESTVECTOR;
+      }
+   }
+
+   {
+      /* sha3_shake_memory_many() with and without AVX2 against the generic code, more than one block of output */
+#ifdef LTC_AMD64_SIMD
+      const unsigned long masks[] = { ~0UL, ~LTC_CPU_AVX2 };
+      unsigned long mask;
+#else
+      const unsigned long masks[] = { 0 };
+#endif
+      hash_job jobs[9];
+      unsigned char out[9][400], ref[400];
+      unsigned long x, m;
+      int err;
+
+      for (x = 0; x < 9; x++) {
+         jobs[x].in = buf;
+         jobs[x].inlen = 21 * x;
+         jobs[x].out = out[x];
+      }
+      for (m = 0; m < sizeof(masks) / sizeof(masks[0]); m++) {
+         for (i = 0; i < 2; i++) {
+            len = i == 0 ? 400 : 17;
+#ifdef LTC_AMD64_SIMD
+            mask = ltc_cpu_mask(masks[m]);
+            err = sha3_shake_memory_many(i == 0 ? 128 : 256, jobs, 9, len);
+            ltc_cpu_mask(mask);
+#else
+            err = sha3_shake_memory_many(i == 0 ? 128 : 256, jobs, 9, len);
+#endif
+            if (err != CRYPT_OK) {
+               return err;
+            }
+            for (x = 0; x < 9; x++) {
+               if ((err = sha3_shake_memory(i == 0 ? 128 : 256, jobs[x].in, jobs[x].inlen, ref, &len)) != CRYPT_OK) {
+                  return err;
+               }
+               if (compare_testvector(out[x], len, ref, len, "SHAKE multi-buffer", (int)(m * 18) + i * 9 + (int)x)) {
+                  return CRYPT_FAIL_TESTVECTOR;
+               }
+            }
+         }
+      }
+   }
+
    return CRYPT_OK;
 #endif
 }
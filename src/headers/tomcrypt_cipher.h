@@ -42,6 +42,12 @@ struct saferp_key {
 #ifdef LTC_RIJNDAEL
 struct rijndael_key {
    ulong32 eK[60], dK[60];
+#ifdef LTC_AES_BITSLICE
+   /* the round keys of eK bitsliced for the multi-block functions, see aes_bitslice.c,
+    * has_bsK is 0 if the key was set up with AES-NI */
+   ulong64 bsK[8 * 15];
+   int has_bsK;
+#endif
    int Nr;
 };
 #endif
@@ -270,6 +270,8 @@
 #define LTC_RIPEMD320
 #define LTC_BLAKE2S
 #define LTC_BLAKE2B
+#define LTC_BLAKE2SP
+#define LTC_BLAKE2BP
 
 #define LTC_HASH_HELPERS
 
@@ -299,8 +301,18 @@
 #define LTC_GCM_MODE
 #define LTC_CHACHA20POLY1305_MODE
 
-/* Use 64KiB tables */
-#ifndef LTC_NO_TABLES
+/* GHASH of the generic GCM code, define one of them:
+ *
+ * LTC_GCM_TABLES       8-bit tables, 64KiB per gcm_state
+ * LTC_GCM_TABLES_4BIT  4-bit tables (Shoup's method), 256 bytes per gcm_state
+ * LTC_GCM_CTMUL        no tables, 64-bit integer multiplications without
+ *                      secret dependent memory accesses
+ *
+ * If none of them is defined, GHASH is computed bit by bit.
+ * The tables aren't used (or computed) on CPUs supporting PCLMULQDQ.
+ */
+#if !defined(LTC_GCM_TABLES) && !defined(LTC_GCM_TABLES_4BIT) && !defined(LTC_GCM_CTMUL) && !defined(LTC_NO_TABLES)
+   /* Use 64KiB tables */
    #define LTC_GCM_TABLES
 #endif
 
@@ -493,6 +505,16 @@
 #define LTC_HKDF
 #endif /* LTC_NO_HKDF */
 
+/* Argon2 password hashing, requires BLAKE2b */
+#if defined(LTC_BLAKE2B) && !defined(LTC_NO_ARGON2)
+#define LTC_ARGON2
+#endif
+
+/* scrypt key derivation, requires PKCS #5 and SHA-256 */
+#if defined(LTC_PKCS_5) && defined(LTC_SHA256) && !defined(LTC_NO_SCRYPT)
+#define LTC_SCRYPT
+#endif
+
 #define LTC_ADLER32
 
 #define LTC_CRC32
@@ -547,6 +569,109 @@
 #endif
 #endif
 
+/* x86-64 SIMD code paths (AES-NI, ...)
+ *
+ * The instruction set extensions are enabled per function and the code paths
+ * are selected at runtime via CPUID, so the library still runs on CPUs which
+ * don't support them.
+ * Define LTC_NO_AMD64_SIMD to disable all of them.
+ */
+#if !defined(LTC_NO_ASM) && !defined(LTC_NO_AMD64_SIMD) && \
+    (defined(__x86_64__) || defined(_M_X64) || defined(_M_AMD64)) && \
+    ((defined(__clang__) && __clang_major__ >= 4) || \
+     (!defined(__clang__) && defined(__GNUC__) && __GNUC__ >= 5) || \
+     (defined(_MSC_VER) && _MSC_VER >= 1900))
+   #define LTC_AMD64_SIMD
+#endif
+
+#if defined(LTC_RIJNDAEL) && defined(LTC_AMD64_SIMD) && !defined(LTC_NO_AES_NI)
+   /* Use AES-NI for AES/Rijndael if the CPU supports it */
+   #define LTC_AES_NI
+#endif
+
+#if defined(LTC_RIJNDAEL) && defined(LTC_AMD64_SIMD) && !defined(LTC_NO_AES_BITSLICE) && !defined(LTC_AES_BITSLICE)
+   /* Use a constant-time bitsliced AES for the multi-block functions if AES-NI isn't available.
+    * Single blocks, the key schedule and the decryption still use the tables.  The key grows by
+    * the bitsliced round keys.
+    * It's portable C and can also be enabled for other (preferably 64-bit) platforms.
+    */
+   #define LTC_AES_BITSLICE
+#endif
+
+/* The compiler knows the AVX-512, VAES and VPCLMULQDQ intrinsics */
+#if defined(LTC_AMD64_SIMD) && !defined(LTC_NO_AMD64_AVX512) && \
+    ((defined(__clang__) && __clang_major__ >= 6) || \
+     (!defined(__clang__) && defined(__GNUC__) && __GNUC__ >= 8) || \
+     (defined(_MSC_VER) && _MSC_VER >= 1920))
+   #define LTC_AMD64_AVX512
+#endif
+
+#if (defined(LTC_SHA1) || defined(LTC_SHA256)) && defined(LTC_AMD64_SIMD) && !defined(LTC_NO_SHA_NI)
+   /* SHA-1 and SHA-256 (and SHA-224) with the SHA extensions */
+   #define LTC_SHA_NI
+#endif
+
+#if defined(LTC_SHA512) && defined(LTC_AMD64_SIMD) && !defined(LTC_NO_SHA512_AVX2)
+   /* SHA-512 (and SHA-384, SHA-512/224, SHA-512/256) with the message schedule of two blocks in AVX2 registers */
+   #define LTC_SHA512_AVX2
+#endif
+
+#if defined(LTC_SHA256) && defined(LTC_HASH_HELPERS) && defined(LTC_AMD64_SIMD) && !defined(LTC_NO_SHA256_MB)
+   /* hash_memory_many() with SHA-256 (and SHA-224) and PBKDF2 with SHA-256, 8 or 16 lanes at a time */
+   #define LTC_SHA256_MB
+#endif
+
+#if (defined(LTC_SHA3) || defined(LTC_KECCAK)) && defined(LTC_AMD64_SIMD) && !defined(LTC_NO_SHA3_MB)
+   /* hash_memory_many() with SHA3 and KECCAK, sha3_shake_memory_many(), 4 messages at a time with AVX2 */
+   #define LTC_SHA3_MB
+#endif
+
+#if (defined(LTC_BLAKE2B) || defined(LTC_BLAKE2S)) && defined(LTC_AMD64_SIMD) && !defined(LTC_NO_BLAKE2_SIMD)
+   /* BLAKE2b with AVX2 and BLAKE2s with SSE4.1, the four G functions of a step at once, also used by Argon2 */
+   #define LTC_BLAKE2_SIMD
+#endif
+
+#if defined(LTC_CHACHA) && defined(LTC_AMD64_SIMD) && !defined(LTC_NO_CHACHA_SIMD)
+   /* ChaCha with SSE2, AVX2 or AVX-512, 4, 8 or 16 blocks at a time */
+   #define LTC_CHACHA_SIMD
+#endif
+
+#if defined(LTC_SCRYPT) && defined(LTC_AMD64_SIMD) && !defined(LTC_NO_SCRYPT_SIMD)
+   /* scrypt with SSE2, Salsa20/8 on the rows of the state in diagonal order */
+   #define LTC_SCRYPT_SIMD
+#endif
+
+#if defined(LTC_POLY1305) && defined(LTC_AMD64_SIMD) && !defined(LTC_NO_POLY1305_SIMD)
+   /* Poly1305 with AVX2, four blocks at a time */
+   #define LTC_POLY1305_SIMD
+#endif
+
+#if defined(LTC_POLY1305) && defined(__SIZEOF_INT128__) && !defined(LTC_NO_POLY1305_R44)
+   /* Poly1305 with 44-bit limbs and 128-bit products */
+   #define LTC_POLY1305_R44
+#endif
+
+#if defined(LTC_CHACHA20POLY1305_MODE) && defined(LTC_CHACHA_SIMD) && defined(LTC_POLY1305_SIMD) && \
+    !defined(LTC_NO_CHACHA20POLY1305_SIMD)
+   /* ChaCha20-Poly1305 with AVX2, encryption and Poly1305 in a single pass */
+   #define LTC_CHACHA20POLY1305_SIMD
+#endif
+
+#if defined(LTC_GCM_MODE) && defined(LTC_AMD64_SIMD) && !defined(LTC_NO_GCM_PCLMUL)
+   /* GHASH with PCLMULQDQ, eight blocks per reduction */
+   #define LTC_GCM_PCLMUL
+#endif
+
+#if defined(LTC_GCM_PCLMUL) && defined(LTC_AES_NI) && !defined(LTC_NO_GCM_AESNI)
+   /* AES-GCM with AES-NI and PCLMULQDQ, encryption and GHASH in a single pass */
+   #define LTC_GCM_AESNI
+#endif
+
+#if defined(LTC_GCM_AESNI) && defined(LTC_AMD64_AVX512) && !defined(LTC_NO_GCM_VAES)
+   /* AES-GCM with VAES and VPCLMULQDQ, 16 blocks at a time */
+   #define LTC_GCM_VAES
+#endif
+
 #if defined(LTC_DER)
    #ifndef LTC_DER_MAX_RECURSION
       /* Maximum recursion limit when processing nested ASN.1 types. */
@@ -554,6 +679,13 @@
    #endif
 #endif
 
+#if defined(LTC_SCRYPT) && defined(LTC_PTHREAD)
+   #ifndef LTC_SCRYPT_THREADS
+      /* Maximum number of threads computing the lanes of scrypt, each one needs its own N * r * 128 octets */
+      #define LTC_SCRYPT_THREADS 4
+   #endif
+#endif
+
 #if defined(LTC_MECC) || defined(LTC_MRSA) || defined(LTC_MDSA)
    /* Include the MPI functionality?  (required by the PK algorithms) */
    #define LTC_MPI
@@ -625,6 +757,26 @@
    #error LTC_BLAKE2BMAC requires LTC_BLAKE2B
 #endif
 
+#if defined(LTC_BLAKE2SP) && !defined(LTC_BLAKE2S)
+   #error LTC_BLAKE2SP requires LTC_BLAKE2S
+#endif
+
+#if defined(LTC_BLAKE2BP) && !defined(LTC_BLAKE2B)
+   #error LTC_BLAKE2BP requires LTC_BLAKE2B
+#endif
+
+#if defined(LTC_HKDF) && !defined(LTC_HMAC)
+   #error LTC_HKDF requires LTC_HMAC
+#endif
+
+#if defined(LTC_ARGON2) && !defined(LTC_BLAKE2B)
+   #error LTC_ARGON2 requires LTC_BLAKE2B
+#endif
+
+#if defined(LTC_SCRYPT) && (!defined(LTC_PKCS_5) || !defined(LTC_SHA256))
+   #error LTC_SCRYPT requires LTC_PKCS_5 and LTC_SHA256
+#endif
+
 #if defined(LTC_SPRNG) && !defined(LTC_RNG_GET_BYTES)
    #error LTC_SPRNG requires LTC_RNG_GET_BYTES
 #endif
@@ -147,6 +147,30 @@ struct blake2b_state {
 };
 #endif
 
+#ifdef LTC_BLAKE2SP
+struct blake2sp_state {
+    ulong32 h[8 * 8];               /* the chaining values of the leaves, the word w of the leaf i is h[8 * w + i] */
+    unsigned char buf[8 * 64];      /* the slot i holds the next block of the leaf i */
+    ulong64 t;                      /* the number of octets compressed by each leaf, see blake2sp_leaf_count() */
+    unsigned long buflen;
+    unsigned char outlen;
+    unsigned char keylen;
+    unsigned char pending;          /* the slots behind buflen hold blocks which aren't compressed yet */
+};
+#endif
+
+#ifdef LTC_BLAKE2BP
+struct blake2bp_state {
+    ulong64 h[8 * 4];               /* the chaining values of the leaves, the word w of the leaf i is h[4 * w + i] */
+    unsigned char buf[4 * 128];     /* the slot i holds the next block of the leaf i */
+    ulong64 t;                      /* the number of octets compressed by each leaf, see blake2bp_leaf_count() */
+    unsigned long buflen;
+    unsigned char outlen;
+    unsigned char keylen;
+    unsigned char pending;          /* the slots behind buflen hold blocks which aren't compressed yet */
+};
+#endif
+
 typedef union Hash_state {
     char dummy[1];
 #ifdef LTC_CHC_HASH
@@ -197,6 +221,12 @@ typedef union Hash_state {
 #ifdef LTC_BLAKE2B
     struct blake2b_state blake2b;
 #endif
+#ifdef LTC_BLAKE2SP
+    struct blake2sp_state blake2sp;
+#endif
+#ifdef LTC_BLAKE2BP
+    struct blake2bp_state blake2bp;
+#endif
 
     void *data;
 } hash_state;
@@ -287,6 +317,7 @@ int sha3_done(hash_state *md, unsigned char *out);
 int sha3_shake_init(hash_state *md, int num);
 #define sha3_shake_process(a,b,c) sha3_process(a,b,c)
 int sha3_shake_done(hash_state *md, unsigned char *out, unsigned long outlen);
+int sha3_shake_squeeze(hash_state *md, unsigned char *out, unsigned long outlen);
 int sha3_shake_test(void);
 int sha3_shake_memory(int num, const unsigned char *in, unsigned long inlen, unsigned char *out, const unsigned long *outlen);
 #endif
@@ -398,6 +429,16 @@ int blake2s_process(hash_state * md, const unsigned char *in, unsigned long inle
 int blake2s_done(hash_state * md, unsigned char *out);
 #endif
 
+#ifdef LTC_BLAKE2SP
+extern const struct ltc_hash_descriptor blake2sp_256_desc;
+int blake2sp_256_init(hash_state * md);
+int blake2sp_256_test(void);
+
+int blake2sp_init(hash_state * md, unsigned long outlen, const unsigned char *key, unsigned long keylen);
+int blake2sp_process(hash_state * md, const unsigned char *in, unsigned long inlen);
+int blake2sp_done(hash_state * md, unsigned char *out);
+#endif
+
 #ifdef LTC_BLAKE2B
 extern const struct ltc_hash_descriptor blake2b_512_desc;
 int blake2b_512_init(hash_state * md);
@@ -420,6 +461,16 @@ int blake2b_process(hash_state * md, const unsigned char *in, unsigned long inle
 int blake2b_done(hash_state * md, unsigned char *out);
 #endif
 
+#ifdef LTC_BLAKE2BP
+extern const struct ltc_hash_descriptor blake2bp_512_desc;
+int blake2bp_512_init(hash_state * md);
+int blake2bp_512_test(void);
+
+int blake2bp_init(hash_state * md, unsigned long outlen, const unsigned char *key, unsigned long keylen);
+int blake2bp_process(hash_state * md, const unsigned char *in, unsigned long inlen);
+int blake2bp_done(hash_state * md, unsigned char *out);
+#endif
+
 #ifdef LTC_MD5
 int md5_init(hash_state * md);
 int md5_process(hash_state * md, const unsigned char *in, unsigned long inlen);
@@ -502,6 +553,18 @@ int hash_memory(int hash,
 int hash_memory_multi(int hash, unsigned char *out, unsigned long *outlen,
                       const unsigned char *in, unsigned long inlen, ...);
 
+/* a job of hash_memory_many(), the jobs are independent of each other */
+typedef struct {
+   const unsigned char *in;        /* the message */
+   unsigned long        inlen;
+   unsigned char       *out;       /* [out] the digest, hashsize octets */
+} hash_job;
+
+int hash_memory_many(int hash, const hash_job *jobs, unsigned long n);
+#ifdef LTC_SHA3
+int sha3_shake_memory_many(int num, const hash_job *jobs, unsigned long n, unsigned long outlen);
+#endif
+
 #ifndef LTC_NO_FILE
 int hash_filehandle(int hash, FILE *in, unsigned char *out, unsigned long *outlen);
 int hash_file(int hash, const char *fname, unsigned char *out, unsigned long *outlen);
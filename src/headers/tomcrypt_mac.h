@@ -15,6 +15,11 @@ typedef struct Hmac_state {
      unsigned char  key[MAXBLOCKSIZE];
 } hmac_state;
 
+typedef struct {
+     hash_state     inner, outer;
+     int            hash;
+} hmac_key;
+
 int hmac_init(hmac_state *hmac, int hash, const unsigned char *key, unsigned long keylen);
 int hmac_process(hmac_state *hmac, const unsigned char *in, unsigned long inlen);
 int hmac_done(hmac_state *hmac, unsigned char *out, unsigned long *outlen);
@@ -30,6 +35,10 @@ int hmac_memory_multi(int hash,
 int hmac_file(int hash, const char *fname, const unsigned char *key,
               unsigned long keylen,
               unsigned char *out, unsigned long *outlen);
+int hmac_key_prepare(hmac_key *hkey, int hash, const unsigned char *key, unsigned long keylen);
+int hmac_memory_prepared(const hmac_key *hkey,
+                         const unsigned char *in,  unsigned long inlen,
+                               unsigned char *out, unsigned long *outlen);
 #endif
 
 #ifdef LTC_OMAC
@@ -252,6 +261,13 @@ typedef struct {
    omac_state    headeromac, ctomac;
 } eax_state;
 
+/* the expanded key, the OMAC and CTR states are copied into each eax_state
+ * instead of scheduling the key again */
+typedef struct {
+   omac_state    omac;   /* keyed OMAC which didn't process any data yet */
+   symmetric_CTR ctr;    /* keyed CTR mode, the IV is set per message */
+} eax_key;
+
 int eax_init(eax_state *eax, int cipher, const unsigned char *key, unsigned long keylen,
              const unsigned char *nonce, unsigned long noncelen,
              const unsigned char *header, unsigned long headerlen);
@@ -278,6 +294,26 @@ int eax_decrypt_verify_memory(int cipher,
     const unsigned char *tag,    unsigned long taglen,
           int           *stat);
 
+int eax_key_init(eax_key *eax, int cipher, const unsigned char *key, unsigned long keylen);
+int eax_msg_init(eax_state *eax, const eax_key *key,
+                 const unsigned char *nonce, unsigned long noncelen,
+                 const unsigned char *header, unsigned long headerlen);
+
+int eax_key_encrypt_authenticate_memory(const eax_key *key,
+    const unsigned char *nonce,  unsigned long noncelen,
+    const unsigned char *header, unsigned long headerlen,
+    const unsigned char *pt,     unsigned long ptlen,
+          unsigned char *ct,
+          unsigned char *tag,    unsigned long *taglen);
+
+int eax_key_decrypt_verify_memory(const eax_key *key,
+    const unsigned char *nonce,  unsigned long noncelen,
+    const unsigned char *header, unsigned long headerlen,
+    const unsigned char *ct,     unsigned long ctlen,
+          unsigned char *pt,
+    const unsigned char *tag,    unsigned long taglen,
+          int           *stat);
+
  int eax_test(void);
 #endif /* EAX MODE */
 
@@ -338,12 +374,22 @@ int s_ocb_done(ocb_state *ocb, const unsigned char *pt, unsigned long ptlen,
 #endif /* LTC_OCB_MODE */
 
 #ifdef LTC_OCB3_MODE
+/* the expanded key, it isn't modified by the ocb3_msg_xxx() functions and can
+ * be shared by several threads */
 typedef struct {
+   unsigned char     L_dollar[MAXBLOCKSIZE],       /* L_$ value */
+                     L_star[MAXBLOCKSIZE],         /* L_* value */
+                     L_[32][MAXBLOCKSIZE];         /* L_{i} values */
+   symmetric_key     key;                     /* scheduled key for cipher */
+   int               cipher,                  /* cipher idx */
+                     block_len;               /* length of block */
+} ocb3_key;
+
+/* the state of a single message */
+typedef struct {
+   const ocb3_key   *key;                          /* the expanded key */
    unsigned char     Offset_0[MAXBLOCKSIZE],       /* Offset_0 value */
                      Offset_current[MAXBLOCKSIZE], /* Offset_{current_block_index} value */
-                     L_dollar[MAXBLOCKSIZE],       /* L_$ value */
-                     L_star[MAXBLOCKSIZE],         /* L_* value */
-                     L_[32][MAXBLOCKSIZE],         /* L_{i} values */
                      tag_part[MAXBLOCKSIZE],       /* intermediate result of tag calculation */
                      checksum[MAXBLOCKSIZE];       /* current checksum */
 
@@ -354,11 +400,15 @@ typedef struct {
    int               adata_buffer_bytes;            /* bytes in AAD buffer */
    unsigned long     ablock_index;                  /* index # for current adata (AAD) block */
 
-   symmetric_key     key;                     /* scheduled key for cipher */
    unsigned long     block_index;             /* index # for current data block */
    int               cipher,                  /* cipher idx */
                      tag_len,                 /* length of tag */
                      block_len;               /* length of block */
+} ocb3_msg;
+
+typedef struct {
+   ocb3_key          key;
+   ocb3_msg          msg;
 } ocb3_state;
 
 int ocb3_init(ocb3_state *ocb, int cipher,
@@ -390,6 +440,35 @@ int ocb3_decrypt_verify_memory(int cipher,
     const unsigned char *tag,    unsigned long taglen,
           int           *stat);
 
+int ocb3_key_init(ocb3_key *ocb, int cipher,
+                  const unsigned char *key, unsigned long keylen);
+
+int ocb3_msg_init(ocb3_msg *ocb, const ocb3_key *key,
+                  const unsigned char *nonce, unsigned long noncelen,
+                  unsigned long taglen);
+
+int ocb3_msg_encrypt(ocb3_msg *ocb, const unsigned char *pt, unsigned long ptlen, unsigned char *ct);
+int ocb3_msg_decrypt(ocb3_msg *ocb, const unsigned char *ct, unsigned long ctlen, unsigned char *pt);
+int ocb3_msg_encrypt_last(ocb3_msg *ocb, const unsigned char *pt, unsigned long ptlen, unsigned char *ct);
+int ocb3_msg_decrypt_last(ocb3_msg *ocb, const unsigned char *ct, unsigned long ctlen, unsigned char *pt);
+int ocb3_msg_add_aad(ocb3_msg *ocb, const unsigned char *aad, unsigned long aadlen);
+int ocb3_msg_done(ocb3_msg *ocb, unsigned char *tag, unsigned long *taglen);
+
+int ocb3_key_encrypt_authenticate_memory(const ocb3_key *key,
+    const unsigned char *nonce,  unsigned long noncelen,
+    const unsigned char *adata,  unsigned long adatalen,
+    const unsigned char *pt,     unsigned long ptlen,
+          unsigned char *ct,
+          unsigned char *tag,    unsigned long *taglen);
+
+int ocb3_key_decrypt_verify_memory(const ocb3_key *key,
+    const unsigned char *nonce,  unsigned long noncelen,
+    const unsigned char *adata,  unsigned long adatalen,
+    const unsigned char *ct,     unsigned long ctlen,
+          unsigned char *pt,
+    const unsigned char *tag,    unsigned long taglen,
+          int           *stat);
+
 int ocb3_test(void);
 
 #endif /* LTC_OCB3_MODE */
@@ -470,21 +549,22 @@ extern const unsigned char gcm_shift_table[];
 #define LTC_GCM_MODE_AAD   1
 #define LTC_GCM_MODE_TEXT  2
 
+/* the expanded key, it isn't modified by the gcm_msg_xxx() functions and can
+ * be shared by several threads */
 typedef struct {
    symmetric_key       K;
-   unsigned char       H[16],        /* multiplier */
-                       X[16],        /* accumulator */
-                       Y[16],        /* counter */
-                       Y_0[16],      /* initial counter */
-                       buf[16];      /* buffer for stuff */
+   unsigned char       H[16];        /* multiplier */
+   int                 cipher;       /* which cipher */
 
-   int                 cipher,       /* which cipher */
-                       ivmode,       /* Which mode is the IV in? */
-                       mode,         /* mode the GCM code is in */
-                       buflen;       /* length of data in buf */
+#ifdef LTC_GCM_PCLMUL
+   int                 simd;         /* which SIMD code paths can be used */
+   unsigned char       Hpow[16][16]; /* H^16 ... H^1 for the SIMD code paths */
+#endif
 
-   ulong64             totlen,       /* 64-bit counter used for IV and AAD */
-                       pttotlen;     /* 64-bit counter for the PT */
+#ifdef LTC_GCM_TABLES_4BIT
+   ulong64             HH[16],       /* i * H for the 4-bit values i, upper half */
+                       HL[16];       /* lower half */
+#endif
 
 #ifdef LTC_GCM_TABLES
    unsigned char       PC[16][256][16]  /* 16 tables of 8x128 */
@@ -493,6 +573,27 @@ __attribute__ ((aligned (16)))
 #endif
 ;
 #endif
+} gcm_key;
+
+/* the state of a single message */
+typedef struct {
+   const gcm_key      *key;          /* the expanded key */
+   unsigned char       X[16],        /* accumulator */
+                       Y[16],        /* counter */
+                       Y_0[16],      /* initial counter */
+                       buf[16];      /* buffer for stuff */
+
+   int                 ivmode,       /* Which mode is the IV in? */
+                       mode,         /* mode the GCM code is in */
+                       buflen;       /* length of data in buf */
+
+   ulong64             totlen,       /* 64-bit counter used for IV and AAD */
+                       pttotlen;     /* 64-bit counter for the PT */
+} gcm_msg;
+
+typedef struct {
+   gcm_key             key;
+   gcm_msg             msg;
 } gcm_state;
 
 void gcm_mult_h(const gcm_state *gcm, unsigned char *I);
@@ -524,6 +625,34 @@ int gcm_memory(      int           cipher,
                      unsigned char *ct,
                      unsigned char *tag,    unsigned long *taglen,
                                int direction);
+
+int gcm_key_init(gcm_key *gcm, int cipher,
+                 const unsigned char *key, int keylen);
+void gcm_key_done(gcm_key *gcm);
+
+int gcm_msg_init(gcm_msg *gcm, const gcm_key *key);
+
+int gcm_msg_add_iv(gcm_msg *gcm,
+                   const unsigned char *IV,     unsigned long IVlen);
+
+int gcm_msg_add_aad(gcm_msg *gcm,
+                    const unsigned char *adata,  unsigned long adatalen);
+
+int gcm_msg_process(gcm_msg *gcm,
+                          unsigned char *pt,     unsigned long ptlen,
+                          unsigned char *ct,
+                          int direction);
+
+int gcm_msg_done(gcm_msg *gcm,
+                       unsigned char *tag,    unsigned long *taglen);
+
+int gcm_key_memory(const gcm_key       *key,
+                   const unsigned char *IV,     unsigned long IVlen,
+                   const unsigned char *adata,  unsigned long adatalen,
+                         unsigned char *pt,     unsigned long ptlen,
+                         unsigned char *ct,
+                         unsigned char *tag,    unsigned long *taglen,
+                                   int direction);
 int gcm_test(void);
 
 #endif /* LTC_GCM_MODE */
@@ -559,6 +688,54 @@ int chacha20poly1305_test(void);
 
 #endif /* LTC_CHACHA20POLY1305_MODE */
 
+#if defined(LTC_GCM_MODE) || defined(LTC_OCB3_MODE) || defined(LTC_CHACHA20POLY1305_MODE)
+
+/* the modes of aead_encrypt_batch() and aead_decrypt_batch() */
+#define LTC_AEAD_GCM               1
+#define LTC_AEAD_OCB3              2
+#define LTC_AEAD_CHACHA20POLY1305  3
+
+/* a packet of a batch, the packets are independent of each other */
+typedef struct {
+   int                  mode;      /* the LTC_AEAD_xxx mode, selects the member of key */
+   union {
+#ifdef LTC_GCM_MODE
+      const gcm_key                *gcm;
+#endif
+#ifdef LTC_OCB3_MODE
+      const ocb3_key               *ocb3;
+#endif
+#ifdef LTC_CHACHA20POLY1305_MODE
+      const chacha20poly1305_state *chacha20poly1305; /* after chacha20poly1305_init() */
+#endif
+   } key;
+   const unsigned char *nonce;     /* the IV/nonce */
+   unsigned long        noncelen;
+   const unsigned char *adata;     /* the additional authenticated data, can be NULL if adatalen is 0 */
+   unsigned long        adatalen;
+   const unsigned char *in;        /* the plaintext when encrypting, the ciphertext when decrypting */
+   unsigned long        inlen;
+   unsigned char       *out;       /* [out] inlen octets, can be the same as in */
+   unsigned char       *tag;       /* [out] when encrypting, [in] when decrypting */
+   unsigned long        taglen;    /* 1 to 16 octets */
+   int                  err;       /* [out] the result of this packet */
+} aead_packet;
+
+int aead_encrypt_batch(int mode, aead_packet *pkt, unsigned long n);
+int aead_decrypt_batch(int mode, aead_packet *pkt, unsigned long n);
+
+#ifdef LTC_OCB3_MODE
+int ocb3_memory_batch(aead_packet *pkt, unsigned long n, int direction);
+#endif
+#ifdef LTC_GCM_MODE
+int gcm_memory_batch(aead_packet *pkt, unsigned long n, int direction);
+#endif
+#ifdef LTC_CHACHA20POLY1305_MODE
+int chacha20poly1305_memory_batch(aead_packet *pkt, unsigned long n, int direction);
+#endif
+
+#endif
+
 /* ref:         $Format:%D$ */
 /* git commit:  $Format:%H$ */
 /* commit time: $Format:%ai$ */
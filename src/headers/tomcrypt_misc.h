@@ -80,8 +80,70 @@ int hkdf(int hash_idx,
          const unsigned char *in,   unsigned long inlen,
                unsigned char *out,  unsigned long outlen);
 
+int hkdf_expand_prepared(const hmac_key *prk,
+                         const unsigned char *info, unsigned long infolen,
+                               unsigned char *out,  unsigned long outlen);
+
+/* a job of hkdf_expand_many(), the jobs share the PRK */
+typedef struct {
+   const unsigned char *info;      /* the context and application specific information */
+   unsigned long        infolen;
+   unsigned char       *out;       /* [out] the output keying material */
+   unsigned long        outlen;
+} hkdf_job;
+
+int hkdf_expand_many(const hmac_key *prk, const hkdf_job *jobs, unsigned long n);
+
 #endif  /* LTC_HKDF */
 
+/* ===> LTC_ARGON2 -- RFC9106 Argon2 password hashing <=== */
+#ifdef LTC_ARGON2
+
+typedef enum {
+   ARGON2_D  = 0,
+   ARGON2_I  = 1,
+   ARGON2_ID = 2
+} argon2_type;
+
+int argon2_test(void);
+
+int argon2_hash(argon2_type type,
+                unsigned long t_cost, unsigned long m_cost, unsigned long parallelism,
+                const unsigned char *pwd,    unsigned long pwdlen,
+                const unsigned char *salt,   unsigned long saltlen,
+                const unsigned char *secret, unsigned long secretlen,
+                const unsigned char *ad,     unsigned long adlen,
+                      unsigned char *out,    unsigned long outlen);
+
+#endif  /* LTC_ARGON2 */
+
+/* ===> LTC_SCRYPT -- RFC7914 scrypt key derivation <=== */
+#ifdef LTC_SCRYPT
+
+/* the scratch memory of scrypt(), may be reused by the calls of one thread */
+typedef struct {
+   void          *mem;
+   unsigned long  size;
+   int            flags, mapped;
+} scrypt_arena;
+
+/* back the arena by huge pages if the OS supports it */
+#define SCRYPT_ARENA_HUGEPAGES 0x1
+
+int scrypt_arena_init(scrypt_arena *arena, int flags);
+int scrypt_arena_reserve(scrypt_arena *arena, unsigned long size);
+int scrypt_arena_done(scrypt_arena *arena);
+
+int scrypt_test(void);
+
+int scrypt(const unsigned char *pwd,  unsigned long pwdlen,
+           const unsigned char *salt, unsigned long saltlen,
+           ulong64 N, unsigned long r, unsigned long p,
+           scrypt_arena *arena,
+                 unsigned char *out,  unsigned long outlen);
+
+#endif  /* LTC_SCRYPT */
+
 /* ---- MEM routines ---- */
 int mem_neq(const void *a, const void *b, size_t len);
 void zeromem(volatile void *out, size_t outlen);
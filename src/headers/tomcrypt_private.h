@@ -15,6 +15,50 @@
 
 #define LTC_PAD_MASK       (0xF000U)
 
+/* enable instruction set extensions on a per function basis */
+#if defined(__GNUC__) || defined(__clang__)
+   #define LTC_ATTRIBUTE_TARGET(x) __attribute__((__target__(x)))
+#else
+   #define LTC_ATTRIBUTE_TARGET(x)
+#endif
+
+/* Lock-free reads of the cipher, hash and prng descriptor tables
+ *
+ * register_xxx() and unregister_xxx() modify the tables with the mutex held
+ * and increment a generation counter before and after the modification, so
+ * it is odd while a slot is being changed. The readers don't lock, they read
+ * the counter before and after scanning a table and retry if it changed.
+ * A slot is published by storing its name last, hence xxx_is_valid() only
+ * has to load the name.
+ */
+#ifdef LTC_PTHREAD
+   #ifndef __ATOMIC_ACQUIRE
+      #error LTC_PTHREAD requires the __atomic builtins of GCC >= 4.7 or clang
+   #endif
+   #define LTC_ATOMIC_LOAD(x)         __atomic_load_n(&(x), __ATOMIC_ACQUIRE)
+   #define LTC_ATOMIC_STORE(x, v)     __atomic_store_n(&(x), (v), __ATOMIC_RELEASE)
+   #define LTC_GEN_GLOBAL(x)          unsigned long x = 0;
+   #define LTC_GEN_PROTO(x)           extern unsigned long x;
+   #define LTC_GEN_WRITE_BEGIN(x)     do { __atomic_store_n(&(x), (x) + 1, __ATOMIC_RELAXED); \
+                                           __atomic_thread_fence(__ATOMIC_RELEASE); } while (0)
+   #define LTC_GEN_WRITE_END(x)       __atomic_store_n(&(x), (x) + 1, __ATOMIC_RELEASE)
+   #define LTC_GEN_READ_BEGIN(x, g)   do { g = __atomic_load_n(&(x), __ATOMIC_ACQUIRE); } while (g & 1)
+   #define LTC_GEN_READ_RETRY(x, g)   (__atomic_thread_fence(__ATOMIC_ACQUIRE), \
+                                       __atomic_load_n(&(x), __ATOMIC_RELAXED) != g)
+#else
+   #define LTC_ATOMIC_LOAD(x)         (x)
+   #define LTC_ATOMIC_STORE(x, v)     (x) = (v)
+   #define LTC_GEN_GLOBAL(x)
+   #define LTC_GEN_PROTO(x)
+   #define LTC_GEN_WRITE_BEGIN(x)
+   #define LTC_GEN_WRITE_END(x)
+   #define LTC_GEN_READ_BEGIN(x, g)   g = 0
+   #define LTC_GEN_READ_RETRY(x, g)   ((void)g, 0)
+#endif
+
+/* size of the open addressing indexes of the descriptor tables, at least half of it is empty */
+#define LTC_INDEX_SIZE  (2 * TAB_SIZE + 1)
+
 /*
  * Internal Enums
  */
@@ -30,6 +74,14 @@ enum ltc_oid_id {
  * Internal Types
  */
 
+/* index of a descriptor table, rebuilt by register_xxx() and unregister_xxx()
+ * the entries are the slot + 1, or 0 if empty */
+typedef struct {
+   short name[LTC_INDEX_SIZE];   /* by the hash of the name, linear probing */
+   short oid[LTC_INDEX_SIZE];    /* by the hash of the OID (hashes only) */
+   short id[256];                /* by ID (ciphers and hashes) */
+} ltc_index_type;
+
 typedef struct {
   int size;
   const char *name, *base, *prime;
@@ -70,8 +122,101 @@ typedef struct
  * Internal functions
  */
 
+/* crypt_index.c */
+
+ulong32 ltc_index_hash_name(const char *name);
+ulong32 ltc_index_hash_oid(const unsigned long *oid, unsigned long oidlen);
+void ltc_cipher_index_update(void);
+void ltc_hash_index_update(void);
+void ltc_prng_index_update(void);
+
+/* tomcrypt_cfg.h */
+
+#ifdef LTC_AMD64_SIMD
+/* CPU features as detected via CPUID */
+#define LTC_CPU_SSSE3      0x00000001UL
+#define LTC_CPU_AESNI      0x00000002UL
+#define LTC_CPU_PCLMUL     0x00000004UL
+#define LTC_CPU_AVX2       0x00000008UL
+/* AVX-512 F, BW and VL */
+#define LTC_CPU_AVX512     0x00000010UL
+#define LTC_CPU_VAES       0x00000020UL
+#define LTC_CPU_VPCLMULQDQ 0x00000040UL
+#define LTC_CPU_SSE2       0x00000080UL
+#define LTC_CPU_SSE41      0x00000100UL
+#define LTC_CPU_SHA        0x00000200UL
+
+int ltc_cpu_has(unsigned long features);
+/* process-wide and not thread-safe, see crypt_cpu_features.c */
+unsigned long ltc_cpu_mask(unsigned long mask);
+#endif
+
+/* tomcrypt_cipher.h */
+
+LTC_GEN_PROTO(ltc_cipher_gen)
+extern ltc_index_type ltc_cipher_index;
+
+#ifdef LTC_AES_NI
+int aesni_is_supported(void);
+int aesni_setup(const unsigned char *key, int keylen, int num_rounds, symmetric_key *skey);
+int aesni_ecb_encrypt(const unsigned char *pt, unsigned char *ct, unsigned long blocks, const symmetric_key *skey);
+int aesni_ecb_decrypt(const unsigned char *ct, unsigned char *pt, unsigned long blocks, const symmetric_key *skey);
+int aesni_ecb_encrypt_multi(const unsigned char *pt, unsigned char *ct, unsigned long blocks, const symmetric_key * const *skey);
+int aesni_ecb_decrypt_multi(const unsigned char *ct, unsigned char *pt, unsigned long blocks, const symmetric_key * const *skey);
+int aesni_cbc_encrypt(const unsigned char *pt, unsigned char *ct, unsigned long blocks, unsigned char *IV, const symmetric_key *skey);
+int aesni_cbc_decrypt(const unsigned char *ct, unsigned char *pt, unsigned long blocks, unsigned char *IV, const symmetric_key *skey);
+int aesni_ctr_encrypt(const unsigned char *pt, unsigned char *ct, unsigned long blocks, unsigned char *IV, int mode, const symmetric_key *skey);
+int aesni_xts_encrypt(const unsigned char *pt, unsigned char *ct, unsigned long blocks, unsigned char *tweak,
+                      const symmetric_key *skey1, const symmetric_key *skey2);
+int aesni_xts_decrypt(const unsigned char *ct, unsigned char *pt, unsigned long blocks, unsigned char *tweak,
+                      const symmetric_key *skey1, const symmetric_key *skey2);
+#endif
+
+#ifdef LTC_AES_BITSLICE
+void rijndael_bs_setup(symmetric_key *skey);
+int rijndael_bs_ecb_encrypt(const unsigned char *pt, unsigned char *ct, unsigned long blocks, const symmetric_key *skey);
+int rijndael_bs_ctr_encrypt(const unsigned char *pt, unsigned char *ct, unsigned long blocks, unsigned char *IV, int mode, const symmetric_key *skey);
+#endif
+
+#ifdef LTC_RIJNDAEL
+int rijndael_accel_ecb_encrypt(const unsigned char *pt, unsigned char *ct, unsigned long blocks, symmetric_key *skey);
+int rijndael_accel_ecb_decrypt(const unsigned char *ct, unsigned char *pt, unsigned long blocks, symmetric_key *skey);
+int rijndael_accel_cbc_encrypt(const unsigned char *pt, unsigned char *ct, unsigned long blocks, unsigned char *IV, symmetric_key *skey);
+int rijndael_accel_cbc_decrypt(const unsigned char *ct, unsigned char *pt, unsigned long blocks, unsigned char *IV, symmetric_key *skey);
+int rijndael_accel_ctr_encrypt(const unsigned char *pt, unsigned char *ct, unsigned long blocks, unsigned char *IV, int mode, symmetric_key *skey);
+int rijndael_accel_xts_encrypt(const unsigned char *pt, unsigned char *ct, unsigned long blocks, unsigned char *tweak,
+                               const symmetric_key *skey1, const symmetric_key *skey2);
+int rijndael_accel_xts_decrypt(const unsigned char *ct, unsigned char *pt, unsigned long blocks, unsigned char *tweak,
+                               const symmetric_key *skey1, const symmetric_key *skey2);
+int rijndael_accel_gcm_memory(const unsigned char *key,    unsigned long keylen,
+                              const unsigned char *IV,     unsigned long IVlen,
+                              const unsigned char *adata,  unsigned long adatalen,
+                                    unsigned char *pt,     unsigned long ptlen,
+                                    unsigned char *ct,
+                                    unsigned char *tag,    unsigned long *taglen,
+                                              int direction);
+#endif
+
+#ifdef LTC_CHACHA_SIMD
+unsigned long chacha_simd_crypt(ulong32 *input, int rounds, const unsigned char *in, unsigned char *out, unsigned long blocks);
+void chacha_simd_keystream_multi(const ulong32 *input, int rounds, unsigned char *out, unsigned long blocks);
+#endif
+
+#ifdef LTC_CHACHA20POLY1305_SIMD
+unsigned long chacha20poly1305_simd_crypt(chacha_state *chacha, poly1305_state *poly,
+                                          const unsigned char *in, unsigned char *out, unsigned long inlen, int direction);
+#endif
+
 /* tomcrypt_hash.h */
 
+LTC_GEN_PROTO(ltc_hash_gen)
+extern ltc_index_type ltc_hash_index;
+
+#if defined(LTC_AMD64_SIMD) && defined(LTC_TEST)
+/* hash_test_cpu.c */
+int hash_test_cpu(const struct ltc_hash_descriptor *hash);
+#endif
+
 /* a simple macro for making hash "process" functions */
 #define HASH_PROCESS(func_name, compress_name, state_var, block_size)                       \
 int func_name (hash_state * md, const unsigned char *in, unsigned long inlen)               \
@@ -113,10 +258,133 @@ int func_name (hash_state * md, const unsigned char *in, unsigned long inlen)
 }
 
 
+/* a hash "process" function which passes all complete blocks to the compress function at once */
+#define HASH_PROCESS_NBLOCKS(func_name, compress_nblocks_name, state_var, block_size)      \
+int func_name (hash_state * md, const unsigned char *in, unsigned long inlen)               \
+{                                                                                           \
+    unsigned long n, blocks;                                                                \
+    int           err;                                                                      \
+    LTC_ARGCHK(md != NULL);                                                                 \
+    LTC_ARGCHK(in != NULL);                                                                 \
+    if (md-> state_var .curlen > sizeof(md-> state_var .buf)) {                             \
+       return CRYPT_INVALID_ARG;                                                            \
+    }                                                                                       \
+    if ((md-> state_var .length + inlen) < md-> state_var .length) {                        \
+      return CRYPT_HASH_OVERFLOW;                                                           \
+    }                                                                                       \
+    while (inlen > 0) {                                                                     \
+        if (md-> state_var .curlen == 0 && inlen >= block_size) {                           \
+           blocks = inlen / block_size;                                                     \
+           if ((err = compress_nblocks_name (md, in, blocks)) != CRYPT_OK) {                \
+              return err;                                                                   \
+           }                                                                                \
+           md-> state_var .length += blocks * block_size * 8;                               \
+           in             += blocks * block_size;                                           \
+           inlen          -= blocks * block_size;                                           \
+        } else {                                                                            \
+           n = MIN(inlen, (block_size - md-> state_var .curlen));                           \
+           XMEMCPY(md-> state_var .buf + md-> state_var.curlen, in, (size_t)n);             \
+           md-> state_var .curlen += n;                                                     \
+           in             += n;                                                             \
+           inlen          -= n;                                                             \
+           if (md-> state_var .curlen == block_size) {                                      \
+              if ((err = compress_nblocks_name (md, md-> state_var .buf, 1)) != CRYPT_OK) { \
+                 return err;                                                                \
+              }                                                                             \
+              md-> state_var .length += 8*block_size;                                       \
+              md-> state_var .curlen = 0;                                                   \
+           }                                                                                \
+       }                                                                                    \
+    }                                                                                       \
+    return CRYPT_OK;                                                                        \
+}
+
+#if defined(LTC_SHA_NI) && defined(LTC_SHA1)
+void sha1_shani_compress(ulong32 *state, const unsigned char *in, unsigned long blocks);
+#endif
+#if defined(LTC_SHA_NI) && defined(LTC_SHA256)
+void sha256_shani_compress(ulong32 *state, const unsigned char *in, unsigned long blocks);
+#endif
+#ifdef LTC_SHA512_AVX2
+void sha512_avx2_compress(ulong64 *state, const unsigned char *in, unsigned long blocks);
+#endif
+#ifdef LTC_SHA256_MB
+int sha256_mb_memory(const ulong32 *iv, unsigned long outlen, const hash_job *jobs, unsigned long n);
+int sha256_mb_pbkdf2(const ulong32 *inner, const ulong32 *outer, unsigned char *t, unsigned long n,
+                     unsigned long iterations);
+#endif
+#ifdef LTC_SHA3_MB
+int sha3_mb_memory(unsigned long capacity_words, unsigned char pad, const hash_job *jobs, unsigned long n,
+                   unsigned long outlen);
+#endif
+#if defined(LTC_BLAKE2_SIMD) && defined(LTC_BLAKE2B)
+void blake2b_avx2_compress(hash_state *md, const unsigned char *buf);
+#endif
+#if defined(LTC_BLAKE2_SIMD) && defined(LTC_BLAKE2S)
+void blake2s_sse41_compress(hash_state *md, const unsigned char *buf);
+#endif
+#if defined(LTC_BLAKE2_SIMD) && defined(LTC_BLAKE2BP)
+void blake2b_avx2_compress4(ulong64 *h, ulong64 *t, const unsigned char *in, unsigned long stripes);
+#endif
+#if defined(LTC_BLAKE2_SIMD) && defined(LTC_BLAKE2SP)
+void blake2s_avx2_compress8(ulong32 *h, ulong64 *t, const unsigned char *in, unsigned long stripes);
+#endif
+#if defined(LTC_BLAKE2_SIMD) && defined(LTC_ARGON2)
+void argon2_avx2_fill_block(ulong64 *next, const ulong64 *prev, const ulong64 *ref, int with_xor);
+#endif
+
 /* tomcrypt_mac.h */
 
+#if defined(LTC_GCM_MODE) || defined(LTC_OCB3_MODE) || defined(LTC_CHACHA20POLY1305_MODE)
+int aead_int_ecb_multi(const unsigned char *in, unsigned char *out, unsigned long blocks,
+                       const symmetric_key * const *skey, const int *cipher, int direction);
+#endif
+
 int ocb3_int_ntz(unsigned long x);
 void ocb3_int_xor_blocks(unsigned char *out, const unsigned char *block_a, const unsigned char *block_b, unsigned long block_len);
+void ocb3_int_nonce_block(unsigned char *iNonce, int *bottom, int block_len,
+                          const unsigned char *nonce, unsigned long noncelen, unsigned long taglen);
+void ocb3_int_offset_zero(unsigned char *Offset, const unsigned char *iKtop, int bottom, int block_len);
+
+#ifdef LTC_POLY1305_SIMD
+unsigned long poly1305_avx2_blocks(ulong32 *h, const ulong32 *r, const unsigned char *in, unsigned long inlen);
+void poly1305_avx2_multi(poly1305_state *st, const unsigned char *in, unsigned long steps);
+#endif
+
+#ifdef LTC_GCM_MODE
+void gcm_key_mult_h(const gcm_key *key, unsigned char *I);
+#endif
+
+#ifdef LTC_GCM_PCLMUL
+/* flags of gcm_state.simd */
+#define LTC_GCM_SIMD_HPOW  1  /* the powers of H are valid */
+#define LTC_GCM_SIMD_AES   2  /* the key was scheduled by aes.c */
+
+int gcm_pclmul_is_supported(void);
+void gcm_pclmul_init(unsigned char *Hpow, const unsigned char *H);
+void gcm_pclmul_mult_h(unsigned char *I, const unsigned char *Hpow);
+void gcm_pclmul_ghash(unsigned char *X, const unsigned char *Hpow, const unsigned char *in, unsigned long inlen);
+#endif
+
+#ifdef LTC_GCM_AESNI
+int gcm_aesni_is_supported(void);
+int gcm_aesni_ctr_ghash(const symmetric_key *skey, unsigned char *Y, unsigned char *X, const unsigned char *Hpow,
+                        const unsigned char *in, unsigned char *out, unsigned long len, int direction);
+int gcm_aesni_memory(const unsigned char *key,    unsigned long keylen,
+                     const unsigned char *IV,     unsigned long IVlen,
+                     const unsigned char *adata,  unsigned long adatalen,
+                           unsigned char *pt,     unsigned long ptlen,
+                           unsigned char *ct,
+                           unsigned char *tag,    unsigned long *taglen,
+                                     int direction);
+#endif
+
+#ifdef LTC_GCM_VAES
+int gcm_vaes_is_supported(void);
+void gcm_vaes_ghash(unsigned char *X, const unsigned char *Hpow, const unsigned char *in, unsigned long inlen);
+int gcm_vaes_ctr_ghash(const symmetric_key *skey, unsigned char *Y, unsigned char *X, const unsigned char *Hpow,
+                       const unsigned char *in, unsigned char *out, unsigned long len, int direction);
+#endif
 
 
 /* tomcrypt_math.h */
@@ -202,6 +470,10 @@ int pbes_decrypt(const pbes_arg  *arg, unsigned char *dec_data, unsigned long *d
 int pbes1_extract(const ltc_asn1_list *s, pbes_arg *res);
 int pbes2_extract(const ltc_asn1_list *s, pbes_arg *res);
 
+#ifdef LTC_SCRYPT_SIMD
+void scrypt_sse2_romix(unsigned char *B, unsigned long r, ulong64 N, ulong32 *V, ulong32 *XY);
+#endif
+
 
 /* tomcrypt_pk.h */
 
@@ -370,6 +642,9 @@ int pkcs12_kdf(               int   hash_id,
 
 /* tomcrypt_prng.h */
 
+LTC_GEN_PROTO(ltc_prng_gen)
+extern ltc_index_type ltc_prng_index;
+
 #define _LTC_PRNG_EXPORT(which) \
 int which ## _export(unsigned char *out, unsigned long *outlen, prng_state *prng)      \
 {                                                                                      \
@@ -0,0 +1,102 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ */
+#include "tomcrypt_private.h"
+
+/**
+  @file hmac_key_prepare.c
+  HMAC support, precompute the inner and outer hash states of a key
+*/
+
+#ifdef LTC_HMAC
+
+/**
+   Prepare an HMAC key for hmac_memory_prepared()
+
+   The hash states after the ipad and opad blocks are stored, so they
+   don't have to be recomputed for every message.  The prepared key is
+   not modified by its users and can be shared between threads.
+   @param hkey     [out] The prepared key
+   @param hash     The index of the hash you want to use
+   @param key      The secret key
+   @param keylen   The length of the secret key (octets)
+   @return CRYPT_OK if successful
+*/
+int hmac_key_prepare(hmac_key *hkey, int hash, const unsigned char *key, unsigned long keylen)
+{
+    unsigned char buf[MAXBLOCKSIZE];
+    unsigned long blocksize, i, z;
+    int err;
+
+    LTC_ARGCHK(hkey != NULL);
+    LTC_ARGCHK(key  != NULL);
+
+    /* valid hash? */
+    if ((err = hash_is_valid(hash)) != CRYPT_OK) {
+        return err;
+    }
+    hkey->hash = hash;
+    blocksize  = hash_descriptor[hash].blocksize;
+
+    /* valid key length? */
+    if (keylen == 0) {
+        return CRYPT_INVALID_KEYSIZE;
+    }
+
+    /* check hash block fits */
+    if (sizeof(buf) < blocksize) {
+        return CRYPT_BUFFER_OVERFLOW;
+    }
+
+    /* make sure we have a large enough key */
+    if (keylen > blocksize) {
+        z = blocksize;
+        if ((err = hash_memory(hash, key, keylen, buf, &z)) != CRYPT_OK) {
+           goto LBL_ERR;
+        }
+        keylen = hash_descriptor[hash].hashsize;
+    } else {
+        XMEMCPY(buf, key, (size_t)keylen);
+    }
+    if (keylen < blocksize) {
+       zeromem(buf + keylen, (size_t)(blocksize - keylen));
+    }
+
+    /* the inner state, after key ^ ipad */
+    for (i = 0; i < blocksize; i++) {
+       buf[i] ^= 0x36;
+    }
+    if ((err = hash_descriptor[hash].init(&hkey->inner)) != CRYPT_OK) {
+       goto LBL_ERR;
+    }
+    if ((err = hash_descriptor[hash].process(&hkey->inner, buf, blocksize)) != CRYPT_OK) {
+       goto LBL_ERR;
+    }
+
+    /* the outer state, after key ^ opad */
+    for (i = 0; i < blocksize; i++) {
+       buf[i] ^= 0x36 ^ 0x5C;
+    }
+    if ((err = hash_descriptor[hash].init(&hkey->outer)) != CRYPT_OK) {
+       goto LBL_ERR;
+    }
+    err = hash_descriptor[hash].process(&hkey->outer, buf, blocksize);
+
+LBL_ERR:
+#ifdef LTC_CLEAN_STACK
+    zeromem(buf, sizeof(buf));
+#endif
+    return err;
+}
+
+#endif
+
+
+/* ref:         $Format:%D$ */
+/* git commit:  $Format:%H$ */
+/* commit time: $Format:%ai$ */
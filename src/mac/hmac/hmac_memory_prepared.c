@@ -0,0 +1,84 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ */
+#include "tomcrypt_private.h"
+
+/**
+  @file hmac_memory_prepared.c
+  HMAC support, process a block of memory with a prepared key
+*/
+
+#ifdef LTC_HMAC
+
+/**
+   HMAC a block of memory with a key from hmac_key_prepare()
+   @param hkey      The prepared key
+   @param in        The data to HMAC
+   @param inlen     The length of the data to HMAC (octets)
+   @param out       [out] Destination of the authentication tag
+   @param outlen    [in/out] Max size and resulting size of authentication tag
+   @return CRYPT_OK if successful
+*/
+int hmac_memory_prepared(const hmac_key *hkey,
+                         const unsigned char *in,  unsigned long inlen,
+                               unsigned char *out, unsigned long *outlen)
+{
+    hash_state md;
+    unsigned char buf[MAXBLOCKSIZE];
+    unsigned long hashsize, i;
+    int hash, err;
+
+    LTC_ARGCHK(hkey   != NULL);
+    LTC_ARGCHK(in     != NULL);
+    LTC_ARGCHK(out    != NULL);
+    LTC_ARGCHK(outlen != NULL);
+
+    hash = hkey->hash;
+    if ((err = hash_is_valid(hash)) != CRYPT_OK) {
+        return err;
+    }
+    hashsize = hash_descriptor[hash].hashsize;
+
+    /* the inner hash */
+    XMEMCPY(&md, &hkey->inner, sizeof(md));
+    if ((err = hash_descriptor[hash].process(&md, in, inlen)) != CRYPT_OK) {
+       goto LBL_ERR;
+    }
+    if ((err = hash_descriptor[hash].done(&md, buf)) != CRYPT_OK) {
+       goto LBL_ERR;
+    }
+
+    /* the outer hash */
+    XMEMCPY(&md, &hkey->outer, sizeof(md));
+    if ((err = hash_descriptor[hash].process(&md, buf, hashsize)) != CRYPT_OK) {
+       goto LBL_ERR;
+    }
+    if ((err = hash_descriptor[hash].done(&md, buf)) != CRYPT_OK) {
+       goto LBL_ERR;
+    }
+
+    /* copy to output  */
+    for (i = 0; i < hashsize && i < *outlen; i++) {
+        out[i] = buf[i];
+    }
+    *outlen = i;
+
+LBL_ERR:
+#ifdef LTC_CLEAN_STACK
+    zeromem(&md, sizeof(md));
+    zeromem(buf, sizeof(buf));
+#endif
+    return err;
+}
+
+#endif
+
+
+/* ref:         $Format:%D$ */
+/* git commit:  $Format:%H$ */
+/* commit time: $Format:%ai$ */
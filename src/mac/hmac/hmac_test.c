@@ -591,6 +591,7 @@ int hmac_test(void)
     };
 
     unsigned long outlen;
+    hmac_key hkey;
     int err;
     int tested=0,failed=0;
     for(i=0; i < (int)(sizeof(cases) / sizeof(cases[0])); i++) {
@@ -608,7 +609,51 @@ int hmac_test(void)
         if(compare_testvector(digest, outlen, cases[i].digest, (size_t)hash_descriptor[hash].hashsize, cases[i].num, i)) {
             failed++;
         }
+
+        /* the same with a prepared key */
+        if((err = hmac_key_prepare(&hkey, hash, cases[i].key, cases[i].keylen)) != CRYPT_OK) {
+            return err;
+        }
+        outlen = sizeof(digest);
+        if((err = hmac_memory_prepared(&hkey, cases[i].data, cases[i].datalen, digest, &outlen)) != CRYPT_OK) {
+            return err;
+        }
+        if(compare_testvector(digest, outlen, cases[i].digest, (size_t)hash_descriptor[hash].hashsize, cases[i].num, i)) {
+            failed++;
+        }
+    }
+
+#if defined(LTC_BLAKE2BP) || defined(LTC_BLAKE2SP)
+    /* the prepared key is copied for every message, BLAKE2bp and BLAKE2sp keep large states */
+    {
+        static const char *tree_hashes[] = { "blake2bp-512", "blake2sp-256" };
+        unsigned char key[200], data[1000], ref[MAXBLOCKSIZE];
+        unsigned long j, reflen;
+        for (j = 0; j < sizeof(key); j++) key[j] = (unsigned char)(j * 3 + 1);
+        for (j = 0; j < sizeof(data); j++) data[j] = (unsigned char)(j * 7 + 5);
+        for(i=0; i < (int)(sizeof(tree_hashes) / sizeof(tree_hashes[0])); i++) {
+            int hash = find_hash(tree_hashes[i]);
+            if (hash == -1) continue;
+            ++tested;
+            if((err = hmac_key_prepare(&hkey, hash, key, sizeof(key))) != CRYPT_OK) {
+                return err;
+            }
+            for (j = 0; j < 3; j++) {
+                reflen = sizeof(ref);
+                if((err = hmac_memory(hash, key, sizeof(key), data, 300 * j + 33, ref, &reflen)) != CRYPT_OK) {
+                    return err;
+                }
+                outlen = sizeof(digest);
+                if((err = hmac_memory_prepared(&hkey, data, 300 * j + 33, digest, &outlen)) != CRYPT_OK) {
+                    return err;
+                }
+                if(compare_testvector(digest, outlen, ref, reflen, "HMAC prepared", i * 3 + (int)j)) {
+                    failed++;
+                }
+            }
+        }
     }
+#endif
 
     if (failed != 0) {
         return CRYPT_FAIL_TESTVECTOR;
@@ -16,6 +16,95 @@
 
 #ifdef LTC_POLY1305
 
+#ifdef LTC_POLY1305_R44
+
+typedef unsigned __int128 ulong128;
+
+/* convert the 26-bit limbs of the state to 44-bit limbs, a[1] may exceed 26 bits */
+static void _poly1305_to44(ulong64 *b, const ulong32 *a)
+{
+   ulong128 t;
+
+   t = (ulong128)a[0] + ((ulong128)a[1] << 26) + ((ulong128)a[2] << 52);
+   b[0] = (ulong64)t & CONST64(0xfffffffffff);
+   t >>= 44;
+   t += ((ulong128)a[3] << 34) + ((ulong128)a[4] << 60);
+   b[1] = (ulong64)t & CONST64(0xfffffffffff);
+   b[2] = (ulong64)(t >> 44);
+}
+
+/* and back again */
+static void _poly1305_to26(ulong32 *a, const ulong64 *b)
+{
+   ulong128 t;
+
+   t = (ulong128)b[0] + ((ulong128)b[1] << 44);
+   a[0] = (ulong32)t & 0x3ffffff; t >>= 26;
+   a[1] = (ulong32)t & 0x3ffffff; t >>= 26;
+   t += (ulong128)b[2] << 36;
+   a[2] = (ulong32)t & 0x3ffffff; t >>= 26;
+   a[3] = (ulong32)t & 0x3ffffff; t >>= 26;
+   a[4] = (ulong32)t;
+}
+
+/* internal only, the state is kept in 26-bit limbs and converted for each call */
+static void _poly1305_block(poly1305_state *st, const unsigned char *in, unsigned long inlen)
+{
+   const ulong64 hibit = (st->final) ? 0 : (CONST64(1) << 40); /* 1 << 128 */
+   ulong64 r[3], h[3];
+   ulong64 r0,r1,r2;
+   ulong64 s1,s2;
+   ulong64 h0,h1,h2;
+   ulong64 t0,t1;
+   ulong128 d0,d1,d2,d;
+   ulong64 c;
+
+   _poly1305_to44(r, st->r);
+   _poly1305_to44(h, st->h);
+
+   r0 = r[0];
+   r1 = r[1];
+   r2 = r[2];
+
+   s1 = r1 * (5 << 2);
+   s2 = r2 * (5 << 2);
+
+   h0 = h[0];
+   h1 = h[1];
+   h2 = h[2];
+
+   while (inlen >= 16) {
+      /* h += in[i] */
+      LOAD64L(t0, in+ 0);
+      LOAD64L(t1, in+ 8);
+      h0 += (( t0                    ) & CONST64(0xfffffffffff));
+      h1 += (((t0 >> 44) | (t1 << 20)) & CONST64(0xfffffffffff));
+      h2 += (((t1 >> 24)             ) & CONST64(0x3ffffffffff)) | hibit;
+
+      /* h *= r */
+      d0 = ((ulong128)h0 * r0); d = ((ulong128)h1 * s2); d0 += d; d = ((ulong128)h2 * s1); d0 += d;
+      d1 = ((ulong128)h0 * r1); d = ((ulong128)h1 * r0); d1 += d; d = ((ulong128)h2 * s2); d1 += d;
+      d2 = ((ulong128)h0 * r2); d = ((ulong128)h1 * r1); d2 += d; d = ((ulong128)h2 * r0); d2 += d;
+
+      /* (partial) h %= p */
+                    c = (ulong64)(d0 >> 44); h0 = (ulong64)d0 & CONST64(0xfffffffffff);
+      d1 += c;      c = (ulong64)(d1 >> 44); h1 = (ulong64)d1 & CONST64(0xfffffffffff);
+      d2 += c;      c = (ulong64)(d2 >> 42); h2 = (ulong64)d2 & CONST64(0x3ffffffffff);
+      h0 += c * 5;  c =          (h0 >> 44); h0 =          h0 & CONST64(0xfffffffffff);
+      h1 += c;
+
+      in += 16;
+      inlen -= 16;
+   }
+
+   h[0] = h0;
+   h[1] = h1;
+   h[2] = h2;
+   _poly1305_to26(st->h, h);
+}
+
+#else
+
 /* internal only */
 static void _poly1305_block(poly1305_state *st, const unsigned char *in, unsigned long inlen)
 {
@@ -79,6 +168,8 @@ static void _poly1305_block(poly1305_state *st, const unsigned char *in, unsigne
    st->h[4] = h4;
 }
 
+#endif /* LTC_POLY1305_R44 */
+
 /**
    Initialize an POLY1305 context.
    @param st       The POLY1305 state
@@ -148,6 +239,14 @@ int poly1305_process(poly1305_state *st, const unsigned char *in, unsigned long
    /* process full blocks */
    if (inlen >= 16) {
       unsigned long want = (inlen & ~(16 - 1));
+#ifdef LTC_POLY1305_SIMD
+      if (want >= 256 && ltc_cpu_has(LTC_CPU_AVX2)) {
+         i = poly1305_avx2_blocks(st->h, st->r, in, want);
+         in += i;
+         inlen -= i;
+         want -= i;
+      }
+#endif
       _poly1305_block(st, in, want);
       in += want;
       inlen -= want;
@@ -0,0 +1,167 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ */
+
+/**
+   @file poly1305_avx2.h
+   Poly1305 helpers shared by poly1305_simd.c and the single-pass
+   ChaCha20-Poly1305 code of chacha_simd.c
+
+   Include after <immintrin.h> (or <intrin.h>).  The four lanes of the
+   accumulator hold every fourth block of the message, the macros expect
+   the locals mask and hibit set by POLY1305_AVX2_CONST().
+*/
+
+#ifndef POLY1305_AVX2_H_
+#define POLY1305_AVX2_H_
+
+#define POLY1305_AVX2_TARGET LTC_ATTRIBUTE_TARGET("avx2")
+
+#define POLY1305_AVX2_LOAD(p)      _mm256_loadu_si256((const __m256i *)(const void *)(p))
+#define POLY1305_AVX2_STORE(p, v)  _mm256_storeu_si256((__m256i *)(void *)(p), (v))
+
+#define POLY1305_AVX2_CONST() do {                                                                      \
+   mask  = _mm256_set1_epi64x(0x3ffffff);                                                               \
+   hibit = _mm256_set1_epi64x(1L << 24);                                                                \
+} while (0)
+
+/* h *= r, partially reduced */
+static LTC_INLINE void _poly1305_mul(ulong32 *h, const ulong32 *r)
+{
+   ulong64 d0,d1,d2,d3,d4;
+   ulong32 s1,s2,s3,s4,c;
+
+   s1 = r[1] * 5;
+   s2 = r[2] * 5;
+   s3 = r[3] * 5;
+   s4 = r[4] * 5;
+
+   d0 = ((ulong64)h[0] * r[0]) + ((ulong64)h[1] * s4) + ((ulong64)h[2] * s3) + ((ulong64)h[3] * s2) + ((ulong64)h[4] * s1);
+   d1 = ((ulong64)h[0] * r[1]) + ((ulong64)h[1] * r[0]) + ((ulong64)h[2] * s4) + ((ulong64)h[3] * s3) + ((ulong64)h[4] * s2);
+   d2 = ((ulong64)h[0] * r[2]) + ((ulong64)h[1] * r[1]) + ((ulong64)h[2] * r[0]) + ((ulong64)h[3] * s4) + ((ulong64)h[4] * s3);
+   d3 = ((ulong64)h[0] * r[3]) + ((ulong64)h[1] * r[2]) + ((ulong64)h[2] * r[1]) + ((ulong64)h[3] * r[0]) + ((ulong64)h[4] * s4);
+   d4 = ((ulong64)h[0] * r[4]) + ((ulong64)h[1] * r[3]) + ((ulong64)h[2] * r[2]) + ((ulong64)h[3] * r[1]) + ((ulong64)h[4] * r[0]);
+
+                  c = (ulong32)(d0 >> 26); h[0] = (ulong32)d0 & 0x3ffffff;
+   d1 += c;       c = (ulong32)(d1 >> 26); h[1] = (ulong32)d1 & 0x3ffffff;
+   d2 += c;       c = (ulong32)(d2 >> 26); h[2] = (ulong32)d2 & 0x3ffffff;
+   d3 += c;       c = (ulong32)(d3 >> 26); h[3] = (ulong32)d3 & 0x3ffffff;
+   d4 += c;       c = (ulong32)(d4 >> 26); h[4] = (ulong32)d4 & 0x3ffffff;
+   h[0] += c * 5; c =          (h[0] >> 26); h[0] =        h[0] & 0x3ffffff;
+   h[1] += c;
+}
+
+/* d = h * r, five 26-bit limbs per lane, s = r * 5 */
+#define POLY1305_MUL(d, h, r, s) do {                                                                   \
+   d[0] = _mm256_add_epi64(_mm256_add_epi64(_mm256_add_epi64(_mm256_add_epi64(                          \
+          _mm256_mul_epu32(h[0], r[0]), _mm256_mul_epu32(h[1], s[4])), _mm256_mul_epu32(h[2], s[3])),   \
+          _mm256_mul_epu32(h[3], s[2])), _mm256_mul_epu32(h[4], s[1]));                                 \
+   d[1] = _mm256_add_epi64(_mm256_add_epi64(_mm256_add_epi64(_mm256_add_epi64(                          \
+          _mm256_mul_epu32(h[0], r[1]), _mm256_mul_epu32(h[1], r[0])), _mm256_mul_epu32(h[2], s[4])),   \
+          _mm256_mul_epu32(h[3], s[3])), _mm256_mul_epu32(h[4], s[2]));                                 \
+   d[2] = _mm256_add_epi64(_mm256_add_epi64(_mm256_add_epi64(_mm256_add_epi64(                          \
+          _mm256_mul_epu32(h[0], r[2]), _mm256_mul_epu32(h[1], r[1])), _mm256_mul_epu32(h[2], r[0])),   \
+          _mm256_mul_epu32(h[3], s[4])), _mm256_mul_epu32(h[4], s[3]));                                 \
+   d[3] = _mm256_add_epi64(_mm256_add_epi64(_mm256_add_epi64(_mm256_add_epi64(                          \
+          _mm256_mul_epu32(h[0], r[3]), _mm256_mul_epu32(h[1], r[2])), _mm256_mul_epu32(h[2], r[1])),   \
+          _mm256_mul_epu32(h[3], r[0])), _mm256_mul_epu32(h[4], s[4]));                                 \
+   d[4] = _mm256_add_epi64(_mm256_add_epi64(_mm256_add_epi64(_mm256_add_epi64(                          \
+          _mm256_mul_epu32(h[0], r[4]), _mm256_mul_epu32(h[1], r[3])), _mm256_mul_epu32(h[2], r[2])),   \
+          _mm256_mul_epu32(h[3], r[1])), _mm256_mul_epu32(h[4], r[0]));                                 \
+} while (0)
+
+/* m = four blocks of the message, the lanes hold the blocks 0, 2, 1 and 3 */
+#define POLY1305_LOAD(m, in) do {                                                                       \
+   __m256i _a = POLY1305_AVX2_LOAD(in), _b = POLY1305_AVX2_LOAD((in) + 32), _lo, _hi;                                     \
+   _lo = _mm256_unpacklo_epi64(_a, _b);                                                                 \
+   _hi = _mm256_unpackhi_epi64(_a, _b);                                                                 \
+   m[0] = _mm256_and_si256(_lo, mask);                                                                  \
+   m[1] = _mm256_and_si256(_mm256_srli_epi64(_lo, 26), mask);                                           \
+   m[2] = _mm256_and_si256(_mm256_or_si256(_mm256_srli_epi64(_lo, 52), _mm256_slli_epi64(_hi, 12)), mask); \
+   m[3] = _mm256_and_si256(_mm256_srli_epi64(_hi, 14), mask);                                           \
+   m[4] = _mm256_or_si256(_mm256_srli_epi64(_hi, 40), hibit);                                           \
+} while (0)
+
+/* h = d, partially reduced */
+#define POLY1305_CARRY(h, d) do {                                                                       \
+   __m256i _c;                                                                                          \
+   _c = _mm256_srli_epi64(d[0], 26); h[0] = _mm256_and_si256(d[0], mask);                               \
+   d[1] = _mm256_add_epi64(d[1], _c);                                                                   \
+   _c = _mm256_srli_epi64(d[1], 26); h[1] = _mm256_and_si256(d[1], mask);                               \
+   d[2] = _mm256_add_epi64(d[2], _c);                                                                   \
+   _c = _mm256_srli_epi64(d[2], 26); h[2] = _mm256_and_si256(d[2], mask);                               \
+   d[3] = _mm256_add_epi64(d[3], _c);                                                                   \
+   _c = _mm256_srli_epi64(d[3], 26); h[3] = _mm256_and_si256(d[3], mask);                               \
+   d[4] = _mm256_add_epi64(d[4], _c);                                                                   \
+   _c = _mm256_srli_epi64(d[4], 26); h[4] = _mm256_and_si256(d[4], mask);                               \
+   h[0] = _mm256_add_epi64(h[0], _mm256_add_epi64(_c, _mm256_slli_epi64(_c, 2)));                       \
+   _c = _mm256_srli_epi64(h[0], 26); h[0] = _mm256_and_si256(h[0], mask);                               \
+   h[1] = _mm256_add_epi64(h[1], _c);                                                                   \
+} while (0)
+
+/* h += m */
+#define POLY1305_ADD(h, m) do {                                                                         \
+   h[0] = _mm256_add_epi64(h[0], m[0]);                                                                 \
+   h[1] = _mm256_add_epi64(h[1], m[1]);                                                                 \
+   h[2] = _mm256_add_epi64(h[2], m[2]);                                                                 \
+   h[3] = _mm256_add_epi64(h[3], m[3]);                                                                 \
+   h[4] = _mm256_add_epi64(h[4], m[4]);                                                                 \
+} while (0)
+
+/* p[i] = r^(i+1), R and S = r^4 and 5 * r^4 in all lanes */
+POLY1305_AVX2_TARGET
+static LTC_INLINE void _poly1305_avx2_powers(ulong32 p[4][5], __m256i *R, __m256i *S, const ulong32 *r)
+{
+   int x;
+
+   XMEMCPY(p[0], r, sizeof(p[0]));
+   for (x = 1; x < 4; x++) {
+      XMEMCPY(p[x], p[x - 1], sizeof(p[x]));
+      _poly1305_mul(p[x], r);
+   }
+   for (x = 0; x < 5; x++) {
+      R[x] = _mm256_set1_epi64x((long long)p[3][x]);
+      S[x] = _mm256_set1_epi64x((long long)p[3][x] * 5);
+   }
+}
+
+/* h = the sum of the lanes of H, multiplied by r^4, r^2, r^3 and r^1 */
+POLY1305_AVX2_TARGET
+static LTC_INLINE void _poly1305_avx2_sum(ulong32 *h, const __m256i *H, ulong32 p[4][5])
+{
+   ulong64 t[4], d0, d1, d2, d3, d4, c;
+   __m256i D[5], R[5], S[5];
+   int x;
+
+   for (x = 0; x < 5; x++) {
+      R[x] = _mm256_setr_epi64x((long long)p[3][x], (long long)p[1][x], (long long)p[2][x], (long long)p[0][x]);
+      S[x] = _mm256_add_epi64(R[x], _mm256_slli_epi64(R[x], 2));
+   }
+   POLY1305_MUL(D, H, R, S);
+
+   POLY1305_AVX2_STORE(t, D[0]); d0 = t[0] + t[1] + t[2] + t[3];
+   POLY1305_AVX2_STORE(t, D[1]); d1 = t[0] + t[1] + t[2] + t[3];
+   POLY1305_AVX2_STORE(t, D[2]); d2 = t[0] + t[1] + t[2] + t[3];
+   POLY1305_AVX2_STORE(t, D[3]); d3 = t[0] + t[1] + t[2] + t[3];
+   POLY1305_AVX2_STORE(t, D[4]); d4 = t[0] + t[1] + t[2] + t[3];
+
+                c = d0 >> 26; h[0] = (ulong32)d0 & 0x3ffffff;
+   d1 += c;     c = d1 >> 26; h[1] = (ulong32)d1 & 0x3ffffff;
+   d2 += c;     c = d2 >> 26; h[2] = (ulong32)d2 & 0x3ffffff;
+   d3 += c;     c = d3 >> 26; h[3] = (ulong32)d3 & 0x3ffffff;
+   d4 += c;     c = d4 >> 26; h[4] = (ulong32)d4 & 0x3ffffff;
+   c = h[0] + c * 5;
+   h[0] = (ulong32)c & 0x3ffffff;
+   h[1] += (ulong32)(c >> 26);
+}
+
+#endif
+
+/* ref:         $Format:%D$ */
+/* git commit:  $Format:%H$ */
+/* commit time: $Format:%ai$ */
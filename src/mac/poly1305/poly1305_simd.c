@@ -0,0 +1,139 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ */
+
+/**
+   @file poly1305_simd.c
+   Poly1305 using the AVX2 instructions of x86-64 CPUs
+
+   The message is split into four interleaved streams, one per 64-bit lane,
+   which are all multiplied by r^4 for each 64 bytes of input:
+
+   H = H * r^4 + (m_4i, m_4i+2, m_4i+1, m_4i+3)
+
+   The lanes are multiplied by the matching powers r^4 ... r^1 and summed up
+   after the last block.  The limbs are 26 bits wide as in poly1305.c, so the
+   products fit the 32x32 bit multiplication of _mm256_mul_epu32().
+
+   poly1305_avx2_multi() uses the lanes for four independent messages.
+*/
+#include "tomcrypt_private.h"
+
+#ifdef LTC_POLY1305_SIMD
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+/* the AVX-512 macros of GCC mix declarations and code */
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wdeclaration-after-statement"
+#endif
+#include <immintrin.h>
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+#endif
+
+#define AVX2_TARGET LTC_ATTRIBUTE_TARGET("avx2")
+
+#include "poly1305_avx2.h"
+
+/**
+  Process multiples of 64 bytes with AVX2
+  @param h      [in/out] The accumulator, 26-bit limbs
+  @param r      The key, 26-bit limbs
+  @param in     The data
+  @param inlen  The length of the data (octets)
+  @return The number of bytes processed
+*/
+AVX2_TARGET
+unsigned long poly1305_avx2_blocks(ulong32 *h, const ulong32 *r, const unsigned char *in, unsigned long inlen)
+{
+   ulong32 p[4][5];
+   __m256i H[5], M[5], D[5], R[5], S[5], mask, hibit;
+   unsigned long n, x;
+
+   n = inlen / 64;
+   if (n == 0) {
+      return 0;
+   }
+
+   POLY1305_AVX2_CONST();
+   _poly1305_avx2_powers(p, R, S, r);
+
+   POLY1305_LOAD(H, in);
+   for (x = 0; x < 5; x++) {
+      H[x] = _mm256_add_epi64(H[x], _mm256_setr_epi64x((long long)h[x], 0, 0, 0));
+   }
+   in += 64;
+
+   for (x = 1; x < n; x++) {
+      /* H = H * r^4 + M */
+      POLY1305_MUL(D, H, R, S);
+
+      POLY1305_CARRY(H, D);
+
+      POLY1305_LOAD(M, in);
+      POLY1305_ADD(H, M);
+      in += 64;
+   }
+
+   /* multiply the lanes by r^4, r^2, r^3 and r^1 and add them up */
+   _poly1305_avx2_sum(h, H, p);
+
+   return n * 64;
+}
+
+/**
+  Process four independent messages with AVX2, one per lane
+
+  Each 64 bytes of input hold one full block of every message, the block of
+  message i at offset 16 * i.
+  @param st     [in/out] The four states of the messages, the buffered partial blocks are ignored
+  @param in     The data
+  @param steps  The number of blocks per message
+*/
+AVX2_TARGET
+void poly1305_avx2_multi(poly1305_state *st, const unsigned char *in, unsigned long steps)
+{
+   ulong64 t[4];
+   __m256i H[5], M[5], D[5], R[5], S[5], mask, hibit;
+   unsigned long n, x;
+
+   POLY1305_AVX2_CONST();
+   /* the lanes are in the order of POLY1305_LOAD */
+   for (x = 0; x < 5; x++) {
+      H[x] = _mm256_setr_epi64x((long long)st[0].h[x], (long long)st[2].h[x], (long long)st[1].h[x], (long long)st[3].h[x]);
+      R[x] = _mm256_setr_epi64x((long long)st[0].r[x], (long long)st[2].r[x], (long long)st[1].r[x], (long long)st[3].r[x]);
+      S[x] = _mm256_add_epi64(R[x], _mm256_slli_epi64(R[x], 2));
+   }
+
+   for (n = 0; n < steps; n++) {
+      /* H = (H + M) * r */
+      POLY1305_LOAD(M, in);
+      POLY1305_ADD(H, M);
+      POLY1305_MUL(D, H, R, S);
+      POLY1305_CARRY(H, D);
+      in += 64;
+   }
+
+   for (x = 0; x < 5; x++) {
+      POLY1305_AVX2_STORE(t, H[x]);
+      st[0].h[x] = (ulong32)t[0];
+      st[2].h[x] = (ulong32)t[1];
+      st[1].h[x] = (ulong32)t[2];
+      st[3].h[x] = (ulong32)t[3];
+   }
+}
+
+#endif
+
+/* ref:         $Format:%D$ */
+/* git commit:  $Format:%H$ */
+/* commit time: $Format:%ai$ */
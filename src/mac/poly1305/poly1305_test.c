@@ -16,6 +16,63 @@
 
 #ifdef LTC_POLY1305
 
+#if defined(LTC_TEST) && defined(LTC_POLY1305_SIMD)
+static int _poly1305_simd_mac(unsigned long mask, const unsigned char *key, const unsigned char *in, unsigned long inlen,
+                              unsigned long split, unsigned char *out)
+{
+   poly1305_state st;
+   unsigned long len = 16;
+   int err;
+
+   mask = ltc_cpu_mask(mask);
+   if ((err = poly1305_init(&st, key, 32)) != CRYPT_OK)                                goto LBL_ERR;
+   if ((err = poly1305_process(&st, in, split)) != CRYPT_OK)                           goto LBL_ERR;
+   if ((err = poly1305_process(&st, in + split, inlen - split)) != CRYPT_OK)           goto LBL_ERR;
+   err = poly1305_done(&st, out, &len);
+LBL_ERR:
+   ltc_cpu_mask(mask);
+   return err;
+}
+
+static int _poly1305_simd_test(void)
+{
+   static const unsigned long lens[] = { 255, 256, 257, 319, 320, 1000, 1024, 1039, 2048, 3000 };
+   unsigned char key[32], P[3000], tag[2][16];
+   unsigned long x, len, split;
+   int err;
+
+   for (x = 0; x < sizeof(P); x++) {
+      P[x] = (unsigned char)(x * 7 + (x >> 8));
+   }
+   for (x = 0; x < 40; x++) {
+      len = lens[x % 10];
+      split = (x < 10) ? 0 : (x * 13) % len;
+      XMEMSET(key, 0xff, 16);
+      if (x & 1) {
+         /* the worst case for the limbs of the accumulator */
+         XMEMSET(P, 0xff, len);
+      }
+      XMEMCPY(key + 16, P + x, 16);
+      if (x >= 20) {
+         XMEMCPY(key, P + 3 * x, 16);
+      }
+      if ((err = _poly1305_simd_mac(~LTC_CPU_AVX2, key, P, len, split, tag[0])) != CRYPT_OK) {
+         return err;
+      }
+      if ((err = _poly1305_simd_mac(~0UL, key, P, len, split, tag[1])) != CRYPT_OK) {
+         return err;
+      }
+      if (compare_testvector(tag[1], 16, tag[0], 16, "POLY1305 SIMD", (int)x)) {
+         return CRYPT_FAIL_TESTVECTOR;
+      }
+      for (split = 0; split < len; split++) {
+         P[split] = (unsigned char)(split * 7 + (split >> 8));
+      }
+   }
+   return CRYPT_OK;
+}
+#endif
+
 int poly1305_test(void)
 {
 #ifndef LTC_TEST
@@ -45,6 +102,9 @@ int poly1305_test(void)
    if ((err = poly1305_process(&st, (unsigned char*)m, mlen)) != CRYPT_OK)           return err;
    if ((err = poly1305_done(&st, out, &len)) != CRYPT_OK)                            return err;
    if (compare_testvector(out, len, tag, sizeof(tag), "POLY1305-TV2", 1) != 0)       return CRYPT_FAIL_TESTVECTOR;
+#ifdef LTC_POLY1305_SIMD
+   if ((err = _poly1305_simd_test()) != CRYPT_OK)                                    return err;
+#endif
    return CRYPT_OK;
 #endif
 }
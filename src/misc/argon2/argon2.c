@@ -0,0 +1,456 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ */
+#include "tomcrypt_private.h"
+
+/**
+  @file argon2.c
+  Argon2 password hashing, RFC 9106
+
+  The memory is an array of p lanes of 1 KiB blocks, each lane is split into
+  four segments.  The segments of one slice are independent of each other,
+  with LTC_PTHREAD every lane of a slice is filled by its own thread.
+*/
+
+#ifdef LTC_ARGON2
+
+#define ARGON2_VERSION       0x13
+#define ARGON2_BLOCK_WORDS   128
+#define ARGON2_SYNC_POINTS   4
+
+typedef struct {
+   ulong64       *memory;
+   unsigned long  passes, lanes, lane_length, segment_length;
+   argon2_type    type;
+} argon2_instance;
+
+/* x + y + 2 * lo32(x) * lo32(y) */
+#define BLAMKA(x, y)  ((x) + (y) + 2 * ((x) & CONST64(0xFFFFFFFF)) * ((y) & CONST64(0xFFFFFFFF)))
+
+#define GB(a, b, c, d)                      \
+   do {                                     \
+      a = BLAMKA(a, b);                     \
+      d = ROR64c(d ^ a, 32);                \
+      c = BLAMKA(c, d);                     \
+      b = ROR64c(b ^ c, 24);                \
+      a = BLAMKA(a, b);                     \
+      d = ROR64c(d ^ a, 16);                \
+      c = BLAMKA(c, d);                     \
+      b = ROR64c(b ^ c, 63);                \
+   } while (0)
+
+/* the permutation P of the 16 words v[i0 + (k / 2) * s2 + (k % 2) * s1], k = 0..15 */
+#define P(v, i0, s1, s2)                                                                \
+   do {                                                                                 \
+      GB(v[i0],          v[i0 + 2*s2],      v[i0 + 4*s2],      v[i0 + 6*s2]);           \
+      GB(v[i0 + s1],     v[i0 + 2*s2 + s1], v[i0 + 4*s2 + s1], v[i0 + 6*s2 + s1]);      \
+      GB(v[i0 + s2],     v[i0 + 3*s2],      v[i0 + 5*s2],      v[i0 + 7*s2]);           \
+      GB(v[i0 + s2 + s1], v[i0 + 3*s2 + s1], v[i0 + 5*s2 + s1], v[i0 + 7*s2 + s1]);     \
+      GB(v[i0],          v[i0 + 2*s2 + s1], v[i0 + 5*s2],      v[i0 + 7*s2 + s1]);      \
+      GB(v[i0 + s1],     v[i0 + 3*s2],      v[i0 + 5*s2 + s1], v[i0 + 6*s2]);           \
+      GB(v[i0 + s2],     v[i0 + 3*s2 + s1], v[i0 + 4*s2],      v[i0 + 6*s2 + s1]);      \
+      GB(v[i0 + s2 + s1], v[i0 + 2*s2],      v[i0 + 4*s2 + s1], v[i0 + 7*s2]);          \
+   } while (0)
+
+/* next = G(prev, ref), or next ^= G(prev, ref) if with_xor is set */
+static void _argon2_fill_block(ulong64 *next, const ulong64 *prev, const ulong64 *ref, int with_xor)
+{
+   ulong64 R[ARGON2_BLOCK_WORDS], Q[ARGON2_BLOCK_WORDS];
+   int i;
+
+#ifdef LTC_BLAKE2_SIMD
+   if (ltc_cpu_has(LTC_CPU_AVX2)) {
+      argon2_avx2_fill_block(next, prev, ref, with_xor);
+      return;
+   }
+#endif
+
+   for (i = 0; i < ARGON2_BLOCK_WORDS; i++) {
+      R[i] = prev[i] ^ ref[i];
+      Q[i] = with_xor ? R[i] ^ next[i] : R[i];
+   }
+   /* the rows of 16 words */
+   for (i = 0; i < 8; i++) {
+      P(R, 16 * i, 1, 2);
+   }
+   /* the columns of two words */
+   for (i = 0; i < 8; i++) {
+      P(R, 2 * i, 1, 16);
+   }
+   for (i = 0; i < ARGON2_BLOCK_WORDS; i++) {
+      next[i] = R[i] ^ Q[i];
+   }
+
+#ifdef LTC_CLEAN_STACK
+   zeromem(R, sizeof(R));
+   zeromem(Q, sizeof(Q));
+#endif
+}
+
+static int _argon2_le32(hash_state *md, unsigned long x)
+{
+   unsigned char buf[4];
+   STORE32L(x, buf);
+   return blake2b_process(md, buf, 4);
+}
+
+/* the variable length hash H' of the octets of in */
+static int _argon2_hprime(unsigned char *out, unsigned long outlen, const unsigned char *in, unsigned long inlen)
+{
+   hash_state md;
+   unsigned char v[64];
+   unsigned long r;
+   int err;
+
+   if ((err = blake2b_init(&md, outlen <= 64 ? outlen : 64, NULL, 0)) != CRYPT_OK) {
+      return err;
+   }
+   if ((err = _argon2_le32(&md, outlen)) != CRYPT_OK) {
+      return err;
+   }
+   if ((err = blake2b_process(&md, in, inlen)) != CRYPT_OK) {
+      return err;
+   }
+   if (outlen <= 64) {
+      return blake2b_done(&md, out);
+   }
+
+   /* the first halves of V_1 .. V_r and all of V_r+1 */
+   if ((err = blake2b_done(&md, v)) != CRYPT_OK) {
+      return err;
+   }
+   for (r = (outlen + 31) / 32 - 2; r > 1; r--) {
+      XMEMCPY(out, v, 32);
+      out    += 32;
+      outlen -= 32;
+      if ((err = blake2b_init(&md, 64, NULL, 0)) != CRYPT_OK) {
+         goto LBL_ERR;
+      }
+      if ((err = blake2b_process(&md, v, 64)) != CRYPT_OK) {
+         goto LBL_ERR;
+      }
+      if ((err = blake2b_done(&md, v)) != CRYPT_OK) {
+         goto LBL_ERR;
+      }
+   }
+   XMEMCPY(out, v, 32);
+   out    += 32;
+   outlen -= 32;
+   if ((err = blake2b_init(&md, outlen, NULL, 0)) != CRYPT_OK) {
+      goto LBL_ERR;
+   }
+   if ((err = blake2b_process(&md, v, 64)) != CRYPT_OK) {
+      goto LBL_ERR;
+   }
+   err = blake2b_done(&md, out);
+
+LBL_ERR:
+#ifdef LTC_CLEAN_STACK
+   zeromem(v, sizeof(v));
+#endif
+   return err;
+}
+
+/* the next 128 pseudo-random values of the data-independent addressing */
+static void _argon2_next_addresses(ulong64 *address, ulong64 *input, const ulong64 *zero)
+{
+   input[6]++;
+   _argon2_fill_block(address, zero, input, 0);
+   _argon2_fill_block(address, zero, address, 0);
+}
+
+/* fill the segment of a lane in a slice of a pass */
+static void _argon2_fill_segment(const argon2_instance *inst, unsigned long pass, unsigned long lane,
+                                 unsigned long slice)
+{
+   ulong64 zero[ARGON2_BLOCK_WORDS], input[ARGON2_BLOCK_WORDS], address[ARGON2_BLOCK_WORDS];
+   ulong64 rnd, x, area;
+   unsigned long index, start, offset, prev, ref_lane, ref_index;
+   int independent;
+
+   independent = inst->type == ARGON2_I || (inst->type == ARGON2_ID && pass == 0 && slice < ARGON2_SYNC_POINTS / 2);
+   if (independent) {
+      XMEMSET(zero, 0, sizeof(zero));
+      XMEMSET(input, 0, sizeof(input));
+      input[0] = pass;
+      input[1] = lane;
+      input[2] = slice;
+      input[3] = (ulong64)inst->lanes * inst->lane_length;
+      input[4] = inst->passes;
+      input[5] = (ulong64)inst->type;
+   }
+
+   /* the first two blocks of a lane are set by the initialization */
+   start = (pass == 0 && slice == 0) ? 2 : 0;
+   if (independent && start != 0) {
+      _argon2_next_addresses(address, input, zero);
+   }
+
+   for (index = start; index < inst->segment_length; index++) {
+      offset = lane * inst->lane_length + slice * inst->segment_length + index;
+      prev = (offset % inst->lane_length == 0) ? offset + inst->lane_length - 1 : offset - 1;
+
+      if (independent) {
+         if (index % ARGON2_BLOCK_WORDS == 0) {
+            _argon2_next_addresses(address, input, zero);
+         }
+         rnd = address[index % ARGON2_BLOCK_WORDS];
+      } else {
+         rnd = inst->memory[prev * ARGON2_BLOCK_WORDS];
+      }
+
+      /* the first slice of the first pass only refers to its own lane */
+      ref_lane = (pass == 0 && slice == 0) ? lane : (unsigned long)((rnd >> 32) % inst->lanes);
+
+      /* the number of blocks which may be referenced, the finished segments and the blocks before this one */
+      if (pass == 0) {
+         area = (ulong64)slice * inst->segment_length;
+      } else {
+         area = inst->lane_length - inst->segment_length;
+      }
+      if (ref_lane == lane) {
+         area += index - 1;
+      } else if (index == 0) {
+         area -= 1;
+      }
+
+      /* a reference biased towards the recent blocks */
+      x = rnd & CONST64(0xFFFFFFFF);
+      x = (x * x) >> 32;
+      x = area - 1 - ((area * x) >> 32);
+      if (pass != 0 && slice != ARGON2_SYNC_POINTS - 1) {
+         x += (ulong64)(slice + 1) * inst->segment_length;
+      }
+      ref_index = (unsigned long)(x % inst->lane_length);
+
+      _argon2_fill_block(inst->memory + offset * ARGON2_BLOCK_WORDS,
+                         inst->memory + prev * ARGON2_BLOCK_WORDS,
+                         inst->memory + (ref_lane * inst->lane_length + ref_index) * ARGON2_BLOCK_WORDS,
+                         pass != 0);
+   }
+
+#ifdef LTC_CLEAN_STACK
+   if (independent) {
+      zeromem(input, sizeof(input));
+      zeromem(address, sizeof(address));
+   }
+#endif
+}
+
+#ifdef LTC_PTHREAD
+typedef struct {
+   const argon2_instance *inst;
+   unsigned long pass, lane, slice;
+} argon2_thread_arg;
+
+static void* _argon2_thread(void *arg)
+{
+   const argon2_thread_arg *a = arg;
+   _argon2_fill_segment(a->inst, a->pass, a->lane, a->slice);
+   return NULL;
+}
+#endif
+
+/* all passes over the memory, the lanes of a slice in parallel with LTC_PTHREAD */
+static int _argon2_fill_memory(const argon2_instance *inst)
+{
+   unsigned long pass, slice, lane;
+#ifdef LTC_PTHREAD
+   pthread_t *thread;
+   argon2_thread_arg *arg;
+   unsigned char *started;
+
+   if (inst->lanes > 1) {
+      thread  = XMALLOC(inst->lanes * sizeof(*thread));
+      arg     = XMALLOC(inst->lanes * sizeof(*arg));
+      started = XMALLOC(inst->lanes);
+      if (thread == NULL || arg == NULL || started == NULL) {
+         if (thread != NULL) {
+            XFREE(thread);
+         }
+         if (arg != NULL) {
+            XFREE(arg);
+         }
+         if (started != NULL) {
+            XFREE(started);
+         }
+         return CRYPT_MEM;
+      }
+      for (pass = 0; pass < inst->passes; pass++) {
+         for (slice = 0; slice < ARGON2_SYNC_POINTS; slice++) {
+            /* lane 0 is filled by this thread, a lane whose thread can't be started as well */
+            for (lane = 1; lane < inst->lanes; lane++) {
+               arg[lane].inst  = inst;
+               arg[lane].pass  = pass;
+               arg[lane].lane  = lane;
+               arg[lane].slice = slice;
+               started[lane] = pthread_create(&thread[lane], NULL, _argon2_thread, &arg[lane]) == 0;
+            }
+            _argon2_fill_segment(inst, pass, 0, slice);
+            for (lane = 1; lane < inst->lanes; lane++) {
+               if (started[lane]) {
+                  pthread_join(thread[lane], NULL);
+               } else {
+                  _argon2_fill_segment(inst, pass, lane, slice);
+               }
+            }
+         }
+      }
+      XFREE(thread);
+      XFREE(arg);
+      XFREE(started);
+      return CRYPT_OK;
+   }
+#endif
+
+   for (pass = 0; pass < inst->passes; pass++) {
+      for (slice = 0; slice < ARGON2_SYNC_POINTS; slice++) {
+         for (lane = 0; lane < inst->lanes; lane++) {
+            _argon2_fill_segment(inst, pass, lane, slice);
+         }
+      }
+   }
+   return CRYPT_OK;
+}
+
+/**
+   Argon2 password hashing
+   @param type          ARGON2_D, ARGON2_I or ARGON2_ID
+   @param t_cost        The number of passes over the memory, at least 1
+   @param m_cost        The memory size in KiB, at least 8 * parallelism
+   @param parallelism   The number of lanes, 1 to 2^24 - 1
+   @param pwd           The password
+   @param pwdlen        The length of the password (octets)
+   @param salt          The salt
+   @param saltlen       The length of the salt (octets), at least 8
+   @param secret        The optional secret key (may be NULL if secretlen is 0)
+   @param secretlen     The length of the secret key (octets)
+   @param ad            The optional associated data (may be NULL if adlen is 0)
+   @param adlen         The length of the associated data (octets)
+   @param out           [out] The tag
+   @param outlen        The length of the tag (octets), at least 4
+   @return CRYPT_OK if successful
+*/
+int argon2_hash(argon2_type type,
+                unsigned long t_cost, unsigned long m_cost, unsigned long parallelism,
+                const unsigned char *pwd,    unsigned long pwdlen,
+                const unsigned char *salt,   unsigned long saltlen,
+                const unsigned char *secret, unsigned long secretlen,
+                const unsigned char *ad,     unsigned long adlen,
+                      unsigned char *out,    unsigned long outlen)
+{
+   argon2_instance inst;
+   hash_state md;
+   unsigned char h0[64 + 8], *buf;
+   unsigned long blocks, lane, i, j;
+   int err;
+
+   LTC_ARGCHK(pwd  != NULL || pwdlen == 0);
+   LTC_ARGCHK(salt != NULL);
+   LTC_ARGCHK(secret != NULL || secretlen == 0);
+   LTC_ARGCHK(ad   != NULL || adlen == 0);
+   LTC_ARGCHK(out  != NULL);
+
+   if (type != ARGON2_D && type != ARGON2_I && type != ARGON2_ID) {
+      return CRYPT_INVALID_ARG;
+   }
+   if (t_cost < 1 || parallelism < 1 || parallelism > 0xFFFFFFUL || m_cost / 8 < parallelism ||
+       saltlen < 8 || outlen < 4) {
+      return CRYPT_INVALID_ARG;
+   }
+   if ((t_cost | m_cost | pwdlen | saltlen | secretlen | adlen | outlen) > 0xFFFFFFFFUL) {
+      return CRYPT_INVALID_ARG;
+   }
+
+   /* the memory size is rounded down to a multiple of 4 * parallelism blocks */
+   inst.type           = type;
+   inst.passes         = t_cost;
+   inst.lanes          = parallelism;
+   inst.segment_length = m_cost / (ARGON2_SYNC_POINTS * parallelism);
+   inst.lane_length    = inst.segment_length * ARGON2_SYNC_POINTS;
+   blocks              = inst.lane_length * parallelism;
+   if (blocks > ((size_t)-1) / (ARGON2_BLOCK_WORDS * sizeof(ulong64))) {
+      return CRYPT_MEM;
+   }
+   inst.memory = XMALLOC(blocks * ARGON2_BLOCK_WORDS * sizeof(ulong64));
+   buf         = XMALLOC(ARGON2_BLOCK_WORDS * sizeof(ulong64));
+   if (inst.memory == NULL || buf == NULL) {
+      if (inst.memory != NULL) {
+         XFREE(inst.memory);
+      }
+      if (buf != NULL) {
+         XFREE(buf);
+      }
+      return CRYPT_MEM;
+   }
+
+   /* H_0 of the parameters and the inputs */
+   if ((err = blake2b_init(&md, 64, NULL, 0)) != CRYPT_OK)                       goto LBL_ERR;
+   if ((err = _argon2_le32(&md, parallelism)) != CRYPT_OK)                       goto LBL_ERR;
+   if ((err = _argon2_le32(&md, outlen)) != CRYPT_OK)                            goto LBL_ERR;
+   if ((err = _argon2_le32(&md, m_cost)) != CRYPT_OK)                            goto LBL_ERR;
+   if ((err = _argon2_le32(&md, t_cost)) != CRYPT_OK)                            goto LBL_ERR;
+   if ((err = _argon2_le32(&md, ARGON2_VERSION)) != CRYPT_OK)                    goto LBL_ERR;
+   if ((err = _argon2_le32(&md, (unsigned long)type)) != CRYPT_OK)               goto LBL_ERR;
+   if ((err = _argon2_le32(&md, pwdlen)) != CRYPT_OK)                            goto LBL_ERR;
+   if (pwdlen > 0 && (err = blake2b_process(&md, pwd, pwdlen)) != CRYPT_OK)      goto LBL_ERR;
+   if ((err = _argon2_le32(&md, saltlen)) != CRYPT_OK)                           goto LBL_ERR;
+   if ((err = blake2b_process(&md, salt, saltlen)) != CRYPT_OK)                  goto LBL_ERR;
+   if ((err = _argon2_le32(&md, secretlen)) != CRYPT_OK)                         goto LBL_ERR;
+   if (secretlen > 0 && (err = blake2b_process(&md, secret, secretlen)) != CRYPT_OK) goto LBL_ERR;
+   if ((err = _argon2_le32(&md, adlen)) != CRYPT_OK)                             goto LBL_ERR;
+   if (adlen > 0 && (err = blake2b_process(&md, ad, adlen)) != CRYPT_OK)         goto LBL_ERR;
+   if ((err = blake2b_done(&md, h0)) != CRYPT_OK)                                goto LBL_ERR;
+
+   /* the first two blocks of each lane, H'(H_0 || LE32(j) || LE32(lane)) */
+   for (lane = 0; lane < parallelism; lane++) {
+      for (j = 0; j < 2; j++) {
+         STORE32L(j, h0 + 64);
+         STORE32L(lane, h0 + 68);
+         if ((err = _argon2_hprime(buf, ARGON2_BLOCK_WORDS * 8, h0, sizeof(h0))) != CRYPT_OK) {
+            goto LBL_ERR;
+         }
+         for (i = 0; i < ARGON2_BLOCK_WORDS; i++) {
+            LOAD64L(inst.memory[(lane * inst.lane_length + j) * ARGON2_BLOCK_WORDS + i], buf + 8 * i);
+         }
+      }
+   }
+
+   if ((err = _argon2_fill_memory(&inst)) != CRYPT_OK) {
+      goto LBL_ERR;
+   }
+
+   /* the tag is H' of the XOR of the last blocks of all lanes */
+   for (lane = 1; lane < parallelism; lane++) {
+      for (i = 0; i < ARGON2_BLOCK_WORDS; i++) {
+         inst.memory[(inst.lane_length - 1) * ARGON2_BLOCK_WORDS + i] ^=
+            inst.memory[((lane + 1) * inst.lane_length - 1) * ARGON2_BLOCK_WORDS + i];
+      }
+   }
+   for (i = 0; i < ARGON2_BLOCK_WORDS; i++) {
+      STORE64L(inst.memory[(inst.lane_length - 1) * ARGON2_BLOCK_WORDS + i], buf + 8 * i);
+   }
+   err = _argon2_hprime(out, outlen, buf, ARGON2_BLOCK_WORDS * 8);
+
+LBL_ERR:
+#ifdef LTC_CLEAN_STACK
+   zeromem(inst.memory, blocks * ARGON2_BLOCK_WORDS * sizeof(ulong64));
+   zeromem(buf, ARGON2_BLOCK_WORDS * sizeof(ulong64));
+   zeromem(h0, sizeof(h0));
+   zeromem(&md, sizeof(md));
+#endif
+   XFREE(inst.memory);
+   XFREE(buf);
+   return err;
+}
+
+#endif
+
+/* ref:         $Format:%D$ */
+/* git commit:  $Format:%H$ */
+/* commit time: $Format:%ai$ */
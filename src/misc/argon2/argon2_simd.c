@@ -0,0 +1,133 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ */
+
+/**
+   @file argon2_simd.c
+   The compression function of Argon2 using the AVX2 instructions of x86-64 CPUs
+
+   The block is held in 32 registers, four per row of 16 words.  The rounds
+   on the rows work like those of BLAKE2b, one row of the state matrix per
+   register.  For the rounds on the columns the two word halves of the rows
+   are regrouped with 128-bit permutes, two columns at a time.
+*/
+#include "tomcrypt_private.h"
+
+#if defined(LTC_ARGON2) && defined(LTC_BLAKE2_SIMD)
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+/* the AVX-512 macros of GCC mix declarations and code */
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wdeclaration-after-statement"
+#endif
+#include <immintrin.h>
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+#endif
+
+#define AVX2_TARGET LTC_ATTRIBUTE_TARGET("avx2")
+
+#define AVX2_LOAD(p)      _mm256_loadu_si256((const __m256i *)(const void *)(p))
+#define AVX2_STORE(p, v)  _mm256_storeu_si256((__m256i *)(void *)(p), (v))
+
+/* x = x + y + 2 * lo32(x) * lo32(y) */
+#define BLAMKA(x, y)                                                        \
+   t = _mm256_mul_epu32((x), (y));                                          \
+   x = _mm256_add_epi64(_mm256_add_epi64((x), (y)), _mm256_add_epi64(t, t));
+
+/* four G functions, on the columns or on the diagonals */
+#define G4(a, b, c, d)                                                      \
+   BLAMKA(a, b)                                                             \
+   d = _mm256_shuffle_epi32(_mm256_xor_si256(d, a), _MM_SHUFFLE(2, 3, 0, 1)); \
+   BLAMKA(c, d)                                                             \
+   b = _mm256_shuffle_epi8(_mm256_xor_si256(b, c), rot24);                  \
+   BLAMKA(a, b)                                                             \
+   d = _mm256_shuffle_epi8(_mm256_xor_si256(d, a), rot16);                  \
+   BLAMKA(c, d)                                                             \
+   b = _mm256_xor_si256(b, c);                                              \
+   b = _mm256_xor_si256(_mm256_srli_epi64(b, 63), _mm256_add_epi64(b, b));
+
+/* the permutation P of 16 words, v0..v3 in a, v4..v7 in b ... */
+#define ROUND(a, b, c, d)                                                   \
+   G4(a, b, c, d)                                                           \
+   b = _mm256_permute4x64_epi64(b, _MM_SHUFFLE(0, 3, 2, 1));                \
+   c = _mm256_permute4x64_epi64(c, _MM_SHUFFLE(1, 0, 3, 2));                \
+   d = _mm256_permute4x64_epi64(d, _MM_SHUFFLE(2, 1, 0, 3));                \
+   G4(a, b, c, d)                                                           \
+   b = _mm256_permute4x64_epi64(b, _MM_SHUFFLE(2, 1, 0, 3));                \
+   c = _mm256_permute4x64_epi64(c, _MM_SHUFFLE(1, 0, 3, 2));                \
+   d = _mm256_permute4x64_epi64(d, _MM_SHUFFLE(0, 3, 2, 1));
+
+/**
+  Compute a block of Argon2 with AVX2
+  @param next      [in/out] The new block, XORed into if with_xor is set
+  @param prev      The previous block
+  @param ref       The reference block, may be the same as next
+  @param with_xor  Non-zero if the result is XORed into the old value of next
+*/
+AVX2_TARGET
+void argon2_avx2_fill_block(ulong64 *next, const ulong64 *prev, const ulong64 *ref, int with_xor)
+{
+   __m256i R[32], Q[32], a[2], b[2], c[2], d[2], t, rot16, rot24;
+   int i, j;
+
+   rot16 = _mm256_setr_epi8(2, 3, 4, 5, 6, 7, 0, 1, 10, 11, 12, 13, 14, 15, 8, 9,
+                            2, 3, 4, 5, 6, 7, 0, 1, 10, 11, 12, 13, 14, 15, 8, 9);
+   rot24 = _mm256_setr_epi8(3, 4, 5, 6, 7, 0, 1, 2, 11, 12, 13, 14, 15, 8, 9, 10,
+                            3, 4, 5, 6, 7, 0, 1, 2, 11, 12, 13, 14, 15, 8, 9, 10);
+
+   for (i = 0; i < 32; i++) {
+      R[i] = Q[i] = _mm256_xor_si256(AVX2_LOAD(prev + 4 * i), AVX2_LOAD(ref + 4 * i));
+   }
+   if (with_xor) {
+      for (i = 0; i < 32; i++) {
+         Q[i] = _mm256_xor_si256(Q[i], AVX2_LOAD(next + 4 * i));
+      }
+   }
+
+   /* the rows, R[4 * i + j] holds the words 4j..4j+3 of the row i */
+   for (i = 0; i < 8; i++) {
+      ROUND(R[4 * i], R[4 * i + 1], R[4 * i + 2], R[4 * i + 3])
+   }
+
+   /* the columns 2j and 2j+1, the words of two rows make one register */
+   for (j = 0; j < 4; j++) {
+      a[0] = _mm256_permute2x128_si256(R[j],      R[4 + j],  0x20);
+      a[1] = _mm256_permute2x128_si256(R[j],      R[4 + j],  0x31);
+      b[0] = _mm256_permute2x128_si256(R[8 + j],  R[12 + j], 0x20);
+      b[1] = _mm256_permute2x128_si256(R[8 + j],  R[12 + j], 0x31);
+      c[0] = _mm256_permute2x128_si256(R[16 + j], R[20 + j], 0x20);
+      c[1] = _mm256_permute2x128_si256(R[16 + j], R[20 + j], 0x31);
+      d[0] = _mm256_permute2x128_si256(R[24 + j], R[28 + j], 0x20);
+      d[1] = _mm256_permute2x128_si256(R[24 + j], R[28 + j], 0x31);
+      ROUND(a[0], b[0], c[0], d[0])
+      ROUND(a[1], b[1], c[1], d[1])
+      R[j]      = _mm256_permute2x128_si256(a[0], a[1], 0x20);
+      R[4 + j]  = _mm256_permute2x128_si256(a[0], a[1], 0x31);
+      R[8 + j]  = _mm256_permute2x128_si256(b[0], b[1], 0x20);
+      R[12 + j] = _mm256_permute2x128_si256(b[0], b[1], 0x31);
+      R[16 + j] = _mm256_permute2x128_si256(c[0], c[1], 0x20);
+      R[20 + j] = _mm256_permute2x128_si256(c[0], c[1], 0x31);
+      R[24 + j] = _mm256_permute2x128_si256(d[0], d[1], 0x20);
+      R[28 + j] = _mm256_permute2x128_si256(d[0], d[1], 0x31);
+   }
+
+   for (i = 0; i < 32; i++) {
+      AVX2_STORE(next + 4 * i, _mm256_xor_si256(R[i], Q[i]));
+   }
+}
+
+#endif
+
+/* ref:         $Format:%D$ */
+/* git commit:  $Format:%H$ */
+/* commit time: $Format:%ai$ */
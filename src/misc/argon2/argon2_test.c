@@ -0,0 +1,120 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ */
+#include "tomcrypt_private.h"
+
+/**
+  @file argon2_test.c
+  Argon2 support, self-test
+*/
+
+#ifdef LTC_ARGON2
+
+/*
+    TEST CASES SOURCE:
+
+RFC 9106, Argon2 Memory-Hard Function for Password Hashing and
+Proof-of-Work Applications, Section 5. Test Vectors
+
+    The other cases are from an independent implementation and cover the
+    longer tags, memory sizes which are rounded down and the regeneration
+    of the addresses.
+*/
+
+/**
+  Argon2 self-test
+  @return CRYPT_OK if successful, CRYPT_NOP if tests have been disabled.
+*/
+int argon2_test(void)
+{
+ #ifndef LTC_TEST
+    return CRYPT_NOP;
+ #else
+    static const unsigned char pwd[32] = {
+       0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01,
+       0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01
+    };
+    static const unsigned char salt[16] = {
+       0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02
+    };
+    static const unsigned char secret[8] = {
+       0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03
+    };
+    static const unsigned char ad[12] = {
+       0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04
+    };
+    static const struct {
+       argon2_type type;
+       unsigned long t_cost, m_cost, parallelism;
+       int rfc;
+       unsigned long outlen;
+       unsigned char out[100];
+    } tests[] = {
+       { ARGON2_D, 3, 32, 4, 1, 32,
+         { 0x51, 0x2b, 0x39, 0x1b, 0x6f, 0x11, 0x62, 0x97, 0x53, 0x71, 0xd3, 0x09, 0x19, 0x73, 0x42, 0x94,
+           0xf8, 0x68, 0xe3, 0xbe, 0x39, 0x84, 0xf3, 0xc1, 0xa1, 0x3a, 0x4d, 0xb9, 0xfa, 0xbe, 0x4a, 0xcb } },
+       { ARGON2_I, 3, 32, 4, 1, 32,
+         { 0xc8, 0x14, 0xd9, 0xd1, 0xdc, 0x7f, 0x37, 0xaa, 0x13, 0xf0, 0xd7, 0x7f, 0x24, 0x94, 0xbd, 0xa1,
+           0xc8, 0xde, 0x6b, 0x01, 0x6d, 0xd3, 0x88, 0xd2, 0x99, 0x52, 0xa4, 0xc4, 0x67, 0x2b, 0x6c, 0xe8 } },
+       { ARGON2_ID, 3, 32, 4, 1, 32,
+         { 0x0d, 0x64, 0x0d, 0xf5, 0x8d, 0x78, 0x76, 0x6c, 0x08, 0xc0, 0x37, 0xa3, 0x4a, 0x8b, 0x53, 0xc9,
+           0xd0, 0x1e, 0xf0, 0x45, 0x2d, 0x75, 0xb6, 0x5e, 0xb5, 0x25, 0x20, 0xe9, 0x6b, 0x01, 0xe6, 0x59 } },
+       { ARGON2_ID, 2, 70, 2, 0, 100,
+         { 0x62, 0x5a, 0x69, 0xc7, 0x8a, 0x15, 0x2c, 0xf7, 0x86, 0x91, 0x3d, 0x2b, 0x33, 0xa2, 0x5e, 0x37,
+           0xc9, 0xe0, 0x04, 0x89, 0xb3, 0xa0, 0xe1, 0xba, 0x0a, 0x22, 0x8e, 0x01, 0xac, 0x68, 0xcd, 0x73,
+           0xaf, 0x4d, 0xd1, 0xfa, 0x4f, 0x42, 0x88, 0xa6, 0xa7, 0x48, 0x19, 0x20, 0x11, 0xbd, 0xed, 0x73,
+           0x7c, 0xb1, 0x1c, 0xab, 0x81, 0xbb, 0x57, 0xca, 0x02, 0x98, 0xa2, 0xe0, 0x66, 0xb9, 0x18, 0xed,
+           0xe5, 0xba, 0x2a, 0x4f, 0x17, 0xff, 0x54, 0xfa, 0x88, 0xb6, 0x7d, 0x9a, 0x5d, 0xa8, 0xe3, 0x63,
+           0x1c, 0xf0, 0x94, 0x41, 0x03, 0x18, 0x15, 0xff, 0x10, 0xb0, 0xc3, 0x6c, 0x5c, 0x93, 0x18, 0xdb,
+           0xab, 0xb3, 0xe1, 0x2e } },
+       { ARGON2_I, 2, 600, 1, 0, 32,
+         { 0x37, 0x43, 0xdd, 0x96, 0x3f, 0x94, 0x75, 0x09, 0x9a, 0x19, 0xe1, 0x6b, 0x09, 0x0f, 0xf2, 0x59,
+           0x8b, 0x78, 0x9f, 0x4c, 0x16, 0xae, 0x27, 0x13, 0xa3, 0x5e, 0x16, 0x44, 0x94, 0x66, 0x5d, 0x78 } },
+    };
+    unsigned char out[100];
+    int i, j, err;
+#ifdef LTC_BLAKE2_SIMD
+    unsigned long mask;
+#endif
+
+    for (i = 0; i < (int)(sizeof(tests) / sizeof(tests[0])); i++) {
+       /* the second time without the SIMD compression */
+       for (j = 0; j < 2; j++) {
+#ifdef LTC_BLAKE2_SIMD
+          mask = ltc_cpu_mask(j == 0 ? ~0UL : 0);
+#endif
+          if (tests[i].rfc) {
+             err = argon2_hash(tests[i].type, tests[i].t_cost, tests[i].m_cost, tests[i].parallelism,
+                               pwd, sizeof(pwd), salt, sizeof(salt), secret, sizeof(secret), ad, sizeof(ad),
+                               out, tests[i].outlen);
+          } else {
+             err = argon2_hash(tests[i].type, tests[i].t_cost, tests[i].m_cost, tests[i].parallelism,
+                               (const unsigned char *)"password", 8, (const unsigned char *)"somesalt", 8,
+                               NULL, 0, NULL, 0, out, tests[i].outlen);
+          }
+#ifdef LTC_BLAKE2_SIMD
+          ltc_cpu_mask(mask);
+#endif
+          if (err != CRYPT_OK) {
+             return err;
+          }
+          if (compare_testvector(out, tests[i].outlen, tests[i].out, tests[i].outlen, "Argon2", i * 2 + j)) {
+             return CRYPT_FAIL_TESTVECTOR;
+          }
+       }
+    }
+
+    return CRYPT_OK;
+ #endif
+}
+
+#endif
+
+/* ref:         $Format:%D$ */
+/* git commit:  $Format:%H$ */
+/* commit time: $Format:%ai$ */
@@ -63,7 +63,14 @@ const char *crypt_build_settings =
    "   Safer\n"
 #endif
 #if defined(LTC_RIJNDAEL)
-   "   Rijndael\n"
+   "   Rijndael"
+#if defined(LTC_AES_NI)
+   " (AES-NI)"
+#endif
+#if defined(LTC_AES_BITSLICE)
+   " (bitsliced)"
+#endif
+   "\n"
 #endif
 #if defined(LTC_XTEA)
    "   XTEA\n"
@@ -130,7 +137,11 @@ const char *crypt_build_settings =
 #endif
    "Stream ciphers built-in:\n"
 #if defined(LTC_CHACHA)
-   "   ChaCha\n"
+   "   ChaCha"
+#if defined(LTC_CHACHA_SIMD)
+   " (SIMD)"
+#endif
+   "\n"
 #endif
 #if defined(LTC_SALSA20)
    "   Salsa20\n"
@@ -153,13 +164,21 @@ const char *crypt_build_settings =
 
     "\nHashes built-in:\n"
 #if defined(LTC_SHA3)
-   "   SHA3\n"
+   "   SHA3"
+#if defined(LTC_SHA3_MB)
+   " (multi-buffer)"
+#endif
+   "\n"
 #endif
 #if defined(LTC_KECCAK)
    "   KECCAK\n"
 #endif
 #if defined(LTC_SHA512)
-   "   SHA-512\n"
+   "   SHA-512"
+#if defined(LTC_SHA512_AVX2)
+   " (AVX2)"
+#endif
+   "\n"
 #endif
 #if defined(LTC_SHA384)
    "   SHA-384\n"
@@ -168,7 +187,14 @@ const char *crypt_build_settings =
    "   SHA-512/256\n"
 #endif
 #if defined(LTC_SHA256)
-   "   SHA-256\n"
+   "   SHA-256"
+#if defined(LTC_SHA_NI)
+   " (SHA-NI)"
+#endif
+#if defined(LTC_SHA256_MB)
+   " (multi-buffer)"
+#endif
+   "\n"
 #endif
 #if defined(LTC_SHA512_224)
    "   SHA-512/224\n"
@@ -180,7 +206,11 @@ const char *crypt_build_settings =
    "   TIGER\n"
 #endif
 #if defined(LTC_SHA1)
-   "   SHA1\n"
+   "   SHA1"
+#if defined(LTC_SHA_NI)
+   " (SHA-NI)"
+#endif
+   "\n"
 #endif
 #if defined(LTC_MD5)
    "   MD5\n"
@@ -207,10 +237,24 @@ const char *crypt_build_settings =
    "   WHIRLPOOL\n"
 #endif
 #if defined(LTC_BLAKE2S)
-   "   BLAKE2S\n"
+   "   BLAKE2S"
+#if defined(LTC_BLAKE2_SIMD)
+   " (SSE4.1)"
+#endif
+   "\n"
 #endif
 #if defined(LTC_BLAKE2B)
-   "   BLAKE2B\n"
+   "   BLAKE2B"
+#if defined(LTC_BLAKE2_SIMD)
+   " (AVX2)"
+#endif
+   "\n"
+#endif
+#if defined(LTC_BLAKE2SP)
+   "   BLAKE2SP\n"
+#endif
+#if defined(LTC_BLAKE2BP)
+   "   BLAKE2BP\n"
 #endif
 #if defined(LTC_CHC_HASH)
    "   CHC_HASH\n"
@@ -266,7 +310,14 @@ const char *crypt_build_settings =
     "   F9\n"
 #endif
 #if defined(LTC_POLY1305)
-    "   POLY1305\n"
+    "   POLY1305"
+#if defined(LTC_POLY1305_R44)
+    " (r44)"
+#endif
+#if defined(LTC_POLY1305_SIMD)
+    " (AVX2)"
+#endif
+    "\n"
 #endif
 #if defined(LTC_BLAKE2SMAC)
     "   BLAKE2S MAC\n"
@@ -293,13 +344,32 @@ const char *crypt_build_settings =
 #if defined(LTC_GCM_TABLES)
     " (tables) "
 #endif
+#if defined(LTC_GCM_TABLES_4BIT)
+    " (4-bit tables) "
+#endif
+#if defined(LTC_GCM_CTMUL)
+    " (CTMUL) "
+#endif
 #if defined(LTC_GCM_TABLES_SSE2)
     " (SSE2) "
+#endif
+#if defined(LTC_GCM_PCLMUL)
+    " (PCLMULQDQ) "
+#endif
+#if defined(LTC_GCM_AESNI)
+    " (AES-NI) "
+#endif
+#if defined(LTC_GCM_VAES)
+    " (VAES) "
 #endif
    "\n"
 #endif
 #if defined(LTC_CHACHA20POLY1305_MODE)
-    "   CHACHA20POLY1305\n"
+    "   CHACHA20POLY1305"
+#if defined(LTC_CHACHA20POLY1305_SIMD)
+    " (AVX2)"
+#endif
+    "\n"
 #endif
 
     "\nPRNG:\n"
@@ -400,6 +470,12 @@ const char *crypt_build_settings =
 #if defined(__x86_64__)
     "   x86-64 detected.\n"
 #endif
+#if defined(LTC_AMD64_SIMD)
+    "   LTC_AMD64_SIMD\n"
+#endif
+#if defined(LTC_AMD64_AVX512)
+    "   LTC_AMD64_AVX512\n"
+#endif
 #if defined(LTC_PPC32)
     "   PPC32 detected.\n"
 #endif
@@ -448,6 +524,18 @@ const char *crypt_build_settings =
 #if defined(LTC_HKDF)
     " HKDF "
 #endif
+#if defined(LTC_ARGON2)
+    " ARGON2 "
+#endif
+#if defined(LTC_SCRYPT)
+    " SCRYPT "
+#if defined(LTC_SCRYPT_SIMD)
+    " LTC_SCRYPT_SIMD "
+#endif
+#if defined(LTC_SCRYPT_THREADS)
+    " " NAME_VALUE(LTC_SCRYPT_THREADS) " "
+#endif
+#endif
 #if defined(LTC_PBES)
     " PBES1 "
     " PBES2 "
@@ -18,6 +18,8 @@ struct ltc_cipher_descriptor cipher_descriptor[TAB_SIZE] = {
  };
 
 LTC_MUTEX_GLOBAL(ltc_cipher_mutex)
+LTC_GEN_GLOBAL(ltc_cipher_gen)
+ltc_index_type ltc_cipher_index;
 
 
 /* ref:         $Format:%D$ */
@@ -20,12 +20,9 @@
 */
 int cipher_is_valid(int idx)
 {
-   LTC_MUTEX_LOCK(&ltc_cipher_mutex);
-   if (idx < 0 || idx >= TAB_SIZE || cipher_descriptor[idx].name == NULL) {
-      LTC_MUTEX_UNLOCK(&ltc_cipher_mutex);
+   if (idx < 0 || idx >= TAB_SIZE || LTC_ATOMIC_LOAD(cipher_descriptor[idx].name) == NULL) {
       return CRYPT_INVALID_CIPHER;
    }
-   LTC_MUTEX_UNLOCK(&ltc_cipher_mutex);
    return CRYPT_OK;
 }
 
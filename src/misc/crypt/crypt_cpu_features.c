@@ -0,0 +1,159 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ */
+#include "tomcrypt_private.h"
+
+/**
+  @file crypt_cpu_features.c
+  Runtime detection of the CPU features used by the SIMD code paths
+*/
+
+#ifdef LTC_AMD64_SIMD
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+
+static volatile int _cpu_detected = 0;
+static volatile unsigned long _cpu_features = 0;
+static volatile unsigned long _cpu_features_mask = ~0UL;
+
+static void _cpuid(ulong32 leaf, ulong32 subleaf, ulong32 regs[4])
+{
+#if defined(_MSC_VER)
+   int r[4];
+   __cpuidex(r, (int)leaf, (int)subleaf);
+   regs[0] = (ulong32)r[0];
+   regs[1] = (ulong32)r[1];
+   regs[2] = (ulong32)r[2];
+   regs[3] = (ulong32)r[3];
+#else
+   unsigned int a, b, c, d;
+   __cpuid_count(leaf, subleaf, a, b, c, d);
+   regs[0] = a;
+   regs[1] = b;
+   regs[2] = c;
+   regs[3] = d;
+#endif
+}
+
+/* the register state the OS saves on context switches */
+static ulong32 _cpu_xcr0(void)
+{
+#if defined(_MSC_VER)
+   unsigned __int64 xcr0 = _xgetbv(0);
+   return (ulong32)xcr0;
+#else
+   unsigned int a, d;
+   __asm__ __volatile__ ("xgetbv" : "=a"(a), "=d"(d) : "c"(0));
+   return a;
+#endif
+}
+
+static unsigned long _cpu_detect(void)
+{
+   ulong32 regs[4], max, xcr0 = 0;
+   unsigned long features = 0;
+
+   _cpuid(0, 0, regs);
+   max = regs[0];
+   if (max < 1) {
+      return 0;
+   }
+
+   _cpuid(1, 0, regs);
+   if (regs[3] & (1UL << 26)) {
+      features |= LTC_CPU_SSE2;
+   }
+   if (regs[2] & (1UL << 1)) {
+      features |= LTC_CPU_PCLMUL;
+   }
+   if (regs[2] & (1UL << 9)) {
+      features |= LTC_CPU_SSSE3;
+   }
+   if (regs[2] & (1UL << 19)) {
+      features |= LTC_CPU_SSE41;
+   }
+   if (regs[2] & (1UL << 25)) {
+      features |= LTC_CPU_AESNI;
+   }
+   /* OSXSAVE */
+   if (regs[2] & (1UL << 27)) {
+      xcr0 = _cpu_xcr0();
+   }
+
+   if (max < 7) {
+      return features;
+   }
+   _cpuid(7, 0, regs);
+   if (regs[1] & (1UL << 29)) {
+      features |= LTC_CPU_SHA;
+   }
+   /* the OS must save the XMM and YMM registers */
+   if ((xcr0 & 0x06) == 0x06) {
+      if (regs[1] & (1UL << 5)) {
+         features |= LTC_CPU_AVX2;
+      }
+      if (regs[2] & (1UL << 9)) {
+         features |= LTC_CPU_VAES;
+      }
+      if (regs[2] & (1UL << 10)) {
+         features |= LTC_CPU_VPCLMULQDQ;
+      }
+   }
+   /* ... and the opmask and ZMM registers */
+   if ((xcr0 & 0xE6) == 0xE6) {
+      /* AVX-512 F, BW and VL */
+      if ((regs[1] & 0xC0010000UL) == 0xC0010000UL) {
+         features |= LTC_CPU_AVX512;
+      }
+   }
+
+   return features;
+}
+
+/**
+   Check whether all of the given CPU features can be used
+   @param features   The required features (LTC_CPU_xxx flags)
+   @return 1 if all features are available, 0 otherwise
+*/
+int ltc_cpu_has(unsigned long features)
+{
+   if (_cpu_detected == 0) {
+      /* racing threads will all detect the same value */
+      _cpu_features = _cpu_detect();
+      _cpu_detected = 1;
+   }
+   return (_cpu_features & _cpu_features_mask & features) == features;
+}
+
+/**
+   Restrict the CPU features the library is allowed to use,
+   e.g. to test the generic code paths on a CPU supporting all extensions
+
+   The mask is global to the process and not protected by a lock.  It
+   affects all threads, and two threads which save and restore it at
+   overlapping times may leave it restricted.  Callers must serialize
+   their changes of the mask.
+   @param mask   The allowed features (LTC_CPU_xxx flags), ~0UL to allow all of them
+   @return The previous mask
+*/
+unsigned long ltc_cpu_mask(unsigned long mask)
+{
+   unsigned long prev = _cpu_features_mask;
+   _cpu_features_mask = mask;
+   return prev;
+}
+
+#endif
+
+/* ref:         $Format:%D$ */
+/* git commit:  $Format:%H$ */
+/* commit time: $Format:%ai$ */
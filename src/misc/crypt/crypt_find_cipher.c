@@ -21,16 +21,20 @@
 int find_cipher(const char *name)
 {
    int x;
+   unsigned long i, h, gen;
+   const char *n;
    LTC_ARGCHK(name != NULL);
-   LTC_MUTEX_LOCK(&ltc_cipher_mutex);
-   for (x = 0; x < TAB_SIZE; x++) {
-       if (cipher_descriptor[x].name != NULL && !XSTRCMP(cipher_descriptor[x].name, name)) {
-          LTC_MUTEX_UNLOCK(&ltc_cipher_mutex);
-          return x;
-       }
-   }
-   LTC_MUTEX_UNLOCK(&ltc_cipher_mutex);
-   return -1;
+   h = ltc_index_hash_name(name) % LTC_INDEX_SIZE;
+   do {
+      LTC_GEN_READ_BEGIN(ltc_cipher_gen, gen);
+      for (i = h; (x = ltc_cipher_index.name[i] - 1) >= 0; i = (i + 1) % LTC_INDEX_SIZE) {
+          n = LTC_ATOMIC_LOAD(cipher_descriptor[x].name);
+          if (n != NULL && !XSTRCMP(n, name)) {
+             break;
+          }
+      }
+   } while (LTC_GEN_READ_RETRY(ltc_cipher_gen, gen));
+   return x;
 }
 
 
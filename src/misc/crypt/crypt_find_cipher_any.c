@@ -23,24 +23,25 @@
 int find_cipher_any(const char *name, int blocklen, int keylen)
 {
    int x;
+   unsigned long gen;
 
    if(name != NULL) {
       x = find_cipher(name);
       if (x != -1) return x;
    }
 
-   LTC_MUTEX_LOCK(&ltc_cipher_mutex);
-   for (x = 0; x < TAB_SIZE; x++) {
-       if (cipher_descriptor[x].name == NULL) {
-          continue;
-       }
-       if (blocklen <= (int)cipher_descriptor[x].block_length && keylen <= (int)cipher_descriptor[x].max_key_length) {
-          LTC_MUTEX_UNLOCK(&ltc_cipher_mutex);
-          return x;
-       }
-   }
-   LTC_MUTEX_UNLOCK(&ltc_cipher_mutex);
-   return -1;
+   do {
+      LTC_GEN_READ_BEGIN(ltc_cipher_gen, gen);
+      for (x = 0; x < TAB_SIZE; x++) {
+          if (LTC_ATOMIC_LOAD(cipher_descriptor[x].name) == NULL) {
+             continue;
+          }
+          if (blocklen <= (int)cipher_descriptor[x].block_length && keylen <= (int)cipher_descriptor[x].max_key_length) {
+             break;
+          }
+      }
+   } while (LTC_GEN_READ_RETRY(ltc_cipher_gen, gen));
+   return (x < TAB_SIZE) ? x : -1;
 }
 
 /* ref:         $Format:%D$ */
@@ -21,16 +21,15 @@
 int find_cipher_id(unsigned char ID)
 {
    int x;
-   LTC_MUTEX_LOCK(&ltc_cipher_mutex);
-   for (x = 0; x < TAB_SIZE; x++) {
-       if (cipher_descriptor[x].ID == ID) {
-          x = (cipher_descriptor[x].name == NULL) ? -1 : x;
-          LTC_MUTEX_UNLOCK(&ltc_cipher_mutex);
-          return x;
-       }
-   }
-   LTC_MUTEX_UNLOCK(&ltc_cipher_mutex);
-   return -1;
+   unsigned long gen;
+   do {
+      LTC_GEN_READ_BEGIN(ltc_cipher_gen, gen);
+      x = ltc_cipher_index.id[ID] - 1;
+      if (x >= 0 && (LTC_ATOMIC_LOAD(cipher_descriptor[x].name) == NULL || cipher_descriptor[x].ID != ID)) {
+         x = -1;
+      }
+   } while (LTC_GEN_READ_RETRY(ltc_cipher_gen, gen));
+   return x;
 }
 
 /* ref:         $Format:%D$ */
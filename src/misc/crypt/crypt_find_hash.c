@@ -21,16 +21,20 @@
 int find_hash(const char *name)
 {
    int x;
+   unsigned long i, h, gen;
+   const char *n;
    LTC_ARGCHK(name != NULL);
-   LTC_MUTEX_LOCK(&ltc_hash_mutex);
-   for (x = 0; x < TAB_SIZE; x++) {
-       if (hash_descriptor[x].name != NULL && XSTRCMP(hash_descriptor[x].name, name) == 0) {
-          LTC_MUTEX_UNLOCK(&ltc_hash_mutex);
-          return x;
-       }
-   }
-   LTC_MUTEX_UNLOCK(&ltc_hash_mutex);
-   return -1;
+   h = ltc_index_hash_name(name) % LTC_INDEX_SIZE;
+   do {
+      LTC_GEN_READ_BEGIN(ltc_hash_gen, gen);
+      for (i = h; (x = ltc_hash_index.name[i] - 1) >= 0; i = (i + 1) % LTC_INDEX_SIZE) {
+          n = LTC_ATOMIC_LOAD(hash_descriptor[x].name);
+          if (n != NULL && XSTRCMP(n, name) == 0) {
+             break;
+          }
+      }
+   } while (LTC_GEN_READ_RETRY(ltc_hash_gen, gen));
+   return x;
 }
 
 /* ref:         $Format:%D$ */
@@ -21,16 +21,15 @@
 int find_hash_id(unsigned char ID)
 {
    int x;
-   LTC_MUTEX_LOCK(&ltc_hash_mutex);
-   for (x = 0; x < TAB_SIZE; x++) {
-      if (hash_descriptor[x].ID == ID) {
-          x = (hash_descriptor[x].name == NULL) ? -1 : x;
-          LTC_MUTEX_UNLOCK(&ltc_hash_mutex);
-          return x;
+   unsigned long gen;
+   do {
+      LTC_GEN_READ_BEGIN(ltc_hash_gen, gen);
+      x = ltc_hash_index.id[ID] - 1;
+      if (x >= 0 && (LTC_ATOMIC_LOAD(hash_descriptor[x].name) == NULL || hash_descriptor[x].ID != ID)) {
+         x = -1;
       }
-   }
-   LTC_MUTEX_UNLOCK(&ltc_hash_mutex);
-   return -1;
+   } while (LTC_GEN_READ_RETRY(ltc_hash_gen, gen));
+   return x;
 }
 
 /* ref:         $Format:%D$ */
@@ -16,16 +16,18 @@
 int find_hash_oid(const unsigned long *ID, unsigned long IDlen)
 {
    int x;
+   unsigned long i, h, gen;
    LTC_ARGCHK(ID != NULL);
-   LTC_MUTEX_LOCK(&ltc_hash_mutex);
-   for (x = 0; x < TAB_SIZE; x++) {
-       if (hash_descriptor[x].name != NULL && hash_descriptor[x].OIDlen == IDlen && !XMEMCMP(hash_descriptor[x].OID, ID, sizeof(unsigned long) * IDlen)) {
-          LTC_MUTEX_UNLOCK(&ltc_hash_mutex);
-          return x;
-       }
-   }
-   LTC_MUTEX_UNLOCK(&ltc_hash_mutex);
-   return -1;
+   h = ltc_index_hash_oid(ID, IDlen) % LTC_INDEX_SIZE;
+   do {
+      LTC_GEN_READ_BEGIN(ltc_hash_gen, gen);
+      for (i = h; (x = ltc_hash_index.oid[i] - 1) >= 0; i = (i + 1) % LTC_INDEX_SIZE) {
+          if (LTC_ATOMIC_LOAD(hash_descriptor[x].name) != NULL && hash_descriptor[x].OIDlen == IDlen && !XMEMCMP(hash_descriptor[x].OID, ID, sizeof(unsigned long) * IDlen)) {
+             break;
+          }
+      }
+   } while (LTC_GEN_READ_RETRY(ltc_hash_gen, gen));
+   return x;
 }
 
 /* ref:         $Format:%D$ */
@@ -21,16 +21,20 @@
 int find_prng(const char *name)
 {
    int x;
+   unsigned long i, h, gen;
+   const char *n;
    LTC_ARGCHK(name != NULL);
-   LTC_MUTEX_LOCK(&ltc_prng_mutex);
-   for (x = 0; x < TAB_SIZE; x++) {
-       if ((prng_descriptor[x].name != NULL) && XSTRCMP(prng_descriptor[x].name, name) == 0) {
-          LTC_MUTEX_UNLOCK(&ltc_prng_mutex);
-          return x;
-       }
-   }
-   LTC_MUTEX_UNLOCK(&ltc_prng_mutex);
-   return -1;
+   h = ltc_index_hash_name(name) % LTC_INDEX_SIZE;
+   do {
+      LTC_GEN_READ_BEGIN(ltc_prng_gen, gen);
+      for (i = h; (x = ltc_prng_index.name[i] - 1) >= 0; i = (i + 1) % LTC_INDEX_SIZE) {
+          n = LTC_ATOMIC_LOAD(prng_descriptor[x].name);
+          if (n != NULL && XSTRCMP(n, name) == 0) {
+             break;
+          }
+      }
+   } while (LTC_GEN_READ_RETRY(ltc_prng_gen, gen));
+   return x;
 }
 
 
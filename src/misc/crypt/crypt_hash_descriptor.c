@@ -18,6 +18,8 @@ struct ltc_hash_descriptor hash_descriptor[TAB_SIZE] = {
 };
 
 LTC_MUTEX_GLOBAL(ltc_hash_mutex)
+LTC_GEN_GLOBAL(ltc_hash_gen)
+ltc_index_type ltc_hash_index;
 
 
 /* ref:         $Format:%D$ */
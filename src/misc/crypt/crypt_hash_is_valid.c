@@ -20,12 +20,9 @@
 */
 int hash_is_valid(int idx)
 {
-   LTC_MUTEX_LOCK(&ltc_hash_mutex);
-   if (idx < 0 || idx >= TAB_SIZE || hash_descriptor[idx].name == NULL) {
-      LTC_MUTEX_UNLOCK(&ltc_hash_mutex);
+   if (idx < 0 || idx >= TAB_SIZE || LTC_ATOMIC_LOAD(hash_descriptor[idx].name) == NULL) {
       return CRYPT_INVALID_HASH;
    }
-   LTC_MUTEX_UNLOCK(&ltc_hash_mutex);
    return CRYPT_OK;
 }
 
@@ -0,0 +1,119 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ */
+#include "tomcrypt_private.h"
+
+/**
+  @file crypt_index.c
+  Hash indexes of the descriptor tables, so that find_cipher(), find_hash(),
+  find_hash_oid() etc. don't have to compare every registered descriptor.
+
+  The indexes are rebuilt with the mutex held whenever a descriptor is
+  (un)registered. Entries with the same key are inserted in the order of the
+  table, so a lookup returns the same slot as a linear search would.
+*/
+
+/**
+   Hash a descriptor name (FNV-1a)
+   @param name   The name
+   @return The hash value
+*/
+ulong32 ltc_index_hash_name(const char *name)
+{
+   ulong32 h = 2166136261UL;
+   while (*name != '\0') {
+      h = ((h ^ (unsigned char)*name++) * 16777619UL) & 0xFFFFFFFFUL;
+   }
+   return h;
+}
+
+/**
+   Hash an OID (FNV-1a over the arcs)
+   @param oid      The OID
+   @param oidlen   The number of arcs
+   @return The hash value
+*/
+ulong32 ltc_index_hash_oid(const unsigned long *oid, unsigned long oidlen)
+{
+   ulong32 h = 2166136261UL;
+   unsigned long x;
+   for (x = 0; x < oidlen; x++) {
+      h = ((h ^ (ulong32)(oid[x] & 0xFFFFFFFFUL)) * 16777619UL) & 0xFFFFFFFFUL;
+   }
+   return h;
+}
+
+static void _index_add(short *tab, ulong32 h, int x)
+{
+   unsigned long i = h % LTC_INDEX_SIZE;
+   while (tab[i] != 0) {
+      i = (i + 1) % LTC_INDEX_SIZE;
+   }
+   tab[i] = (short)(x + 1);
+}
+
+/**
+   Rebuild the index of cipher_descriptor[], call with ltc_cipher_mutex held
+*/
+void ltc_cipher_index_update(void)
+{
+   int x;
+   ltc_index_type *idx = &ltc_cipher_index;
+
+   XMEMSET(idx, 0, sizeof(*idx));
+   for (x = 0; x < TAB_SIZE; x++) {
+      if (cipher_descriptor[x].name == NULL) {
+         continue;
+      }
+      _index_add(idx->name, ltc_index_hash_name(cipher_descriptor[x].name), x);
+      if (idx->id[cipher_descriptor[x].ID] == 0) {
+         idx->id[cipher_descriptor[x].ID] = (short)(x + 1);
+      }
+   }
+}
+
+/**
+   Rebuild the index of hash_descriptor[], call with ltc_hash_mutex held
+*/
+void ltc_hash_index_update(void)
+{
+   int x;
+   ltc_index_type *idx = &ltc_hash_index;
+
+   XMEMSET(idx, 0, sizeof(*idx));
+   for (x = 0; x < TAB_SIZE; x++) {
+      if (hash_descriptor[x].name == NULL) {
+         continue;
+      }
+      _index_add(idx->name, ltc_index_hash_name(hash_descriptor[x].name), x);
+      _index_add(idx->oid, ltc_index_hash_oid(hash_descriptor[x].OID, hash_descriptor[x].OIDlen), x);
+      if (idx->id[hash_descriptor[x].ID] == 0) {
+         idx->id[hash_descriptor[x].ID] = (short)(x + 1);
+      }
+   }
+}
+
+/**
+   Rebuild the index of prng_descriptor[], call with ltc_prng_mutex held
+*/
+void ltc_prng_index_update(void)
+{
+   int x;
+   ltc_index_type *idx = &ltc_prng_index;
+
+   XMEMSET(idx, 0, sizeof(*idx));
+   for (x = 0; x < TAB_SIZE; x++) {
+      if (prng_descriptor[x].name != NULL) {
+         _index_add(idx->name, ltc_index_hash_name(prng_descriptor[x].name), x);
+      }
+   }
+}
+
+/* ref:         $Format:%D$ */
+/* git commit:  $Format:%H$ */
+/* commit time: $Format:%ai$ */
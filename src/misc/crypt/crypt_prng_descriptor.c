@@ -17,6 +17,8 @@ struct ltc_prng_descriptor prng_descriptor[TAB_SIZE] = {
 };
 
 LTC_MUTEX_GLOBAL(ltc_prng_mutex)
+LTC_GEN_GLOBAL(ltc_prng_gen)
+ltc_index_type ltc_prng_index;
 
 
 /* ref:         $Format:%D$ */
@@ -20,12 +20,9 @@
 */
 int prng_is_valid(int idx)
 {
-   LTC_MUTEX_LOCK(&ltc_prng_mutex);
-   if (idx < 0 || idx >= TAB_SIZE || prng_descriptor[idx].name == NULL) {
-      LTC_MUTEX_UNLOCK(&ltc_prng_mutex);
+   if (idx < 0 || idx >= TAB_SIZE || LTC_ATOMIC_LOAD(prng_descriptor[idx].name) == NULL) {
       return CRYPT_INVALID_PRNG;
    }
-   LTC_MUTEX_UNLOCK(&ltc_prng_mutex);
    return CRYPT_OK;
 }
 
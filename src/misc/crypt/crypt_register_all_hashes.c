@@ -93,6 +93,12 @@ int register_all_hashes(void)
    REGISTER_HASH(&blake2b_384_desc);
    REGISTER_HASH(&blake2b_512_desc);
 #endif
+#ifdef LTC_BLAKE2SP
+   REGISTER_HASH(&blake2sp_256_desc);
+#endif
+#ifdef LTC_BLAKE2BP
+   REGISTER_HASH(&blake2bp_512_desc);
+#endif
 #ifdef LTC_CHC_HASH
    REGISTER_HASH(&chc_desc);
    LTC_ARGCHK(chc_register(find_cipher_any("aes", 8, 16)) == CRYPT_OK);
@@ -21,6 +21,7 @@
 int register_cipher(const struct ltc_cipher_descriptor *cipher)
 {
    int x;
+   struct ltc_cipher_descriptor desc;
 
    LTC_ARGCHK(cipher != NULL);
 
@@ -36,7 +37,14 @@ int register_cipher(const struct ltc_cipher_descriptor *cipher)
    /* find a blank spot */
    for (x = 0; x < TAB_SIZE; x++) {
        if (cipher_descriptor[x].name == NULL) {
-          XMEMCPY(&cipher_descriptor[x], cipher, sizeof(struct ltc_cipher_descriptor));
+          /* the readers don't lock, store the name last */
+          XMEMCPY(&desc, cipher, sizeof(struct ltc_cipher_descriptor));
+          desc.name = NULL;
+          LTC_GEN_WRITE_BEGIN(ltc_cipher_gen);
+          XMEMCPY(&cipher_descriptor[x], &desc, sizeof(struct ltc_cipher_descriptor));
+          LTC_ATOMIC_STORE(cipher_descriptor[x].name, cipher->name);
+          ltc_cipher_index_update();
+          LTC_GEN_WRITE_END(ltc_cipher_gen);
           LTC_MUTEX_UNLOCK(&ltc_cipher_mutex);
           return x;
        }
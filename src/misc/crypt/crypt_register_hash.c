@@ -21,6 +21,7 @@
 int register_hash(const struct ltc_hash_descriptor *hash)
 {
    int x;
+   struct ltc_hash_descriptor desc;
 
    LTC_ARGCHK(hash != NULL);
 
@@ -36,7 +37,14 @@ int register_hash(const struct ltc_hash_descriptor *hash)
    /* find a blank spot */
    for (x = 0; x < TAB_SIZE; x++) {
        if (hash_descriptor[x].name == NULL) {
-          XMEMCPY(&hash_descriptor[x], hash, sizeof(struct ltc_hash_descriptor));
+          /* the readers don't lock, store the name last */
+          XMEMCPY(&desc, hash, sizeof(struct ltc_hash_descriptor));
+          desc.name = NULL;
+          LTC_GEN_WRITE_BEGIN(ltc_hash_gen);
+          XMEMCPY(&hash_descriptor[x], &desc, sizeof(struct ltc_hash_descriptor));
+          LTC_ATOMIC_STORE(hash_descriptor[x].name, hash->name);
+          ltc_hash_index_update();
+          LTC_GEN_WRITE_END(ltc_hash_gen);
           LTC_MUTEX_UNLOCK(&ltc_hash_mutex);
           return x;
        }
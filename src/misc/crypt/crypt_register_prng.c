@@ -21,6 +21,7 @@
 int register_prng(const struct ltc_prng_descriptor *prng)
 {
    int x;
+   struct ltc_prng_descriptor desc;
 
    LTC_ARGCHK(prng != NULL);
 
@@ -36,7 +37,14 @@ int register_prng(const struct ltc_prng_descriptor *prng)
    /* find a blank spot */
    for (x = 0; x < TAB_SIZE; x++) {
        if (prng_descriptor[x].name == NULL) {
-          XMEMCPY(&prng_descriptor[x], prng, sizeof(struct ltc_prng_descriptor));
+          /* the readers don't lock, store the name last */
+          XMEMCPY(&desc, prng, sizeof(struct ltc_prng_descriptor));
+          desc.name = NULL;
+          LTC_GEN_WRITE_BEGIN(ltc_prng_gen);
+          XMEMCPY(&prng_descriptor[x], &desc, sizeof(struct ltc_prng_descriptor));
+          LTC_ATOMIC_STORE(prng_descriptor[x].name, prng->name);
+          ltc_prng_index_update();
+          LTC_GEN_WRITE_END(ltc_prng_gen);
           LTC_MUTEX_UNLOCK(&ltc_prng_mutex);
           return x;
        }
@@ -78,6 +78,12 @@ static const crypt_size _crypt_sizes[] = {
 #ifdef LTC_BLAKE2B
     _SZ_STRINGIFY_S(blake2b_state),
 #endif
+#ifdef LTC_BLAKE2SP
+    _SZ_STRINGIFY_S(blake2sp_state),
+#endif
+#ifdef LTC_BLAKE2BP
+    _SZ_STRINGIFY_S(blake2bp_state),
+#endif
 
     /* block cipher key sizes */
     _SZ_STRINGIFY_S(ltc_cipher_descriptor),
@@ -196,6 +202,7 @@ static const crypt_size _crypt_sizes[] = {
     /* MAC sizes            -- no states for ccm, lrw */
 #ifdef LTC_HMAC
     _SZ_STRINGIFY_T(hmac_state),
+    _SZ_STRINGIFY_T(hmac_key),
 #endif
 #ifdef LTC_OMAC
     _SZ_STRINGIFY_T(omac_state),
@@ -208,18 +215,23 @@ static const crypt_size _crypt_sizes[] = {
 #endif
 #ifdef LTC_EAX_MODE
     _SZ_STRINGIFY_T(eax_state),
+    _SZ_STRINGIFY_T(eax_key),
 #endif
 #ifdef LTC_OCB_MODE
     _SZ_STRINGIFY_T(ocb_state),
 #endif
 #ifdef LTC_OCB3_MODE
     _SZ_STRINGIFY_T(ocb3_state),
+    _SZ_STRINGIFY_T(ocb3_key),
+    _SZ_STRINGIFY_T(ocb3_msg),
 #endif
 #ifdef LTC_CCM_MODE
     _SZ_STRINGIFY_T(ccm_state),
 #endif
 #ifdef LTC_GCM_MODE
     _SZ_STRINGIFY_T(gcm_state),
+    _SZ_STRINGIFY_T(gcm_key),
+    _SZ_STRINGIFY_T(gcm_msg),
 #endif
 #ifdef LTC_PELICAN
     _SZ_STRINGIFY_T(pelican_state),
@@ -284,6 +296,9 @@ static const crypt_size _crypt_sizes[] = {
 #ifdef LTC_CRC32
     _SZ_STRINGIFY_T(crc32_state),
 #endif
+#ifdef LTC_SCRYPT
+    _SZ_STRINGIFY_T(scrypt_arena),
+#endif
 
     _SZ_STRINGIFY_T(ltc_mp_digit),
     _SZ_STRINGIFY_T(ltc_math_descriptor)
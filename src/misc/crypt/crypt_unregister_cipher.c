@@ -28,8 +28,11 @@ int unregister_cipher(const struct ltc_cipher_descriptor *cipher)
    LTC_MUTEX_LOCK(&ltc_cipher_mutex);
    for (x = 0; x < TAB_SIZE; x++) {
        if (XMEMCMP(&cipher_descriptor[x], cipher, sizeof(struct ltc_cipher_descriptor)) == 0) {
-          cipher_descriptor[x].name = NULL;
+          LTC_GEN_WRITE_BEGIN(ltc_cipher_gen);
+          LTC_ATOMIC_STORE(cipher_descriptor[x].name, NULL);
           cipher_descriptor[x].ID   = 255;
+          ltc_cipher_index_update();
+          LTC_GEN_WRITE_END(ltc_cipher_gen);
           LTC_MUTEX_UNLOCK(&ltc_cipher_mutex);
           return CRYPT_OK;
        }
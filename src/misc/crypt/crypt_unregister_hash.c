@@ -28,7 +28,10 @@ int unregister_hash(const struct ltc_hash_descriptor *hash)
    LTC_MUTEX_LOCK(&ltc_hash_mutex);
    for (x = 0; x < TAB_SIZE; x++) {
        if (XMEMCMP(&hash_descriptor[x], hash, sizeof(struct ltc_hash_descriptor)) == 0) {
-          hash_descriptor[x].name = NULL;
+          LTC_GEN_WRITE_BEGIN(ltc_hash_gen);
+          LTC_ATOMIC_STORE(hash_descriptor[x].name, NULL);
+          ltc_hash_index_update();
+          LTC_GEN_WRITE_END(ltc_hash_gen);
           LTC_MUTEX_UNLOCK(&ltc_hash_mutex);
           return CRYPT_OK;
        }
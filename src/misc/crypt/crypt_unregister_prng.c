@@ -28,7 +28,10 @@ int unregister_prng(const struct ltc_prng_descriptor *prng)
    LTC_MUTEX_LOCK(&ltc_prng_mutex);
    for (x = 0; x < TAB_SIZE; x++) {
        if (XMEMCMP(&prng_descriptor[x], prng, sizeof(struct ltc_prng_descriptor)) == 0) {
-          prng_descriptor[x].name = NULL;
+          LTC_GEN_WRITE_BEGIN(ltc_prng_gen);
+          LTC_ATOMIC_STORE(prng_descriptor[x].name, NULL);
+          ltc_prng_index_update();
+          LTC_GEN_WRITE_END(ltc_prng_gen);
           LTC_MUTEX_UNLOCK(&ltc_prng_mutex);
           return CRYPT_OK;
        }
@@ -0,0 +1,80 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ */
+#include "tomcrypt_private.h"
+
+#if defined(LTC_AMD64_SIMD) && defined(LTC_TEST)
+/**
+  @file hash_test_cpu.c
+  Self-test helper for the SIMD code of the hashes
+*/
+
+static int _hash_test_cpu_one(const struct ltc_hash_descriptor *hash, unsigned long cpumask,
+                              const unsigned char *in, unsigned long inlen, unsigned long split,
+                              unsigned char *out)
+{
+   hash_state md;
+   unsigned long mask;
+   int err;
+
+   mask = ltc_cpu_mask(cpumask);
+   if ((err = hash->init(&md)) == CRYPT_OK &&
+       (err = hash->process(&md, in, split)) == CRYPT_OK &&
+       (err = hash->process(&md, in + split, inlen - split)) == CRYPT_OK) {
+      err = hash->done(&md, out);
+   }
+   ltc_cpu_mask(mask);
+   return err;
+}
+
+/**
+  Compare a hash under each CPU mask against its generic code
+
+  The messages are up to 1000 octets long, several blocks per call, and
+  split at odd offsets.  The reference is computed with all CPU features
+  masked, it is then compared with all features and with each single
+  feature masked, so every step down the dispatch of the hash is run.
+  @param hash   The hash to test
+  @return CRYPT_OK if successful
+*/
+int hash_test_cpu(const struct ltc_hash_descriptor *hash)
+{
+   unsigned char buf[1000], ref[MAXBLOCKSIZE], tmp[MAXBLOCKSIZE];
+   unsigned long x, m, len, split, mask;
+   int err;
+
+   LTC_ARGCHK(hash != NULL);
+
+   for (x = 0; x < sizeof(buf); x++) {
+      buf[x] = (unsigned char)(x * 13 + 5);
+   }
+   for (x = 0; x < 10; x++) {
+      len = 100 * x + 37;
+      split = (x * 71) % len;
+      if ((err = _hash_test_cpu_one(hash, 0, buf, len, split, ref)) != CRYPT_OK) {
+         return err;
+      }
+      /* m == 0 is all features, then each of the ten LTC_CPU_ flags masked */
+      for (m = 0; m <= 10; m++) {
+         mask = (m == 0) ? ~0UL : ~(1UL << (m - 1));
+         if ((err = _hash_test_cpu_one(hash, mask, buf, len, split, tmp)) != CRYPT_OK) {
+            return err;
+         }
+         if (compare_testvector(tmp, hash->hashsize, ref, hash->hashsize, hash->name, (int)(x * 100 + m))) {
+            return CRYPT_FAIL_TESTVECTOR;
+         }
+      }
+   }
+   return CRYPT_OK;
+}
+
+#endif
+
+/* ref:         $Format:%D$ */
+/* git commit:  $Format:%H$ */
+/* commit time: $Format:%ai$ */
@@ -34,74 +34,157 @@ int hkdf_extract(int hash_idx, const unsigned char *salt, unsigned long  saltlen
    return hmac_memory(hash_idx, salt, saltlen, in, inlen, out, outlen);
 }
 
-int hkdf_expand(int hash_idx, const unsigned char *info, unsigned long infolen,
-                              const unsigned char *in,   unsigned long inlen,
-                                    unsigned char *out,  unsigned long outlen)
+/* T(1) | T(2) | ... of the PRK in hkey, md and buf are the scratch space of the caller */
+static int _hkdf_expand(const hmac_key *hkey, const struct ltc_hash_descriptor *desc,
+                        const unsigned char *info, unsigned long infolen,
+                              unsigned char *out,  unsigned long outlen,
+                        hash_state *md, unsigned char *buf)
 {
-   unsigned long hashsize;
-   int err;
+   const unsigned char *prev;
+   unsigned long hashsize, outoff;
    unsigned char N;
-   unsigned long Noutlen, outoff;
-
-   unsigned char *T,  *dat;
-   unsigned long Tlen, datlen;
-
-   /* make sure hash descriptor is valid */
-   if ((err = hash_is_valid(hash_idx)) != CRYPT_OK) {
-      return err;
-   }
-
-   hashsize = hash_descriptor[hash_idx].hashsize;
+   int err;
 
-   /* RFC5869 parameter restrictions */
-   if (inlen < hashsize || outlen > hashsize * 255) {
+   hashsize = desc->hashsize;
+   if (outlen > hashsize * 255) {
       return CRYPT_INVALID_ARG;
    }
    if (info == NULL && infolen != 0) {
       return CRYPT_INVALID_ARG;
    }
-   LTC_ARGCHK(out != NULL);
 
-   Tlen = hashsize + infolen + 1;
-   T = XMALLOC(Tlen); /* Replace with static buffer? */
-   if (T == NULL) {
-      return CRYPT_MEM;
+   prev = NULL;
+   N = 0;
+   for (outoff = 0; outoff < outlen; outoff += hashsize) {
+      /* T(N) = HMAC(PRK, T(N-1) | info | N), T(0) is empty */
+      XMEMCPY(md, &hkey->inner, sizeof(*md));
+      if (prev != NULL && (err = desc->process(md, prev, hashsize)) != CRYPT_OK) {
+         return err;
+      }
+      if (infolen > 0 && (err = desc->process(md, info, infolen)) != CRYPT_OK) {
+         return err;
+      }
+      ++N;
+      if ((err = desc->process(md, &N, 1)) != CRYPT_OK) {
+         return err;
+      }
+      if ((err = desc->done(md, buf)) != CRYPT_OK) {
+         return err;
+      }
+      XMEMCPY(md, &hkey->outer, sizeof(*md));
+      if ((err = desc->process(md, buf, hashsize)) != CRYPT_OK) {
+         return err;
+      }
+      /* the whole blocks go straight to out, T(N) is read from there */
+      if (outlen - outoff >= hashsize) {
+         if ((err = desc->done(md, out + outoff)) != CRYPT_OK) {
+            return err;
+         }
+         prev = out + outoff;
+      } else {
+         if ((err = desc->done(md, buf)) != CRYPT_OK) {
+            return err;
+         }
+         XMEMCPY(out + outoff, buf, outlen - outoff);
+      }
    }
-   if (info != NULL) {
-      XMEMCPY(T + hashsize, info, infolen);
+   return CRYPT_OK;
+}
+
+/**
+   HKDF-Expand with a PRK from hmac_key_prepare(), without memory allocation
+   @param prk       The prepared PRK
+   @param info      The optional context and application specific information (may be NULL if infolen is 0)
+   @param infolen   The length of info (octets)
+   @param out       [out] The output keying material
+   @param outlen    The length of the output keying material, at most 255 times the size of the hash (octets)
+   @return CRYPT_OK if successful
+*/
+int hkdf_expand_prepared(const hmac_key *prk,
+                         const unsigned char *info, unsigned long infolen,
+                               unsigned char *out,  unsigned long outlen)
+{
+   hash_state md;
+   unsigned char buf[MAXBLOCKSIZE];
+   int err;
+
+   LTC_ARGCHK(prk != NULL);
+   LTC_ARGCHK(out != NULL || outlen == 0);
+
+   if ((err = hash_is_valid(prk->hash)) != CRYPT_OK) {
+      return err;
    }
+   err = _hkdf_expand(prk, &hash_descriptor[prk->hash], info, infolen, out, outlen, &md, buf);
 
-   /* HMAC data T(1) doesn't include a previous hash value */
-   dat    = T    + hashsize;
-   datlen = Tlen - hashsize;
+#ifdef LTC_CLEAN_STACK
+   zeromem(&md, sizeof(md));
+   zeromem(buf, sizeof(buf));
+#endif
+   return err;
+}
 
-   N = 0;
-   outoff = 0; /* offset in out to write to */
-   while (1) { /* an exit condition breaks mid-loop */
-      Noutlen = MIN(hashsize, outlen - outoff);
-      T[Tlen - 1] = ++N;
-      if ((err = hmac_memory(hash_idx, in, inlen, dat, datlen,
-                             out + outoff, &Noutlen)) != CRYPT_OK) {
-         zeromem(T, Tlen);
-         XFREE(T);
-         return err;
-      }
-      outoff += Noutlen;
+/**
+   HKDF-Expand of several outputs with the same PRK, e.g. the keys and IVs of a TLS 1.3 traffic secret
+   @param prk    The prepared PRK
+   @param jobs   The info and the output of each expansion
+   @param n      The number of jobs
+   @return CRYPT_OK if successful
+*/
+int hkdf_expand_many(const hmac_key *prk, const hkdf_job *jobs, unsigned long n)
+{
+   hash_state md;
+   unsigned char buf[MAXBLOCKSIZE];
+   unsigned long i;
+   int err;
 
-      if (outoff >= outlen) { /* loop exit condition */
+   LTC_ARGCHK(prk  != NULL);
+   LTC_ARGCHK(jobs != NULL || n == 0);
+
+   if ((err = hash_is_valid(prk->hash)) != CRYPT_OK) {
+      return err;
+   }
+   for (i = 0; i < n; i++) {
+      LTC_ARGCHK(jobs[i].out != NULL || jobs[i].outlen == 0);
+      if ((err = _hkdf_expand(prk, &hash_descriptor[prk->hash], jobs[i].info, jobs[i].infolen,
+                              jobs[i].out, jobs[i].outlen, &md, buf)) != CRYPT_OK) {
          break;
       }
+   }
 
-      /* All subsequent HMAC data T(N) DOES include the previous hash value */
-      XMEMCPY(T, out + hashsize * (N-1), hashsize);
-      if (N == 1) {
-         dat = T;
-         datlen = Tlen;
-      }
+#ifdef LTC_CLEAN_STACK
+   zeromem(&md, sizeof(md));
+   zeromem(buf, sizeof(buf));
+#endif
+   return err;
+}
+
+int hkdf_expand(int hash_idx, const unsigned char *info, unsigned long infolen,
+                              const unsigned char *in,   unsigned long inlen,
+                                    unsigned char *out,  unsigned long outlen)
+{
+   hmac_key prk;
+   int err;
+
+   /* make sure hash descriptor is valid */
+   if ((err = hash_is_valid(hash_idx)) != CRYPT_OK) {
+      return err;
    }
-   zeromem(T, Tlen);
-   XFREE(T);
-   return CRYPT_OK;
+
+   /* RFC5869 parameter restrictions */
+   if (inlen < hash_descriptor[hash_idx].hashsize) {
+      return CRYPT_INVALID_ARG;
+   }
+   LTC_ARGCHK(out != NULL);
+
+   if ((err = hmac_key_prepare(&prk, hash_idx, in, inlen)) != CRYPT_OK) {
+      return err;
+   }
+   err = hkdf_expand_prepared(&prk, info, infolen, out, outlen);
+
+#ifdef LTC_CLEAN_STACK
+   zeromem(&prk, sizeof(prk));
+#endif
+   return err;
 }
 
 /* all in one step */
@@ -112,27 +195,18 @@ int hkdf(int hash_idx, const unsigned char *salt, unsigned long saltlen,
 {
    unsigned long hashsize;
    int err;
-   unsigned char *extracted;
+   unsigned char extracted[MAXBLOCKSIZE];
 
    /* make sure hash descriptor is valid */
    if ((err = hash_is_valid(hash_idx)) != CRYPT_OK) {
       return err;
    }
 
-   hashsize = hash_descriptor[hash_idx].hashsize;
-
-   extracted = XMALLOC(hashsize); /* replace with static buffer? */
-   if (extracted == NULL) {
-      return CRYPT_MEM;
-   }
-   if ((err = hkdf_extract(hash_idx, salt, saltlen, in, inlen, extracted, &hashsize)) != 0) {
-      zeromem(extracted, hashsize);
-      XFREE(extracted);
-      return err;
+   hashsize = sizeof(extracted);
+   if ((err = hkdf_extract(hash_idx, salt, saltlen, in, inlen, extracted, &hashsize)) == CRYPT_OK) {
+      err = hkdf_expand(hash_idx, info, infolen, extracted, hashsize, out, outlen);
    }
-   err = hkdf_expand(hash_idx, info, infolen, extracted, hashsize, out, outlen);
-   zeromem(extracted, hashsize);
-   XFREE(extracted);
+   zeromem(extracted, sizeof(extracted));
    return err;
 }
 #endif /* LTC_HKDF */
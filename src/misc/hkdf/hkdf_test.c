@@ -35,7 +35,10 @@ int hkdf_test(void)
  #ifndef LTC_TEST
     return CRYPT_NOP;
  #else
-    unsigned char OKM[82];
+    unsigned char OKM[82], OKM2[82], PRK[MAXBLOCKSIZE];
+    unsigned long PRK_l;
+    hmac_key prk;
+    hkdf_job jobs[2];
     int i;
 
     static const struct hkdf_test_case {
@@ -274,8 +277,80 @@ int hkdf_test(void)
         if(compare_testvector(OKM, cases[i].OKM_l, cases[i].OKM, (size_t)cases[i].OKM_l, "HKDF", cases[i].num)) {
             failed++;
         }
+
+        /* the same with a prepared PRK, and a batch with a shorter output which is a prefix of the long one */
+        PRK_l = sizeof(PRK);
+        if((err = hkdf_extract(hash, cases[i].salt, cases[i].salt_l,
+                               cases[i].IKM, cases[i].IKM_l, PRK, &PRK_l)) != CRYPT_OK) {
+            return err;
+        }
+        if((err = hmac_key_prepare(&prk, hash, PRK, PRK_l)) != CRYPT_OK) {
+            return err;
+        }
+        jobs[0].info    = cases[i].info;
+        jobs[0].infolen = cases[i].info_l;
+        jobs[0].out     = OKM;
+        jobs[0].outlen  = cases[i].OKM_l;
+        jobs[1].info    = cases[i].info;
+        jobs[1].infolen = cases[i].info_l;
+        jobs[1].out     = OKM2;
+        jobs[1].outlen  = cases[i].OKM_l / 2;
+        XMEMSET(OKM, 0, sizeof(OKM));
+        XMEMSET(OKM2, 0, sizeof(OKM2));
+        if((err = hkdf_expand_many(&prk, jobs, 2)) != CRYPT_OK) {
+            return err;
+        }
+        if(compare_testvector(PRK, PRK_l, cases[i].PRK, (size_t)cases[i].PRK_l, "HKDF PRK", cases[i].num) ||
+           compare_testvector(OKM, cases[i].OKM_l, cases[i].OKM, (size_t)cases[i].OKM_l, "HKDF many", cases[i].num) ||
+           compare_testvector(OKM2, cases[i].OKM_l / 2, cases[i].OKM, (size_t)cases[i].OKM_l / 2, "HKDF many", cases[i].num + 100)) {
+            failed++;
+        }
+        XMEMSET(OKM, 0, sizeof(OKM));
+        if((err = hkdf_expand_prepared(&prk, cases[i].info, cases[i].info_l, OKM, cases[i].OKM_l)) != CRYPT_OK) {
+            return err;
+        }
+        if(compare_testvector(OKM, cases[i].OKM_l, cases[i].OKM, (size_t)cases[i].OKM_l, "HKDF prepared", cases[i].num)) {
+            failed++;
+        }
     }
 
+#if defined(LTC_BLAKE2BP) || defined(LTC_BLAKE2SP)
+    /* the prepared PRK is copied for every block, BLAKE2bp and BLAKE2sp keep large states */
+    {
+        static const char *tree_hashes[] = { "blake2bp-512", "blake2sp-256" };
+        static const unsigned char info[] = "tree hash";
+        unsigned char T[MAXBLOCKSIZE + sizeof(info)], ref[3 * MAXBLOCKSIZE], out[3 * MAXBLOCKSIZE];
+        unsigned long j, hashsize, Tlen, outlen;
+        for (j = 0; j < sizeof(PRK); j++) PRK[j] = (unsigned char)(j * 5 + 3);
+        for(i=0; i < (int)(sizeof(tree_hashes) / sizeof(tree_hashes[0])); i++) {
+            int hash = find_hash(tree_hashes[i]);
+            if (hash == -1) continue;
+            ++tested;
+            hashsize = hash_descriptor[hash].hashsize;
+            /* T(N) = HMAC(PRK, T(N-1) | info | N) with hmac_memory() */
+            for (j = 0, Tlen = 0; j < 3; j++) {
+                XMEMCPY(T + Tlen, info, sizeof(info) - 1);
+                T[Tlen + sizeof(info) - 1] = (unsigned char)(j + 1);
+                outlen = hashsize;
+                if((err = hmac_memory(hash, PRK, hashsize, T, Tlen + sizeof(info), ref + j * hashsize, &outlen)) != CRYPT_OK) {
+                    return err;
+                }
+                XMEMCPY(T, ref + j * hashsize, hashsize);
+                Tlen = hashsize;
+            }
+            if((err = hmac_key_prepare(&prk, hash, PRK, hashsize)) != CRYPT_OK) {
+                return err;
+            }
+            if((err = hkdf_expand_prepared(&prk, info, sizeof(info) - 1, out, 2 * hashsize + 1)) != CRYPT_OK) {
+                return err;
+            }
+            if(compare_testvector(out, 2 * hashsize + 1, ref, 2 * hashsize + 1, "HKDF prepared", i)) {
+                failed++;
+            }
+        }
+    }
+#endif
+
     if (failed != 0) {
         return CRYPT_FAIL_TESTVECTOR;
     }
@@ -14,6 +14,44 @@
 */
 #ifdef LTC_PKCS_5
 
+/* the number of output blocks which are computed together */
+#define PKCS_5_ALG2_BLOCKS 16
+
+/* U_1 of a block, the HMAC of the salt and the block number */
+static int _pkcs_5_alg2_u1(const hmac_key *hkey,
+                           const unsigned char *salt, unsigned long salt_len,
+                           ulong32 blkno, unsigned char *out)
+{
+   hash_state md;
+   unsigned char buf[MAXBLOCKSIZE];
+   int hash, err;
+
+   hash = hkey->hash;
+   STORE32H(blkno, buf);
+   XMEMCPY(&md, &hkey->inner, sizeof(md));
+   if ((err = hash_descriptor[hash].process(&md, salt, salt_len)) != CRYPT_OK) {
+      goto LBL_ERR;
+   }
+   if ((err = hash_descriptor[hash].process(&md, buf, 4)) != CRYPT_OK) {
+      goto LBL_ERR;
+   }
+   if ((err = hash_descriptor[hash].done(&md, buf)) != CRYPT_OK) {
+      goto LBL_ERR;
+   }
+   XMEMCPY(&md, &hkey->outer, sizeof(md));
+   if ((err = hash_descriptor[hash].process(&md, buf, hash_descriptor[hash].hashsize)) != CRYPT_OK) {
+      goto LBL_ERR;
+   }
+   err = hash_descriptor[hash].done(&md, out);
+
+LBL_ERR:
+#ifdef LTC_CLEAN_STACK
+   zeromem(&md, sizeof(md));
+   zeromem(buf, sizeof(buf));
+#endif
+   return err;
+}
+
 /**
    Execute PKCS #5 v2
    @param password          The input password (or key)
@@ -33,9 +71,9 @@ int pkcs_5_alg2(const unsigned char *password, unsigned long password_len,
 {
    int err, itts;
    ulong32  blkno;
-   unsigned long stored, left, x, y;
+   unsigned long stored, left, hashsize, n, x, y, z;
    unsigned char *buf[2];
-   hmac_state    *hmac;
+   hmac_key      *hkey;
 
    LTC_ARGCHK(password != NULL);
    LTC_ARGCHK(salt     != NULL);
@@ -46,61 +84,69 @@ int pkcs_5_alg2(const unsigned char *password, unsigned long password_len,
    if ((err = hash_is_valid(hash_idx)) != CRYPT_OK) {
       return err;
    }
+   hashsize = hash_descriptor[hash_idx].hashsize;
 
-   buf[0] = XMALLOC(MAXBLOCKSIZE * 2);
-   hmac   = XMALLOC(sizeof(hmac_state));
-   if (hmac == NULL || buf[0] == NULL) {
-      if (hmac != NULL) {
-         XFREE(hmac);
+   buf[0] = XMALLOC(MAXBLOCKSIZE * (PKCS_5_ALG2_BLOCKS + 1));
+   hkey   = XMALLOC(sizeof(hmac_key));
+   if (hkey == NULL || buf[0] == NULL) {
+      if (hkey != NULL) {
+         XFREE(hkey);
       }
       if (buf[0] != NULL) {
          XFREE(buf[0]);
       }
       return CRYPT_MEM;
    }
-   /* buf[1] points to the second block of MAXBLOCKSIZE bytes */
-   buf[1] = buf[0] + MAXBLOCKSIZE;
+   /* buf[0] holds the blocks which are computed together, buf[1] is the current U */
+   buf[1] = buf[0] + MAXBLOCKSIZE * PKCS_5_ALG2_BLOCKS;
+
+   /* the key is the same for all HMACs, only the midstates after the padded key are used */
+   if ((err = hmac_key_prepare(hkey, hash_idx, password, password_len)) != CRYPT_OK) {
+      goto LBL_ERR;
+   }
 
    left   = *outlen;
    blkno  = 1;
    stored = 0;
    while (left != 0) {
-       /* process block number blkno */
-       zeromem(buf[0], MAXBLOCKSIZE*2);
-
-       /* store current block number and increment for next pass */
-       STORE32H(blkno, buf[1]);
-       ++blkno;
-
-       /* get PRF(P, S||int(blkno)) */
-       if ((err = hmac_init(hmac, hash_idx, password, password_len)) != CRYPT_OK) {
-          goto LBL_ERR;
+       n = (left + hashsize - 1) / hashsize;
+       if (n > PKCS_5_ALG2_BLOCKS) {
+          n = PKCS_5_ALG2_BLOCKS;
        }
-       if ((err = hmac_process(hmac, salt, salt_len)) != CRYPT_OK) {
-          goto LBL_ERR;
-       }
-       if ((err = hmac_process(hmac, buf[1], 4)) != CRYPT_OK) {
-          goto LBL_ERR;
-       }
-       x = MAXBLOCKSIZE;
-       if ((err = hmac_done(hmac, buf[0], &x)) != CRYPT_OK) {
-          goto LBL_ERR;
+
+       /* get PRF(P, S||int(blkno)) of the next n blocks */
+       for (x = 0; x < n; x++) {
+          if ((err = _pkcs_5_alg2_u1(hkey, salt, salt_len, blkno++, buf[0] + x * hashsize)) != CRYPT_OK) {
+             goto LBL_ERR;
+          }
        }
 
-       /* now compute repeated and XOR it in buf[1] */
-       XMEMCPY(buf[1], buf[0], x);
-       for (itts = 1; itts < iteration_count; ++itts) {
-           if ((err = hmac_memory(hash_idx, password, password_len, buf[0], x, buf[0], &x)) != CRYPT_OK) {
-              goto LBL_ERR;
-           }
-           for (y = 0; y < x; y++) {
-               buf[1][y] ^= buf[0][y];
-           }
+       /* now compute repeated and XOR it in the blocks, in parallel if possible */
+       err = CRYPT_NOP;
+#ifdef LTC_SHA256_MB
+       if (hash_descriptor[hash_idx].process == sha256_process && hashsize == 32 && iteration_count > 1) {
+          err = sha256_mb_pbkdf2(hkey->inner.sha256.state, hkey->outer.sha256.state, buf[0], n,
+                                 (unsigned long)iteration_count - 1);
+       }
+#endif
+       if (err == CRYPT_NOP) {
+          for (x = 0; x < n; x++) {
+             XMEMCPY(buf[1], buf[0] + x * hashsize, hashsize);
+             for (itts = 1; itts < iteration_count; ++itts) {
+                 z = hashsize;
+                 if ((err = hmac_memory_prepared(hkey, buf[1], hashsize, buf[1], &z)) != CRYPT_OK) {
+                    goto LBL_ERR;
+                 }
+                 for (y = 0; y < hashsize; y++) {
+                     buf[0][x * hashsize + y] ^= buf[1][y];
+                 }
+             }
+          }
        }
 
-       /* now emit upto x bytes of buf[1] to output */
-       for (y = 0; y < x && left != 0; ++y) {
-           out[stored++] = buf[1][y];
+       /* now emit upto n blocks to output */
+       for (y = 0; y < n * hashsize && left != 0; ++y) {
+           out[stored++] = buf[0][y];
            --left;
        }
    }
@@ -109,11 +155,11 @@ int pkcs_5_alg2(const unsigned char *password, unsigned long password_len,
    err = CRYPT_OK;
 LBL_ERR:
 #ifdef LTC_CLEAN_STACK
-   zeromem(buf[0], MAXBLOCKSIZE*2);
-   zeromem(hmac, sizeof(hmac_state));
+   zeromem(buf[0], MAXBLOCKSIZE * (PKCS_5_ALG2_BLOCKS + 1));
+   zeromem(hkey, sizeof(hmac_key));
 #endif
 
-   XFREE(hmac);
+   XFREE(hkey);
    XFREE(buf[0]);
 
    return err;
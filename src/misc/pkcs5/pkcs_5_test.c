@@ -185,6 +185,113 @@ int pkcs_5_test (void)
         }
     }
 
+#ifdef LTC_SHA256
+    /* PBKDF2-HMAC-SHA256 with more than one block of output, the first from RFC 7914 */
+    {
+       static const struct {
+          const char *P, *S;
+          int c;
+          unsigned char DK[64];
+       } cases_sha256[] = {
+          { "passwd", "salt", 1,
+            { 0x55, 0xac, 0x04, 0x6e, 0x56, 0xe3, 0x08, 0x9f, 0xec, 0x16, 0x91, 0xc2, 0x25, 0x44, 0xb6, 0x05,
+              0xf9, 0x41, 0x85, 0x21, 0x6d, 0xde, 0x04, 0x65, 0xe6, 0x8b, 0x9d, 0x57, 0xc2, 0x0d, 0xac, 0xbc,
+              0x49, 0xca, 0x9c, 0xcc, 0xf1, 0x79, 0xb6, 0x45, 0x99, 0x16, 0x64, 0xb3, 0x9d, 0x77, 0xef, 0x31,
+              0x7c, 0x71, 0xb8, 0x45, 0xb1, 0xe3, 0x0b, 0xd5, 0x09, 0x11, 0x20, 0x41, 0xd3, 0xa1, 0x97, 0x83 } },
+          { "password", "salt", 4096,
+            { 0xc5, 0xe4, 0x78, 0xd5, 0x92, 0x88, 0xc8, 0x41, 0xaa, 0x53, 0x0d, 0xb6, 0x84, 0x5c, 0x4c, 0x8d,
+              0x96, 0x28, 0x93, 0xa0, 0x01, 0xce, 0x4e, 0x11, 0xa4, 0x96, 0x38, 0x73, 0xaa, 0x98, 0x13, 0x4a,
+              0xf7, 0xad, 0x98, 0xc1, 0xb4, 0x58, 0xce, 0x3f, 0xd7, 0x4c, 0xa3, 0x5b, 0xeb, 0xa3, 0xcd, 0xa7,
+              0xb8, 0xd1, 0x03, 0x8d, 0x6a, 0x87, 0x07, 0x1b, 0x91, 0x8f, 0x83, 0x74, 0x05, 0xf3, 0xfe, 0x77 } },
+       };
+       unsigned char long_dk[3][20 * 32 + 7];
+       int sha256 = find_hash("sha256"), j;
+#ifdef LTC_SHA256_MB
+       unsigned long mask;
+#endif
+
+       for (i = 0; sha256 != -1 && i < (int)(sizeof(cases_sha256) / sizeof(cases_sha256[0])); i++) {
+          /* with SHA-NI disabled the blocks are computed in parallel lanes */
+          for (j = 0; j < 2; j++, tested++) {
+#ifdef LTC_SHA256_MB
+             mask = ltc_cpu_mask(j == 0 ? ~0UL : ~LTC_CPU_SHA);
+#endif
+             dkLen = sizeof(long_dk[0]);
+             err = pkcs_5_alg2((const unsigned char*)cases_sha256[i].P, (unsigned long)strlen(cases_sha256[i].P),
+                               (const unsigned char*)cases_sha256[i].S, (unsigned long)strlen(cases_sha256[i].S),
+                               cases_sha256[i].c, sha256, long_dk[0], &dkLen);
+#ifdef LTC_SHA256_MB
+             ltc_cpu_mask(mask);
+#endif
+             if (err != CRYPT_OK) {
+                ++failed;
+             } else if (compare_testvector(long_dk[0], 64, cases_sha256[i].DK, 64, "PKCS#5_2 SHA256", i)) {
+                ++failed;
+             }
+          }
+       }
+
+#ifdef LTC_SHA256_MB
+       /* more blocks than lanes, with sixteen and eight lanes against the blocks one by one */
+       for (j = 0; sha256 != -1 && j < 3; j++) {
+          mask = ltc_cpu_mask(j == 0 ? ~LTC_CPU_SHA : j == 1 ? ~(LTC_CPU_SHA | LTC_CPU_AVX512) : 0);
+          dkLen = sizeof(long_dk[j]);
+          err = pkcs_5_alg2((const unsigned char*)"password", 8, (const unsigned char*)"salt", 4,
+                            7, sha256, long_dk[j], &dkLen);
+          ltc_cpu_mask(mask);
+          if (err != CRYPT_OK || dkLen != sizeof(long_dk[j])) {
+             ++failed;
+          }
+       }
+       for (j = 0; sha256 != -1 && j < 2; j++, tested++) {
+          if (compare_testvector(long_dk[j], sizeof(long_dk[j]), long_dk[2], sizeof(long_dk[2]), "PKCS#5_2 lanes", j)) {
+             ++failed;
+          }
+       }
+#endif
+    }
+#endif
+
+#if defined(LTC_BLAKE2BP) || defined(LTC_BLAKE2SP)
+    /* the prepared password is copied for every iteration, BLAKE2bp and BLAKE2sp keep large states */
+    {
+       static const char *tree_hashes[] = { "blake2bp-512", "blake2sp-256" };
+       unsigned char S[8], U[MAXBLOCKSIZE], T[3 * MAXBLOCKSIZE], out[2 * MAXBLOCKSIZE + 1];
+       unsigned long hashsize, ulen, j, x;
+       int k, tree;
+
+       for (i = 0; i < (int)(sizeof(tree_hashes) / sizeof(tree_hashes[0])); i++) {
+          if ((tree = find_hash(tree_hashes[i])) == -1) continue;
+          ++tested;
+          hashsize = hash_descriptor[tree].hashsize;
+          /* T_j = U_1 ^ U_2 ^ U_3 with U_1 = HMAC(P, S | INT(j)) and U_k = HMAC(P, U_k-1) from hmac_memory() */
+          XMEMCPY(S, "salt", 4);
+          for (j = 0; j < 3; j++) {
+             STORE32H(j + 1, S + 4);
+             ulen = sizeof(U);
+             err = hmac_memory(tree, (const unsigned char*)"password", 8, S, 8, U, &ulen);
+             for (k = 0; err == CRYPT_OK && k < 3; k++) {
+                for (x = 0; x < hashsize; x++) {
+                   T[j * hashsize + x] = (k == 0 ? 0 : T[j * hashsize + x]) ^ U[x];
+                }
+                ulen = sizeof(U);
+                err = hmac_memory(tree, (const unsigned char*)"password", 8, U, hashsize, U, &ulen);
+             }
+             if (err != CRYPT_OK) {
+                return err;
+             }
+          }
+          dkLen = 2 * hashsize + 1;
+          if ((err = pkcs_5_alg2((const unsigned char*)"password", 8, (const unsigned char*)"salt", 4,
+                                 3, tree, out, &dkLen)) != CRYPT_OK) {
+             ++failed;
+          } else if (compare_testvector(out, dkLen, T, 2 * hashsize + 1, "PKCS#5_2 tree hash", i)) {
+             ++failed;
+          }
+       }
+    }
+#endif
+
     /* testing alg 1 */
     for(i=0; i < (int)(sizeof(cases_5_1) / sizeof(case_item)); i++, tested++) {
         dkLen = cases_5_1[i].dkLen;
@@ -0,0 +1,271 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ */
+#include "tomcrypt_private.h"
+
+/**
+  @file scrypt.c
+  scrypt key derivation, RFC 7914
+
+  The p lanes of ROMix are independent of each other, with LTC_PTHREAD up to
+  LTC_SCRYPT_THREADS of them are computed at once, every thread with its own
+  V.  All the memory is taken from an scrypt_arena.
+*/
+
+#ifdef LTC_SCRYPT
+
+#ifdef LTC_PTHREAD
+#define SCRYPT_MAX_WORKERS  LTC_SCRYPT_THREADS
+#else
+#define SCRYPT_MAX_WORKERS  1
+#endif
+
+#define QUARTERROUND(a,b,c,d) \
+    x[b] ^= (ROL((x[a] + x[d]),  7)); \
+    x[c] ^= (ROL((x[b] + x[a]),  9)); \
+    x[d] ^= (ROL((x[c] + x[b]), 13)); \
+    x[a] ^= (ROL((x[d] + x[c]), 18));
+
+/* B = B + Salsa20/8(B) */
+static void _scrypt_salsa20_8(ulong32 *B)
+{
+   ulong32 x[16];
+   int i;
+
+   XMEMCPY(x, B, sizeof(x));
+   for (i = 8; i > 0; i -= 2) {
+      QUARTERROUND( 0, 4, 8,12)
+      QUARTERROUND( 5, 9,13, 1)
+      QUARTERROUND(10,14, 2, 6)
+      QUARTERROUND(15, 3, 7,11)
+      QUARTERROUND( 0, 1, 2, 3)
+      QUARTERROUND( 5, 6, 7, 4)
+      QUARTERROUND(10,11, 8, 9)
+      QUARTERROUND(15,12,13,14)
+   }
+   for (i = 0; i < 16; i++) {
+      B[i] += x[i];
+   }
+}
+
+#undef QUARTERROUND
+
+/* out = BlockMix(in), the 2 * r blocks of 16 words */
+static void _scrypt_blockmix(const ulong32 *in, ulong32 *out, unsigned long r)
+{
+   ulong32 X[16];
+   unsigned long i, k;
+
+   XMEMCPY(X, in + (2 * r - 1) * 16, sizeof(X));
+   for (i = 0; i < 2 * r; i++) {
+      for (k = 0; k < 16; k++) {
+         X[k] ^= in[i * 16 + k];
+      }
+      _scrypt_salsa20_8(X);
+      /* the even blocks go to the first half, the odd ones to the second */
+      XMEMCPY(out + ((i & 1) * r + i / 2) * 16, X, sizeof(X));
+   }
+}
+
+/* B = ROMix(B), V holds N * 32 * r words and XY 64 * r words */
+static void _scrypt_romix(unsigned char *B, unsigned long r, ulong64 N, ulong32 *V, ulong32 *XY)
+{
+   ulong32 *X, *Y, *T;
+   unsigned long k, words;
+   ulong64 i, j;
+
+#ifdef LTC_SCRYPT_SIMD
+   if (ltc_cpu_has(LTC_CPU_SSE2)) {
+      scrypt_sse2_romix(B, r, N, V, XY);
+      return;
+   }
+#endif
+
+   words = 32 * r;
+   X     = XY;
+   Y     = XY + words;
+   for (k = 0; k < words; k++) {
+      LOAD32L(V[k], B + 4 * k);
+   }
+   /* V_i = BlockMix^i(B), written in place */
+   for (i = 0; i + 1 < N; i++) {
+      _scrypt_blockmix(V + i * words, V + (i + 1) * words, r);
+   }
+   _scrypt_blockmix(V + (N - 1) * words, X, r);
+   for (i = 0; i < N; i++) {
+      /* Integerify(X) mod N */
+      j = (X[words - 16] | ((ulong64)X[words - 15] << 32)) & (N - 1);
+      for (k = 0; k < words; k++) {
+         X[k] ^= V[j * words + k];
+      }
+      _scrypt_blockmix(X, Y, r);
+      T = X;
+      X = Y;
+      Y = T;
+   }
+   for (k = 0; k < words; k++) {
+      STORE32L(X[k], B + 4 * k);
+   }
+}
+
+typedef struct {
+   unsigned char *B;
+   ulong64        N;
+   unsigned long  r, p, first, step;
+   ulong32       *V, *XY;
+} scrypt_worker;
+
+/* the lanes first, first + step, ... of B */
+static void _scrypt_worker(const scrypt_worker *w)
+{
+   unsigned long lane;
+
+   for (lane = w->first; lane < w->p; lane += w->step) {
+      _scrypt_romix(w->B + lane * 128 * w->r, w->r, w->N, w->V, w->XY);
+   }
+}
+
+#ifdef LTC_PTHREAD
+static void* _scrypt_thread(void *arg)
+{
+   _scrypt_worker(arg);
+   return NULL;
+}
+#endif
+
+/**
+   scrypt key derivation
+   @param pwd       The password
+   @param pwdlen    The length of the password (octets)
+   @param salt      The salt
+   @param saltlen   The length of the salt (octets)
+   @param N         The CPU/memory cost, a power of 2 greater than 1 and less than 2^(16 * r)
+   @param r         The block size, r * p must be less than 2^30
+   @param p         The parallelization
+   @param arena     The scratch memory to use, or NULL to allocate it for this call
+   @param out       [out] The derived key
+   @param outlen    The length of the derived key (octets)
+   @return CRYPT_OK if successful
+*/
+int scrypt(const unsigned char *pwd,  unsigned long pwdlen,
+           const unsigned char *salt, unsigned long saltlen,
+           ulong64 N, unsigned long r, unsigned long p,
+           scrypt_arena *arena,
+                 unsigned char *out,  unsigned long outlen)
+{
+   scrypt_worker worker[SCRYPT_MAX_WORKERS];
+#ifdef LTC_PTHREAD
+   pthread_t thread[SCRYPT_MAX_WORKERS];
+   int started[SCRYPT_MAX_WORKERS];
+#endif
+   scrypt_arena tmp;
+   ulong64 blk, vsize;
+   unsigned long workers, total, len, w;
+   unsigned char *B;
+   const unsigned char zero = 0;
+   int hash, err;
+
+   LTC_ARGCHK(pwd  != NULL || pwdlen == 0);
+   LTC_ARGCHK(salt != NULL || saltlen == 0);
+   LTC_ARGCHK(out  != NULL);
+
+   if (N < 2 || (N & (N - 1)) != 0 || r == 0 || p == 0 || (ulong64)r * p >= (1UL << 30) || outlen == 0) {
+      return CRYPT_INVALID_ARG;
+   }
+   if (r < 4 && (N >> (16 * r)) != 0) {
+      return CRYPT_INVALID_ARG;
+   }
+
+   /* the arena holds the p lanes of B, then V, X and Y of every worker */
+   workers = p < SCRYPT_MAX_WORKERS ? p : SCRYPT_MAX_WORKERS;
+   blk     = (ulong64)128 * r;
+   if (blk * p > ULONG_MAX || ULONG_MAX / blk < N + 2) {
+      return CRYPT_MEM;
+   }
+   vsize = blk * (N + 2);
+   if ((ULONG_MAX - blk * p) / vsize < workers) {
+      return CRYPT_MEM;
+   }
+   total = (unsigned long)(blk * p + vsize * workers);
+
+   hash = register_hash(&sha256_desc);
+   if ((err = hash_is_valid(hash)) != CRYPT_OK) {
+      return err;
+   }
+
+   if (arena == NULL) {
+      if ((err = scrypt_arena_init(&tmp, 0)) != CRYPT_OK) {
+         return err;
+      }
+      arena = &tmp;
+   }
+   if ((err = scrypt_arena_reserve(arena, total)) != CRYPT_OK) {
+      goto LBL_ERR;
+   }
+   B = arena->mem;
+
+   /* an empty HMAC key is padded to the same block as a single zero octet */
+   if (pwdlen == 0) {
+      pwd    = &zero;
+      pwdlen = 1;
+   }
+   if (salt == NULL) {
+      salt = &zero;
+   }
+   len = (unsigned long)(blk * p);
+   if ((err = pkcs_5_alg2(pwd, pwdlen, salt, saltlen, 1, hash, B, &len)) != CRYPT_OK) {
+      goto LBL_ERR;
+   }
+
+   for (w = 0; w < workers; w++) {
+      worker[w].B     = B;
+      worker[w].N     = N;
+      worker[w].r     = r;
+      worker[w].p     = p;
+      worker[w].first = w;
+      worker[w].step  = workers;
+      worker[w].V     = (ulong32 *)(void *)(B + blk * p + vsize * w);
+      worker[w].XY    = worker[w].V + N * 32 * r;
+   }
+#ifdef LTC_PTHREAD
+   /* the first worker runs in this thread, a worker whose thread can't be started as well */
+   for (w = 1; w < workers; w++) {
+      started[w] = pthread_create(&thread[w], NULL, _scrypt_thread, &worker[w]) == 0;
+   }
+   _scrypt_worker(&worker[0]);
+   for (w = 1; w < workers; w++) {
+      if (started[w]) {
+         pthread_join(thread[w], NULL);
+      } else {
+         _scrypt_worker(&worker[w]);
+      }
+   }
+#else
+   _scrypt_worker(&worker[0]);
+#endif
+
+   len = outlen;
+   err = pkcs_5_alg2(pwd, pwdlen, B, (unsigned long)(blk * p), 1, hash, out, &len);
+
+LBL_ERR:
+#ifdef LTC_CLEAN_STACK
+   if (arena->mem != NULL) {
+      zeromem(arena->mem, total);
+   }
+#endif
+   if (arena == &tmp) {
+      scrypt_arena_done(&tmp);
+   }
+   return err;
+}
+
+#endif
+
+/* ref:         $Format:%D$ */
+/* git commit:  $Format:%H$ */
+/* commit time: $Format:%ai$ */
@@ -0,0 +1,135 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ */
+#include "tomcrypt_private.h"
+
+/**
+  @file scrypt_arena.c
+  scrypt support, the reusable scratch memory
+
+  The arena only grows, so a caller which derives many keys with the same
+  parameters allocates the memory once.  With SCRYPT_ARENA_HUGEPAGES the
+  memory is mapped with huge pages on Linux, either explicitly reserved
+  ones or transparent huge pages, which saves most of the TLB misses of
+  the random reads of ROMix.
+*/
+
+#ifdef LTC_SCRYPT
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#define SCRYPT_HUGEPAGE_SIZE  (2UL * 1024 * 1024)
+#endif
+
+static void _scrypt_arena_free(scrypt_arena *arena)
+{
+   if (arena->mem == NULL) {
+      return;
+   }
+#if defined(__linux__)
+   if (arena->mapped) {
+      munmap(arena->mem, arena->size);
+   } else
+#endif
+   {
+      XFREE(arena->mem);
+   }
+   arena->mem    = NULL;
+   arena->size   = 0;
+   arena->mapped = 0;
+}
+
+/**
+   Initialize an empty scrypt arena
+   @param arena   [out] The arena
+   @param flags   0 or SCRYPT_ARENA_HUGEPAGES
+   @return CRYPT_OK if successful
+*/
+int scrypt_arena_init(scrypt_arena *arena, int flags)
+{
+   LTC_ARGCHK(arena != NULL);
+
+   if ((flags & ~SCRYPT_ARENA_HUGEPAGES) != 0) {
+      return CRYPT_INVALID_ARG;
+   }
+   arena->mem    = NULL;
+   arena->size   = 0;
+   arena->flags  = flags;
+   arena->mapped = 0;
+   return CRYPT_OK;
+}
+
+/**
+   Make sure an scrypt arena holds at least size octets
+   @param arena   The arena
+   @param size    The minimum size (octets)
+   @return CRYPT_OK if successful
+*/
+int scrypt_arena_reserve(scrypt_arena *arena, unsigned long size)
+{
+   LTC_ARGCHK(arena != NULL);
+
+   if (size <= arena->size) {
+      return CRYPT_OK;
+   }
+   _scrypt_arena_free(arena);
+
+#if defined(__linux__)
+   if ((arena->flags & SCRYPT_ARENA_HUGEPAGES) && size <= ULONG_MAX - SCRYPT_HUGEPAGE_SIZE) {
+      void *mem;
+      unsigned long mapsize = (size + SCRYPT_HUGEPAGE_SIZE - 1) & ~(SCRYPT_HUGEPAGE_SIZE - 1);
+
+      mem = MAP_FAILED;
+#ifdef MAP_HUGETLB
+      /* huge pages reserved by the administrator */
+      mem = mmap(NULL, mapsize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+#endif
+      if (mem == MAP_FAILED) {
+         /* else transparent huge pages, if they are enabled */
+         mem = mmap(NULL, mapsize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+#ifdef MADV_HUGEPAGE
+         if (mem != MAP_FAILED) {
+            madvise(mem, mapsize, MADV_HUGEPAGE);
+         }
+#endif
+      }
+      if (mem != MAP_FAILED) {
+         arena->mem    = mem;
+         arena->size   = mapsize;
+         arena->mapped = 1;
+         return CRYPT_OK;
+      }
+   }
+#endif
+
+   arena->mem = XMALLOC(size);
+   if (arena->mem == NULL) {
+      return CRYPT_MEM;
+   }
+   arena->size = size;
+   return CRYPT_OK;
+}
+
+/**
+   Release the memory of an scrypt arena
+   @param arena   The arena
+   @return CRYPT_OK if successful
+*/
+int scrypt_arena_done(scrypt_arena *arena)
+{
+   LTC_ARGCHK(arena != NULL);
+
+   _scrypt_arena_free(arena);
+   return CRYPT_OK;
+}
+
+#endif
+
+/* ref:         $Format:%D$ */
+/* git commit:  $Format:%H$ */
+/* commit time: $Format:%ai$ */
@@ -0,0 +1,157 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ */
+
+/**
+   @file scrypt_simd.c
+   ROMix of scrypt using the SSE2 instructions of x86-64 CPUs
+
+   The 16 words of a Salsa20 block are kept in diagonal order, the word i of
+   the block at the position 5 * i mod 16, so the four quarter-rounds of a
+   column or a row step are one operation on four registers and the steps
+   only rotate the registers in between.  B is reordered once when it's
+   loaded and once when it's stored, V holds the blocks in that order.
+*/
+#include "tomcrypt_private.h"
+
+#ifdef LTC_SCRYPT_SIMD
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <emmintrin.h>
+#endif
+
+#define SSE2_TARGET  LTC_ATTRIBUTE_TARGET("sse2")
+
+#define SSE2_LOAD(p)       _mm_loadu_si128((const __m128i *)(const void *)(p))
+#define SSE2_STORE(p, v)   _mm_storeu_si128((__m128i *)(void *)(p), (v))
+
+/* a ^= (b + c) <<< n */
+#define SSE2_ARX(a, b, c, n)                                                \
+   T = _mm_add_epi32((b), (c));                                             \
+   a = _mm_xor_si128(a, _mm_xor_si128(_mm_slli_epi32(T, (n)), _mm_srli_epi32(T, 32 - (n))));
+
+/* the row X0 holds the words 0, 5, 10, 15, X1 4, 9, 14, 3, X2 8, 13, 2, 7 and X3 12, 1, 6, 11 */
+#define SSE2_DOUBLEROUND                                                    \
+   SSE2_ARX(X1, X0, X3, 7)                                                  \
+   SSE2_ARX(X2, X1, X0, 9)                                                  \
+   SSE2_ARX(X3, X2, X1, 13)                                                 \
+   SSE2_ARX(X0, X3, X2, 18)                                                 \
+   X1 = _mm_shuffle_epi32(X1, 0x93);                                        \
+   X2 = _mm_shuffle_epi32(X2, 0x4E);                                        \
+   X3 = _mm_shuffle_epi32(X3, 0x39);                                        \
+   SSE2_ARX(X3, X0, X1, 7)                                                  \
+   SSE2_ARX(X2, X3, X0, 9)                                                  \
+   SSE2_ARX(X1, X2, X3, 13)                                                 \
+   SSE2_ARX(X0, X1, X2, 18)                                                 \
+   X1 = _mm_shuffle_epi32(X1, 0x39);                                        \
+   X2 = _mm_shuffle_epi32(X2, 0x4E);                                        \
+   X3 = _mm_shuffle_epi32(X3, 0x93);
+
+/* out = BlockMix(in ^ xr), xr may be NULL */
+SSE2_TARGET
+static void _scrypt_sse2_blockmix(const ulong32 *in, const ulong32 *xr, ulong32 *out, unsigned long r)
+{
+   __m128i X0, X1, X2, X3, Y0, Y1, Y2, Y3, T;
+   unsigned long i;
+   ulong32 *dst;
+
+   X0 = SSE2_LOAD(in + (2 * r - 1) * 16);
+   X1 = SSE2_LOAD(in + (2 * r - 1) * 16 + 4);
+   X2 = SSE2_LOAD(in + (2 * r - 1) * 16 + 8);
+   X3 = SSE2_LOAD(in + (2 * r - 1) * 16 + 12);
+   if (xr != NULL) {
+      X0 = _mm_xor_si128(X0, SSE2_LOAD(xr + (2 * r - 1) * 16));
+      X1 = _mm_xor_si128(X1, SSE2_LOAD(xr + (2 * r - 1) * 16 + 4));
+      X2 = _mm_xor_si128(X2, SSE2_LOAD(xr + (2 * r - 1) * 16 + 8));
+      X3 = _mm_xor_si128(X3, SSE2_LOAD(xr + (2 * r - 1) * 16 + 12));
+   }
+   for (i = 0; i < 2 * r; i++) {
+      Y0 = SSE2_LOAD(in + i * 16);
+      Y1 = SSE2_LOAD(in + i * 16 + 4);
+      Y2 = SSE2_LOAD(in + i * 16 + 8);
+      Y3 = SSE2_LOAD(in + i * 16 + 12);
+      if (xr != NULL) {
+         Y0 = _mm_xor_si128(Y0, SSE2_LOAD(xr + i * 16));
+         Y1 = _mm_xor_si128(Y1, SSE2_LOAD(xr + i * 16 + 4));
+         Y2 = _mm_xor_si128(Y2, SSE2_LOAD(xr + i * 16 + 8));
+         Y3 = _mm_xor_si128(Y3, SSE2_LOAD(xr + i * 16 + 12));
+      }
+      X0 = Y0 = _mm_xor_si128(X0, Y0);
+      X1 = Y1 = _mm_xor_si128(X1, Y1);
+      X2 = Y2 = _mm_xor_si128(X2, Y2);
+      X3 = Y3 = _mm_xor_si128(X3, Y3);
+
+      SSE2_DOUBLEROUND
+      SSE2_DOUBLEROUND
+      SSE2_DOUBLEROUND
+      SSE2_DOUBLEROUND
+
+      X0 = _mm_add_epi32(X0, Y0);
+      X1 = _mm_add_epi32(X1, Y1);
+      X2 = _mm_add_epi32(X2, Y2);
+      X3 = _mm_add_epi32(X3, Y3);
+
+      /* the even blocks go to the first half, the odd ones to the second */
+      dst = out + ((i & 1) * r + i / 2) * 16;
+      SSE2_STORE(dst,      X0);
+      SSE2_STORE(dst + 4,  X1);
+      SSE2_STORE(dst + 8,  X2);
+      SSE2_STORE(dst + 12, X3);
+   }
+}
+
+/**
+  B = ROMix(B) with SSE2
+  @param B    [in/out] The 128 * r octets of a lane
+  @param r    The block size
+  @param N    The CPU/memory cost
+  @param V    The scratch memory of N * 32 * r words
+  @param XY   The scratch memory of 64 * r words
+*/
+SSE2_TARGET
+void scrypt_sse2_romix(unsigned char *B, unsigned long r, ulong64 N, ulong32 *V, ulong32 *XY)
+{
+   ulong32 *X, *Y, *T;
+   unsigned long words, k, i;
+   ulong64 n, j;
+
+   words = 32 * r;
+   X     = XY;
+   Y     = XY + words;
+   for (k = 0; k < 2 * r; k++) {
+      for (i = 0; i < 16; i++) {
+         LOAD32L(V[16 * k + i], B + 4 * (16 * k + (5 * i) % 16));
+      }
+   }
+   /* V_i = BlockMix^i(B), written in place */
+   for (n = 0; n + 1 < N; n++) {
+      _scrypt_sse2_blockmix(V + n * words, NULL, V + (n + 1) * words, r);
+   }
+   _scrypt_sse2_blockmix(V + (N - 1) * words, NULL, X, r);
+   for (n = 0; n < N; n++) {
+      /* Integerify(X) mod N, the words 0 and 1 of the last block are at the positions 0 and 13 */
+      j = (X[words - 16] | ((ulong64)X[words - 3] << 32)) & (N - 1);
+      _scrypt_sse2_blockmix(X, V + j * words, Y, r);
+      T = X;
+      X = Y;
+      Y = T;
+   }
+   for (k = 0; k < 2 * r; k++) {
+      for (i = 0; i < 16; i++) {
+         STORE32L(X[16 * k + i], B + 4 * (16 * k + (5 * i) % 16));
+      }
+   }
+}
+
+#endif
+
+/* ref:         $Format:%D$ */
+/* git commit:  $Format:%H$ */
+/* commit time: $Format:%ai$ */
@@ -0,0 +1,104 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ */
+#include "tomcrypt_private.h"
+
+/**
+  @file scrypt_test.c
+  scrypt support, self-test
+*/
+
+#ifdef LTC_SCRYPT
+
+/*
+    TEST CASES SOURCE:
+
+RFC 7914, The scrypt Password-Based Key Derivation Function,
+Section 12. Test Vectors, the first three of them
+
+    The last case is from an independent implementation and covers an odd r
+    and more lanes than threads.
+*/
+
+/**
+  scrypt self-test
+  @return CRYPT_OK if successful, CRYPT_NOP if tests have been disabled.
+*/
+int scrypt_test(void)
+{
+ #ifndef LTC_TEST
+    return CRYPT_NOP;
+ #else
+    static const struct {
+       const char *pwd, *salt;
+       ulong64 N;
+       unsigned long r, p, outlen;
+       unsigned char out[64];
+    } tests[] = {
+       { "", "", 16, 1, 1, 64,
+         { 0x77, 0xd6, 0x57, 0x62, 0x38, 0x65, 0x7b, 0x20, 0x3b, 0x19, 0xca, 0x42, 0xc1, 0x8a, 0x04, 0x97,
+           0xf1, 0x6b, 0x48, 0x44, 0xe3, 0x07, 0x4a, 0xe8, 0xdf, 0xdf, 0xfa, 0x3f, 0xed, 0xe2, 0x14, 0x42,
+           0xfc, 0xd0, 0x06, 0x9d, 0xed, 0x09, 0x48, 0xf8, 0x32, 0x6a, 0x75, 0x3a, 0x0f, 0xc8, 0x1f, 0x17,
+           0xe8, 0xd3, 0xe0, 0xfb, 0x2e, 0x0d, 0x36, 0x28, 0xcf, 0x35, 0xe2, 0x0c, 0x38, 0xd1, 0x89, 0x06 } },
+       { "password", "NaCl", 1024, 8, 16, 64,
+         { 0xfd, 0xba, 0xbe, 0x1c, 0x9d, 0x34, 0x72, 0x00, 0x78, 0x56, 0xe7, 0x19, 0x0d, 0x01, 0xe9, 0xfe,
+           0x7c, 0x6a, 0xd7, 0xcb, 0xc8, 0x23, 0x78, 0x30, 0xe7, 0x73, 0x76, 0x63, 0x4b, 0x37, 0x31, 0x62,
+           0x2e, 0xaf, 0x30, 0xd9, 0x2e, 0x22, 0xa3, 0x88, 0x6f, 0xf1, 0x09, 0x27, 0x9d, 0x98, 0x30, 0xda,
+           0xc7, 0x27, 0xaf, 0xb9, 0x4a, 0x83, 0xee, 0x6d, 0x83, 0x60, 0xcb, 0xdf, 0xa2, 0xcc, 0x06, 0x40 } },
+       { "pleaseletmein", "SodiumChloride", 16384, 8, 1, 64,
+         { 0x70, 0x23, 0xbd, 0xcb, 0x3a, 0xfd, 0x73, 0x48, 0x46, 0x1c, 0x06, 0xcd, 0x81, 0xfd, 0x38, 0xeb,
+           0xfd, 0xa8, 0xfb, 0xba, 0x90, 0x4f, 0x8e, 0x3e, 0xa9, 0xb5, 0x43, 0xf6, 0x54, 0x5d, 0xa1, 0xf2,
+           0xd5, 0x43, 0x29, 0x55, 0x61, 0x3f, 0x0f, 0xcf, 0x62, 0xd4, 0x97, 0x05, 0x24, 0x2a, 0x9a, 0xf9,
+           0xe6, 0x1e, 0x85, 0xdc, 0x0d, 0x65, 0x1e, 0x40, 0xdf, 0xcf, 0x01, 0x7b, 0x45, 0x57, 0x58, 0x87 } },
+       { "pleaseletmein", "SodiumChloride", 256, 3, 5, 37,
+         { 0x9a, 0x0e, 0x6d, 0x4b, 0x55, 0x14, 0xbb, 0xf4, 0xfc, 0x2a, 0x39, 0x05, 0x9d, 0xc3, 0xe9, 0x26,
+           0x4e, 0x4b, 0xe1, 0xbf, 0x27, 0x7f, 0x22, 0x65, 0xa6, 0x3c, 0xac, 0x79, 0xf3, 0x58, 0x1d, 0x71,
+           0x11, 0x17, 0x4a, 0x6c, 0x90 } },
+    };
+    scrypt_arena arena;
+    unsigned char out[64];
+    int i, j, err;
+#ifdef LTC_SCRYPT_SIMD
+    unsigned long mask;
+#endif
+
+    if ((err = scrypt_arena_init(&arena, SCRYPT_ARENA_HUGEPAGES)) != CRYPT_OK) {
+       return err;
+    }
+    for (i = 0; i < (int)(sizeof(tests) / sizeof(tests[0])); i++) {
+       /* with a new scratch memory, then with the arena which is reused, without SSE2 */
+       for (j = 0; j < 2; j++) {
+#ifdef LTC_SCRYPT_SIMD
+          mask = ltc_cpu_mask(j == 0 ? ~0UL : ~LTC_CPU_SSE2);
+#endif
+          err = scrypt((const unsigned char *)tests[i].pwd, (unsigned long)strlen(tests[i].pwd),
+                       (const unsigned char *)tests[i].salt, (unsigned long)strlen(tests[i].salt),
+                       tests[i].N, tests[i].r, tests[i].p, j == 0 ? NULL : &arena, out, tests[i].outlen);
+#ifdef LTC_SCRYPT_SIMD
+          ltc_cpu_mask(mask);
+#endif
+          if (err != CRYPT_OK) {
+             scrypt_arena_done(&arena);
+             return err;
+          }
+          if (compare_testvector(out, tests[i].outlen, tests[i].out, tests[i].outlen, "scrypt", i * 2 + j)) {
+             scrypt_arena_done(&arena);
+             return CRYPT_FAIL_TESTVECTOR;
+          }
+       }
+    }
+
+    return scrypt_arena_done(&arena);
+ #endif
+}
+
+#endif
+
+/* ref:         $Format:%D$ */
+/* git commit:  $Format:%H$ */
+/* commit time: $Format:%ai$ */
@@ -75,6 +75,35 @@ static int _ctr_encrypt(const unsigned char *pt, unsigned char *ct, unsigned lon
    return CRYPT_OK;
 }
 
+/**
+  Number of times the counter can be incremented before it wraps around
+  @param ctr    CTR state
+  @return The number of increments, ULONG_MAX if it doesn't matter
+*/
+static unsigned long _ctr_room(const symmetric_CTR *ctr)
+{
+   unsigned long room = 0;
+   int x, w;
+   unsigned char c;
+
+   w = (ctr->mode == CTR_COUNTER_LITTLE_ENDIAN) ? ctr->ctrlen : ctr->blocklen - ctr->ctrlen;
+
+   /* a counter as wide as the block wraps around the same way in the accelerator */
+   if (w == ctr->blocklen) {
+      return ULONG_MAX;
+   }
+   for (x = 0; x < w; x++) {
+      /* x'th least significant byte of the counter */
+      c = ctr->ctr[(ctr->mode == CTR_COUNTER_LITTLE_ENDIAN) ? x : ctr->blocklen - 1 - x];
+      if (x < (int)sizeof(room)) {
+         room |= (unsigned long)(255 - c) << (8 * x);
+      } else if (c != 255) {
+         return ULONG_MAX;
+      }
+   }
+   return room;
+}
+
 /**
   CTR encrypt
   @param pt     Plaintext
@@ -85,6 +114,7 @@ static int _ctr_encrypt(const unsigned char *pt, unsigned char *ct, unsigned lon
 */
 int ctr_encrypt(const unsigned char *pt, unsigned char *ct, unsigned long len, symmetric_CTR *ctr)
 {
+   unsigned long blocks;
    int err, fr;
 
    LTC_ARGCHK(pt != NULL);
@@ -119,13 +149,16 @@ int ctr_encrypt(const unsigned char *pt, unsigned char *ct, unsigned long len, s
        len -= fr;
      }
 
-     if (len >= (unsigned long)ctr->blocklen) {
-       if ((err = cipher_descriptor[ctr->cipher].accel_ctr_encrypt(pt, ct, len/ctr->blocklen, ctr->ctr, ctr->mode, &ctr->key)) != CRYPT_OK) {
+     /* the accelerator increments the whole block, so stop it before a shorter counter wraps around */
+     blocks = _ctr_room(ctr);
+     blocks = MIN(len / ctr->blocklen, blocks);
+     if (blocks > 0) {
+       if ((err = cipher_descriptor[ctr->cipher].accel_ctr_encrypt(pt, ct, blocks, ctr->ctr, ctr->mode, &ctr->key)) != CRYPT_OK) {
           return err;
        }
-       pt += (len / ctr->blocklen) * ctr->blocklen;
-       ct += (len / ctr->blocklen) * ctr->blocklen;
-       len %= ctr->blocklen;
+       pt += blocks * ctr->blocklen;
+       ct += blocks * ctr->blocklen;
+       len -= blocks * ctr->blocklen;
      }
    }
 
@@ -71,6 +71,16 @@ int chacha_crypt(chacha_state *st, const unsigned char *in, unsigned long inlen,
       out += j;
       in  += j;
    }
+#ifdef LTC_CHACHA_SIMD
+   if (inlen >= 256) {
+      /* whole blocks, as long as the 32-bit counter doesn't wrap around */
+      j = chacha_simd_crypt(st->input, st->rounds, in, out, MIN(inlen / 64, 0xFFFFFFFFUL - st->input[12]));
+      inlen -= 64 * j;
+      if (inlen == 0) return CRYPT_OK;
+      out += 64 * j;
+      in  += 64 * j;
+   }
+#endif
    for (;;) {
      _chacha_block(buf, st->input, st->rounds);
      if (st->ivlen == 8) {
@@ -0,0 +1,480 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ */
+
+/**
+   @file chacha_simd.c
+   ChaCha using the SSE2, AVX2 and AVX-512 instructions of x86-64 CPUs
+
+   Each of the 16 words of the state is held in its own register, one block
+   per 32-bit lane, so 4, 8 or 16 blocks are computed at once without any
+   shuffling between the rounds.  The blocks are transposed back into their
+   byte order before they're XOR'ed with the input.
+
+   The lanes don't need to share a state, chacha_simd_keystream_multi()
+   transposes one state per block into the registers instead.
+
+   chacha20poly1305_simd_crypt() computes Poly1305 in between the AVX2
+   rounds, so ChaCha20-Poly1305 needs only a single pass over the data.
+*/
+#include "tomcrypt_private.h"
+
+#ifdef LTC_CHACHA_SIMD
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+/* the AVX-512 macros of GCC mix declarations and code */
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wdeclaration-after-statement"
+#endif
+#include <immintrin.h>
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+#endif
+
+#ifdef LTC_CHACHA20POLY1305_SIMD
+#include "../../mac/poly1305/poly1305_avx2.h"
+#endif
+
+#define SSE2_TARGET   LTC_ATTRIBUTE_TARGET("sse2")
+#define AVX2_TARGET   LTC_ATTRIBUTE_TARGET("avx2")
+#define AVX512_TARGET LTC_ATTRIBUTE_TARGET("avx2,avx512f")
+
+/* one double round on the state x[0..15] */
+#define CHACHA_QR(a, b, c, d, ADD, XOR, ROL16, ROL12, ROL8, ROL7) \
+   x[a] = ADD(x[a], x[b]); x[d] = ROL16(XOR(x[d], x[a])); \
+   x[c] = ADD(x[c], x[d]); x[b] = ROL12(XOR(x[b], x[c])); \
+   x[a] = ADD(x[a], x[b]); x[d] = ROL8(XOR(x[d], x[a]));  \
+   x[c] = ADD(x[c], x[d]); x[b] = ROL7(XOR(x[b], x[c]));
+
+#define CHACHA_DOUBLEROUND(ADD, XOR, ROL16, ROL12, ROL8, ROL7) \
+   CHACHA_QR(0, 4,  8, 12, ADD, XOR, ROL16, ROL12, ROL8, ROL7) \
+   CHACHA_QR(1, 5,  9, 13, ADD, XOR, ROL16, ROL12, ROL8, ROL7) \
+   CHACHA_QR(2, 6, 10, 14, ADD, XOR, ROL16, ROL12, ROL8, ROL7) \
+   CHACHA_QR(3, 7, 11, 15, ADD, XOR, ROL16, ROL12, ROL8, ROL7) \
+   CHACHA_QR(0, 5, 10, 15, ADD, XOR, ROL16, ROL12, ROL8, ROL7) \
+   CHACHA_QR(1, 6, 11, 12, ADD, XOR, ROL16, ROL12, ROL8, ROL7) \
+   CHACHA_QR(2, 7,  8, 13, ADD, XOR, ROL16, ROL12, ROL8, ROL7) \
+   CHACHA_QR(3, 4,  9, 14, ADD, XOR, ROL16, ROL12, ROL8, ROL7)
+
+#define SSE2_LOAD(p)       _mm_loadu_si128((const __m128i *)(const void *)(p))
+#define SSE2_STORE(p, v)   _mm_storeu_si128((__m128i *)(void *)(p), (v))
+#define SSE2_ROL(x, n)     _mm_or_si128(_mm_slli_epi32((x), (n)), _mm_srli_epi32((x), 32 - (n)))
+#define SSE2_ROL16(x)      _mm_shufflehi_epi16(_mm_shufflelo_epi16((x), 0xB1), 0xB1)
+#define SSE2_ROL12(x)      SSE2_ROL((x), 12)
+#define SSE2_ROL8(x)       SSE2_ROL((x), 8)
+#define SSE2_ROL7(x)       SSE2_ROL((x), 7)
+
+#define AVX2_LOAD(p)       _mm256_loadu_si256((const __m256i *)(const void *)(p))
+#define AVX2_STORE(p, v)   _mm256_storeu_si256((__m256i *)(void *)(p), (v))
+#define AVX2_ROL(x, n)     _mm256_or_si256(_mm256_slli_epi32((x), (n)), _mm256_srli_epi32((x), 32 - (n)))
+#define AVX2_ROL16(x)      _mm256_shuffle_epi8((x), r16)
+#define AVX2_ROL12(x)      AVX2_ROL((x), 12)
+#define AVX2_ROL8(x)       _mm256_shuffle_epi8((x), r8)
+#define AVX2_ROL7(x)       AVX2_ROL((x), 7)
+
+#define AVX512_LOAD(p)     _mm512_loadu_si512((const void *)(p))
+#define AVX512_STORE(p, v) _mm512_storeu_si512((void *)(p), (v))
+#define AVX512_ROL16(x)    _mm512_rol_epi32((x), 16)
+#define AVX512_ROL12(x)    _mm512_rol_epi32((x), 12)
+#define AVX512_ROL8(x)     _mm512_rol_epi32((x), 8)
+#define AVX512_ROL7(x)     _mm512_rol_epi32((x), 7)
+
+/* transpose the 4x4 matrices of 32-bit words in each 128-bit lane */
+#define CHACHA_TRANSPOSE(a, b, c, d, UNPACKLO32, UNPACKHI32, UNPACKLO64, UNPACKHI64) \
+   do {                                                                             \
+      t0 = UNPACKLO32(a, b);                                                         \
+      t1 = UNPACKLO32(c, d);                                                         \
+      t2 = UNPACKHI32(a, b);                                                         \
+      t3 = UNPACKHI32(c, d);                                                         \
+      a = UNPACKLO64(t0, t1);                                                        \
+      b = UNPACKHI64(t0, t1);                                                        \
+      c = UNPACKLO64(t2, t3);                                                        \
+      d = UNPACKHI64(t2, t3);                                                        \
+   } while (0)
+
+/* the rounds on the 4 blocks of s, the key stream is XOR'ed with in, or stored if in is NULL */
+SSE2_TARGET
+static LTC_INLINE void _chacha_sse2_rounds(const __m128i *s, int rounds, const unsigned char *in, unsigned char *out)
+{
+   __m128i x[16], t0, t1, t2, t3;
+   int i, g;
+
+   for (i = 0; i < 16; i++) {
+      x[i] = s[i];
+   }
+   for (i = rounds; i > 0; i -= 2) {
+      CHACHA_DOUBLEROUND(_mm_add_epi32, _mm_xor_si128, SSE2_ROL16, SSE2_ROL12, SSE2_ROL8, SSE2_ROL7)
+   }
+   for (i = 0; i < 16; i++) {
+      x[i] = _mm_add_epi32(x[i], s[i]);
+   }
+
+   for (g = 0; g < 16; g += 4) {
+      CHACHA_TRANSPOSE(x[g], x[g + 1], x[g + 2], x[g + 3],
+                       _mm_unpacklo_epi32, _mm_unpackhi_epi32, _mm_unpacklo_epi64, _mm_unpackhi_epi64);
+      for (i = 0; i < 4; i++) {
+         t0 = x[g + i];
+         if (in != NULL) {
+            t0 = _mm_xor_si128(SSE2_LOAD(in + 64 * i + 4 * g), t0);
+         }
+         SSE2_STORE(out + 64 * i + 4 * g, t0);
+      }
+   }
+}
+
+/* 4 blocks */
+SSE2_TARGET
+static void _chacha_sse2(ulong32 *input, int rounds, const unsigned char *in, unsigned char *out)
+{
+   __m128i s[16];
+   int i;
+
+   for (i = 0; i < 16; i++) {
+      s[i] = _mm_set1_epi32((int)input[i]);
+   }
+   s[12] = _mm_add_epi32(s[12], _mm_setr_epi32(0, 1, 2, 3));
+   _chacha_sse2_rounds(s, rounds, in, out);
+   input[12] += 4;
+}
+
+/* the key stream of 4 blocks, each with its own state */
+SSE2_TARGET
+static void _chacha_sse2_multi(const ulong32 *input, int rounds, unsigned char *out)
+{
+   __m128i s[16], t0, t1, t2, t3;
+   int i, g;
+
+   for (g = 0; g < 16; g += 4) {
+      for (i = 0; i < 4; i++) {
+         s[g + i] = SSE2_LOAD(input + 16 * i + g);
+      }
+      CHACHA_TRANSPOSE(s[g], s[g + 1], s[g + 2], s[g + 3],
+                       _mm_unpacklo_epi32, _mm_unpackhi_epi32, _mm_unpacklo_epi64, _mm_unpackhi_epi64);
+   }
+   _chacha_sse2_rounds(s, rounds, NULL, out);
+}
+
+/* the byte shuffles of AVX2_ROL16 and AVX2_ROL8 */
+#define AVX2_ROL_INIT()                                                                          \
+   r16 = _mm256_setr_epi8(2, 3, 0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 14, 15, 12, 13,                 \
+                          2, 3, 0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 14, 15, 12, 13);                \
+   r8  = _mm256_setr_epi8(3, 0, 1, 2, 7, 4, 5, 6, 11, 8, 9, 10, 15, 12, 13, 14,                 \
+                          3, 0, 1, 2, 7, 4, 5, 6, 11, 8, 9, 10, 15, 12, 13, 14)
+
+/* the key stream of the 8 blocks of s after the rounds x, it's XOR'ed with in, or stored if in is NULL */
+AVX2_TARGET
+static LTC_INLINE void _chacha_avx2_output(__m256i *x, const __m256i *s, const unsigned char *in, unsigned char *out)
+{
+   __m256i t0, t1, t2, t3;
+   int i, g;
+
+   for (i = 0; i < 16; i++) {
+      x[i] = _mm256_add_epi32(x[i], s[i]);
+   }
+
+   /* x[g + i] holds 16 bytes of block i in the low and of block i + 4 in the high lane */
+   for (g = 0; g < 16; g += 4) {
+      CHACHA_TRANSPOSE(x[g], x[g + 1], x[g + 2], x[g + 3],
+                       _mm256_unpacklo_epi32, _mm256_unpackhi_epi32, _mm256_unpacklo_epi64, _mm256_unpackhi_epi64);
+   }
+   for (g = 0; g < 16; g += 8) {
+      for (i = 0; i < 4; i++) {
+         t0 = _mm256_permute2x128_si256(x[g + i], x[g + 4 + i], 0x20);
+         t1 = _mm256_permute2x128_si256(x[g + i], x[g + 4 + i], 0x31);
+         if (in != NULL) {
+            t0 = _mm256_xor_si256(AVX2_LOAD(in + 64 * i + 4 * g), t0);
+            t1 = _mm256_xor_si256(AVX2_LOAD(in + 64 * (i + 4) + 4 * g), t1);
+         }
+         AVX2_STORE(out + 64 * i + 4 * g, t0);
+         AVX2_STORE(out + 64 * (i + 4) + 4 * g, t1);
+      }
+   }
+}
+
+/* the rounds on the 8 blocks of s, the key stream is XOR'ed with in, or stored if in is NULL */
+AVX2_TARGET
+static LTC_INLINE void _chacha_avx2_rounds(const __m256i *s, int rounds, const unsigned char *in, unsigned char *out)
+{
+   __m256i x[16], r16, r8;
+   int i;
+
+   AVX2_ROL_INIT();
+   for (i = 0; i < 16; i++) {
+      x[i] = s[i];
+   }
+   for (i = rounds; i > 0; i -= 2) {
+      CHACHA_DOUBLEROUND(_mm256_add_epi32, _mm256_xor_si256, AVX2_ROL16, AVX2_ROL12, AVX2_ROL8, AVX2_ROL7)
+   }
+   _chacha_avx2_output(x, s, in, out);
+}
+
+/* 8 blocks */
+AVX2_TARGET
+static void _chacha_avx2(ulong32 *input, int rounds, const unsigned char *in, unsigned char *out)
+{
+   __m256i s[16];
+   int i;
+
+   for (i = 0; i < 16; i++) {
+      s[i] = _mm256_set1_epi32((int)input[i]);
+   }
+   s[12] = _mm256_add_epi32(s[12], _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+   _chacha_avx2_rounds(s, rounds, in, out);
+   input[12] += 8;
+}
+
+/* the key stream of 8 blocks, each with its own state */
+AVX2_TARGET
+static void _chacha_avx2_multi(const ulong32 *input, int rounds, unsigned char *out)
+{
+   __m256i s[16], t0, t1, t2, t3;
+   int i, g;
+
+   /* the states i and i + 4 go to the low and the high lane, so lane j of s[k] is word k of state j */
+   for (g = 0; g < 16; g += 4) {
+      for (i = 0; i < 4; i++) {
+         s[g + i] = _mm256_inserti128_si256(_mm256_castsi128_si256(SSE2_LOAD(input + 16 * i + g)),
+                                            SSE2_LOAD(input + 16 * (i + 4) + g), 1);
+      }
+      CHACHA_TRANSPOSE(s[g], s[g + 1], s[g + 2], s[g + 3],
+                       _mm256_unpacklo_epi32, _mm256_unpackhi_epi32, _mm256_unpacklo_epi64, _mm256_unpackhi_epi64);
+   }
+   _chacha_avx2_rounds(s, rounds, NULL, out);
+}
+
+#ifdef LTC_AMD64_AVX512
+/* 16 blocks */
+AVX512_TARGET
+static void _chacha_avx512(ulong32 *input, int rounds, const unsigned char *in, unsigned char *out)
+{
+   __m512i x[16], s[16], t0, t1, t2, t3;
+   int i;
+
+   for (i = 0; i < 16; i++) {
+      s[i] = _mm512_set1_epi32((int)input[i]);
+   }
+   s[12] = _mm512_add_epi32(s[12], _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15));
+   for (i = 0; i < 16; i++) {
+      x[i] = s[i];
+   }
+   for (i = rounds; i > 0; i -= 2) {
+      CHACHA_DOUBLEROUND(_mm512_add_epi32, _mm512_xor_si512, AVX512_ROL16, AVX512_ROL12, AVX512_ROL8, AVX512_ROL7)
+   }
+   for (i = 0; i < 16; i++) {
+      x[i] = _mm512_add_epi32(x[i], s[i]);
+   }
+
+   /* x[4 * g + i] holds 16 bytes of the blocks i, i + 4, i + 8 and i + 12 in its four lanes */
+   for (i = 0; i < 16; i += 4) {
+      CHACHA_TRANSPOSE(x[i], x[i + 1], x[i + 2], x[i + 3],
+                       _mm512_unpacklo_epi32, _mm512_unpackhi_epi32, _mm512_unpacklo_epi64, _mm512_unpackhi_epi64);
+   }
+   for (i = 0; i < 4; i++) {
+      t0 = _mm512_shuffle_i32x4(x[i], x[4 + i], 0x44);
+      t1 = _mm512_shuffle_i32x4(x[8 + i], x[12 + i], 0x44);
+      t2 = _mm512_shuffle_i32x4(x[i], x[4 + i], 0xEE);
+      t3 = _mm512_shuffle_i32x4(x[8 + i], x[12 + i], 0xEE);
+      AVX512_STORE(out + 64 * i,        _mm512_xor_si512(AVX512_LOAD(in + 64 * i),        _mm512_shuffle_i32x4(t0, t1, 0x88)));
+      AVX512_STORE(out + 64 * (i + 4),  _mm512_xor_si512(AVX512_LOAD(in + 64 * (i + 4)),  _mm512_shuffle_i32x4(t0, t1, 0xDD)));
+      AVX512_STORE(out + 64 * (i + 8),  _mm512_xor_si512(AVX512_LOAD(in + 64 * (i + 8)),  _mm512_shuffle_i32x4(t2, t3, 0x88)));
+      AVX512_STORE(out + 64 * (i + 12), _mm512_xor_si512(AVX512_LOAD(in + 64 * (i + 12)), _mm512_shuffle_i32x4(t2, t3, 0xDD)));
+   }
+   input[12] += 16;
+}
+#endif
+
+#ifdef LTC_CHACHA20POLY1305_SIMD
+/* the ciphertext which is authenticated while chunk n of len octets is computed */
+#define CHACHA20POLY1305_CT(n, len) do {     \
+   if (direction != CHACHA20POLY1305_ENCRYPT) { \
+      m    = in + (len) * (n);               \
+      left = (len);                          \
+   } else if ((n) > 0) {                     \
+      m    = out + (len) * ((n) - 1);        \
+      left = (len);                          \
+   } else {                                  \
+      m    = out;                            \
+      left = 0;                              \
+   }                                         \
+} while (0)
+
+/* the Poly1305 lanes over the next 64 octets of the ciphertext */
+#define CHACHA20POLY1305_POLY() do {         \
+   if (!first) {                             \
+      POLY1305_MUL(D, H, R, S);              \
+      POLY1305_CARRY(H, D);                  \
+   }                                         \
+   POLY1305_LOAD(M, m);                      \
+   POLY1305_ADD(H, M);                       \
+   first = 0;                                \
+   m    += 64;                               \
+   left -= 64;                               \
+} while (0)
+
+/*
+   8 ChaCha20 blocks of 64 octets per chunk, the 8 steps of the AVX2
+   Poly1305 over 512 octets of ciphertext are done in between the double
+   rounds.  When encrypting it's the ciphertext of the previous chunk,
+   which was just written and is still in the L1 cache.  When decrypting
+   it's the input of the current chunk, before it's overwritten.
+*/
+AVX2_TARGET
+static void _chacha20poly1305_avx2(ulong32 *input, int rounds, ulong32 *h, const ulong32 *r,
+                                   const unsigned char *in, unsigned char *out, unsigned long chunks, int direction)
+{
+   __m256i x[16], s[16], eight, r16, r8;
+   __m256i H[5], M[5], D[5], R[5], S[5], mask, hibit;
+   ulong32 p[4][5];
+   const unsigned char *m;
+   unsigned long n, left;
+   int i, first;
+
+   AVX2_ROL_INIT();
+   POLY1305_AVX2_CONST();
+   _poly1305_avx2_powers(p, R, S, r);
+   for (i = 0; i < 5; i++) {
+      H[i] = _mm256_setr_epi64x((long long)h[i], 0, 0, 0);
+   }
+   first = 1;
+
+   for (i = 0; i < 16; i++) {
+      s[i] = _mm256_set1_epi32((int)input[i]);
+   }
+   s[12] = _mm256_add_epi32(s[12], _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+   eight = _mm256_set1_epi32(8);
+
+   for (n = 0; n < chunks; n++) {
+      CHACHA20POLY1305_CT(n, 512);
+      for (i = 0; i < 16; i++) {
+         x[i] = s[i];
+      }
+      for (i = rounds; i > 0; i -= 2) {
+         CHACHA_DOUBLEROUND(_mm256_add_epi32, _mm256_xor_si256, AVX2_ROL16, AVX2_ROL12, AVX2_ROL8, AVX2_ROL7)
+         if (left > 0) {
+            CHACHA20POLY1305_POLY();
+         }
+      }
+      while (left > 0) {
+         CHACHA20POLY1305_POLY();
+      }
+      _chacha_avx2_output(x, s, in + 512 * n, out + 512 * n);
+      s[12] = _mm256_add_epi32(s[12], eight);
+   }
+   if (direction == CHACHA20POLY1305_ENCRYPT) {
+      /* the ciphertext of the last chunk */
+      for (m = out + 512 * (chunks - 1), left = 512; left > 0;) {
+         CHACHA20POLY1305_POLY();
+      }
+   }
+
+   _poly1305_avx2_sum(h, H, p);
+   input[12] += (ulong32)(8 * chunks);
+#ifdef LTC_CLEAN_STACK
+   zeromem(p, sizeof(p));
+#endif
+}
+
+#endif
+
+/**
+   Encrypt (or decrypt) whole blocks with ChaCha, several blocks at a time
+   @param input   The ChaCha state, its 32-bit block counter is incremented
+   @param rounds  The number of rounds
+   @param in      The plaintext (or ciphertext)
+   @param out     [out] The ciphertext (or plaintext)
+   @param blocks  The maximum number of 64 octet blocks, the counter must not wrap around
+   @return The number of blocks processed, a multiple of four
+*/
+unsigned long chacha_simd_crypt(ulong32 *input, int rounds, const unsigned char *in, unsigned char *out, unsigned long blocks)
+{
+   unsigned long n = 0;
+
+#ifdef LTC_AMD64_AVX512
+   if (blocks >= 16 && ltc_cpu_has(LTC_CPU_AVX512)) {
+      for (; n + 16 <= blocks; n += 16) {
+         _chacha_avx512(input, rounds, in + 64 * n, out + 64 * n);
+      }
+   }
+#endif
+   if (blocks - n >= 8 && ltc_cpu_has(LTC_CPU_AVX2)) {
+      for (; n + 8 <= blocks; n += 8) {
+         _chacha_avx2(input, rounds, in + 64 * n, out + 64 * n);
+      }
+   }
+   if (ltc_cpu_has(LTC_CPU_SSE2)) {
+      for (; n + 4 <= blocks; n += 4) {
+         _chacha_sse2(input, rounds, in + 64 * n, out + 64 * n);
+      }
+   }
+   return n;
+}
+
+/**
+   Compute ChaCha key stream blocks, each of them with its own state
+
+   This allows to compute the few blocks of many short messages at once.
+   @param input   The states, 16 words per block
+   @param rounds  The number of rounds
+   @param out     [out] The key stream, 64 octets per block
+   @param blocks  The number of blocks, a multiple of four
+*/
+void chacha_simd_keystream_multi(const ulong32 *input, int rounds, unsigned char *out, unsigned long blocks)
+{
+   unsigned long n = 0;
+
+   if (ltc_cpu_has(LTC_CPU_AVX2)) {
+      for (; n + 8 <= blocks; n += 8) {
+         _chacha_avx2_multi(input + 16 * n, rounds, out + 64 * n);
+      }
+   }
+   for (; n + 4 <= blocks; n += 4) {
+      _chacha_sse2_multi(input + 16 * n, rounds, out + 64 * n);
+   }
+}
+
+#ifdef LTC_CHACHA20POLY1305_SIMD
+/**
+   Encrypt (or decrypt) and authenticate with ChaCha20-Poly1305 in a single pass
+
+   The key stream and the Poly1305 input must be at a block boundary, i.e.
+   there are no buffered octets in either state, otherwise nothing is done.
+   @param chacha    The ChaCha state, its 32-bit block counter is incremented
+   @param poly      The Poly1305 state, the ciphertext is added to it
+   @param in        The plaintext (or ciphertext)
+   @param out       [out] The ciphertext (or plaintext)
+   @param inlen     The maximum number of octets, the counter must not wrap around
+   @param direction CHACHA20POLY1305_ENCRYPT or CHACHA20POLY1305_DECRYPT
+   @return The number of octets processed, a multiple of 512
+*/
+unsigned long chacha20poly1305_simd_crypt(chacha_state *chacha, poly1305_state *poly,
+                                          const unsigned char *in, unsigned char *out, unsigned long inlen, int direction)
+{
+   unsigned long chunks;
+
+   /* with AVX-512 the 16 block ChaCha kernel followed by a separate pass of Poly1305 is faster */
+   if (chacha->ksleft != 0 || poly->leftover != 0 || !ltc_cpu_has(LTC_CPU_AVX2) || ltc_cpu_has(LTC_CPU_AVX512)) {
+      return 0;
+   }
+   chunks = MIN(inlen / 512, (0xFFFFFFFFUL - chacha->input[12]) / 8);
+   if (chunks == 0) {
+      return 0;
+   }
+   _chacha20poly1305_avx2(chacha->input, chacha->rounds, poly->h, poly->r, in, out, chunks, direction);
+   return 512 * chunks;
+}
+#endif
+
+#endif
+
+/* ref:         $Format:%D$ */
+/* git commit:  $Format:%H$ */
+/* commit time: $Format:%ai$ */
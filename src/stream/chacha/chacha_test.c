@@ -16,6 +16,74 @@
 
 #ifdef LTC_CHACHA
 
+#if defined(LTC_TEST) && defined(LTC_CHACHA_SIMD)
+/* encrypt with the code paths allowed by the CPU feature mask, in two calls */
+static int _chacha_simd_crypt(unsigned long mask, const unsigned char *key, int rounds, int ivlen, ulong64 counter,
+                              const unsigned char *in, unsigned long inlen, unsigned long split, unsigned char *out)
+{
+   chacha_state st;
+   int err;
+
+   mask = ltc_cpu_mask(mask);
+   if ((err = chacha_setup(&st, key, 32, rounds)) != CRYPT_OK)                        goto LBL_ERR;
+   if (ivlen == 12) {
+      err = chacha_ivctr32(&st, key + 8, 12, (ulong32)counter);
+   } else {
+      err = chacha_ivctr64(&st, key + 8, 8, counter);
+   }
+   if (err != CRYPT_OK)                                                               goto LBL_ERR;
+   if ((err = chacha_crypt(&st, in, split, out)) != CRYPT_OK)                         goto LBL_ERR;
+   err = chacha_crypt(&st, in + split, inlen - split, out + split);
+LBL_ERR:
+   ltc_cpu_mask(mask);
+   return err;
+}
+
+/* compare the SIMD code paths with the generic code */
+static int _chacha_simd_test(void)
+{
+   static const unsigned long lens[] = { 255, 256, 257, 511, 512, 700, 1024, 1100, 2048, 2500 };
+   static const unsigned long masks[] = {
+      ~0UL,
+      ~LTC_CPU_AVX512,
+      ~(LTC_CPU_AVX512 | LTC_CPU_AVX2),
+   };
+   static const int rounds[] = { 20, 12, 8 };
+   unsigned char key[32], P[2500], C[2][2500];
+   unsigned long x, m, len, split;
+   ulong64 counter;
+   int ivlen, err;
+
+   for (x = 0; x < sizeof(P); x++) {
+      P[x] = (unsigned char)(x * 7 + 3);
+   }
+   for (x = 0; x < sizeof(key); x++) {
+      key[x] = (unsigned char)(x * 17 + 9);
+   }
+
+   for (x = 0; x < sizeof(lens)/sizeof(lens[0]); x++) {
+      len   = lens[x];
+      split = (x * 37) % 100;
+      ivlen = (x & 1) ? 8 : 12;
+      /* the 32-bit counter is close to its limit, the 64-bit counter carries */
+      counter = (x & 1) ? CONST64(0xFFFFFFF5) : ((x % 4) == 2 ? 0xFFFFFFFFUL - (len + 63) / 64 : 1);
+      if ((err = _chacha_simd_crypt(~(LTC_CPU_SSE2 | LTC_CPU_AVX2 | LTC_CPU_AVX512), key, rounds[x % 3], ivlen, counter,
+                                    P, len, split, C[0])) != CRYPT_OK) {
+         return err;
+      }
+      for (m = 0; m < sizeof(masks)/sizeof(masks[0]); m++) {
+         if ((err = _chacha_simd_crypt(masks[m], key, rounds[x % 3], ivlen, counter, P, len, split, C[1])) != CRYPT_OK) {
+            return err;
+         }
+         if (compare_testvector(C[1], len, C[0], len, "CHACHA SIMD", (int)(x * 10 + m))) {
+            return CRYPT_FAIL_TESTVECTOR;
+         }
+      }
+   }
+   return CRYPT_OK;
+}
+#endif
+
 int chacha_test(void)
 {
 #ifndef LTC_TEST
@@ -73,6 +141,10 @@ int chacha_test(void)
                             n + 4, sizeof(n) - 4, 1, (unsigned char*)pt, len, out)) != CRYPT_OK)  return err;
    if (compare_testvector(out, len, ct, sizeof(ct), "CHACHA-TV5", 1))                      return CRYPT_FAIL_TESTVECTOR;
 
+#ifdef LTC_CHACHA_SIMD
+   if ((err = _chacha_simd_test()) != CRYPT_OK)                                            return err;
+#endif
+
    return CRYPT_OK;
 #endif
 }
@@ -12,7 +12,10 @@
 
 int cipher_hash_test(void)
 {
-   int           x;
+   int           x, y;
+#ifdef LTC_AMD64_SIMD
+   unsigned long mask;
+#endif
 
    /* test block ciphers */
    for (x = 0; cipher_descriptor[x].name != NULL; x++) {
@@ -52,6 +55,35 @@ int cipher_hash_test(void)
    DOX(sha3_shake_test(), "sha3_shake");
 #endif
 
+   /* the indexed lookups must find the first matching slot */
+   for (x = 0; cipher_descriptor[x].name != NULL; x++) {
+      DOX(find_cipher(cipher_descriptor[x].name) == x ? CRYPT_OK : CRYPT_ERROR, cipher_descriptor[x].name);
+      y = find_cipher_id(cipher_descriptor[x].ID);
+      DOX(y >= 0 && y <= x && cipher_descriptor[y].ID == cipher_descriptor[x].ID ? CRYPT_OK : CRYPT_ERROR, cipher_descriptor[x].name);
+   }
+   for (x = 0; hash_descriptor[x].name != NULL; x++) {
+      DOX(find_hash(hash_descriptor[x].name) == x ? CRYPT_OK : CRYPT_ERROR, hash_descriptor[x].name);
+      y = find_hash_id(hash_descriptor[x].ID);
+      DOX(y >= 0 && y <= x && hash_descriptor[y].ID == hash_descriptor[x].ID ? CRYPT_OK : CRYPT_ERROR, hash_descriptor[x].name);
+      y = find_hash_oid(hash_descriptor[x].OID, hash_descriptor[x].OIDlen);
+      DOX(y >= 0 && y <= x && hash_descriptor[y].OIDlen == hash_descriptor[x].OIDlen ? CRYPT_OK : CRYPT_ERROR, hash_descriptor[x].name);
+   }
+   DO(find_cipher("no such cipher") == -1 ? CRYPT_OK : CRYPT_ERROR);
+   DO(find_hash("no such hash") == -1 ? CRYPT_OK : CRYPT_ERROR);
+
+#ifdef LTC_AMD64_SIMD
+   /* test the generic code paths as well, the mask is process-wide so the
+    * test runner doesn't run this in parallel to the other tests changing it */
+   mask = ltc_cpu_mask(0);
+   for (x = 0; cipher_descriptor[x].name != NULL; x++) {
+      DOX(cipher_descriptor[x].test(), cipher_descriptor[x].name);
+   }
+   for (x = 0; hash_descriptor[x].name != NULL; x++) {
+      DOX(hash_descriptor[x].test(), hash_descriptor[x].name);
+   }
+   ltc_cpu_mask(mask);
+#endif
+
    return 0;
 }
 
@@ -16,6 +16,12 @@ int misc_test(void)
 #ifdef LTC_PKCS_5
    DO(pkcs_5_test());
 #endif
+#ifdef LTC_ARGON2
+   DO(argon2_test());
+#endif
+#ifdef LTC_SCRYPT
+   DO(scrypt_test());
+#endif
 #ifdef LTC_PADDING
    DO(padding_test());
 #endif
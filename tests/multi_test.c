@@ -40,6 +40,33 @@ int multi_test(void)
       printf("Failed: %d %lu %lu\n", __LINE__, len, len2);
       return CRYPT_FAIL_TESTVECTOR;
    }
+#if defined(LTC_SHA256) && defined(LTC_HASH_HELPERS)
+   {
+      /* more jobs than lanes, the messages end in different blocks */
+      const unsigned long lens[] = { 0, 1, 3, 55, 56, 57, 63, 64, 65, 100, 119, 120, 127, 128, 129, 200, 511, 512, 1000, 1031 };
+      static unsigned char msg[1031];
+      hash_job jobs[20];
+      unsigned char out[20][32];
+      int x, hash = find_hash("sha256");
+      for (x = 0; x < (int)sizeof(msg); x++) {
+         msg[x] = (unsigned char)(x * 7 + 3);
+      }
+      for (x = 0; x < 20; x++) {
+         jobs[x].in = msg;
+         jobs[x].inlen = lens[x];
+         jobs[x].out = out[x];
+      }
+      DO(hash_memory_many(hash, jobs, 20));
+      for (x = 0; x < 20; x++) {
+         len = sizeof(buf[0]);
+         DO(hash_memory(hash, msg, lens[x], buf[0], &len));
+         if (len != sizeof(out[x]) || memcmp(buf[0], out[x], len)) {
+            printf("Failed: %d %d\n", __LINE__, x);
+            return CRYPT_FAIL_TESTVECTOR;
+         }
+      }
+   }
+#endif
 
 #ifdef LTC_HMAC
    len = sizeof(buf[0]);
@@ -12,21 +12,24 @@
 #define GIT_VERSION "Undefined version"
 #endif
 
-#define LTC_TEST_FN(f)  { f, #f }
+#define LTC_TEST_FN(f)  { f, #f, 0 }
+/* a test which restricts the CPU features with ltc_cpu_mask(), directly or in the self-tests it calls */
+#define LTC_TEST_FN_CPU_MASK(f)  { f, #f, 1 }
 
 typedef struct {
    int (*fn)(void);
    const char* name;
+   int cpu_mask;
 } test_function;
 
 static const test_function test_functions[] =
 {
       LTC_TEST_FN(store_test),
       LTC_TEST_FN(rotate_test),
-      LTC_TEST_FN(misc_test),
+      LTC_TEST_FN_CPU_MASK(misc_test),
       LTC_TEST_FN(mpi_test),
-      LTC_TEST_FN(cipher_hash_test),
-      LTC_TEST_FN(mac_test),
+      LTC_TEST_FN_CPU_MASK(cipher_hash_test),
+      LTC_TEST_FN_CPU_MASK(mac_test),
       LTC_TEST_FN(modes_test),
       LTC_TEST_FN(der_test),
       LTC_TEST_FN(pkcs_1_test),
@@ -90,14 +93,20 @@ typedef struct
    ulong64 delta;
 } thread_info;
 
+/* the mask of ltc_cpu_mask() is global, the tests which change it must not overlap
+ * or one of them may restore the mask another one has set */
+static pthread_mutex_t cpu_mask_lock = PTHREAD_MUTEX_INITIALIZER;
+
 static void *run(void *arg)
 {
    thread_info *tinfo = arg;
    ulong64 ts;
 
+   if (tinfo->t->cpu_mask) pthread_mutex_lock(&cpu_mask_lock);
    ts = epoch_usec();
    tinfo->err = tinfo->t->fn();
    tinfo->delta = epoch_usec() - ts;
+   if (tinfo->t->cpu_mask) pthread_mutex_unlock(&cpu_mask_lock);
 
    return arg;
 }
@@ -259,6 +268,12 @@ static void _unregister_all(void)
   unregister_hash(&blake2b_384_desc);
   unregister_hash(&blake2b_512_desc);
 #endif
+#ifdef LTC_BLAKE2SP
+  unregister_hash(&blake2sp_256_desc);
+#endif
+#ifdef LTC_BLAKE2BP
+  unregister_hash(&blake2bp_512_desc);
+#endif
 #ifdef LTC_CHC_HASH
   unregister_hash(&chc_desc);
 #endif